@@ -1,88 +1,286 @@
 #include "data_parser.h"
+#include "hd32mt_profile.h"
 #include "esp_log.h"
+#include <math.h>
 #include <string.h>
 #include <stdint.h>
-#include <stdio.h>
 
-static const char *TAG = "DATA_PARSER";
+/* Normalize kayıt: "$R0" YYMMDDhhmmss ' ' <N*4 bayt> '&' (karakterler/düzen/kodlama profile göre) */
+#define HD32MT_RECORD_PREFIX_LEN      3
+#define HD32MT_RECORD_TIMESTAMP_LEN   12
+#define HD32MT_RECORD_PAYLOAD_OFFSET  (HD32MT_RECORD_PREFIX_LEN + HD32MT_RECORD_TIMESTAMP_LEN + 1)
+
+/* Sensör arızası/taşma işareti olarak gelen değerler */
+#define HD32MT_VALUE_LIMIT            1e6f
 
-static sensor_info_t sensor_map[MAX_SENSORS];
-static int sensor_map_count = 0;
+static const char *TAG = "DATA_PARSER";
 
 /* -----------------------------------------
- * Sensör Haritası Yönetimi
+ * Zaman Damgası
  * ----------------------------------------- */
-void parser_reset_sensor_map(void)
+static inline int two_digits(const char *p)
+{
+    return (p[0] - '0') * 10 + (p[1] - '0');
+}
+
+/* 1970-01-01'den bu yana gün (proleptik Gregoryen, H. Hinnant days_from_civil) */
+static int32_t days_from_civil(int year, unsigned month, unsigned day)
+{
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = (unsigned)(year - era * 400);
+    const unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int32_t)doe - 719468;
+}
+
+static inline bool is_digits(const char *p, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        if ((unsigned)(p[i] - '0') > 9u) return false;
+    }
+    return true;
+}
+
+static int days_in_month(int year, int month)
+{
+    static const uint8_t DAYS[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    if (month == 2 && (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0))) {
+        return 29;
+    }
+    return DAYS[month - 1];
+}
+
+#define HD32MT_INLINE static inline __attribute__((always_inline))
+
+/* Tarih alanı (6 hane) → günün epoch tabanı; alan sırası profilden */
+HD32MT_INLINE bool decode_day(const char *day_field, hd32mt_timestamp_layout_t layout,
+                              uint32_t *out_day_epoch)
 {
-    sensor_map_count = 0;
+    if (!is_digits(day_field, 6)) return false;
+
+    const bool day_first = layout == HD32MT_TIMESTAMP_DDMMYY;
+    int year  = 2000 + two_digits(day_field + (day_first ? 4 : 0));
+    int month = two_digits(day_field + 2);
+    int day   = two_digits(day_field + (day_first ? 0 : 4));
+    if (month < 1 || month > 12 || day < 1 || day > days_in_month(year, month)) {
+        return false;
+    }
+    *out_day_epoch = (uint32_t)days_from_civil(year, (unsigned)month, (unsigned)day) * 86400u;
+    return true;
 }
 
-void parser_add_sensor(const char *name, const char *unit)
+HD32MT_INLINE bool decode_timestamp(hd32mt_timestamp_cache_t *cache, const char *timestamp,
+                                    hd32mt_timestamp_layout_t layout, uint32_t *out_epoch)
 {
-    if (sensor_map_count >= MAX_SENSORS) return;
-    strncpy(sensor_map[sensor_map_count].name, name, sizeof(sensor_map[0].name) - 1);
-    strncpy(sensor_map[sensor_map_count].unit, unit, sizeof(sensor_map[0].unit) - 1);
-    sensor_map_count++;
+    // Saat kısmı her kayıtta: yalnızca 6 rakam ve aralık kontrolü
+    const char *time_field = timestamp + 6;
+    if (!is_digits(time_field, 6)) return false;
+    int hour   = two_digits(time_field + 0);
+    int minute = two_digits(time_field + 2);
+    int second = two_digits(time_field + 4);
+    if (hour > 23 || minute > 59 || second > 59) return false;
+
+    // Gün tabanı: önbellekteki günle aynıysa takvim hesabı yok
+    uint32_t day_epoch;
+    if (cache && cache->valid && memcmp(cache->day, timestamp, sizeof(cache->day)) == 0) {
+        day_epoch = cache->day_epoch;
+    } else {
+        if (!decode_day(timestamp, layout, &day_epoch)) return false;
+        if (cache) {
+            memcpy(cache->day, timestamp, sizeof(cache->day));
+            cache->day_epoch = day_epoch;
+            cache->valid     = true;
+            cache->day_changes++;
+        }
+    }
+
+    *out_epoch = day_epoch + (uint32_t)(hour * 3600 + minute * 60 + second);
+    return true;
+}
+
+bool hd32mt_timestamp_decode(hd32mt_timestamp_cache_t *cache, const char *timestamp, uint32_t *out_epoch)
+{
+    if (!timestamp || !out_epoch) return false;
+    return decode_timestamp(cache, timestamp, HD32MT_TIMESTAMP_YYMMDD, out_epoch);
 }
 
 /* -----------------------------------------
- * Delta Ohm RS232 Satır Çözümleyici
+ * Delta Ohm RS232 Kayıt Çözümleyici
+ *
+ * Gövdeler profil sabitleriyle açılır (bkz. HD32MT_PROFILE_LIST):
+ * her profil kendi dallanmasız çözücüsünü alır.
  * ----------------------------------------- */
-bool parse_hd32mt_record(const char *raw_line, hd32mt_data_t *out)
+
+typedef struct {
+    char                      prefix;
+    char                      type_a;
+    char                      type_b;
+    char                      flag;
+    char                      first_flag;
+    hd32mt_timestamp_layout_t layout;
+    hd32mt_payload_encoding_t encoding;
+    uint8_t                   channels;     /* 0 = uzunluktan */
+    char                      terminator;
+} frame_format_t;
+
+/* Başlık doğrulaması + epoch; payload kanal sayısını döner (0 = geçersiz kayıt).
+ * Çerçeveleyici kaydı HD32MT_FRAMER_MAX_RECORD_BYTES ile sınırlar (< 256 kanal). */
+HD32MT_INLINE size_t decode_header(const char *frame, size_t length, hd32mt_timestamp_cache_t *cache,
+                                   uint32_t *out_epoch, const frame_format_t format)
 {
-    if (!raw_line || !out) return false;
+    // 1️⃣ Satır tipi kontrolü (sonlandırıcı dahil)
+    if (!frame || length < HD32MT_RECORD_PAYLOAD_OFFSET + 1 + 4) return 0;
+    if (frame[0] != format.prefix || (frame[1] != format.type_a && frame[1] != format.type_b) ||
+        (frame[2] != format.flag && frame[2] != format.first_flag))
+        return 0;
+    if (frame[length - 1] != format.terminator || frame[HD32MT_RECORD_PAYLOAD_OFFSET - 1] != ' ')
+        return 0;
 
-    // 1️⃣ Satır tipi kontrolü
-    if (strncmp(raw_line, "$R0", 3) != 0 && strncmp(raw_line, "$A0", 3) != 0)
-        return false;
+    // 2️⃣ Tarih etiketi sabit konumda (çerçeveleyici başlığı normalize eder)
+    if (!decode_timestamp(cache, frame + HD32MT_RECORD_PREFIX_LEN, format.layout, out_epoch))
+        return 0;
+
+    // 3️⃣ Binary veri kısmı: başlıktan sonlandırıcıya kadar.
+    //    Payload 0x0A/0x0D/0x26 içerebilir, uzunluk çerçeveleyiciden gelir.
+    size_t channels = (length - HD32MT_RECORD_PAYLOAD_OFFSET - 1) / 4;
+    if (format.channels && channels != format.channels) return 0;
+    return channels;
+}
+
+/*
+ * 4️⃣ 4 baytlık float'lar: hizasız okuma (+ BE ise tek bswap), dallanmasız geçerlilik.
+ * out[i * stride] yazılır (tek kayıt: 1, sütun çıktısı: kapasite).
+ * Geçersiz değer yerinde kalır, biti temizlenir.
+ */
+HD32MT_INLINE uint32_t decode_payload(const uint8_t *payload, size_t channels, float *out, size_t stride,
+                                      const frame_format_t format)
+{
+    uint32_t valid_mask = 0;
+    for (size_t i = 0; i < channels; ++i) {
+        uint32_t bits;
+        memcpy(&bits, payload + i * 4, sizeof(bits));
+        if (format.encoding == HD32MT_ENCODING_F32_BE) {
+            bits = __builtin_bswap32(bits);
+        }
 
-    // 2️⃣ Tarih etiketini bul
-    const char *ts = strstr(raw_line, "24");  // "240801120831" gibi
-    if (!ts) return false;
-    strncpy(out->timestamp, ts, 12);
-    out->timestamp[12] = '\0';
-
-    // 3️⃣ Tarihi biçimlendir
-    snprintf(out->timestamp_full, sizeof(out->timestamp_full),
-             "20%c%c-%c%c-%c%c %c%c:%c%c:%c%c",
-             ts[0], ts[1], ts[2], ts[3],
-             ts[4], ts[5], ts[6], ts[7],
-             ts[8], ts[9], ts[10], ts[11]);
-
-    // 4️⃣ Binary veri kısmını bul
-    const char *data_start = strchr(ts, ' ');
-    if (!data_start) return false;
-    data_start++;
-    const char *end = strchr(data_start, '&');
-    if (!end) return false;
-
-    size_t data_len = end - data_start;
-    if (data_len < 4) return false;
-
-    // 5️⃣ Float çözümleme (big endian)
-    out->sensor_count = 0;
-    for (int i = 0; i + 4 <= data_len && out->sensor_count < MAX_SENSORS; i += 4) {
-        uint8_t b[4];
-        b[0] = (uint8_t)data_start[i + 3];
-        b[1] = (uint8_t)data_start[i + 2];
-        b[2] = (uint8_t)data_start[i + 1];
-        b[3] = (uint8_t)data_start[i + 0];
         float value;
-        memcpy(&value, b, 4);
-
-        if (value == value && value > -1e6f && value < 1e6f) {
-            int idx = out->sensor_count;
-            out->sensors[idx] = value;
-            out->labels[idx] = (idx < sensor_map_count) ? sensor_map[idx].name : "Unknown";
-            out->units[idx]  = (idx < sensor_map_count) ? sensor_map[idx].unit : "";
-            out->sensor_count++;
+        memcpy(&value, &bits, sizeof(value));
+        out[i * stride] = value;
+
+        /* |x| < limit NaN/Inf için de yanlış olur */
+        valid_mask |= (uint32_t)(fabsf(value) < HD32MT_VALUE_LIMIT) << i;
+    }
+    return valid_mask;
+}
+
+HD32MT_INLINE bool decode_frame(const char *frame, size_t length, hd32mt_timestamp_cache_t *cache,
+                                hd32mt_record_t *out, const frame_format_t format)
+{
+    if (!frame || !out) return false;
+
+    size_t payload_channels = decode_header(frame, length, cache, &out->epoch, format);
+    if (payload_channels == 0 || out->capacity == 0) return false;
+
+    size_t channels = payload_channels < out->capacity ? payload_channels : out->capacity;
+    out->payload_channels = payload_channels > UINT8_MAX ? UINT8_MAX : (uint8_t)payload_channels;
+    out->channel_count = (uint8_t)channels;
+    out->valid_mask = decode_payload((const uint8_t *)frame + HD32MT_RECORD_PAYLOAD_OFFSET,
+                                     channels, out->values, 1, format);
+
+    ESP_LOGD(TAG, "Kayıt: epoch=%u, %u kanal, geçerli=0x%03x",
+             (unsigned)out->epoch, (unsigned)out->channel_count, (unsigned)out->valid_mask);
+    return true;
+}
+
+HD32MT_INLINE size_t decode_frames(const hd32mt_frame_ref_t *frames, size_t frame_count,
+                                   hd32mt_record_columns_t *out, const frame_format_t format)
+{
+    if (!frames || !out || !out->epochs || !out->valid_masks ||
+        !out->channel_counts || !out->values ||
+        out->channel_capacity == 0 || out->channel_capacity > HD32MT_MAX_CHANNELS) {
+        return 0;
+    }
+
+    // Toplu kaynaklar (indirme, SD, replay) genelde aynı günde: tek takvim hesabı
+    hd32mt_timestamp_cache_t cache = {0};
+    const size_t start = out->count;
+    const size_t capacity = out->capacity;
+    for (size_t f = 0; f < frame_count && out->count < capacity; ++f) {
+        const size_t row = out->count;
+        size_t channels = decode_header(frames[f].data, frames[f].length, &cache, &out->epochs[row], format);
+        if (channels == 0) {
+            out->errors++;
+            continue;
         }
+        if (channels > out->channel_capacity) {
+            channels = out->channel_capacity;
+            out->truncated++;
+        }
+        out->channel_counts[row] = (uint8_t)channels;
+        out->valid_masks[row] = decode_payload((const uint8_t *)frames[f].data + HD32MT_RECORD_PAYLOAD_OFFSET,
+                                               channels, &out->values[row], capacity, format);
+        out->count++;
     }
+    return out->count - start;
+}
 
-    ESP_LOGI(TAG, "Tarih: %s (%d sensör)", out->timestamp_full, out->sensor_count);
-    for (int k = 0; k < out->sensor_count; k++) {
-        ESP_LOGI(TAG, "  [%s] = %.2f %s", out->labels[k], out->sensors[k], out->units[k]);
+/* -----------------------------------------
+ * Profiller (derlemede açılır)
+ * ----------------------------------------- */
+
+#define HD32MT_PROFILE_DECODERS(id, dl_type, prefix, type_a, type_b, flag, first_flag,                 \
+                                layout, encoding, channels, terminator)                                 \
+    static const frame_format_t FORMAT_##id = { prefix, type_a, type_b, flag, first_flag,               \
+                                                layout, encoding, channels, terminator };               \
+    static bool decode_frame_##id(const char *frame, size_t length,                                     \
+                                  hd32mt_timestamp_cache_t *cache, hd32mt_record_t *out)                \
+    {                                                                                                    \
+        return decode_frame(frame, length, cache, out, FORMAT_##id);                                     \
+    }                                                                                                    \
+    static size_t decode_frames_##id(const hd32mt_frame_ref_t *frames, size_t frame_count,              \
+                                     hd32mt_record_columns_t *out)                                       \
+    {                                                                                                    \
+        return decode_frames(frames, frame_count, out, FORMAT_##id);                                     \
+    }
+HD32MT_PROFILE_LIST(HD32MT_PROFILE_DECODERS)
+#undef HD32MT_PROFILE_DECODERS
+
+#define HD32MT_PROFILE_ENTRY(id, dl_type, prefix, type_a, type_b, flag, first_flag,                    \
+                             layout, encoding, channels, terminator)                                   \
+    [HD32MT_PROFILE_##id] = { HD32MT_PROFILE_##id, dl_type,                                            \
+                              { prefix, { type_a, type_b }, { flag, first_flag }, terminator, channels }, \
+                              layout, encoding, decode_frame_##id, decode_frames_##id },
+static const hd32mt_profile_t PROFILES[HD32MT_PROFILE_COUNT] = {
+    HD32MT_PROFILE_LIST(HD32MT_PROFILE_ENTRY)
+};
+#undef HD32MT_PROFILE_ENTRY
+
+const hd32mt_profile_t *hd32mt_profile_get(hd32mt_profile_id_t id)
+{
+    return (unsigned)id < HD32MT_PROFILE_COUNT ? &PROFILES[id] : &PROFILES[HD32MT_PROFILE_DEFAULT];
+}
+
+const hd32mt_profile_t *hd32mt_profile_find(const char *dl_type)
+{
+    if (!dl_type || dl_type[0] == '\0') return NULL;
+    for (size_t i = 0; i < HD32MT_PROFILE_COUNT; ++i) {
+        if (strcmp(PROFILES[i].dl_type, dl_type) == 0) {
+            return &PROFILES[i];
+        }
     }
+    return NULL;
+}
 
-    return (out->sensor_count > 0);
+/* Varsayılan profil (HD32MT.1) */
+bool parse_hd32mt_frame(const char *frame, size_t length, hd32mt_timestamp_cache_t *cache,
+                        hd32mt_record_t *out)
+{
+    return PROFILES[HD32MT_PROFILE_DEFAULT].decode(frame, length, cache, out);
+}
+
+size_t parse_hd32mt_frames(const hd32mt_frame_ref_t *frames, size_t frame_count,
+                           hd32mt_record_columns_t *out)
+{
+    return PROFILES[HD32MT_PROFILE_DEFAULT].decode_batch(frames, frame_count, out);
 }
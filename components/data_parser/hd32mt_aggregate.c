@@ -0,0 +1,127 @@
+#include "hd32mt_aggregate.h"
+#include "esp_log.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "HD32MT_AGGREGATE";
+
+/* ------------------------------ Dışarıya Açık API ------------------------------ */
+
+bool hd32mt_aggregator_init(hd32mt_aggregator_t *aggregator, const hd32mt_aggregate_config_t *config,
+                            uint8_t channel_capacity)
+{
+    if (!aggregator || !config || config->window_sec == 0 ||
+        channel_capacity == 0 || channel_capacity > HD32MT_MAX_CHANNELS) {
+        return false;
+    }
+    memset(aggregator, 0, sizeof(*aggregator));
+    aggregator->channels = calloc(channel_capacity, sizeof(hd32mt_channel_stats_t));
+    if (!aggregator->channels) {
+        ESP_LOGE(TAG, "Pencere durumu ayrılamadı (%u kanal)", (unsigned)channel_capacity);
+        return false;
+    }
+    aggregator->config   = *config;
+    aggregator->capacity = channel_capacity;
+    return true;
+}
+
+void hd32mt_aggregator_deinit(hd32mt_aggregator_t *aggregator)
+{
+    if (!aggregator) return;
+    free(aggregator->channels);
+    memset(aggregator, 0, sizeof(*aggregator));
+}
+
+bool hd32mt_aggregator_window_done(const hd32mt_aggregator_t *aggregator, uint32_t epoch)
+{
+    if (!aggregator || !aggregator->open) return false;
+    return epoch < aggregator->window_start ||
+           epoch - aggregator->window_start >= aggregator->config.window_sec;
+}
+
+uint32_t hd32mt_aggregator_window_end(const hd32mt_aggregator_t *aggregator)
+{
+    if (!aggregator || !aggregator->open) return 0;
+    return aggregator->window_start + aggregator->config.window_sec;
+}
+
+void hd32mt_aggregator_add(hd32mt_aggregator_t *aggregator, const hd32mt_record_t *record)
+{
+    if (!aggregator || !aggregator->channels || !record) return;
+
+    // 1️⃣ Pencere kapalıysa kaydın zamanıyla aç (hizalıysa aralığın başına)
+    if (!aggregator->open) {
+        uint32_t start = record->epoch;
+        if (aggregator->config.align_to_clock) {
+            start -= start % aggregator->config.window_sec;
+        }
+        aggregator->window_start  = start;
+        aggregator->open          = true;
+        aggregator->instrument_id = record->instrument_id;
+        aggregator->schema_id     = record->schema_id;
+    } else if (record->epoch < aggregator->window_start) {
+        aggregator->stats.clock_jumps++;
+    }
+
+    // 2️⃣ Kanal başına Welford güncellemesi; geçersiz kanal sayılmaz
+    uint8_t channels = record->channel_count < aggregator->capacity
+                     ? record->channel_count : aggregator->capacity;
+    for (uint8_t i = 0; i < channels; ++i) {
+        if (!hd32mt_record_channel_valid(record, i)) continue;
+
+        hd32mt_channel_stats_t *stats = &aggregator->channels[i];
+        float value = record->values[i];
+        if (stats->count == 0) {
+            stats->min   = value;
+            stats->max   = value;
+            stats->first = value;
+        } else {
+            if (value < stats->min) stats->min = value;
+            if (value > stats->max) stats->max = value;
+        }
+        stats->last = value;
+        stats->count++;
+        float delta = value - stats->mean;
+        stats->mean += delta / (float)stats->count;
+        stats->m2   += delta * (value - stats->mean);
+    }
+    if (channels > aggregator->channel_count) {
+        aggregator->channel_count = channels;
+    }
+    aggregator->records++;
+    aggregator->stats.records++;
+}
+
+bool hd32mt_aggregator_summary(const hd32mt_aggregator_t *aggregator, hd32mt_window_summary_t *out)
+{
+    if (!aggregator || !out || !aggregator->open) return false;
+    *out = (hd32mt_window_summary_t){
+        .window_start  = aggregator->window_start,
+        .window_sec    = aggregator->config.window_sec,
+        .records       = aggregator->records,
+        .channel_count = aggregator->channel_count,
+        .instrument_id = aggregator->instrument_id,
+        .schema_id     = aggregator->schema_id,
+        .channels      = aggregator->channels,
+    };
+    return true;
+}
+
+void hd32mt_aggregator_reset(hd32mt_aggregator_t *aggregator)
+{
+    if (!aggregator || !aggregator->channels) return;
+    if (aggregator->open) {
+        aggregator->stats.windows++;
+    }
+    memset(aggregator->channels, 0, aggregator->capacity * sizeof(hd32mt_channel_stats_t));
+    aggregator->channel_count = 0;
+    aggregator->records       = 0;
+    aggregator->open          = false;
+}
+
+float hd32mt_channel_stddev(const hd32mt_channel_stats_t *stats)
+{
+    if (!stats || stats->count < 2) return 0.0f;
+    return sqrtf(stats->m2 / (float)(stats->count - 1));
+}
@@ -0,0 +1,118 @@
+#include "hd32mt_alarm.h"
+#include <string.h>
+
+/* ------------------------------ Yardımcılar ------------------------------ */
+
+/* Geçerli değer için yeni durum: alarmdaysa histerezis içine dönene kadar kalır */
+static uint8_t alarm_next_state(const hd32mt_alarm_rule_t *rule, uint8_t state, float value,
+                                float *threshold)
+{
+    if (state == HD32MT_ALARM_HIGH && value > rule->high - rule->hysteresis) {
+        *threshold = rule->high;
+        return HD32MT_ALARM_HIGH;
+    }
+    if (state == HD32MT_ALARM_LOW && value < rule->low + rule->hysteresis) {
+        *threshold = rule->low;
+        return HD32MT_ALARM_LOW;
+    }
+    if (rule->has_high && value > rule->high) {
+        *threshold = rule->high;
+        return HD32MT_ALARM_HIGH;
+    }
+    if (rule->has_low && value < rule->low) {
+        *threshold = rule->low;
+        return HD32MT_ALARM_LOW;
+    }
+    // Temizlenen alarmın eşiği olayda kalsın
+    if (state == HD32MT_ALARM_HIGH) *threshold = rule->high;
+    if (state == HD32MT_ALARM_LOW)  *threshold = rule->low;
+    return HD32MT_ALARM_NORMAL;
+}
+
+/* ------------------------------ Dışarıya Açık API ------------------------------ */
+
+void hd32mt_alarm_set_init(hd32mt_alarm_set_t *set)
+{
+    if (!set) return;
+    memset(set, 0, sizeof(*set));
+}
+
+bool hd32mt_alarm_set_rule(hd32mt_alarm_set_t *set, uint8_t channel, const hd32mt_alarm_rule_t *rule)
+{
+    if (!set || channel >= HD32MT_MAX_CHANNELS) return false;
+
+    set->states[channel] = HD32MT_ALARM_NORMAL;
+    if (!rule || (!rule->has_low && !rule->has_high && !rule->fault)) {
+        memset(&set->rules[channel], 0, sizeof(set->rules[channel]));
+        set->rule_mask &= ~(1u << channel);
+        return true;
+    }
+    if (rule->hysteresis < 0.0f || (rule->has_low && rule->has_high && rule->low > rule->high)) {
+        return false;
+    }
+    set->rules[channel] = *rule;
+    set->rule_mask |= 1u << channel;
+    return true;
+}
+
+size_t hd32mt_alarm_evaluate(hd32mt_alarm_set_t *set, const hd32mt_record_t *record,
+                             hd32mt_alarm_event_t *events, size_t max_events)
+{
+    if (!set || !record || !events || set->rule_mask == 0) return 0;
+
+    uint32_t mask = set->rule_mask;
+    if (record->channel_count < 32) {
+        mask &= (1u << record->channel_count) - 1u;
+    }
+    if (!mask) return 0;
+    set->stats.evaluated++;
+
+    size_t count = 0;
+    while (mask && count < max_events) {
+        uint8_t i = (uint8_t)__builtin_ctz(mask);
+        mask &= mask - 1u;
+
+        const hd32mt_alarm_rule_t *rule = &set->rules[i];
+        uint8_t state = set->states[i];
+        uint8_t next;
+        float threshold = 0.0f;
+        float value = record->values[i];
+
+        // 1️⃣ Geçersiz kanal: arıza kuralı yoksa durum korunur
+        if (!hd32mt_record_channel_valid(record, i)) {
+            if (!rule->fault) continue;
+            next = HD32MT_ALARM_FAULT;
+        } else {
+            // 2️⃣ Geçerli değer: arızadan çıkış eşiklere sıfırdan bakar
+            next = alarm_next_state(rule, state == HD32MT_ALARM_FAULT ? HD32MT_ALARM_NORMAL : state,
+                                    value, &threshold);
+        }
+        if (next == state) continue;
+
+        events[count++] = (hd32mt_alarm_event_t){
+            .channel   = i,
+            .state     = next,
+            .previous  = state,
+            .value     = value,
+            .threshold = threshold,
+        };
+        set->states[i] = next;
+        if (next == HD32MT_ALARM_NORMAL) {
+            set->stats.cleared++;
+        } else {
+            set->stats.raised++;
+        }
+    }
+    return count;
+}
+
+const char *hd32mt_alarm_state_name(uint8_t state)
+{
+    switch (state) {
+        case HD32MT_ALARM_NORMAL: return "CLEAR";
+        case HD32MT_ALARM_LOW:    return "LOW";
+        case HD32MT_ALARM_HIGH:   return "HIGH";
+        case HD32MT_ALARM_FAULT:  return "FAULT";
+        default:                  return "?";
+    }
+}
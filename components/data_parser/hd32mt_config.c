@@ -0,0 +1,390 @@
+#include "hd32mt_config.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "nvs.h"
+
+/* Şema önbelleği: "fp<parmak izi başı>" → şema, "inst<id>" → güncel anahtar */
+#define HD32MT_SCHEMA_NVS_NAMESPACE     "hd32schema"
+#define HD32MT_SCHEMA_NVS_KEY_PREFIX    "fp"
+#define HD32MT_SCHEMA_NVS_INST_FMT      "inst%u"
+#define HD32MT_SCHEMA_NVS_KEY_LEN       15    /* NVS anahtar sınırı */
+
+/* Paket sonu: "<veri><2 bayt sağlama>&NNNN" */
+#define HD32MT_PACKET_CHECKSUM_BYTES    2
+#define HD32MT_PACKET_MARKER_DIGITS     4
+
+static const char *TAG = "HD32MT_CONFIG";
+
+/* ------------------------------- Yardımcı Fonksiyonlar ------------------------------- */
+
+static void copy_field(char *dest, size_t cap, const char *src, size_t length)
+{
+    if (length >= cap) length = cap - 1;
+    memcpy(dest, src, length);
+    dest[length] = '\0';
+}
+
+static bool starts_with(const char *line, size_t length, const char *prefix)
+{
+    size_t prefix_length = strlen(prefix);
+    return length >= prefix_length && memcmp(line, prefix, prefix_length) == 0;
+}
+
+/* CSV alanı: *cursor virgülden sonrasına ilerler */
+static bool next_field(const char **cursor, const char *end, const char **field, size_t *field_length)
+{
+    if (*cursor > end) return false;
+    const char *comma = memchr(*cursor, ',', (size_t)(end - *cursor));
+    const char *stop = comma ? comma : end;
+    *field = *cursor;
+    *field_length = (size_t)(stop - *cursor);
+    *cursor = stop + 1;
+    return true;
+}
+
+static bool is_packet_marker(const char *line, size_t length)
+{
+    if (length != HD32MT_PACKET_MARKER_DIGITS) return false;
+    for (size_t i = 0; i < length; ++i) {
+        if (line[i] < '0' || line[i] > '9') return false;
+    }
+    return true;
+}
+
+static bool is_fingerprint(const char *line, size_t length)
+{
+    if (length != HD32MT_FINGERPRINT_LEN) return false;
+    for (size_t i = 0; i < length; ++i) {
+        char ch = line[i];
+        if (!((ch >= '0' && ch <= '9') || (ch >= 'A' && ch <= 'F') || (ch >= 'a' && ch <= 'f'))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static hd32mt_config_variable_t *find_variable(hd32mt_config_parser_t *parser, char variable, bool create)
+{
+    for (uint8_t i = 0; i < parser->variable_count; ++i) {
+        if (parser->variables[i].variable == variable) {
+            return &parser->variables[i];
+        }
+    }
+    if (!create || parser->variable_count >= HD32MT_CONFIG_MAX_VARIABLES) {
+        return NULL;
+    }
+    hd32mt_config_variable_t *slot = &parser->variables[parser->variable_count++];
+    memset(slot, 0, sizeof(*slot));
+    slot->variable = variable;
+    return slot;
+}
+
+static void start_block(hd32mt_config_parser_t *parser)
+{
+    memset(&parser->schema, 0, sizeof(parser->schema));
+    parser->variable_count    = 0;
+    parser->table_header_seen = false;
+    parser->section           = HD32MT_CONFIG_SECTION_PROGRAM;
+    parser->active            = true;
+}
+
+/* ------------------------------- Satır Çözümleme ------------------------------- */
+
+/* "#const a=pyraustham,Current Loop 4-20mA,BIP1" / "#unit a=w/m2" */
+static void parse_variable_line(hd32mt_config_parser_t *parser, const char *line, size_t length,
+                                size_t keyword_length, bool is_unit)
+{
+    const char *cursor = line + keyword_length;
+    const char *end = line + length;
+    while (cursor < end && *cursor == ' ') cursor++;
+    if (end - cursor < 2 || cursor[1] != '=') return;
+
+    hd32mt_config_variable_t *variable = find_variable(parser, cursor[0], true);
+    if (!variable) return;
+
+    cursor += 2;
+    const char *field;
+    size_t field_length;
+    if (!next_field(&cursor, end, &field, &field_length)) return;
+    if (is_unit) {
+        copy_field(variable->unit, sizeof(variable->unit), field, field_length);
+    } else {
+        copy_field(variable->name, sizeof(variable->name), field, field_length);
+    }
+}
+
+/* "[Table1]" satırı: "Current Loop 4-20mA,b,Albedo,w/m2,SampleAvg,0/0/0" */
+static void parse_table_line(hd32mt_config_parser_t *parser, const char *line, size_t length)
+{
+    /* İlk satır ("1,2,0,0") tablo başlığıdır */
+    if (!parser->table_header_seen) {
+        parser->table_header_seen = true;
+        return;
+    }
+    if (parser->schema.sensor_count >= HD32MT_MAX_CHANNELS) return;
+
+    const char *cursor = line;
+    const char *end = line + length;
+    const char *fields[4];
+    size_t lengths[4];
+    for (int i = 0; i < 4; ++i) {
+        if (!next_field(&cursor, end, &fields[i], &lengths[i])) return;
+    }
+
+    uint8_t channel = parser->schema.sensor_count++;
+    sensor_info_t *sensor = &parser->schema.sensors[channel];
+    copy_field(sensor->name, sizeof(sensor->name), fields[2], lengths[2]);
+    copy_field(sensor->unit, sizeof(sensor->unit), fields[3], lengths[3]);
+    parser->schema.variables[channel] = lengths[1] == 1 ? fields[1][0] : '\0';
+}
+
+/* Program bölümündeki "c=(b/a)" satırı: derlenmeden saklanır (bkz. hd32mt_formula) */
+static bool is_formula_line(const char *line, size_t length)
+{
+    size_t i = 1;
+    if (length < 3 || line[0] < 'a' || line[0] > 'z') return false;
+    while (i < length && line[i] == ' ') i++;
+    return i < length && line[i] == '=';
+}
+
+static void store_formula_line(hd32mt_config_parser_t *parser, const char *line, size_t length)
+{
+    char *formulas = parser->schema.formulas;
+    size_t used = strlen(formulas);
+    if (used + length + 2 > sizeof(parser->schema.formulas)) {
+        ESP_LOGW(TAG, "Formül alanı dolu, satır atlandı: %.*s", (int)length, line);
+        return;
+    }
+    if (used > 0) formulas[used++] = '\n';
+    memcpy(formulas + used, line, length);
+    formulas[used + length] = '\0';
+}
+
+/* Tablo yoksa #const sırası ve #unit birimleri kullanılır */
+static void fill_from_variables(hd32mt_config_parser_t *parser)
+{
+    for (uint8_t i = 0; i < parser->variable_count && parser->schema.sensor_count < HD32MT_MAX_CHANNELS; ++i) {
+        const hd32mt_config_variable_t *variable = &parser->variables[i];
+        if (variable->name[0] == '\0') continue;
+        parser->schema.variables[parser->schema.sensor_count] = variable->variable;
+        sensor_info_t *sensor = &parser->schema.sensors[parser->schema.sensor_count++];
+        memcpy(sensor->name, variable->name, sizeof(sensor->name));
+        memcpy(sensor->unit, variable->unit, sizeof(sensor->unit));
+    }
+}
+
+/* @return true: blok bitti */
+static bool process_line(hd32mt_config_parser_t *parser, const char *line, size_t length)
+{
+    /* Başta STX vb. kontrol karakterleri ve boşluklar, sonda boşluk/virgül */
+    while (length > 0 && ((unsigned char)line[0] < 0x20 || line[0] == ' ')) {
+        line++;
+        length--;
+    }
+    while (length > 0 && (line[length - 1] == ' ' || line[length - 1] == ',')) {
+        length--;
+    }
+    if (length == 0) return false;
+
+    if (starts_with(line, length, "#const")) {
+        if (!parser->active || parser->section != HD32MT_CONFIG_SECTION_PROGRAM) {
+            start_block(parser);
+        }
+        parse_variable_line(parser, line, length, strlen("#const"), false);
+        return false;
+    }
+    if (!parser->active) return false;
+
+    if (starts_with(line, length, "#unit")) {
+        parse_variable_line(parser, line, length, strlen("#unit"), true);
+    } else if (starts_with(line, length, "[DLType:")) {
+        const char *type = line + strlen("[DLType:");
+        size_t type_length = length - strlen("[DLType:");
+        if (type_length > 0 && type[type_length - 1] == ']') type_length--;
+        copy_field(parser->schema.dl_type, sizeof(parser->schema.dl_type), type, type_length);
+        parser->section = HD32MT_CONFIG_SECTION_OTHER;
+    } else if (starts_with(line, length, "[Sensors]")) {
+        parser->section = HD32MT_CONFIG_SECTION_SENSORS;
+    } else if (starts_with(line, length, "[Table1]")) {
+        parser->section = HD32MT_CONFIG_SECTION_TABLE;
+        parser->table_header_seen = false;
+    } else if (line[0] == '{') {
+        parser->section = HD32MT_CONFIG_SECTION_FINGERPRINT;
+    } else if (line[0] == '}') {
+        parser->active = false;
+        return true;
+    } else if (line[0] == '[' && parser->section != HD32MT_CONFIG_SECTION_FINGERPRINT) {
+        parser->section = HD32MT_CONFIG_SECTION_OTHER;
+    } else if (parser->section == HD32MT_CONFIG_SECTION_PROGRAM && is_formula_line(line, length)) {
+        store_formula_line(parser, line, length);
+    } else if (parser->section == HD32MT_CONFIG_SECTION_TABLE) {
+        parse_table_line(parser, line, length);
+    } else if (parser->section == HD32MT_CONFIG_SECTION_FINGERPRINT && is_fingerprint(line, length)) {
+        copy_field(parser->schema.fingerprint, sizeof(parser->schema.fingerprint), line, length);
+    }
+    return false;
+}
+
+/* ------------------------------ Dışarıya Açık API ------------------------------ */
+
+void hd32mt_config_init(hd32mt_config_parser_t *parser)
+{
+    if (parser) {
+        memset(parser, 0, sizeof(*parser));
+    }
+}
+
+bool hd32mt_config_feed_line(hd32mt_config_parser_t *parser, const char *line, size_t length,
+                             hd32mt_schema_t *out_schema)
+{
+    if (!parser || !line) return false;
+
+    /* "&NNNN" paket numarası: önceki parçanın sonundaki sağlamayı at, sonrakiyle birleştir */
+    if (is_packet_marker(line, length)) {
+        if (parser->held_length >= HD32MT_PACKET_CHECKSUM_BYTES) {
+            parser->held_length -= HD32MT_PACKET_CHECKSUM_BYTES;
+            parser->join_next = true;
+        }
+        return false;
+    }
+
+    bool complete = false;
+    if (parser->join_next) {
+        parser->join_next = false;
+        size_t room = sizeof(parser->held_line) - parser->held_length;
+        size_t take = length < room ? length : room;
+        memcpy(parser->held_line + parser->held_length, line, take);
+        parser->held_length += take;
+        return false;
+    }
+
+    if (parser->held_length > 0) {
+        complete = process_line(parser, parser->held_line, parser->held_length);
+        parser->held_length = 0;
+    }
+
+    /* Blok sonu beklemeden işlenir; diğer satırlar bir sonraki satıra kadar tutulur */
+    if (!complete && length > 0 && line[0] == '}') {
+        complete = process_line(parser, line, length);
+    } else if (!complete) {
+        size_t take = length < sizeof(parser->held_line) ? length : sizeof(parser->held_line);
+        memcpy(parser->held_line, line, take);
+        parser->held_length = take;
+    }
+
+    if (!complete) return false;
+
+    if (parser->schema.sensor_count == 0) {
+        fill_from_variables(parser);
+    }
+    parser->held_length = 0;
+    parser->join_next   = false;
+    if (out_schema) {
+        *out_schema = parser->schema;
+    }
+    ESP_LOGI(TAG, "Konfigürasyon bloğu çözüldü: %s, %u kanal, parmak izi=%s",
+             parser->schema.dl_type[0] ? parser->schema.dl_type : "?",
+             (unsigned)parser->schema.sensor_count,
+             parser->schema.fingerprint[0] ? parser->schema.fingerprint : "yok");
+    return true;
+}
+
+uint16_t hd32mt_schema_id(const hd32mt_schema_t *schema)
+{
+    if (!schema || schema->sensor_count == 0) return 0;
+
+    /* FNV-1a (32 bit), 16 bite katlanır */
+    uint32_t hash = 2166136261u;
+    const uint8_t *bytes = (const uint8_t *)schema;
+    for (size_t i = 0; i < sizeof(*schema); ++i) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    uint16_t id = (uint16_t)(hash ^ (hash >> 16));
+    return id ? id : 1;
+}
+
+/* ------------------------------ NVS Önbelleği ------------------------------ */
+
+static void schema_key(const hd32mt_schema_t *schema, char *key, size_t cap)
+{
+    /* Parmak izi yoksa (eski firmware) kanal sayısıyla ayrıştır */
+    if (schema->fingerprint[0]) {
+        snprintf(key, cap, "%s%.*s", HD32MT_SCHEMA_NVS_KEY_PREFIX,
+                 HD32MT_SCHEMA_NVS_KEY_LEN - (int)strlen(HD32MT_SCHEMA_NVS_KEY_PREFIX),
+                 schema->fingerprint);
+    } else {
+        snprintf(key, cap, "%snofp%u", HD32MT_SCHEMA_NVS_KEY_PREFIX, (unsigned)schema->sensor_count);
+    }
+}
+
+bool hd32mt_schema_load(uint8_t instrument_id, hd32mt_schema_t *out_schema)
+{
+    if (!out_schema) return false;
+
+    nvs_handle_t handle;
+    if (nvs_open(HD32MT_SCHEMA_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return false;
+    }
+
+    char inst_key[16];
+    char key[HD32MT_SCHEMA_NVS_KEY_LEN + 1];
+    size_t key_length = sizeof(key);
+    size_t blob_length = sizeof(*out_schema);
+    snprintf(inst_key, sizeof(inst_key), HD32MT_SCHEMA_NVS_INST_FMT, (unsigned)instrument_id);
+
+    bool ok = nvs_get_str(handle, inst_key, key, &key_length) == ESP_OK &&
+              nvs_get_blob(handle, key, out_schema, &blob_length) == ESP_OK &&
+              blob_length == sizeof(*out_schema);
+    nvs_close(handle);
+
+    if (ok) {
+        out_schema->fingerprint[HD32MT_FINGERPRINT_LEN] = '\0';
+        ESP_LOGI(TAG, "[%u] Şema önbellekten yüklendi: %u kanal (%s)",
+                 (unsigned)instrument_id, (unsigned)out_schema->sensor_count, key);
+    }
+    return ok;
+}
+
+bool hd32mt_schema_store(uint8_t instrument_id, const hd32mt_schema_t *schema)
+{
+    if (!schema) return false;
+
+    nvs_handle_t handle;
+    if (nvs_open(HD32MT_SCHEMA_NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
+        ESP_LOGW(TAG, "NVS açılamadı, şema saklanmadı");
+        return false;
+    }
+
+    char inst_key[16];
+    char key[HD32MT_SCHEMA_NVS_KEY_LEN + 1];
+    snprintf(inst_key, sizeof(inst_key), HD32MT_SCHEMA_NVS_INST_FMT, (unsigned)instrument_id);
+    schema_key(schema, key, sizeof(key));
+
+    /* Aynı şema zaten varsa flash'ı yıpratma */
+    hd32mt_schema_t existing;
+    size_t blob_length = sizeof(existing);
+    bool known = nvs_get_blob(handle, key, &existing, &blob_length) == ESP_OK &&
+                 blob_length == sizeof(existing) &&
+                 memcmp(&existing, schema, sizeof(existing)) == 0;
+
+    esp_err_t err = ESP_OK;
+    if (!known) {
+        err = nvs_set_blob(handle, key, schema, sizeof(*schema));
+    }
+    if (err == ESP_OK) {
+        err = nvs_set_str(handle, inst_key, key);
+    }
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "[%u] Şema saklanamadı: %s", (unsigned)instrument_id, esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,104 @@
+#include "hd32mt_deadband.h"
+#include "esp_log.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "HD32MT_DEADBAND";
+
+/* ------------------------------ Dışarıya Açık API ------------------------------ */
+
+bool hd32mt_deadband_init(hd32mt_deadband_filter_t *filter, uint8_t channel_capacity,
+                          const hd32mt_deadband_t *default_band, uint32_t heartbeat_sec)
+{
+    if (!filter || !default_band || channel_capacity == 0 || channel_capacity > HD32MT_MAX_CHANNELS) {
+        return false;
+    }
+    memset(filter, 0, sizeof(*filter));
+
+    // Tek blok: bantlar + son değerler + son zamanlar
+    size_t bytes = channel_capacity * (sizeof(hd32mt_deadband_t) + sizeof(float) + sizeof(uint32_t));
+    uint8_t *block = calloc(1, bytes);
+    if (!block) {
+        ESP_LOGE(TAG, "Deadband durumu ayrılamadı (%u kanal)", (unsigned)channel_capacity);
+        return false;
+    }
+    filter->bands      = (hd32mt_deadband_t *)block;
+    filter->last       = (float *)(filter->bands + channel_capacity);
+    filter->last_epoch = (uint32_t *)(filter->last + channel_capacity);
+    filter->capacity      = channel_capacity;
+    filter->heartbeat_sec = heartbeat_sec;
+    for (uint8_t i = 0; i < channel_capacity; ++i) {
+        filter->bands[i] = *default_band;
+    }
+    return true;
+}
+
+void hd32mt_deadband_deinit(hd32mt_deadband_filter_t *filter)
+{
+    if (!filter) return;
+    free(filter->bands);
+    memset(filter, 0, sizeof(*filter));
+}
+
+bool hd32mt_deadband_set(hd32mt_deadband_filter_t *filter, uint8_t channel, const hd32mt_deadband_t *band)
+{
+    if (!filter || !filter->bands || !band || channel >= filter->capacity) {
+        return false;
+    }
+    filter->bands[channel] = *band;
+    return true;
+}
+
+uint32_t hd32mt_deadband_apply(hd32mt_deadband_filter_t *filter, const hd32mt_record_t *record)
+{
+    if (!filter || !filter->bands || !record) return 0;
+
+    uint8_t channels = record->channel_count < filter->capacity
+                     ? record->channel_count : filter->capacity;
+    uint32_t report = 0;
+    for (uint8_t i = 0; i < channels; ++i) {
+        if (!hd32mt_record_channel_valid(record, i)) continue;
+        filter->stats.channels++;
+
+        uint32_t bit = 1u << i;
+        float value = record->values[i];
+        bool send;
+        if (!(filter->reported_mask & bit)) {
+            send = true;   /* İlk değer */
+        } else {
+            // 1️⃣ Bant: mutlak ve yüzde bandından büyüğü
+            float delta = fabsf(value - filter->last[i]);
+            float band  = filter->bands[i].absolute;
+            float relative = filter->bands[i].percent * 0.01f * fabsf(filter->last[i]);
+            if (relative > band) band = relative;
+            send = band > 0.0f ? delta > band : delta != 0.0f;
+
+            // 2️⃣ Heartbeat: bant içinde kalsa da sessizlik sınırında gönderilir
+            if (!send && filter->heartbeat_sec &&
+                record->epoch - filter->last_epoch[i] >= filter->heartbeat_sec) {
+                send = true;
+                filter->stats.heartbeats++;
+            }
+        }
+        if (send) {
+            filter->last[i]       = value;
+            filter->last_epoch[i] = record->epoch;
+            report |= bit;
+        }
+    }
+
+    filter->reported_mask |= report;
+    filter->stats.records++;
+    filter->stats.reported += (uint32_t)__builtin_popcount(report);
+    if (report == 0) {
+        filter->stats.suppressed++;
+    }
+    return report;
+}
+
+void hd32mt_deadband_invalidate(hd32mt_deadband_filter_t *filter)
+{
+    if (!filter) return;
+    filter->reported_mask = 0;
+}
@@ -0,0 +1,346 @@
+#include "hd32mt_formula.h"
+#include "esp_log.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Derlenecek satır için yerel kopya (strtof '\0' ister) */
+#define HD32MT_FORMULA_MAX_LINE_BYTES   128
+
+static const char *TAG = "HD32MT_FORMULA";
+
+typedef struct {
+    const char           *cursor;
+    hd32mt_formula_t     *out;
+    const hd32mt_formula_set_t *set;
+    bool                  ok;
+} formula_compiler_t;
+
+/* ------------------------------- Yardımcı Fonksiyonlar ------------------------------- */
+
+static inline bool is_variable(char ch)
+{
+    return ch >= 'a' && ch <= 'z';
+}
+
+static inline bool is_identifier_char(char ch)
+{
+    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_';
+}
+
+static void skip_spaces(formula_compiler_t *c)
+{
+    while (*c->cursor == ' ' || *c->cursor == '\t') c->cursor++;
+}
+
+static int find_channel(const hd32mt_formula_set_t *set, char variable)
+{
+    for (uint8_t i = 0; i < set->channel_count; ++i) {
+        if (set->variables[i] == variable) return i;
+    }
+    return -1;
+}
+
+static void emit(formula_compiler_t *c, uint8_t opcode, uint8_t channel, float k)
+{
+    if (!c->ok) return;
+    if (c->out->op_count >= HD32MT_FORMULA_MAX_OPS) {
+        c->ok = false;
+        return;
+    }
+    c->out->ops[c->out->op_count++] = (hd32mt_formula_op_t){ .opcode = opcode, .channel = channel, .k = k };
+}
+
+static inline bool is_constant(const formula_compiler_t *c, uint8_t start, uint8_t end)
+{
+    return end - start == 1 && c->out->ops[start].opcode == HD32MT_FORMULA_OP_CONST;
+}
+
+static bool fold(uint8_t opcode, float left, float right, float *out)
+{
+    switch (opcode) {
+    case HD32MT_FORMULA_OP_ADD: *out = left + right; return true;
+    case HD32MT_FORMULA_OP_SUB: *out = left - right; return true;
+    case HD32MT_FORMULA_OP_MUL: *out = left * right; return true;
+    case HD32MT_FORMULA_OP_DIV:
+        if (right == 0.0f) return false;
+        *out = left / right;
+        return true;
+    default:
+        return false;
+    }
+}
+
+/*
+ * İkili işlem: iki sabit → katlanır, sağ sabit → anlık değerli işlem,
+ * aksi halde yığın işlemi. left/right işlenenlerin kod başlangıçlarıdır.
+ */
+static void emit_binary(formula_compiler_t *c, uint8_t opcode, uint8_t left, uint8_t right)
+{
+    if (!c->ok) return;
+    hd32mt_formula_t *f = c->out;
+    if (is_constant(c, left, right) && is_constant(c, right, f->op_count)) {
+        c->ok = fold(opcode, f->ops[left].k, f->ops[right].k, &f->ops[left].k);
+        f->op_count--;
+        return;
+    }
+    if (is_constant(c, right, f->op_count)) {
+        if (opcode == HD32MT_FORMULA_OP_DIV && f->ops[right].k == 0.0f) {
+            c->ok = false;
+            return;
+        }
+        f->ops[right].opcode = (uint8_t)(opcode - HD32MT_FORMULA_OP_ADD + HD32MT_FORMULA_OP_ADD_K);
+        return;
+    }
+    /* k*x, k+x: değişme özelliğiyle sabit sağa alınır */
+    if (is_constant(c, left, right) &&
+        (opcode == HD32MT_FORMULA_OP_ADD || opcode == HD32MT_FORMULA_OP_MUL)) {
+        float k = f->ops[left].k;
+        memmove(&f->ops[left], &f->ops[right], (size_t)(f->op_count - right) * sizeof(f->ops[0]));
+        f->ops[f->op_count - 1] = (hd32mt_formula_op_t){
+            .opcode = (uint8_t)(opcode - HD32MT_FORMULA_OP_ADD + HD32MT_FORMULA_OP_ADD_K), .k = k,
+        };
+        return;
+    }
+    emit(c, opcode, 0, 0.0f);
+}
+
+/* ------------------------------- Ayrıştırıcı ------------------------------- */
+
+static void compile_expression(formula_compiler_t *c);
+
+static void compile_unary(formula_compiler_t *c)
+{
+    skip_spaces(c);
+    if (!c->ok) return;
+
+    char ch = *c->cursor;
+    if (ch == '-') {
+        c->cursor++;
+        uint8_t start = c->out->op_count;
+        compile_unary(c);
+        if (!c->ok) return;
+        if (is_constant(c, start, c->out->op_count)) {
+            c->out->ops[start].k = -c->out->ops[start].k;
+        } else {
+            emit(c, HD32MT_FORMULA_OP_NEG, 0, 0.0f);
+        }
+        return;
+    }
+    if (ch == '+') {
+        c->cursor++;
+        compile_unary(c);
+        return;
+    }
+    if (ch == '(') {
+        c->cursor++;
+        compile_expression(c);
+        skip_spaces(c);
+        if (*c->cursor != ')') {
+            c->ok = false;
+            return;
+        }
+        c->cursor++;
+        return;
+    }
+    if ((ch >= '0' && ch <= '9') || ch == '.') {
+        char *end;
+        float value = strtof(c->cursor, &end);
+        if (end == c->cursor || !isfinite(value)) {
+            c->ok = false;
+            return;
+        }
+        c->cursor = end;
+        emit(c, HD32MT_FORMULA_OP_CONST, 0, value);
+        return;
+    }
+    /* Tek harfli değişken; "BIPvolt(1)" gibi işlevler cihazda hesaplanır, burada yok */
+    if (is_variable(ch) && !is_identifier_char(c->cursor[1])) {
+        int channel = find_channel(c->set, ch);
+        if (channel < 0) {
+            c->ok = false;
+            return;
+        }
+        c->cursor++;
+        c->out->input_mask |= 1u << channel;
+        emit(c, HD32MT_FORMULA_OP_LOAD, (uint8_t)channel, 0.0f);
+        return;
+    }
+    c->ok = false;
+}
+
+static void compile_term(formula_compiler_t *c)
+{
+    uint8_t left = c->out->op_count;
+    compile_unary(c);
+    for (;;) {
+        skip_spaces(c);
+        char ch = *c->cursor;
+        if (!c->ok || (ch != '*' && ch != '/')) return;
+        c->cursor++;
+        uint8_t right = c->out->op_count;
+        compile_unary(c);
+        emit_binary(c, ch == '*' ? HD32MT_FORMULA_OP_MUL : HD32MT_FORMULA_OP_DIV, left, right);
+    }
+}
+
+static void compile_expression(formula_compiler_t *c)
+{
+    uint8_t left = c->out->op_count;
+    compile_term(c);
+    for (;;) {
+        skip_spaces(c);
+        char ch = *c->cursor;
+        if (!c->ok || (ch != '+' && ch != '-')) return;
+        c->cursor++;
+        uint8_t right = c->out->op_count;
+        compile_term(c);
+        emit_binary(c, ch == '+' ? HD32MT_FORMULA_OP_ADD : HD32MT_FORMULA_OP_SUB, left, right);
+    }
+}
+
+/* Yığın derinliği sınırda mı ve sonuçta tek değer kalıyor mu */
+static bool verify_stack(const hd32mt_formula_t *formula)
+{
+    int depth = 0;
+    for (uint8_t i = 0; i < formula->op_count; ++i) {
+        switch (formula->ops[i].opcode) {
+        case HD32MT_FORMULA_OP_LOAD:
+        case HD32MT_FORMULA_OP_CONST:
+            depth++;
+            break;
+        case HD32MT_FORMULA_OP_ADD:
+        case HD32MT_FORMULA_OP_SUB:
+        case HD32MT_FORMULA_OP_MUL:
+        case HD32MT_FORMULA_OP_DIV:
+            depth--;
+            break;
+        default:
+            break;
+        }
+        if (depth < 1 || depth > HD32MT_FORMULA_MAX_DEPTH) return false;
+    }
+    return depth == 1;
+}
+
+/* ------------------------------ Dışarıya Açık API ------------------------------ */
+
+void hd32mt_formula_set_init(hd32mt_formula_set_t *set, const char *variables, uint8_t channel_count)
+{
+    if (!set) return;
+    memset(set, 0, sizeof(*set));
+    if (channel_count > HD32MT_MAX_CHANNELS) channel_count = HD32MT_MAX_CHANNELS;
+    if (variables) {
+        memcpy(set->variables, variables, channel_count);
+    }
+    set->recorded_channels = channel_count;
+    set->channel_count     = channel_count;
+}
+
+bool hd32mt_formula_set_add(hd32mt_formula_set_t *set, const char *line, size_t length, bool derived_only)
+{
+    if (!set || !line || length == 0 || length >= HD32MT_FORMULA_MAX_LINE_BYTES) return false;
+
+    char text[HD32MT_FORMULA_MAX_LINE_BYTES];
+    memcpy(text, line, length);
+    text[length] = '\0';
+
+    // 1️⃣ Hedef: "x="
+    const char *cursor = text;
+    while (*cursor == ' ') cursor++;
+    char variable = *cursor++;
+    while (*cursor == ' ') cursor++;
+    if (!is_variable(variable) || *cursor != '=') return false;
+    cursor++;
+
+    int target = find_channel(set, variable);
+    if (target >= 0 && target < set->recorded_channels && derived_only) {
+        return true;
+    }
+    bool appended = target < 0;
+    if (appended) {
+        if (set->channel_count >= HD32MT_MAX_CHANNELS) return false;
+        target = set->channel_count;
+    }
+    if (set->rule_count >= HD32MT_FORMULA_MAX_RULES) {
+        ESP_LOGW(TAG, "Formül sınırı dolu (%d): %s", HD32MT_FORMULA_MAX_RULES, text);
+        return false;
+    }
+
+    // 2️⃣ İfade → işlem dizisi
+    hd32mt_formula_t formula = { .target = (uint8_t)target };
+    formula_compiler_t compiler = { .cursor = cursor, .out = &formula, .set = set, .ok = true };
+    compile_expression(&compiler);
+    skip_spaces(&compiler);
+    if (!compiler.ok || *compiler.cursor != '\0' || !verify_stack(&formula)) {
+        ESP_LOGD(TAG, "Derlenemeyen formül: %s", text);
+        return false;
+    }
+
+    // 3️⃣ Türetilmiş kanal sonraki formüllerde değişken olarak kullanılabilir
+    if (appended) {
+        set->variables[target] = variable;
+        set->channel_count++;
+    }
+    set->rules[set->rule_count++] = formula;
+    ESP_LOGD(TAG, "Formül: %s → kanal %d, %u işlem", text, target, (unsigned)formula.op_count);
+    return true;
+}
+
+bool hd32mt_formula_eval(const hd32mt_formula_t *formula, const float *values, uint32_t valid_mask,
+                         float *out_value)
+{
+    if ((valid_mask & formula->input_mask) != formula->input_mask) return false;
+
+    /* Derinlik derlemede doğrulandı */
+    float stack[HD32MT_FORMULA_MAX_DEPTH];
+    int top = -1;
+    for (uint8_t i = 0; i < formula->op_count; ++i) {
+        const hd32mt_formula_op_t *op = &formula->ops[i];
+        switch (op->opcode) {
+        case HD32MT_FORMULA_OP_LOAD:  stack[++top] = values[op->channel]; break;
+        case HD32MT_FORMULA_OP_CONST: stack[++top] = op->k; break;
+        case HD32MT_FORMULA_OP_ADD:   stack[top - 1] += stack[top]; top--; break;
+        case HD32MT_FORMULA_OP_SUB:   stack[top - 1] -= stack[top]; top--; break;
+        case HD32MT_FORMULA_OP_MUL:   stack[top - 1] *= stack[top]; top--; break;
+        case HD32MT_FORMULA_OP_DIV:   stack[top - 1] /= stack[top]; top--; break;
+        case HD32MT_FORMULA_OP_NEG:   stack[top] = -stack[top]; break;
+        case HD32MT_FORMULA_OP_ADD_K: stack[top] += op->k; break;
+        case HD32MT_FORMULA_OP_SUB_K: stack[top] -= op->k; break;
+        case HD32MT_FORMULA_OP_MUL_K: stack[top] *= op->k; break;
+        case HD32MT_FORMULA_OP_DIV_K: stack[top] /= op->k; break;
+        default: return false;
+        }
+    }
+
+    /* Sıfıra bölme vb. sonuç geçersiz kanaldır */
+    if (!isfinite(stack[0])) return false;
+    *out_value = stack[0];
+    return true;
+}
+
+void hd32mt_formula_set_apply(const hd32mt_formula_set_t *set, hd32mt_record_t *record)
+{
+    if (!set || !record) return;
+
+    for (uint8_t i = 0; i < set->rule_count; ++i) {
+        const hd32mt_formula_t *formula = &set->rules[i];
+        uint8_t target = formula->target;
+        if (target >= record->capacity) continue;
+
+        // Kayıtta olmayan ara kanallar geçersiz olarak doldurulur
+        while (record->channel_count <= target) {
+            record->values[record->channel_count] = 0.0f;
+            record->valid_mask &= ~(1u << record->channel_count);
+            record->channel_count++;
+        }
+
+        float value;
+        if (hd32mt_formula_eval(formula, record->values, record->valid_mask, &value)) {
+            record->values[target] = value;
+            record->valid_mask |= 1u << target;
+        } else {
+            record->valid_mask &= ~(1u << target);
+        }
+    }
+}
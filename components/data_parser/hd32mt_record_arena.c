@@ -0,0 +1,98 @@
+#include "hd32mt_record_arena.h"
+#include "esp_log.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "RECORD_ARENA";
+
+/* Yuvalar float hizasında kalsın diye boyut 4'ün katına yuvarlanır */
+static size_t arena_slot_bytes(uint8_t channel_capacity)
+{
+    size_t bytes = HD32MT_RECORD_BYTES(channel_capacity);
+    return (bytes + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1);
+}
+
+static bool arena_allocate(hd32mt_record_arena_t *arena, uint16_t slot_count, uint8_t channel_capacity)
+{
+    size_t slot_bytes = arena_slot_bytes(channel_capacity);
+    size_t slots_total = slot_bytes * slot_count;
+    uint8_t *storage = malloc(slots_total + slot_count * sizeof(uint16_t));
+    if (!storage) {
+        ESP_LOGE(TAG, "Kayıt havuzu ayrılamadı (%u x %u bayt)",
+                 (unsigned)slot_count, (unsigned)slot_bytes);
+        return false;
+    }
+
+    free(arena->storage);
+    arena->storage          = storage;
+    arena->free_slots       = (uint16_t *)(storage + slots_total);
+    arena->slot_bytes       = slot_bytes;
+    arena->slot_count       = slot_count;
+    arena->channel_capacity = channel_capacity;
+    arena->free_count       = slot_count;
+    for (uint16_t i = 0; i < slot_count; ++i) {
+        arena->free_slots[i] = (uint16_t)(slot_count - 1 - i);
+    }
+    return true;
+}
+
+bool hd32mt_record_arena_init(hd32mt_record_arena_t *arena, uint16_t slot_count, uint8_t channel_capacity)
+{
+    if (!arena || slot_count == 0 ||
+        channel_capacity == 0 || channel_capacity > HD32MT_MAX_CHANNELS) {
+        return false;
+    }
+    memset(arena, 0, sizeof(*arena));
+    return arena_allocate(arena, slot_count, channel_capacity);
+}
+
+void hd32mt_record_arena_deinit(hd32mt_record_arena_t *arena)
+{
+    if (!arena) return;
+    free(arena->storage);
+    memset(arena, 0, sizeof(*arena));
+}
+
+hd32mt_record_t *hd32mt_record_arena_alloc(hd32mt_record_arena_t *arena)
+{
+    if (!arena || arena->free_count == 0) {
+        if (arena) arena->stats.alloc_failures++;
+        return NULL;
+    }
+    uint16_t slot = arena->free_slots[--arena->free_count];
+    arena->stats.allocs++;
+    uint16_t in_use = hd32mt_record_arena_in_use(arena);
+    if (in_use > arena->stats.peak_in_use) {
+        arena->stats.peak_in_use = in_use;
+    }
+    return hd32mt_record_init(arena->storage + (size_t)slot * arena->slot_bytes, arena->channel_capacity);
+}
+
+void hd32mt_record_arena_free(hd32mt_record_arena_t *arena, hd32mt_record_t *record)
+{
+    if (!arena || !record) return;
+
+    size_t offset = (size_t)((uint8_t *)record - arena->storage);
+    if ((uint8_t *)record < arena->storage || offset % arena->slot_bytes != 0 ||
+        offset / arena->slot_bytes >= arena->slot_count || arena->free_count >= arena->slot_count) {
+        ESP_LOGE(TAG, "Havuza ait olmayan kayıt bırakıldı");
+        return;
+    }
+    arena->free_slots[arena->free_count++] = (uint16_t)(offset / arena->slot_bytes);
+}
+
+bool hd32mt_record_arena_resize(hd32mt_record_arena_t *arena, uint8_t channel_capacity)
+{
+    if (!arena || channel_capacity == 0 || channel_capacity > HD32MT_MAX_CHANNELS) {
+        return false;
+    }
+    if (channel_capacity == arena->channel_capacity) {
+        return true;
+    }
+    if (hd32mt_record_arena_in_use(arena) != 0) {
+        ESP_LOGW(TAG, "Kullanımda kayıt var, kapasite değişmedi (%u kanal)",
+                 (unsigned)arena->channel_capacity);
+        return false;
+    }
+    return arena_allocate(arena, arena->slot_count, channel_capacity);
+}
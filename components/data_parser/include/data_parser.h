@@ -1,33 +1,126 @@
 #pragma once
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
-#define MAX_SENSORS 10
-
-
+/*
+ * Kanal sayısı şemanın (cihaz programı) çalışma zamanı özelliğidir; kayıtlar
+ * hd32mt_record_arena ile kaynağın kapasitesine göre ayrılır. Bu sınır yalnızca
+ * valid_mask genişliği ve şema tablosu içindir.
+ */
+#define HD32MT_MAX_CHANNELS 32
 
 typedef struct {
     char name[32];
     char unit[8];
 } sensor_info_t;
 
+/**
+ * Hat boyunca (parser → kuyruk → gönderici → SD) taşınan sıkıştırılmış kayıt.
+ *
+ * Yalnızca değerler ve kimlikler tutulur; kanal isim/birimleri ve metin
+ * zaman damgası kayıtta yoktur, biçimlendirme anında schema_id ile çözülür.
+ * Kanallar konumsaldır: geçersiz değer atılmaz, valid_mask biti temizlenir
+ * (kanal indeksleri kaymaz).
+ *
+ * values[] kaydın sonundadır ve capacity kadar yer vardır; kayıt kendi başına
+ * tanımlanmaz, hd32mt_record_arena_alloc (ya da HD32MT_RECORD_BYTES boyutlu
+ * bir alan + hd32mt_record_init) ile alınır.
+ */
+typedef struct {
+    uint32_t epoch;                  /* UTC saniye (kayıt başlığındaki YYMMDDhhmmss) */
+    uint32_t valid_mask;             /* bit i = values[i] geçerli */
+    uint16_t schema_id;              /* hd32mt_schema_id(), 0 = şema yok */
+    uint8_t  instrument_id;          /* Kaydı üreten kaynak (çoklu port), varsayılan 0 */
+    uint8_t  channel_count;          /* Çözülen kanal (≤ capacity) */
+    uint8_t  capacity;               /* values[] uzunluğu (≤ HD32MT_MAX_CHANNELS) */
+    uint8_t  payload_channels;       /* Payload'daki kanal; > channel_count ise kırpıldı */
+    float    values[];
+} hd32mt_record_t;
+
+#define HD32MT_RECORD_BYTES(capacity) (sizeof(hd32mt_record_t) + (size_t)(capacity) * sizeof(float))
+
+/** HD32MT_RECORD_BYTES(capacity) baytlık, float hizalı alanı boş kayıt yapar. */
+static inline hd32mt_record_t *hd32mt_record_init(void *storage, uint8_t capacity)
+{
+    hd32mt_record_t *record = (hd32mt_record_t *)storage;
+    *record = (hd32mt_record_t){ .capacity = capacity };
+    return record;
+}
+
+static inline bool hd32mt_record_channel_valid(const hd32mt_record_t *record, uint8_t channel)
+{
+    return channel < record->channel_count && (record->valid_mask & (1u << channel)) != 0;
+}
+
+/**
+ * Artımlı zaman damgası çözücü: ardışık kayıtlar genelde aynı günde olduğundan
+ * son görülen YYMMDD ve o günün epoch tabanı saklanır; aynı günde yalnızca
+ * hhmmss çözülür (takvim hesabı gün değişince bir kez yapılır).
+ * Sıfırla başlatılmış yapı geçerlidir. Kaynak (cihaz) başına bir tane tutulur.
+ */
 typedef struct {
-    char timestamp[13];              // YYMMDDhhmmss
-    float sensors[MAX_SENSORS];      // Sensör değerleri
-    const char *labels[MAX_SENSORS]; // Sensör isimleri
-    const char *units[MAX_SENSORS];  // Sensör birimleri
-    int sensor_count;
-    char timestamp_full[20];  // "2024-08-01 12:08:31"
-} hd32mt_data_t;
+    char     day[6];        /* Son YYMMDD */
+    uint32_t day_epoch;     /* O günün 00:00:00 UTC epoch'u */
+    bool     valid;
+    uint32_t day_changes;   /* Tam takvim hesabı sayısı */
+} hd32mt_timestamp_cache_t;
 
 /**
- * @brief HD32MT sensör konfigürasyonlarını (isim + birim) belleğe yükler.
+ * "YYMMDDhhmmss" → UTC epoch saniye (saat dilimi/mktime kullanılmaz).
+ * Ay uzunluğu ve artık yıl dahil doğrulanır.
+ * @param cache   NULL olabilir (her seferinde tam hesap)
+ * @return false  Rakam olmayan ya da aralık dışı alan
  */
-void parser_reset_sensor_map(void);
-void parser_add_sensor(const char *name, const char *unit);
+bool hd32mt_timestamp_decode(hd32mt_timestamp_cache_t *cache, const char *timestamp, uint32_t *out_epoch);
+
+static inline bool hd32mt_timestamp_to_epoch(const char *timestamp, uint32_t *out_epoch)
+{
+    return hd32mt_timestamp_decode(NULL, timestamp, out_epoch);
+}
+
+/**
+ * @brief Çerçeveleyiciden gelen (binary payload içerebilen) kaydı çözümler.
+ * Varsayılan profil (HD32MT.1); oturumun profili için hd32mt_profile_t.decode.
+ * @param frame  "$R0" YYMMDDhhmmss ' ' <N*4 bayt> '&'
+ * @param length Kaydın tam uzunluğu (payload '\0' içerebilir)
+ * @param cache  Kaynağın zaman damgası önbelleği (NULL olabilir)
+ * @param out    Çözülmüş kayıt (schema_id/instrument_id çağıran tarafından doldurulur).
+ *               En fazla out->capacity kanal çözülür; fazlası payload_channels'tan görülür.
+ */
+bool parse_hd32mt_frame(const char *frame, size_t length, hd32mt_timestamp_cache_t *cache,
+                        hd32mt_record_t *out);
+
+/* ------------------------------ Toplu Çözümleme ------------------------------ */
+
+/** Çerçeveleyiciden gelen bir kayıt (halka, SD taşma dosyası, indirme, replay) */
+typedef struct {
+    const char *data;
+    size_t      length;
+} hd32mt_frame_ref_t;
+
+/**
+ * Sütun düzeninde çıktı: her dizi çağıran tarafından ayrılır.
+ *   epochs[i], valid_masks[i], channel_counts[i]      i < capacity
+ *   values[ch * capacity + i]                         ch < channel_capacity
+ * Böylece bir kanalın tüm örnekleri bellekte ardışıktır.
+ */
+typedef struct {
+    size_t    capacity;
+    uint8_t   channel_capacity; /* Şemanın kanal sayısı (≤ HD32MT_MAX_CHANNELS) */
+    size_t    count;            /* Çözülen kayıt (başarısızlar atlanır) */
+    size_t    errors;           /* Çözülemeyen kayıt */
+    size_t    truncated;        /* channel_capacity'den fazla kanallı kayıt */
+    uint32_t *epochs;
+    uint32_t *valid_masks;
+    uint8_t  *channel_counts;
+    float    *values;           /* channel_capacity * capacity */
+} hd32mt_record_columns_t;
 
 /**
- * @brief Satır HD32MT formatında ise çözümler.
- * @param raw_line RS232’den gelen satır ("$R0 ...")
- * @param out Çözülmüş veri
+ * Kayıt dizisini sütunlara çözer (count'a eklenir, önce count = 0 yapılmalı).
+ * Tek kayıtlık parse_hd32mt_frame ile aynı doğrulama ve geçerlilik kuralları.
+ * @return Bu çağrıda çözülen kayıt sayısı (kapasite dolunca durur)
  */
-bool parse_hd32mt_record(const char *raw_line, hd32mt_data_t *out);
+size_t parse_hd32mt_frames(const hd32mt_frame_ref_t *frames, size_t frame_count,
+                           hd32mt_record_columns_t *out);
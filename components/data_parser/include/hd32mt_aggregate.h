@@ -0,0 +1,87 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "data_parser.h"
+
+/**
+ * Pencereli toplama: kayıtları kanal başına O(1) durumla özetler
+ * (adet, ortalama/sapma için Welford, min, max, ilk, son).
+ *
+ * Pencere kayıt zamanına (record->epoch) göre ilerler:
+ *  - align_to_clock: pencereler epoch'un window_sec katlarında başlar (12:00:00, 12:01:00 ...)
+ *  - aksi halde pencere ilk kayıtla başlar
+ * Pencere dışı (sonraki ya da saat geri gitmiş) kayıt geldiğinde çağıran
+ * önce özeti alır (hd32mt_aggregator_summary) ve pencereyi kapatır.
+ *
+ * Kanal dizisi başlangıçta kaynağın kapasitesine göre bir kez ayrılır.
+ * Kilit yoktur: tek görevde kullanılır.
+ */
+
+typedef struct {
+    uint32_t count;        /* Geçerli örnek */
+    float    mean;
+    float    m2;           /* Welford: sapma karelerinin toplamı */
+    float    min;
+    float    max;
+    float    first;
+    float    last;
+} hd32mt_channel_stats_t;
+
+typedef struct {
+    uint32_t window_sec;       /* ≥ 1 */
+    bool     align_to_clock;
+} hd32mt_aggregate_config_t;
+
+typedef struct {
+    uint32_t windows;          /* Kapatılan pencere */
+    uint32_t records;          /* Toplanan kayıt */
+    uint32_t clock_jumps;      /* Pencere başından eski kayıt (saat geri alındı) */
+} hd32mt_aggregate_stats_t;
+
+typedef struct {
+    hd32mt_aggregate_config_t config;
+    hd32mt_channel_stats_t   *channels;
+    uint8_t                   capacity;
+    uint8_t                   channel_count;   /* Pencerede görülen en geniş kayıt */
+    bool                      open;
+    uint8_t                   instrument_id;
+    uint16_t                  schema_id;
+    uint32_t                  window_start;    /* epoch */
+    uint32_t                  records;         /* Penceredeki kayıt */
+    hd32mt_aggregate_stats_t  stats;
+} hd32mt_aggregator_t;
+
+/** Kapanan pencerenin salt okunur görünümü (hd32mt_aggregator_reset'e kadar geçerli) */
+typedef struct {
+    uint32_t                      window_start;
+    uint32_t                      window_sec;
+    uint32_t                      records;
+    uint8_t                       channel_count;
+    uint8_t                       instrument_id;
+    uint16_t                      schema_id;
+    const hd32mt_channel_stats_t *channels;
+} hd32mt_window_summary_t;
+
+bool hd32mt_aggregator_init(hd32mt_aggregator_t *aggregator, const hd32mt_aggregate_config_t *config,
+                            uint8_t channel_capacity);
+
+void hd32mt_aggregator_deinit(hd32mt_aggregator_t *aggregator);
+
+/** Kayıt açık pencereye girmiyorsa true (önce özet alınıp pencere kapatılmalı). */
+bool hd32mt_aggregator_window_done(const hd32mt_aggregator_t *aggregator, uint32_t epoch);
+
+/** Kaydı açık pencereye ekler; pencere kapalıysa kaydın zamanıyla açar. */
+void hd32mt_aggregator_add(hd32mt_aggregator_t *aggregator, const hd32mt_record_t *record);
+
+/** Pencerenin sonu (epoch, hariç); pencere kapalıysa 0. */
+uint32_t hd32mt_aggregator_window_end(const hd32mt_aggregator_t *aggregator);
+
+/** @return false  Açık pencere yok */
+bool hd32mt_aggregator_summary(const hd32mt_aggregator_t *aggregator, hd32mt_window_summary_t *out);
+
+/** Pencereyi kapatır, kanal durumlarını sıfırlar. */
+void hd32mt_aggregator_reset(hd32mt_aggregator_t *aggregator);
+
+/** Örneklem standart sapması (n < 2 → 0) */
+float hd32mt_channel_stddev(const hd32mt_channel_stats_t *stats);
@@ -0,0 +1,68 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "data_parser.h"
+
+/**
+ * Kanal başına alarm kuralları; kayıt çözülür çözülmez değerlendirilir.
+ *
+ *  - Eşik: değer high'ı aşınca HIGH, low'un altına inince LOW; alarm,
+ *    değer eşiğin hysteresis kadar içine dönünce temizlenir (titreşim yok).
+ *  - Arıza: fault kuralı varsa kanal geçersizleşince (kaydedici hata kodu,
+ *    NaN, sınır dışı değer) FAULT; geçerli değer gelince eşiklere dönülür.
+ *
+ * Yalnızca durum değişimleri olay üretir. Kuralı olmayan kanallar için maliyet
+ * tek maske testidir.
+ */
+
+typedef enum {
+    HD32MT_ALARM_NORMAL = 0,
+    HD32MT_ALARM_LOW,
+    HD32MT_ALARM_HIGH,
+    HD32MT_ALARM_FAULT,
+} hd32mt_alarm_state_t;
+
+typedef struct {
+    bool  has_low;
+    bool  has_high;
+    bool  fault;          /* Geçersiz kanal alarmı */
+    float low;
+    float high;
+    float hysteresis;     /* ≥ 0 */
+} hd32mt_alarm_rule_t;
+
+typedef struct {
+    uint8_t channel;      /* 0'dan başlayan */
+    uint8_t state;        /* hd32mt_alarm_state_t (NORMAL = temizlendi) */
+    uint8_t previous;
+    float   value;        /* FAULT'ta anlamsız */
+    float   threshold;    /* Aşılan/temizlenen eşik */
+} hd32mt_alarm_event_t;
+
+typedef struct {
+    uint32_t evaluated;   /* Kural içeren kayıt */
+    uint32_t raised;
+    uint32_t cleared;
+} hd32mt_alarm_stats_t;
+
+typedef struct {
+    hd32mt_alarm_rule_t rules[HD32MT_MAX_CHANNELS];
+    uint8_t             states[HD32MT_MAX_CHANNELS];
+    uint32_t            rule_mask;      /* Kuralı olan kanallar */
+    hd32mt_alarm_stats_t stats;
+} hd32mt_alarm_set_t;
+
+void hd32mt_alarm_set_init(hd32mt_alarm_set_t *set);
+
+/** Kanal kuralı; rule NULL ise kural kaldırılır (durum sıfırlanır). */
+bool hd32mt_alarm_set_rule(hd32mt_alarm_set_t *set, uint8_t channel, const hd32mt_alarm_rule_t *rule);
+
+/**
+ * Kaydı kurallara göre değerlendirir.
+ * @return  events'e yazılan durum değişimi (en fazla max_events; fazlası bir sonraki kayıtta)
+ */
+size_t hd32mt_alarm_evaluate(hd32mt_alarm_set_t *set, const hd32mt_record_t *record,
+                             hd32mt_alarm_event_t *events, size_t max_events);
+
+const char *hd32mt_alarm_state_name(uint8_t state);
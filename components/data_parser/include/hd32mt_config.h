@@ -0,0 +1,97 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "data_parser.h"
+
+/*
+ * HD32MT konfigürasyon bloğu (bağlantıda cihazın gönderdiği program):
+ *
+ *   #const a=pyraustham,Current Loop 4-20mA,BIP1     değişken → isim
+ *   #unit a=w/m2                                     değişken → birim
+ *   c=(b/a)                                          türetilmiş değişken (formül)
+ *   [DLType:HD32MT.1]
+ *   [Sensors] ...
+ *   [Table1]                                         kaydedilen kanallar (sıralı)
+ *   1,2,0,0
+ *   Current Loop 4-20mA,b,Albedo,w/m2,SampleAvg,0/0/0
+ *   {
+ *   [scarta],
+ *   A8D0DDAB603A2561674840CDC96E2AD333FFA6E6,        parmak izi (40 hex)
+ *   }
+ *
+ * Blok "&NNNN" numaralı paketlerle gelir; paket sonundaki 2 baytlık sağlama
+ * atılır ve bölünen satır birleştirilir.
+ */
+
+#define HD32MT_FINGERPRINT_LEN          40
+#define HD32MT_DLTYPE_MAX_LEN           24
+#define HD32MT_CONFIG_MAX_VARIABLES     HD32MT_MAX_CHANNELS
+#define HD32MT_CONFIG_MAX_LINE_BYTES    256
+#define HD32MT_CONFIG_MAX_FORMULA_BYTES 256   /* '\n' ayrılmış "x=<ifade>" satırları */
+
+/** Kanal isim/birim şeması (sensor_map'in cihaz başına karşılığı) */
+typedef struct {
+    char          fingerprint[HD32MT_FINGERPRINT_LEN + 1];
+    char          dl_type[HD32MT_DLTYPE_MAX_LEN];   /* "HD32MT.1" */
+    uint8_t       sensor_count;
+    sensor_info_t sensors[HD32MT_MAX_CHANNELS];
+    char          variables[HD32MT_MAX_CHANNELS];        /* Kanalın program değişkeni, '\0' = bilinmiyor */
+    char          formulas[HD32MT_CONFIG_MAX_FORMULA_BYTES];  /* bkz. hd32mt_formula */
+} hd32mt_schema_t;
+
+typedef enum {
+    HD32MT_CONFIG_SECTION_NONE = 0,
+    HD32MT_CONFIG_SECTION_PROGRAM,       /* #const / #unit / formüller */
+    HD32MT_CONFIG_SECTION_SENSORS,
+    HD32MT_CONFIG_SECTION_TABLE,
+    HD32MT_CONFIG_SECTION_FINGERPRINT,
+    HD32MT_CONFIG_SECTION_OTHER,
+} hd32mt_config_section_t;
+
+typedef struct {
+    char name[sizeof(((sensor_info_t *)0)->name)];
+    char unit[sizeof(((sensor_info_t *)0)->unit)];
+    char variable;
+} hd32mt_config_variable_t;
+
+typedef struct {
+    bool                      active;          /* Blok toplanıyor */
+    hd32mt_config_section_t   section;
+    bool                      table_header_seen;
+    hd32mt_schema_t           schema;          /* Oluşturulan şema */
+
+    hd32mt_config_variable_t  variables[HD32MT_CONFIG_MAX_VARIABLES];
+    uint8_t                   variable_count;
+
+    /* Paket sınırında bölünen satırı birleştirmek için bir satır geride durulur */
+    char                      held_line[HD32MT_CONFIG_MAX_LINE_BYTES];
+    size_t                    held_length;
+    bool                      join_next;
+} hd32mt_config_parser_t;
+
+void hd32mt_config_init(hd32mt_config_parser_t *parser);
+
+/**
+ * Çerçeveleyiciden gelen metin satırını işler.
+ * @return true  Blok tamamlandı, out_schema dolduruldu
+ */
+bool hd32mt_config_feed_line(hd32mt_config_parser_t *parser, const char *line, size_t length,
+                             hd32mt_schema_t *out_schema);
+
+/**
+ * Kayıtlarda taşınan kısa şema kimliği (hd32mt_record_t.schema_id).
+ * Şema içeriğinden türetilir, asla 0 değildir; boş şema için 0.
+ */
+uint16_t hd32mt_schema_id(const hd32mt_schema_t *schema);
+
+/* ------------------------------ NVS Önbelleği ------------------------------ */
+
+/** Cihazın son şemasını NVS'ten yükler (yeniden başlatmada öğrenmeyi atlar). */
+bool hd32mt_schema_load(uint8_t instrument_id, hd32mt_schema_t *out_schema);
+
+/**
+ * Şemayı parmak izi anahtarıyla saklar ve cihazın güncel şeması yapar.
+ * Aynı parmak izi zaten kayıtlıysa flash'a tekrar yazılmaz.
+ */
+bool hd32mt_schema_store(uint8_t instrument_id, const hd32mt_schema_t *schema);
@@ -0,0 +1,56 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "data_parser.h"
+
+/**
+ * İstisna ile raporlama (deadband): kanal yalnızca son gönderilen değerinden
+ * bant kadar uzaklaşınca ya da heartbeat_sec boyunca sessiz kaldıysa raporlanır.
+ *
+ * Bant = max(absolute, percent/100 * |son gönderilen|); ikisi de 0 ise her
+ * değişiklik raporlanır. Geçersiz kanal raporlanmaz, son değeri korunur.
+ *
+ * Kanal dizileri başlangıçta kaynağın kapasitesine göre bir kez ayrılır.
+ * Kilit yoktur: tek görevde kullanılır (bant yazımı 32 bitlik float, yırtılmaz).
+ */
+
+typedef struct {
+    float absolute;    /* Birim cinsinden, 0 = yok */
+    float percent;     /* Son gönderilen değerin yüzdesi, 0 = yok */
+} hd32mt_deadband_t;
+
+typedef struct {
+    uint32_t records;      /* Süzgeçten geçen kayıt */
+    uint32_t suppressed;   /* Hiç kanalı raporlanmayan (satır gitmeyen) kayıt */
+    uint32_t channels;     /* Süzgeçten geçen geçerli kanal */
+    uint32_t reported;     /* Raporlanan kanal */
+    uint32_t heartbeats;   /* Yalnızca sessizlik süresi dolduğu için raporlanan kanal */
+} hd32mt_deadband_stats_t;
+
+typedef struct {
+    hd32mt_deadband_t *bands;
+    float             *last;         /* Son gönderilen değer */
+    uint32_t          *last_epoch;   /* Son gönderim zamanı */
+    uint32_t           reported_mask;   /* Son değeri bilinen kanallar */
+    uint8_t            capacity;
+    uint32_t           heartbeat_sec;   /* 0 = heartbeat yok */
+    hd32mt_deadband_stats_t stats;
+} hd32mt_deadband_filter_t;
+
+bool hd32mt_deadband_init(hd32mt_deadband_filter_t *filter, uint8_t channel_capacity,
+                          const hd32mt_deadband_t *default_band, uint32_t heartbeat_sec);
+
+void hd32mt_deadband_deinit(hd32mt_deadband_filter_t *filter);
+
+/** Tek kanalın bandı; channel kapasite dışındaysa false */
+bool hd32mt_deadband_set(hd32mt_deadband_filter_t *filter, uint8_t channel, const hd32mt_deadband_t *band);
+
+/**
+ * Raporlanacak kanalları seçer ve gönderilmiş sayar (son değer/zaman güncellenir).
+ * @return  Raporlanacak kanal maskesi (0 = kayıt bastırıldı)
+ */
+uint32_t hd32mt_deadband_apply(hd32mt_deadband_filter_t *filter, const hd32mt_record_t *record);
+
+/** Son gönderilenleri unutur (gönderim başarısız, şema değişti): sonraki kayıt tam raporlanır */
+void hd32mt_deadband_invalidate(hd32mt_deadband_filter_t *filter);
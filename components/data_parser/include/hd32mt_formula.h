@@ -0,0 +1,83 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "data_parser.h"
+
+/**
+ * Türetilmiş kanal formülleri (konfigürasyon bloğundaki "c=(b/a)" satırları).
+ *
+ * Formül bir kez, bağlantıda derlenir: metin → düz işlem dizisi (yığın makinesi).
+ * Kayıt başına yalnızca dizi yürütülür; ayrıştırma ve bellek ayırma yoktur.
+ *
+ * Dilbilgisi:  ifade := terim (('+'|'-') terim)*
+ *              terim := tekli (('*'|'/') tekli)*
+ *              tekli := '-' tekli | sayı | değişken | '(' ifade ')'
+ * Değişkenler HD32MT program değişkenleridir ('a'..'z'); kanal karşılıkları
+ * şemadan gelir. Sabitler derlemede katlanır, sağ işlenen sabitse işlem
+ * anlık değerli (ör. x*k+o → LOAD, MUL_K, ADD_K) üretilir.
+ */
+
+#define HD32MT_FORMULA_MAX_OPS      16
+#define HD32MT_FORMULA_MAX_DEPTH    8
+#define HD32MT_FORMULA_MAX_RULES    16
+
+typedef enum {
+    HD32MT_FORMULA_OP_LOAD = 0,     /* push values[channel] */
+    HD32MT_FORMULA_OP_CONST,        /* push k */
+    HD32MT_FORMULA_OP_ADD,
+    HD32MT_FORMULA_OP_SUB,
+    HD32MT_FORMULA_OP_MUL,
+    HD32MT_FORMULA_OP_DIV,
+    HD32MT_FORMULA_OP_NEG,
+    HD32MT_FORMULA_OP_ADD_K,        /* tepe + k */
+    HD32MT_FORMULA_OP_SUB_K,
+    HD32MT_FORMULA_OP_MUL_K,
+    HD32MT_FORMULA_OP_DIV_K,
+} hd32mt_formula_opcode_t;
+
+typedef struct {
+    uint8_t opcode;
+    uint8_t channel;
+    float   k;
+} hd32mt_formula_op_t;
+
+typedef struct {
+    hd32mt_formula_op_t ops[HD32MT_FORMULA_MAX_OPS];
+    uint8_t             op_count;
+    uint8_t             target;         /* Sonucun yazıldığı kanal */
+    uint32_t            input_mask;     /* Okunan kanallar: hepsi geçerliyse sonuç geçerli */
+} hd32mt_formula_t;
+
+/** Bir kaynağın formülleri; sıra önemlidir (türetilmiş kanal sonrakilerde kullanılabilir). */
+typedef struct {
+    hd32mt_formula_t rules[HD32MT_FORMULA_MAX_RULES];
+    uint8_t          rule_count;
+    char             variables[HD32MT_MAX_CHANNELS];   /* kanal i → değişken */
+    uint8_t          recorded_channels;                /* Cihazın kaydettiği kanal */
+    uint8_t          channel_count;                    /* + türetilmiş kanallar */
+} hd32mt_formula_set_t;
+
+/**
+ * @param variables  Kaydedilen kanalların değişkenleri (kanal sırasıyla, '\0' = yok)
+ */
+void hd32mt_formula_set_init(hd32mt_formula_set_t *set, const char *variables, uint8_t channel_count);
+
+/**
+ * "x=<ifade>" satırını derleyip ekler. x kaydedilen bir kanal değilse yeni
+ * (türetilmiş) kanal olarak kanalların sonuna eklenir.
+ * @param derived_only  true: hedefi kaydedilen kanal olan satır atlanır
+ *                      (cihaz onu zaten hesaplamıştır)
+ * @return false        Sözdizimi hatası, bilinmeyen değişken/işlev ya da yer yok
+ */
+bool hd32mt_formula_set_add(hd32mt_formula_set_t *set, const char *line, size_t length, bool derived_only);
+
+/** Tek formül: values/valid_mask üzerinden; sonuç sonlu ve girdiler geçerliyse true. */
+bool hd32mt_formula_eval(const hd32mt_formula_t *formula, const float *values, uint32_t valid_mask,
+                         float *out_value);
+
+/**
+ * Tüm formülleri kayda uygular (record->capacity içinde kalan hedefler).
+ * Türetilmiş kanallar channel_count'u büyütür.
+ */
+void hd32mt_formula_set_apply(const hd32mt_formula_set_t *set, hd32mt_record_t *record);
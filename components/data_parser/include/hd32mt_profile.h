@@ -0,0 +1,98 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "data_parser.h"
+
+/**
+ * Delta OHM kaydedici profilleri.
+ *
+ * Her model bir satırla tanımlanır; HD32MT_PROFILE_LIST derlemede genişletilir
+ * ve her profil için sabitleri gömülü ayrı bir çözücü üretilir (çalışma anında
+ * profil yorumlanmaz). Oturumdaki profil, konfigürasyon bloğundaki
+ * "[DLType:...]" satırından seçilir (hd32mt_profile_find).
+ *
+ * Ortak çerçeve (çerçeveleyicinin normalize ettiği biçim):
+ *   <önek> <tip> <bayrak> <12 haneli zaman> ' ' <N x 4 bayt> <sonlandırıcı>
+ * Çerçeveleyici (serial_if_set_profile) ve çözücü aynı sabitleri kullanır.
+ *
+ * X(kimlik, DLType, önek, tip1, tip2, bayrak, ilk kayıt bayrağı,
+ *   zaman düzeni, kodlama, kanal sayısı, sonlandırıcı)
+ *   bayrak        sıradan kayıt; ilk kayıt bayrağı bellek dökümünün ilk kaydı ("$R1")
+ *   zaman düzeni  HD32MT_TIMESTAMP_YYMMDD / HD32MT_TIMESTAMP_DDMMYY (+ hhmmss)
+ *   kodlama       HD32MT_ENCODING_F32_BE / HD32MT_ENCODING_F32_LE
+ *   kanal sayısı  0 = kayıt uzunluğundan, aksi halde tam bu kadar olmalı
+ */
+#define HD32MT_PROFILE_LIST(X) \
+    X(HD32MT_1, "HD32MT.1", '$', 'R', 'A', '0', '1', HD32MT_TIMESTAMP_YYMMDD, HD32MT_ENCODING_F32_BE, 0, '&') \
+    HD32MT_PROFILE_TEST_LIST(X)
+
+/*
+ * Yalnızca host testleri (HD32MT_PROFILE_TEST_ENTRIES): varsayılandan her sabiti
+ * farklı bir profil; çerçeveleyici ve çözücünün sabitleri profilden aldığını sınar.
+ */
+#ifdef HD32MT_PROFILE_TEST_ENTRIES
+#define HD32MT_PROFILE_TEST_LIST(X) \
+    X(TEST_LE, "TEST.LE", '#', 'M', 'N', '5', '6', HD32MT_TIMESTAMP_DDMMYY, HD32MT_ENCODING_F32_LE, 3, '%')
+#else
+#define HD32MT_PROFILE_TEST_LIST(X)
+#endif
+
+/* Tanımlı DLType yoksa (eski şema, harici kaynak) kullanılan profil */
+#define HD32MT_PROFILE_DEFAULT  HD32MT_PROFILE_HD32MT_1
+
+typedef enum {
+    HD32MT_TIMESTAMP_YYMMDD = 0,
+    HD32MT_TIMESTAMP_DDMMYY,
+} hd32mt_timestamp_layout_t;
+
+typedef enum {
+    HD32MT_ENCODING_F32_BE = 0,
+    HD32MT_ENCODING_F32_LE,
+} hd32mt_payload_encoding_t;
+
+#define HD32MT_PROFILE_ENUM_ENTRY(id, ...) HD32MT_PROFILE_##id,
+typedef enum {
+    HD32MT_PROFILE_LIST(HD32MT_PROFILE_ENUM_ENTRY)
+    HD32MT_PROFILE_COUNT
+} hd32mt_profile_id_t;
+#undef HD32MT_PROFILE_ENUM_ENTRY
+
+typedef bool (*hd32mt_frame_decoder_t)(const char *frame, size_t length,
+                                       hd32mt_timestamp_cache_t *cache, hd32mt_record_t *out);
+typedef size_t (*hd32mt_batch_decoder_t)(const hd32mt_frame_ref_t *frames, size_t frame_count,
+                                         hd32mt_record_columns_t *out);
+
+/* Hat üzerindeki kayıt sınırları: çerçeveleyicinin profilden aldığı kısım */
+typedef struct {
+    char    prefix;              /* '$' */
+    char    record_types[2];     /* "$R0" / "$A0" → 'R', 'A' */
+    char    record_flags[2];     /* '0' sıradan, '1' döküm ilk kaydı */
+    char    terminator;          /* '&' */
+    uint8_t channel_count;       /* 0 = kayıt uzunluğundan */
+} hd32mt_frame_format_t;
+
+typedef struct {
+    hd32mt_profile_id_t       id;
+    const char               *dl_type;
+    hd32mt_frame_format_t     frame;
+    hd32mt_timestamp_layout_t layout;
+    hd32mt_payload_encoding_t encoding;
+    hd32mt_frame_decoder_t    decode;         /* parse_hd32mt_frame ile aynı sözleşme */
+    hd32mt_batch_decoder_t    decode_batch;   /* parse_hd32mt_frames ile aynı sözleşme */
+} hd32mt_profile_t;
+
+const hd32mt_profile_t *hd32mt_profile_get(hd32mt_profile_id_t id);
+
+/** DLType ("HD32MT.1") → profil; bilinmiyorsa NULL. */
+const hd32mt_profile_t *hd32mt_profile_find(const char *dl_type);
+
+/** Satır bu profilin veri kaydı mı (yalnızca başlık karakterleri) */
+static inline bool hd32mt_profile_is_data_record(const hd32mt_profile_t *profile,
+                                                 const char *line, size_t length)
+{
+    const hd32mt_frame_format_t *frame = &profile->frame;
+    return length >= 3 && line[0] == frame->prefix &&
+           (line[1] == frame->record_types[0] || line[1] == frame->record_types[1]) &&
+           (line[2] == frame->record_flags[0] || line[2] == frame->record_flags[1]);
+}
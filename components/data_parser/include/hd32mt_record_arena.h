@@ -0,0 +1,57 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "data_parser.h"
+
+/**
+ * Hat (kaynak) başına kayıt havuzu.
+ *
+ * - Başlangıçta tek bir blok ayrılır: slot_count adet HD32MT_RECORD_BYTES(channel_capacity)
+ *   baytlık yuva + boş yuva yığını. Kayıt başına malloc yoktur.
+ * - Kapasite kaynağın şemasından gelir; 4 kanallı kurulum 10 kanallık yer ayırmaz.
+ * - Şema değişince hd32mt_record_arena_resize ile yeniden boyutlanır
+ *   (yalnızca tüm yuvalar boşken).
+ *
+ * Kilit yoktur: havuz tek görevde (hattın tüketicisi) kullanılır.
+ */
+
+typedef struct {
+    uint32_t allocs;
+    uint32_t alloc_failures;    /* Tüm yuvalar doluyken istenen */
+    uint16_t peak_in_use;
+} hd32mt_record_arena_stats_t;
+
+typedef struct {
+    uint8_t  *storage;           /* Yuvalar + boş yuva yığını (tek blok) */
+    uint16_t *free_slots;
+    size_t    slot_bytes;
+    uint16_t  slot_count;
+    uint16_t  free_count;
+    uint8_t   channel_capacity;
+    hd32mt_record_arena_stats_t stats;
+} hd32mt_record_arena_t;
+
+/**
+ * @param slot_count        Aynı anda elde tutulabilecek kayıt
+ * @param channel_capacity  1..HD32MT_MAX_CHANNELS
+ */
+bool hd32mt_record_arena_init(hd32mt_record_arena_t *arena, uint16_t slot_count, uint8_t channel_capacity);
+
+void hd32mt_record_arena_deinit(hd32mt_record_arena_t *arena);
+
+/** Boş kayıt (capacity = channel_capacity); yuva yoksa NULL. */
+hd32mt_record_t *hd32mt_record_arena_alloc(hd32mt_record_arena_t *arena);
+
+void hd32mt_record_arena_free(hd32mt_record_arena_t *arena, hd32mt_record_t *record);
+
+/**
+ * Kanal kapasitesini değiştirir (blok yeniden ayrılır).
+ * @return false  Kullanımda kayıt var ya da bellek yok (eski kapasite geçerli kalır)
+ */
+bool hd32mt_record_arena_resize(hd32mt_record_arena_t *arena, uint8_t channel_capacity);
+
+static inline uint16_t hd32mt_record_arena_in_use(const hd32mt_record_arena_t *arena)
+{
+    return (uint16_t)(arena->slot_count - arena->free_count);
+}
@@ -0,0 +1,241 @@
+#include "alarm_sender.h"
+#include "data_sender.h"
+#include "data_frame.h"
+#include "net_manager.h"
+#include "storage_spiffs.h"
+#include "time_if.h"
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "lwip/sockets.h"
+
+#define ALARM_SENDER_TASK_NAME         "alarm_sender"
+#define ALARM_SENDER_TASK_STACK_BYTES  4096
+#define ALARM_SENDER_TASK_PRIORITY     7      /* telemetry_task (5) ve net_manager (5) üstünde */
+#define ALARM_SENDER_QUEUE_LENGTH      8
+#define ALARM_SENDER_MAX_EVENTS        8      /* Satır başına olay; fazlası sonraki kayıtta */
+#define ALARM_SENDER_CHECK_MS          1000   /* Isıtılmış bağlantının denetim aralığı */
+#define ALARM_SENDER_MAX_LINE_BYTES \
+    (96 + ALARM_SENDER_MAX_EVENTS * (16 + 2 * (DATA_FRAME_MAX_VALUE_CHARS + 1)))
+
+static const char *TAG = "ALARM_SENDER";
+
+typedef struct {
+    int64_t              detected_us;
+    uint32_t             epoch;
+    uint8_t              instrument_id;
+    uint8_t              event_count;
+    hd32mt_alarm_event_t events[ALARM_SENDER_MAX_EVENTS];
+} alarm_item_t;
+
+typedef struct {
+    alarm_sender_config_t config;
+    QueueHandle_t         queue;
+    int                   warm_sock;        /* -1 = yok */
+    int64_t               warm_since_us;
+    int64_t               next_prewarm_us;  /* Başarısız ısıtmadan sonra bekleme */
+    alarm_sender_stats_t  stats;
+    char                  frame[ALARM_SENDER_MAX_LINE_BYTES];
+} alarm_sender_t;
+
+static alarm_sender_t s_alarm = { .warm_sock = -1 };
+static atomic_bool    s_running = false;
+
+/* ------------------------------ Isıtılmış bağlantı ------------------------------ */
+
+static void alarm_sender_drop_warm(alarm_sender_t *as)
+{
+    if (as->warm_sock >= 0) {
+        close(as->warm_sock);
+        as->warm_sock = -1;
+    }
+}
+
+/* Sunucu boştaki bağlantıyı kapatmış mı (okunacak veri yoksa canlı sayılır) */
+static bool alarm_sender_warm_alive(int sock)
+{
+    char probe;
+    int rcv = recv(sock, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (rcv == 0) return false;
+    if (rcv < 0) return errno == EAGAIN || errno == EWOULDBLOCK;
+    return true;
+}
+
+static void alarm_sender_prewarm(alarm_sender_t *as)
+{
+    int64_t now_us = esp_timer_get_time();
+
+    // 1️⃣ Eskimiş ya da karşı tarafın kapattığı bağlantı bırakılır
+    if (as->warm_sock >= 0) {
+        if (now_us - as->warm_since_us < (int64_t)as->config.prewarm_max_age_ms * 1000 &&
+            alarm_sender_warm_alive(as->warm_sock)) {
+            return;
+        }
+        alarm_sender_drop_warm(as);
+    }
+
+    // 2️⃣ Ağ yoksa ya da son deneme yeni başarısız olduysa bekle
+    if (!net_manager_is_connected() || now_us < as->next_prewarm_us) {
+        return;
+    }
+    as->warm_sock = data_sender_connect();
+    if (as->warm_sock < 0) {
+        as->stats.prewarm_failures++;
+        as->next_prewarm_us = now_us + (int64_t)as->config.retry_interval_ms * 1000;
+        return;
+    }
+    as->warm_since_us = esp_timer_get_time();
+}
+
+/* ------------------------------ Teslim ------------------------------ */
+
+static void alarm_sender_deliver(alarm_sender_t *as, const alarm_item_t *item)
+{
+    char timestamp[DATA_FRAME_TIMESTAMP_BYTES];
+    if (item->epoch != 0) {
+        data_frame_format_epoch(item->epoch, timestamp, sizeof(timestamp));
+    } else {
+        time_if_get_formatted_timestamp(timestamp, sizeof(timestamp));
+    }
+    size_t length = data_frame_build_alarm(item->instrument_id, timestamp,
+                                           item->events, item->event_count,
+                                           as->frame, sizeof(as->frame));
+    if (length == 0) {
+        ESP_LOGE(TAG, "Alarm satırı oluşturulamadı");
+        as->stats.failed++;
+        return;
+    }
+
+    // 1️⃣ Hazır bağlantı; karşı taraf kapatmışsa bir kez taze bağlantıyla
+    int sock = as->warm_sock;
+    bool warm = sock >= 0;
+    as->warm_sock = -1;
+    bool ok = false;
+    if (warm) {
+        ok = data_sender_exchange(sock, as->frame, length);
+    }
+    if (!ok) {
+        sock = data_sender_connect();
+        ok = sock >= 0 && data_sender_exchange(sock, as->frame, length);
+        warm = false;
+    }
+
+    // 2️⃣ Süre: algılamadan sunucu yanıtına
+    uint32_t latency_ms = (uint32_t)((esp_timer_get_time() - item->detected_us) / 1000);
+    if (ok) {
+        as->stats.sent++;
+        as->stats.warm_hits += warm;
+        as->stats.last_latency_ms   = latency_ms;
+        as->stats.total_latency_ms += latency_ms;
+        if (latency_ms > as->stats.max_latency_ms) {
+            as->stats.max_latency_ms = latency_ms;
+        }
+    } else {
+        as->stats.failed++;
+        ESP_LOGE(TAG, "[%u] Alarm gönderilemedi", (unsigned)item->instrument_id);
+    }
+    if (ok && latency_ms > as->config.budget_ms) {
+        as->stats.over_budget++;
+        ESP_LOGW(TAG, "[%u] Alarm bütçeyi aştı: %u ms > %u ms (%s bağlantı)",
+                 (unsigned)item->instrument_id, (unsigned)latency_ms,
+                 (unsigned)as->config.budget_ms, warm ? "hazır" : "yeni");
+    } else {
+        ESP_LOGI(TAG, "[%u] Alarm (%u olay) %u ms", (unsigned)item->instrument_id,
+                 (unsigned)item->event_count, (unsigned)latency_ms);
+    }
+
+    // 3️⃣ Kritik yol dışında: SD
+    storage_write_frame(as->frame);
+}
+
+static void alarm_sender_task(void *param)
+{
+    alarm_sender_t *as = param;
+    alarm_item_t item;
+
+    for (;;) {
+        alarm_sender_prewarm(as);
+        if (xQueueReceive(as->queue, &item, pdMS_TO_TICKS(ALARM_SENDER_CHECK_MS)) == pdTRUE) {
+            alarm_sender_deliver(as, &item);
+        }
+    }
+}
+
+/* ------------------------------ Dışarıya Açık API ------------------------------ */
+
+bool alarm_sender_start(const alarm_sender_config_t *config)
+{
+    bool expected = false;
+    if (!atomic_compare_exchange_strong(&s_running, &expected, true)) {
+        return true;
+    }
+
+    const alarm_sender_config_t default_config = ALARM_SENDER_DEFAULT_CONFIG();
+    alarm_sender_t *as = &s_alarm;
+    as->config    = config ? *config : default_config;
+    as->warm_sock = -1;
+    as->queue     = xQueueCreate(ALARM_SENDER_QUEUE_LENGTH, sizeof(alarm_item_t));
+    if (!as->queue) {
+        ESP_LOGE(TAG, "Alarm kuyruğu oluşturulamadı");
+        atomic_store(&s_running, false);
+        return false;
+    }
+
+    BaseType_t ok = xTaskCreate(alarm_sender_task,
+                                ALARM_SENDER_TASK_NAME,
+                                ALARM_SENDER_TASK_STACK_BYTES,
+                                as,
+                                ALARM_SENDER_TASK_PRIORITY,
+                                NULL);
+    if (ok != pdPASS) {
+        ESP_LOGE(TAG, "Alarm görevi oluşturulamadı");
+        vQueueDelete(as->queue);
+        as->queue = NULL;
+        atomic_store(&s_running, false);
+        return false;
+    }
+    ESP_LOGI(TAG, "Alarm hattı başlatıldı (bütçe %u ms)", (unsigned)as->config.budget_ms);
+    return true;
+}
+
+bool alarm_sender_is_running(void)
+{
+    return atomic_load(&s_running) && s_alarm.queue;
+}
+
+bool alarm_sender_post(uint8_t instrument_id, uint32_t epoch,
+                       const hd32mt_alarm_event_t *events, size_t event_count)
+{
+    if (!events || event_count == 0 || !alarm_sender_is_running()) {
+        return false;
+    }
+
+    alarm_item_t item = {
+        .detected_us   = esp_timer_get_time(),
+        .epoch         = epoch,
+        .instrument_id = instrument_id,
+        .event_count   = (uint8_t)(event_count < ALARM_SENDER_MAX_EVENTS ? event_count : ALARM_SENDER_MAX_EVENTS),
+    };
+    memcpy(item.events, events, item.event_count * sizeof(item.events[0]));
+
+    if (xQueueSend(s_alarm.queue, &item, 0) != pdTRUE) {
+        s_alarm.stats.dropped++;
+        return false;
+    }
+    s_alarm.stats.posted++;
+    return true;
+}
+
+void alarm_sender_get_stats(alarm_sender_stats_t *out_stats)
+{
+    if (out_stats) {
+        *out_stats = s_alarm.stats;
+    }
+}
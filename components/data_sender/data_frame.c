@@ -0,0 +1,324 @@
+#include "data_frame.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* Bu sınırın altında değer tamsayı kuruşla yazılır, üstünde snprintf */
+#define DATA_FRAME_FIXED2_LIMIT   1e15
+
+/* ==========================================================
+ * 1️⃣ ALANLAR
+ * ========================================================== */
+
+/* "$<device_id>$" ya da çoklu cihazda "$<device_id>:<instrument_id>$" */
+static int data_frame_format_device_id(uint8_t instrument_id, char *out, size_t out_cap)
+{
+    const char *manual_device_id = "00-08-DC-20-00-59";
+    if (instrument_id != 0) {
+        // Çoklu cihaz: ikinci/üçüncü HD32MT "<device_id>:<instrument_id>" ile ayrılır
+        return snprintf(out, out_cap, "$%s:%u$",
+                        manual_device_id, //cfg->device_id,
+                        (unsigned)instrument_id);
+    }
+    return snprintf(out, out_cap, "$%s$",
+                    manual_device_id); //cfg->device_id
+}
+
+void data_frame_format_epoch(uint32_t epoch, char *out, size_t out_cap)
+{
+    time_t seconds = (time_t)epoch;
+    struct tm civil;
+    gmtime_r(&seconds, &civil);
+    snprintf(out, out_cap, "%02d/%02d/%02d-%02d:%02d:%02d",
+             civil.tm_mday, civil.tm_mon + 1, civil.tm_year % 100,
+             civil.tm_hour, civil.tm_min, civil.tm_sec);
+}
+
+size_t data_frame_format_fixed2(float value, char *out)
+{
+    /* float * 100 double'da tamdır (24 + 7 bit): yuvarlama printf'teki gibi kesin değerden */
+    double scaled = (double)value * 100.0;
+    if (!(fabs(scaled) < DATA_FRAME_FIXED2_LIMIT)) {
+        int written = snprintf(out, DATA_FRAME_MAX_VALUE_CHARS, "%.2f", value);
+        return written > 0 ? (size_t)written : 0;
+    }
+
+    char *p = out;
+    if (signbit(value)) *p++ = '-';   /* printf gibi: -0.001 → "-0.00" */
+
+    uint64_t cents = (uint64_t)nearbyint(fabs(scaled));
+    uint64_t whole = cents / 100;
+    unsigned fraction = (unsigned)(cents % 100);
+
+    char digits[20];
+    int count = 0;
+    do {
+        digits[count++] = (char)('0' + whole % 10);
+        whole /= 10;
+    } while (whole);
+    while (count) *p++ = digits[--count];
+
+    *p++ = '.';
+    *p++ = (char)('0' + fraction / 10);
+    *p++ = (char)('0' + fraction % 10);
+    return (size_t)(p - out);
+}
+
+/* ==========================================================
+ * 2️⃣ SATIRLAR
+ * ========================================================== */
+
+size_t data_frame_build(const hd32mt_record_t *record, int total_channels, const char *timestamp,
+                        char *out, size_t out_cap)
+{
+    if (!record || !timestamp || !out || out_cap == 0) return 0;
+
+    size_t offset = 0;
+    int written = data_frame_format_device_id(record->instrument_id, out, out_cap);
+    if (written < 0 || (size_t)written >= out_cap)
+        return 0;
+    offset += written;
+
+    written = snprintf(out + offset, out_cap - offset, "%s$%d$", timestamp, total_channels);
+    if (written < 0 || (size_t)written >= out_cap - offset)
+        return 0;
+    offset += written;
+
+    /* Kanal başına snprintf yok: değer + '$', sonda "\r\n\0" için yer kalmalı */
+    char value[DATA_FRAME_MAX_VALUE_CHARS];
+    for (int i = 0; i < total_channels; ++i) {
+        size_t length = 0;
+        if (i >= record->channel_count) {
+            length = data_frame_format_fixed2(0.0f, value);
+        } else if (hd32mt_record_channel_valid(record, (uint8_t)i)) {
+            length = data_frame_format_fixed2(record->values[i], value);
+        }
+        // Geçersiz kanal yerinde boş kalır: sonraki kanallar kaymaz
+        if (offset + length + 1 + 3 > out_cap)
+            return 0;
+        memcpy(out + offset, value, length);
+        offset += length;
+        out[offset++] = '$';
+    }
+
+    if (offset + 3 > out_cap)
+        return 0;
+    memcpy(out + offset, "\r\n", 3);
+    return offset + 2;
+}
+
+size_t data_frame_build_changes(const hd32mt_record_t *record, uint32_t channel_mask, int total_channels,
+                                const char *timestamp, char *out, size_t out_cap)
+{
+    if (!record || !timestamp || !out || out_cap == 0) return 0;
+
+    uint8_t channels = record->channel_count;
+    if (channels < 32) {
+        channel_mask &= (1u << channels) - 1u;
+    }
+
+    size_t offset = 0;
+    int written = data_frame_format_device_id(record->instrument_id, out, out_cap);
+    if (written < 0 || (size_t)written >= out_cap)
+        return 0;
+    offset += written;
+
+    written = snprintf(out + offset, out_cap - offset, "DELTA$%s$%d$%d$",
+                       timestamp, total_channels, __builtin_popcount(channel_mask));
+    if (written < 0 || (size_t)written >= out_cap - offset)
+        return 0;
+    offset += written;
+
+    while (channel_mask) {
+        unsigned i = (unsigned)__builtin_ctz(channel_mask);
+        channel_mask &= channel_mask - 1u;
+
+        // "<no>|<değer>$": no en fazla 2 hane
+        if (offset + 3 + DATA_FRAME_MAX_VALUE_CHARS + 1 + 3 > out_cap)
+            return 0;
+        unsigned number = i + 1;
+        if (number >= 10) out[offset++] = (char)('0' + number / 10);
+        out[offset++] = (char)('0' + number % 10);
+        out[offset++] = '|';
+        offset += data_frame_format_fixed2(record->values[i], out + offset);
+        out[offset++] = '$';
+    }
+
+    if (offset + 3 > out_cap)
+        return 0;
+    memcpy(out + offset, "\r\n", 3);
+    return offset + 2;
+}
+
+size_t data_frame_build_alarm(uint8_t instrument_id, const char *timestamp,
+                              const hd32mt_alarm_event_t *events, size_t event_count,
+                              char *out, size_t out_cap)
+{
+    if (!timestamp || !events || !out || out_cap == 0) return 0;
+
+    size_t offset = 0;
+    int written = data_frame_format_device_id(instrument_id, out, out_cap);
+    if (written < 0 || (size_t)written >= out_cap)
+        return 0;
+    offset += written;
+
+    written = snprintf(out + offset, out_cap - offset, "ALARM$%s$%u$", timestamp, (unsigned)event_count);
+    if (written < 0 || (size_t)written >= out_cap - offset)
+        return 0;
+    offset += written;
+
+    for (size_t i = 0; i < event_count; ++i) {
+        const hd32mt_alarm_event_t *event = &events[i];
+        // "<no>|<durum>|<değer>|<eşik>$"
+        if (offset + 3 + 6 + 2 * (DATA_FRAME_MAX_VALUE_CHARS + 1) + 1 + 3 > out_cap)
+            return 0;
+        offset += (size_t)snprintf(out + offset, out_cap - offset, "%u|%s|",
+                                   (unsigned)event->channel + 1, hd32mt_alarm_state_name(event->state));
+        if (event->state != HD32MT_ALARM_FAULT) {
+            offset += data_frame_format_fixed2(event->value, out + offset);
+        }
+        out[offset++] = '|';
+        offset += data_frame_format_fixed2(event->threshold, out + offset);
+        out[offset++] = '$';
+    }
+
+    if (offset + 3 > out_cap)
+        return 0;
+    memcpy(out + offset, "\r\n", 3);
+    return offset + 2;
+}
+
+size_t data_frame_build_schema(const hd32mt_schema_t *schema, uint8_t instrument_id,
+                               char *out, size_t out_cap)
+{
+    if (!schema || !out || out_cap == 0) return 0;
+
+    size_t offset = 0;
+    int written = data_frame_format_device_id(instrument_id, out, out_cap);
+    if (written < 0 || (size_t)written >= out_cap)
+        return 0;
+    offset += written;
+
+    written = snprintf(out + offset, out_cap - offset, "SCHEMA$%s$%s$%u$",
+                       schema->fingerprint[0] ? schema->fingerprint : "-",
+                       schema->dl_type[0] ? schema->dl_type : "-",
+                       (unsigned)schema->sensor_count);
+    if (written < 0 || (size_t)written >= out_cap - offset)
+        return 0;
+    offset += written;
+
+    for (int i = 0; i < schema->sensor_count && i < HD32MT_MAX_CHANNELS; ++i) {
+        written = snprintf(out + offset, out_cap - offset, "%s|%s$",
+                           schema->sensors[i].name, schema->sensors[i].unit);
+        if (written < 0 || (size_t)written >= out_cap - offset)
+            return 0;
+        offset += written;
+    }
+
+    if (offset + 3 > out_cap)
+        return 0;
+    memcpy(out + offset, "\r\n", 3);
+    return offset + 2;
+}
+
+size_t data_frame_build_window(const hd32mt_window_summary_t *summary, char *out, size_t out_cap)
+{
+    if (!summary || !summary->channels || !out || out_cap == 0) return 0;
+
+    size_t offset = 0;
+    int written = data_frame_format_device_id(summary->instrument_id, out, out_cap);
+    if (written < 0 || (size_t)written >= out_cap)
+        return 0;
+    offset += written;
+
+    char timestamp[DATA_FRAME_TIMESTAMP_BYTES];
+    data_frame_format_epoch(summary->window_start, timestamp, sizeof(timestamp));
+    written = snprintf(out + offset, out_cap - offset, "AGG$%s$%u$%u$%u$",
+                       timestamp, (unsigned)summary->window_sec,
+                       (unsigned)summary->records, (unsigned)summary->channel_count);
+    if (written < 0 || (size_t)written >= out_cap - offset)
+        return 0;
+    offset += written;
+
+    for (uint8_t i = 0; i < summary->channel_count; ++i) {
+        const hd32mt_channel_stats_t *stats = &summary->channels[i];
+        if (stats->count > 0) {
+            // Sayı dışındaki alanlar veri satırıyla aynı "%.2f" biçiminde
+            const float values[] = {
+                stats->mean, stats->min, stats->max, hd32mt_channel_stddev(stats),
+            };
+            const float edges[] = { stats->first, stats->last };
+            if (offset + DATA_FRAME_WINDOW_FIELDS * DATA_FRAME_MAX_VALUE_CHARS + 3 > out_cap)
+                return 0;
+            for (size_t k = 0; k < sizeof(values) / sizeof(values[0]); ++k) {
+                offset += data_frame_format_fixed2(values[k], out + offset);
+                out[offset++] = '|';
+            }
+            offset += (size_t)snprintf(out + offset, out_cap - offset, "%u|", (unsigned)stats->count);
+            offset += data_frame_format_fixed2(edges[0], out + offset);
+            out[offset++] = '|';
+            offset += data_frame_format_fixed2(edges[1], out + offset);
+        }
+        if (offset + 1 + 3 > out_cap)
+            return 0;
+        out[offset++] = '$';
+    }
+
+    if (offset + 3 > out_cap)
+        return 0;
+    memcpy(out + offset, "\r\n", 3);
+    return offset + 2;
+}
+
+/* ==========================================================
+ * 3️⃣ SIRA NUMARASI VE ONAY
+ * ========================================================== */
+
+size_t data_frame_build_seq_prefix(uint32_t seq, char *out, size_t out_cap)
+{
+    if (!out || out_cap == 0) return 0;
+
+    int written = snprintf(out, out_cap, "#%lu", (unsigned long)seq);
+    if (written < 0 || (size_t)written >= out_cap)
+        return 0;
+    return (size_t)written;
+}
+
+size_t data_frame_build_seq_hello(uint32_t base_seq, char *out, size_t out_cap)
+{
+    if (!out || out_cap == 0) return 0;
+
+    int written = data_frame_format_device_id(0, out, out_cap);
+    if (written < 0 || (size_t)written >= out_cap)
+        return 0;
+    size_t offset = (size_t)written;
+
+    written = snprintf(out + offset, out_cap - offset, "SEQ$%lu$\r\n", (unsigned long)base_seq);
+    if (written < 0 || (size_t)written >= out_cap - offset)
+        return 0;
+    return offset + (size_t)written;
+}
+
+bool data_frame_parse_ack(const char *line, size_t length, uint32_t *out_seq)
+{
+    static const char prefix[] = "$ACK$";
+    const size_t prefix_len = sizeof(prefix) - 1;
+    if (!line || !out_seq || length <= prefix_len || memcmp(line, prefix, prefix_len) != 0)
+        return false;
+
+    // "$ACK$<seq>" ardından isteğe bağlı "$", "\r", "\n"
+    uint64_t seq = 0;
+    size_t i = prefix_len;
+    for (; i < length && line[i] >= '0' && line[i] <= '9'; ++i) {
+        seq = seq * 10 + (uint64_t)(line[i] - '0');
+        if (seq > UINT32_MAX) return false;
+    }
+    if (i == prefix_len) return false;
+    for (; i < length; ++i) {
+        if (line[i] != '$' && line[i] != '\r' && line[i] != '\n') return false;
+    }
+    *out_seq = (uint32_t)seq;
+    return true;
+}
@@ -1,115 +1,148 @@
 #include "data_sender.h"
 #include "cfg_if.h"
 #include "net_manager.h"
+#include "net_dns_cache.h"
 #include "esp_log.h"
 #include "lwip/sockets.h"
 #include "lwip/netdb.h"
 #include "data_parser.h"
+#include "data_frame.h"
 #include "time_if.h"
 #include "storage_spiffs.h"
+#include "uplink_conn.h"
 
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
 
 #define DATA_SENDER_MAX_LINE_BYTES 512
+/* 1: satırlar kalıcı bağlantıdan (uplink_conn), 0: satır başına connect/shutdown/recv */
+#define DATA_SENDER_PERSISTENT_CONNECTION 1
+/* >0: sıra numaralı satır + sunucu onayı, en fazla bu kadar onaysız satır (sunucu desteklemeli) */
+#define DATA_SENDER_ACK_WINDOW 0
+#define DATA_SENDER_TIMEOUT_MS 5000
+/* Şema satırı: başlık + kanal başına "isim|birim$" */
+#define DATA_SENDER_MAX_SCHEMA_BYTES \
+    (128 + HD32MT_MAX_CHANNELS * (sizeof(((sensor_info_t *)0)->name) + sizeof(((sensor_info_t *)0)->unit) + 2))
+/* Pencere satırı: başlık + kanal başına 7 alan (yalnızca pencere başına bir kez ayrılır) */
+#define DATA_SENDER_WINDOW_BYTES(channels) \
+    (128 + (size_t)(channels) * (DATA_FRAME_WINDOW_FIELDS * DATA_FRAME_MAX_VALUE_CHARS + 1))
 static const char *TAG = "DATA_SENDER";
 
 /* ==========================================================
- * 1️⃣ FRAME OLUŞTURMA
+ * 1️⃣ FRAME OLUŞTURMA (biçimleme data_frame.c'de, host'ta da derlenir)
  * ========================================================== */
-static bool data_sender_build_frame(const hd32mt_data_t *record,
-                                    int total_channels,
-                                    const char *manual_timestamp,
-                                    char *out_frame,
-                                    size_t out_cap)
-{
-    if (!record || !out_frame || out_cap == 0) return false;
 
-    char timestamp[24];
+/* Zaman burada, gönderim anında biçimlenir (kayıtta yalnızca epoch var) */
+static void data_sender_format_timestamp(const hd32mt_record_t *record, const char *manual_timestamp,
+                                         char *timestamp, size_t timestamp_cap)
+{
     if (manual_timestamp && strlen(manual_timestamp) > 5) {
-        strncpy(timestamp, manual_timestamp, sizeof(timestamp));
-        timestamp[sizeof(timestamp) - 1] = '\0';
+        strncpy(timestamp, manual_timestamp, timestamp_cap);
+        timestamp[timestamp_cap - 1] = '\0';
+    } else if (record->epoch != 0) {
+        data_frame_format_epoch(record->epoch, timestamp, timestamp_cap);
     } else {
-        time_if_get_formatted_timestamp(timestamp, sizeof(timestamp)); 
+        time_if_get_formatted_timestamp(timestamp, timestamp_cap);
     }
+}
+
+static size_t data_sender_build_frame(const hd32mt_record_t *record,
+                                      int total_channels,
+                                      const char *manual_timestamp,
+                                      char *out_frame,
+                                      size_t out_cap)
+{
+    if (!record || !out_frame || out_cap == 0) return 0;
+
+    char timestamp[DATA_FRAME_TIMESTAMP_BYTES];
+    data_sender_format_timestamp(record, manual_timestamp, timestamp, sizeof(timestamp));
 
     const device_cfg_t *cfg = cfg_get();
     if (!cfg) {
         ESP_LOGE(TAG, "Config not available!");
-        return false;
+        return 0;
     }
-    const char *manual_device_id = "00-08-DC-20-00-59";
-    size_t offset = 0;
-    int written = snprintf(out_frame + offset, out_cap - offset,
-                           "$%s$%s$%d$",
-                           manual_device_id, //cfg->device_id,
-                           timestamp,
-                           total_channels);
-    if (written < 0 || (size_t)written >= out_cap - offset)
-        return false;
-    offset += written;
-
-    for (int i = 0; i < total_channels; ++i) {
-        float val = (i < record->sensor_count) ? record->sensors[i] : 0.0f;
-        written = snprintf(out_frame + offset, out_cap - offset, "%.2f$", val);
-        if (written < 0 || (size_t)written >= out_cap - offset)
-            return false;
-        offset += written;
-    }
-
-    snprintf(out_frame + offset, out_cap - offset, "\r\n");
-    return true;
+    return data_frame_build(record, total_channels, timestamp, out_frame, out_cap);
 }
 
 /* ==========================================================
  * 2️⃣ SUNUCUYA GÖNDERME
  * ========================================================== */
-static bool data_sender_send_to_server(const char *frame)
+/* Bloklamayan soketle bağlanır; el sıkışma select ile timeout_ms kadar beklenir */
+static int data_sender_open(uint32_t timeout_ms)
 {
     const device_cfg_t *cfg = cfg_get();
-    if (!cfg || !frame) return false;
+    if (!cfg) return -1;
 
     if (!net_manager_is_connected()) {
         ESP_LOGW(TAG, "Network not connected");
-        return false;
+        return -1;
     }
 
-    struct addrinfo hints = {0}, *res = NULL;
-    char port_str[8];
-    snprintf(port_str, sizeof(port_str), "%ld", cfg->server_port);
-    hints.ai_socktype = SOCK_STREAM;
-
-    if (getaddrinfo(cfg->server_host, port_str, &hints, &res) != 0 || !res) {
+    // Ad önbellekten (TTL, negatif önbellek, DNS hatasında eski adres)
+    struct sockaddr_storage address;
+    socklen_t address_len = 0;
+    if (!net_dns_cache_resolve(cfg->server_host, (uint16_t)cfg->server_port, &address, &address_len)) {
         ESP_LOGE(TAG, "getaddrinfo failed");
-        return false;
+        return -1;
     }
 
-    int sock = -1;
-    for (struct addrinfo *it = res; it; it = it->ai_next) {
-        sock = socket(it->ai_family, it->ai_socktype, it->ai_protocol);
-        if (sock < 0) continue;
-
-        int one = 1;
-        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
-
-        struct timeval timeout = { .tv_sec = 5, .tv_usec = 0 };
-        setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
-        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    int sock = socket(address.ss_family, SOCK_STREAM, IPPROTO_TCP);
+    if (sock < 0) {
+        ESP_LOGE(TAG, "socket failed");
+        return -1;
+    }
 
-        if (connect(sock, it->ai_addr, it->ai_addrlen) == 0)
-            break;
+    int one = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
 
-        close(sock);
-        sock = -1;
+    bool connected = connect(sock, (struct sockaddr *)&address, address_len) == 0;
+    if (!connected && errno == EINPROGRESS) {
+        fd_set write_set;
+        FD_ZERO(&write_set);
+        FD_SET(sock, &write_set);
+        struct timeval timeout = { .tv_sec = timeout_ms / 1000, .tv_usec = (timeout_ms % 1000) * 1000 };
+        int so_error = 0;
+        socklen_t so_error_len = sizeof(so_error);
+        connected = select(sock + 1, NULL, &write_set, NULL, &timeout) > 0 &&
+                    getsockopt(sock, SOL_SOCKET, SO_ERROR, &so_error, &so_error_len) == 0 &&
+                    so_error == 0;
     }
-    freeaddrinfo(res);
-
-    if (sock < 0) {
+    if (!connected) {
         ESP_LOGE(TAG, "connect failed");
-        return false;
+        close(sock);
+        net_dns_cache_expire(cfg->server_host);   // Sunucu taşınmış olabilir: sonraki deneme yeniden çözer
+        return -1;
     }
+    return sock;
+}
+
+int data_sender_connect(void)
+{
+    int sock = data_sender_open(DATA_SENDER_TIMEOUT_MS);
+    if (sock < 0) return -1;
+
+    // Satır başına değiş tokuş bloklayan kipte; gönderim ve yanıt 5 sn ile sınırlı
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) & ~O_NONBLOCK);
+    struct timeval timeout = { .tv_sec = DATA_SENDER_TIMEOUT_MS / 1000, .tv_usec = 0 };
+    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return sock;
+}
+
+int data_sender_connect_nonblocking(uint32_t timeout_ms)
+{
+    return data_sender_open(timeout_ms);
+}
+
+bool data_sender_exchange(int sock, const char *frame, size_t len)
+{
+    if (sock < 0 || !frame) return false;
 
-    size_t len = strlen(frame);
     ssize_t sent = send(sock, frame, len, 0);
     if (sent != (ssize_t)len) {
         ESP_LOGE(TAG, "send failed (%d/%u)", (int)sent, (unsigned)len);
@@ -124,14 +157,30 @@ static bool data_sender_send_to_server(const char *frame)
     int rcv = recv(sock, resp, sizeof(resp) - 1, 0);
     if (rcv > 0) {
         resp[rcv] = '\0';
-        ESP_LOGI(TAG, "Server response: %s", resp);
+        ESP_LOGD(TAG, "Server response: %s", resp);
     }
 
     close(sock);
-    ESP_LOGI(TAG, "Frame sent OK");
+    ESP_LOGD(TAG, "Frame sent OK");
     return true;
 }
 
+static bool data_sender_send_to_server(const char *frame, size_t len)
+{
+    if (!frame) return false;
+
+#if DATA_SENDER_PERSISTENT_CONNECTION
+    if (uplink_conn_is_ready()) {
+        return uplink_conn_send(frame, len);
+    }
+#endif
+    int sock = data_sender_connect();
+    if (sock < 0) {
+        return false;
+    }
+    return data_sender_exchange(sock, frame, len);
+}
+
 
 /* ==========================================================
  * 3️⃣ SD KARTA KAYDETME
@@ -145,19 +194,123 @@ static bool data_sender_save_to_sd(const char *frame)
 /* ==========================================================
  * 4️⃣ KOORDİNE EDİCİ (ANA FONKSİYON)
  * ========================================================== */
-bool data_sender_send_frame_from_record(const hd32mt_data_t *record,
+bool data_sender_send_frame_from_record(const hd32mt_record_t *record,
                                         int total_channels,
                                         const char *formatted_timestamp)
 {
 
     char frame[DATA_SENDER_MAX_LINE_BYTES];
-    if (!data_sender_build_frame(record, total_channels, formatted_timestamp,
-                             frame, sizeof(frame))) {
+    size_t length = data_sender_build_frame(record, total_channels, formatted_timestamp,
+                                            frame, sizeof(frame));
+    if (length == 0) {
         ESP_LOGE(TAG, "Frame build failed");
         return false;
     }
 
-    bool net_ok = data_sender_send_to_server(frame);
+    bool net_ok = data_sender_send_to_server(frame, length);
     data_sender_save_to_sd(frame);  // İnternet olsa da olmasa da SD’ye yaz
     return net_ok;
 }
+
+bool data_sender_init(void)
+{
+    // Sunucu adı ağ her geldiğinde arka planda çözülür
+    const device_cfg_t *cfg = cfg_get();
+    if (cfg && !net_dns_cache_register(cfg->server_host)) {
+        ESP_LOGW(TAG, "Server host not cached: %s", cfg->server_host);
+    }
+#if DATA_SENDER_PERSISTENT_CONNECTION
+    uplink_conn_config_t uplink_config = UPLINK_CONN_DEFAULT_CONFIG();
+    uplink_config.ack_window = DATA_SENDER_ACK_WINDOW;
+    return uplink_conn_init(&uplink_config);
+#else
+    return true;
+#endif
+}
+
+bool data_sender_store_record(const hd32mt_record_t *record, int total_channels)
+{
+    char frame[DATA_SENDER_MAX_LINE_BYTES];
+    size_t length = data_sender_build_frame(record, total_channels, NULL, frame, sizeof(frame));
+    if (length == 0) {
+        ESP_LOGE(TAG, "Frame build failed");
+        return false;
+    }
+    return data_sender_save_to_sd(frame);
+}
+
+bool data_sender_send_changes(const hd32mt_record_t *record, uint32_t channel_mask, int total_channels)
+{
+    if (!record) return false;
+
+    char frame[DATA_SENDER_MAX_LINE_BYTES];
+    char timestamp[DATA_FRAME_TIMESTAMP_BYTES];
+    data_sender_format_timestamp(record, NULL, timestamp, sizeof(timestamp));
+    size_t length = data_frame_build_changes(record, channel_mask, total_channels, timestamp,
+                                             frame, sizeof(frame));
+    if (length == 0) {
+        ESP_LOGE(TAG, "Delta frame build failed");
+        return false;
+    }
+
+    bool net_ok = data_sender_send_to_server(frame, length);
+    // SD'de arşiv tam kalır: seyrek satır yerine kaydın tamamı
+    data_sender_store_record(record, total_channels);
+    return net_ok;
+}
+
+bool data_sender_send_window(const hd32mt_window_summary_t *summary)
+{
+    if (!summary) return false;
+
+    // Dakikada bir: yığında 3 KB yerine satır boyu kadar heap
+    size_t cap = DATA_SENDER_WINDOW_BYTES(summary->channel_count);
+    char *frame = malloc(cap);
+    if (!frame) {
+        ESP_LOGE(TAG, "Window frame alloc failed (%u B)", (unsigned)cap);
+        return false;
+    }
+
+    size_t length = data_frame_build_window(summary, frame, cap);
+    if (length == 0) {
+        ESP_LOGE(TAG, "Window frame build failed");
+        free(frame);
+        return false;
+    }
+
+    bool net_ok = data_sender_send_to_server(frame, length);
+    data_sender_save_to_sd(frame);
+    free(frame);
+    return net_ok;
+}
+
+bool data_sender_send_schema(const hd32mt_schema_t *schema, uint8_t instrument_id, bool save_to_sd)
+{
+    if (!schema) return false;
+
+    char frame[DATA_SENDER_MAX_SCHEMA_BYTES];
+    size_t length = data_frame_build_schema(schema, instrument_id, frame, sizeof(frame));
+    if (length == 0) {
+        ESP_LOGE(TAG, "Schema frame build failed");
+        return false;
+    }
+
+    bool net_ok = data_sender_send_to_server(frame, length);
+    if (save_to_sd) {
+        data_sender_save_to_sd(frame);  // SD'deki veri satırları da şemasız okunamaz
+    }
+    return net_ok;
+}
+
+uint32_t data_sender_get_session(void)
+{
+#if DATA_SENDER_PERSISTENT_CONNECTION
+    if (uplink_conn_is_ready()) {
+        uplink_conn_stats_t uplink;
+        uplink_conn_get_stats(&uplink);
+        return uplink.connects;
+    }
+#endif
+    // Satır başına bağlantıda oturum yok: arayüz değişimi yeni oturum sayılır
+    return net_manager_get_link_generation();
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hd32mt_alarm.h"
+
+/*
+ * Alarm hızlı hattı: eşik/arıza olayları normal veri yolunu (DNS, connect,
+ * 5 sn zaman aşımları, SD yazımı, taşma birikmesi) beklemez.
+ *
+ *  - Olaylar telemetri görevinden kısa bir kuyruğa bloklanmadan atılır
+ *  - Ayrı, yüksek öncelikli görev önceden açılmış (ısıtılmış) bağlantıyla
+ *    gönderir; sunucu bağlantı başına tek satır beklediği için her alarmdan
+ *    sonra bir sonraki bağlantı hemen hazırlanır
+ *  - Algılamadan sunucu yanıtına kadar geçen süre ölçülür, bütçeyi aşanlar sayılır
+ *  - SD'ye yazım gönderimden sonra (kritik yol dışında)
+ */
+
+typedef struct {
+    uint32_t budget_ms;            /* Teslim süresi bütçesi (aşılırsa uyarı + sayaç) */
+    uint32_t prewarm_max_age_ms;   /* Boşta bekleyen bağlantı bu kadar sonra yenilenir */
+    uint32_t retry_interval_ms;    /* Isıtma başarısızsa tekrar deneme aralığı */
+} alarm_sender_config_t;
+
+#define ALARM_SENDER_DEFAULT_CONFIG()    \
+    {                                    \
+        .budget_ms          = 2000,      \
+        .prewarm_max_age_ms = 30000,     \
+        .retry_interval_ms  = 10000,     \
+    }
+
+typedef struct {
+    uint32_t posted;           /* Kuyruğa giren alarm satırı */
+    uint32_t dropped;          /* Kuyruk dolu */
+    uint32_t sent;
+    uint32_t failed;           /* Isıtılmış ve taze bağlantıyla da gidemedi */
+    uint32_t warm_hits;        /* Hazır bağlantıyla gönderilen */
+    uint32_t prewarm_failures;
+    uint32_t over_budget;      /* Bütçeyi aşan teslim */
+    uint32_t last_latency_ms;
+    uint32_t max_latency_ms;
+    uint64_t total_latency_ms; /* Ortalama = total / sent */
+} alarm_sender_stats_t;
+
+/** Görevi başlatır (tekrar çağrılırsa bir şey yapmaz). @param config NULL ise varsayılan */
+bool alarm_sender_start(const alarm_sender_config_t *config);
+
+bool alarm_sender_is_running(void);
+
+/**
+ * Bir kaydın alarm olaylarını kuyruğa atar (bloklamaz). Süre ölçümü bu çağrıda başlar.
+ * @param epoch  Kayıt zamanı (0 ise gönderim anının saati)
+ * @return false  Görev yok ya da kuyruk dolu
+ */
+bool alarm_sender_post(uint8_t instrument_id, uint32_t epoch,
+                       const hd32mt_alarm_event_t *events, size_t event_count);
+
+void alarm_sender_get_stats(alarm_sender_stats_t *out_stats);
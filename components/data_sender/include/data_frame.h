@@ -0,0 +1,95 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "data_parser.h"
+#include "hd32mt_config.h"
+#include "hd32mt_aggregate.h"
+#include "hd32mt_alarm.h"
+
+/**
+ * Sunucu satırı biçimleyicisi (data_sender'ın ağ/SD'den bağımsız kısmı).
+ * cfg/ağ/zaman bağımlılığı yoktur; host'ta da derlenir.
+ *
+ * Veri satırı:  $<device_id>$<dd/mm/yy-HH:MM:SS>$<N>$<ch1>$...$<chN>\r\n
+ * Şema satırı:  $<device_id>$SCHEMA$<fingerprint>$<dl_type>$<N>$<isim>|<birim>$...$\r\n
+ * Değişenler:   $<device_id>$DELTA$<dd/mm/yy-HH:MM:SS>$<N>$<adet>$<kanal no>|<değer>$...$\r\n
+ * Alarm:        $<device_id>$ALARM$<dd/mm/yy-HH:MM:SS>$<adet>$<kanal no>|<durum>|<değer>|<eşik>$...$\r\n
+ * Pencere:      $<device_id>$AGG$<başlangıç>$<pencere sn>$<kayıt>$<N>$<ort>|<min>|<max>|<sapma>|<adet>|<ilk>|<son>$...$\r\n
+ *
+ * Sıra numarası eki (isteğe bağlı, sunucu desteklemeli; bkz. uplink_conn.h):
+ *   Satır:       #<seq> + yukarıdaki satırlardan biri, ör. #1042$<device_id>$...\r\n
+ *   Oturum:      $<device_id>$SEQ$<base>$\r\n  (bağlantının ilk satırı)
+ *   Onay:        $ACK$<seq>\r\n                (sunucudan)
+ *
+ * <base>'den küçük numaralar ya onaylandı ya da cihaz vazgeçti (SD'de);
+ * sunucu base - 1'e kadarını tamam sayar. Onay, kesintisiz işlenen en büyük
+ * numaradır. Sunucu onayladığı numarayı yeniden işlemez: yeniden gönderim
+ * idempotenttir.
+ */
+
+/* Pencere satırında kanal başına alan sayısı (ort|min|max|sapma|adet|ilk|son) */
+#define DATA_FRAME_WINDOW_FIELDS     7
+
+/* Tek değerin en uzun metni ("%.2f" FLT_MAX + işaret) */
+#define DATA_FRAME_MAX_VALUE_CHARS   48
+#define DATA_FRAME_TIMESTAMP_BYTES   24
+#define DATA_FRAME_SEQ_PREFIX_BYTES  12     /* "#" + 10 hane + '\0' */
+
+/** Kayıt zamanı, time_if_get_formatted_timestamp ile aynı biçimde (gg/aa/yy-SS:DD:ss) */
+void data_frame_format_epoch(uint32_t epoch, char *out, size_t out_cap);
+
+/**
+ * printf("%.2f") ile aynı çıktı, snprintf'siz (yuvarlama: en yakın, eşitlikte çift).
+ * @param out  En az DATA_FRAME_MAX_VALUE_CHARS bayt; '\0' yazılmaz
+ * @return     Yazılan karakter
+ */
+size_t data_frame_format_fixed2(float value, char *out);
+
+/**
+ * Veri satırı. Kanallar konumsaldır: geçersiz kanal boş alan, kayıtta
+ * olmayan kanal 0.00 olur.
+ * @param timestamp  Biçimlenmiş zaman (bkz. data_frame_format_epoch)
+ * @return           Satır uzunluğu ('\0' hariç), sığmazsa 0
+ */
+size_t data_frame_build(const hd32mt_record_t *record, int total_channels, const char *timestamp,
+                        char *out, size_t out_cap);
+
+/**
+ * Seyrek veri satırı: yalnızca maskedeki kanallar, 1'den başlayan kanal
+ * numarasıyla (veri satırındaki <chK> ile aynı sıra).
+ * @return  Satır uzunluğu ('\0' hariç), sığmazsa 0
+ */
+size_t data_frame_build_changes(const hd32mt_record_t *record, uint32_t channel_mask, int total_channels,
+                                const char *timestamp, char *out, size_t out_cap);
+
+/**
+ * Alarm satırı; durum HIGH/LOW/FAULT/CLEAR, FAULT'ta değer alanı boş.
+ * @return  Satır uzunluğu ('\0' hariç), sığmazsa 0
+ */
+size_t data_frame_build_alarm(uint8_t instrument_id, const char *timestamp,
+                              const hd32mt_alarm_event_t *events, size_t event_count,
+                              char *out, size_t out_cap);
+
+/** Şema satırı; sığmazsa 0 */
+size_t data_frame_build_schema(const hd32mt_schema_t *schema, uint8_t instrument_id,
+                               char *out, size_t out_cap);
+
+/**
+ * Pencere özeti satırı. Kanallar konumsaldır: penceredeki örneği olmayan
+ * kanal boş alan olur.
+ * @return  Satır uzunluğu ('\0' hariç), sığmazsa 0
+ */
+size_t data_frame_build_window(const hd32mt_window_summary_t *summary, char *out, size_t out_cap);
+
+/** Sıra numarası öneki "#<seq>"; sığmazsa 0 */
+size_t data_frame_build_seq_prefix(uint32_t seq, char *out, size_t out_cap);
+
+/** Oturum satırı: bu bağlantıda beklenen ilk numara; sığmazsa 0 */
+size_t data_frame_build_seq_hello(uint32_t base_seq, char *out, size_t out_cap);
+
+/**
+ * Sunucu onay satırı ("$ACK$<seq>", sonunda "\r\n" olabilir).
+ * @return  false: onay satırı değil
+ */
+bool data_frame_parse_ack(const char *line, size_t length, uint32_t *out_seq);
@@ -2,18 +2,89 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include "data_parser.h"
+#include "hd32mt_config.h"
+#include "hd32mt_aggregate.h"
+
+/**
+ * Kalıcı sunucu bağlantısını hazırlar (bkz. uplink_conn.h). Çağrılmazsa
+ * satırlar eskisi gibi satır başına bağlantıyla gider.
+ */
+bool data_sender_init(void);
 
 /**
  * Çoklu sensörü tek satır halinde gönderir:
- * $<device_id>$<yy/mm/dd-HH:MM:SS>$<total_channels>$<ch1>$...$<chN>\r\n
+ * $<device_id>$<dd/mm/yy-HH:MM:SS>$<total_channels>$<ch1>$...$<chN>\r\n
+ * (record->instrument_id != 0 ise kimlik "<device_id>:<instrument_id>" olur)
+ *
+ * Kanallar konumsaldır: geçersiz kanal boş alan ("$$") olarak yazılır,
+ * kayıtta olmayan kanallar 0.00 ile doldurulur.
  *
- * @param record                Parser’dan gelen veri (pozisyonel diziler)
+ * @param record                Parser’dan gelen kayıt (zaman = record->epoch)
  * @param total_channels        Toplam kanal sayısı (N)
- * @param formatted_timestamp   "yy/mm/dd-HH:MM:SS" (RTC’den hazır biçim)
+ * @param formatted_timestamp   NULL değilse kayıt zamanı yerine kullanılır
  * @return true                 Satır başarıyla gönderildiyse
  */
-bool data_sender_send_frame_from_record(const hd32mt_data_t *record,
+bool data_sender_send_frame_from_record(const hd32mt_record_t *record,
                                         int total_channels,
                                         const char *formatted_timestamp);
+/**
+ * Kaydı yalnızca SD'ye yazar (pencereli gönderimde ham arşiv); biçim
+ * data_sender_send_frame_from_record ile aynıdır.
+ */
+bool data_sender_store_record(const hd32mt_record_t *record, int total_channels);
+
+/**
+ * Yalnızca maskedeki kanalları seyrek satırla gönderir (SD'ye kaydın tamamı yazılır):
+ * $<device_id>$DELTA$<dd/mm/yy-HH:MM:SS>$<N>$<adet>$<kanal no>|<değer>$...$\r\n
+ *
+ * @return true  Sunucuya ulaştıysa
+ */
+bool data_sender_send_changes(const hd32mt_record_t *record, uint32_t channel_mask, int total_channels);
+
+/**
+ * Pencere özetini tek satır olarak gönderir ve SD'ye yazar:
+ * $<device_id>$AGG$<başlangıç>$<pencere sn>$<kayıt>$<N>$<ort>|<min>|<max>|<sapma>|<adet>|<ilk>|<son>$...$\r\n
+ *
+ * @return true  Sunucuya ulaştıysa
+ */
+bool data_sender_send_window(const hd32mt_window_summary_t *summary);
+
+/**
+ * Kanal isim/birim şemasını oturumda bir kez gönderir (veri satırları yalnızca değer taşır):
+ * $<device_id>$SCHEMA$<fingerprint>$<dl_type>$<N>$<isim>|<birim>$...$\r\n
+ *
+ * @param save_to_sd  Satır SD'ye de yazılsın mı (şema değişince bir kez; ağ
+ *                    denemeleri tekrarlandıkça SD'de kopya birikmesin)
+ * @return true  Sunucuya ulaştıysa
+ */
+bool data_sender_send_schema(const hd32mt_schema_t *schema, uint8_t instrument_id, bool save_to_sd);
+
+/**
+ * Sunucu oturumu sayacı: kalıcı bağlantıda her yeni bağlantıda, satır başına
+ * bağlantıda arayüz değişince artar. Değiştiyse sunucu (yeniden başlamış
+ * olabilir) oturum başı satırlarını (şema) yeniden almalı.
+ */
+uint32_t data_sender_get_session(void);
+
+/**
+ * Sunucuya TCP bağlantısı açar (DNS + connect, 5 sn zaman aşımı).
+ * Önceden bağlanıp bekletmek isteyen yollar (alarm hattı) için.
+ * @return  Soket, ağ yoksa/bağlanamazsa -1
+ */
+int data_sender_connect(void);
+
+/**
+ * data_sender_connect gibi, ama soket O_NONBLOCK kalır (select ile
+ * kullanan uplink görevi için).
+ * @param timeout_ms  El sıkışma için en uzun bekleme
+ */
+int data_sender_connect_nonblocking(uint32_t timeout_ms);
+
+/**
+ * Tek satırı gönderir, yazma yönünü kapatır, kısa yanıtı bekler ve soketi kapatır
+ * (sunucu bağlantı başına bir satır bekler). Soket her durumda kapanır.
+ */
+bool data_sender_exchange(int sock, const char *frame, size_t len);
+
 /** Test/manuel kullanım: cfg_if.device_id yerine bunu kullan. NULL ya da "" verirsen override kapanır. */
 void data_sender_set_device_id_override(const char *device_id_override);
\ No newline at end of file
@@ -0,0 +1,162 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Sunucuya kalıcı bağlantı (satır başına connect yerine).
+ *
+ *  - Gönderim kendi görevinde: uplink_conn_send satırı sınırlı giden kuyruğa
+ *    kopyalar ve hemen döner, ağ beklemesi telemetry_task'ı durdurmaz.
+ *    Kuyruk doluysa satır yalnızca SD'ye gider
+ *  - Soket bloklamayan kipte; yazma ve karşı tarafın kapatması select ile
+ *    beklenir, write_stall_ms boyunca yazılamayan bağlantı bırakılır
+ *  - Tek soket açık tutulur; satırlar art arda aynı akıştan gider ("\r\n" ayraç)
+ *  - Ölü karşı taraf: TCP keepalive + yazma hatası + karşı tarafın kapatması
+ *    (gönderim öncesi bloklamayan okuma); hepsi yeniden bağlantıya yol açar
+ *  - Bağlanamazsa üstel geri çekilme (yarısı sabit, yarısı rastgele): bekleme
+ *    süresince gönderim hemen false döner, satır yalnızca SD'ye gider
+ *  - net_manager arayüz değiştirdiğinde (bağlantı nesli değişir) soket yenilenir
+ *  - Birleştirme: satırlar tamponda toplanır, bayt/adet sınırı ya da en uzun
+ *    bekleme dolunca tek send() ile gider (kayıt başına bir segment yerine).
+ *    Sınırlar etkin arayüze göre (ETH < Wi-Fi < GSM) seçilir; bekleme
+ *    ölçülen RTT'ye göre profilin aralığında ayarlanır (RTT yüksekse
+ *    bekletmenin göreli maliyeti düşüktür)
+ *  - Onay kipi (ack_window > 0, sunucu desteklemeli; biçim data_frame.h'de):
+ *    satırlar NVS'de saklanan, hiç geri gitmeyen sıra numarası taşır. En
+ *    fazla ack_window satır onaysız yolda olabilir (kayıt başına bir RTT
+ *    beklenmez). Sunucu kesintisiz işlediği en büyük numarayı onaylar;
+ *    onaylanmayanlar yeni bağlantıda yeniden gönderilir, sunucu tekrarları
+ *    numaradan tanır. Onay süreleri RTT örneği olarak birleştirmeye gider
+ *
+ * Kuyruk tek mutex altında; birden fazla görev gönderebilir. Mutex ağ
+ * işlemleri sırasında tutulmaz.
+ */
+
+/* Giden kuyruğun sınırları; profil eşikleri bunların altında kalır */
+#define UPLINK_QUEUE_BYTES        8192
+#define UPLINK_QUEUE_FRAMES       64
+
+/* Bekleme (tutma) süresi histogramı, ms cinsinden üst sınırlar (son kova: daha uzun) */
+#define UPLINK_HOLD_BUCKETS       12
+#define UPLINK_HOLD_BUCKET_LIMITS_MS { 0, 1, 5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000 }
+
+typedef struct {
+    uint32_t backoff_min_ms;
+    uint32_t backoff_max_ms;
+    int      keepalive_idle_sec;       /* İlk yoklamaya kadar boşta kalma */
+    int      keepalive_interval_sec;
+    int      keepalive_count;          /* Cevapsız yoklama sayısı → bağlantı ölü */
+    bool     coalesce;                 /* false: satır beklemeden yazılır */
+    uint32_t connect_timeout_ms;
+    uint32_t write_stall_ms;           /* Soket bu süre yazılamazsa bağlantı ölü sayılır */
+    uint16_t ack_window;               /* Onaysız yoldaki en fazla satır; 0 = onay kipi kapalı */
+    uint32_t ack_timeout_ms;           /* Bu süre onay ilerlemezse yeniden bağlan ve yeniden gönder */
+} uplink_conn_config_t;
+
+#define UPLINK_CONN_DEFAULT_CONFIG()      \
+    {                                     \
+        .backoff_min_ms         = 500,    \
+        .backoff_max_ms         = 60000,  \
+        .keepalive_idle_sec     = 30,     \
+        .keepalive_interval_sec = 5,      \
+        .keepalive_count        = 3,      \
+        .coalesce               = true,   \
+        .connect_timeout_ms     = 5000,   \
+        .write_stall_ms         = 10000,  \
+        .ack_window             = 0,      \
+        .ack_timeout_ms         = 10000,  \
+    }
+
+/* Sıra numarası NVS'ye bu kadar ileriye ayrılarak yazılır (her satırda değil). Blok
+ * yarılanınca uplink görevi sıradakini ayırır; üretici NVS'yi hiç beklemez */
+#define UPLINK_SEQ_RESERVE        1024
+/* Üst üste bu kadar onay zaman aşımında yoldaki satırlardan vazgeçilir (SD'de var) */
+#define UPLINK_ACK_MAX_TIMEOUTS   3
+
+/* Arayüz başına birleştirme profili: bekleme RTT'ye göre [min, max] aralığında */
+typedef struct {
+    uint16_t max_bytes;
+    uint8_t  max_frames;
+    uint16_t min_hold_ms;
+    uint16_t max_hold_ms;
+} uplink_batch_profile_t;
+
+#define UPLINK_BATCH_PROFILE_ETHERNET  { .max_bytes = 1400, .max_frames = 16, .min_hold_ms = 20,  .max_hold_ms = 200  }
+#define UPLINK_BATCH_PROFILE_WIFI      { .max_bytes = 2800, .max_frames = 24, .min_hold_ms = 50,  .max_hold_ms = 500  }
+#define UPLINK_BATCH_PROFILE_GSM       { .max_bytes = 4096, .max_frames = 32, .min_hold_ms = 200, .max_hold_ms = 2000 }
+
+typedef struct {
+    uint32_t connects;
+    uint32_t connect_failures;
+    uint32_t disconnects;              /* Yazma hatası, karşı taraf kapattı, arayüz değişti */
+    uint32_t interface_changes;
+    uint32_t backoff_skips;            /* Geri çekilme sırasında gönderilmeyen satır */
+    uint32_t frames;                   /* Toplam gönderilen (yazılan) satır */
+    uint32_t frames_this_connection;
+    uint32_t max_frames_per_connection;
+    uint32_t backoff_ms;               /* Sıradaki bekleme (0 = bağlı ya da ilk deneme) */
+    uint32_t last_connect_ms;          /* DNS + TCP el sıkışma */
+    uint32_t max_connect_ms;
+    uint64_t total_connect_ms;         /* Ortalama = total / connects */
+
+    /* Birleştirme */
+    uint32_t writes;                   /* send() çağrısı (tam yazılan tampon) */
+    uint32_t segments;                 /* Tahmini TCP segmenti (bayt / MSS) → paket/kayıt = segments / frames */
+    uint32_t dropped_frames;           /* Yazılamayan tamponda kalan (SD'de var) */
+    uint32_t srtt_ms;                  /* Düzgünleştirilmiş RTT (bağlantı kurma süresinden) */
+    uint16_t hold_ms;                  /* Etkin en uzun bekleme */
+    uint16_t batch_bytes;              /* Etkin bayt sınırı */
+    uint32_t hold_histogram[UPLINK_HOLD_BUCKETS + 1];   /* Kuyruğa girişten sokete verilişe */
+
+    /* Giden kuyruk (üreticiler → uplink görevi) */
+    uint32_t queue_frames;             /* Anlık doluluk */
+    uint32_t queue_bytes;
+    uint32_t peak_queue_frames;
+    uint32_t peak_queue_bytes;
+    uint32_t queue_full;               /* Kuyruk dolu: satır yalnızca SD'de */
+    uint32_t write_stalls;             /* write_stall_ms boyunca yazılamadı */
+
+    /* Onay kipi */
+    uint32_t acked;                    /* Sunucunun onayladığı satır */
+    uint32_t inflight;                 /* Anlık: yazıldı, onay bekliyor */
+    uint32_t max_inflight;
+    uint32_t retransmits;              /* Yeni bağlantıda yeniden gönderilen satır */
+    uint32_t ack_timeouts;
+    uint32_t seq_next;                 /* Sıradaki satırın numarası */
+    uint32_t seq_exhausted;            /* Ayrılmış numara bitti (NVS yazımı gecikti): satır yalnızca SD'de */
+    uint32_t last_ack_seq;
+} uplink_conn_stats_t;
+
+/** Kuyruğu ve gönderim görevini hazırlar. @param config NULL ise UPLINK_CONN_DEFAULT_CONFIG */
+bool uplink_conn_init(const uplink_conn_config_t *config);
+
+bool uplink_conn_is_ready(void);
+
+/**
+ * Satırı giden kuyruğa kopyalar; ağı hiç beklemez. Bağlantıyı uplink görevi
+ * kurar; açık bağlantıda yazma hatası olursa bir kez yeni bağlantıyla
+ * tekrar dener.
+ *
+ * true "satır kuyruğa alındı" demektir; sonradan yazılamayan satırlar
+ * dropped_frames'e sayılır.
+ * @return false  Ağ yok, geri çekilme sürüyor ya da kuyruk dolu
+ */
+bool uplink_conn_send(const char *frame, size_t length);
+
+/** Bekleyenler yazıldıktan sonra bağlantıyı kapattırır (sonraki gönderim yeniden bağlanır). */
+void uplink_conn_close(void);
+
+void uplink_conn_get_stats(uplink_conn_stats_t *out_stats);
+
+/** Bekleyen satırların bekleme süresi dolmadan yazılmasını ister. */
+bool uplink_conn_flush(void);
+
+/**
+ * Satırların tamponda bekleme süresi yüzdeliği (ör. 50, 90, 99).
+ * @return  İlgili kovanın üst sınırı (ms); veri yoksa 0, son kovada UINT32_MAX
+ */
+uint32_t uplink_conn_hold_percentile(const uplink_conn_stats_t *stats, unsigned percent);
+
+/** Dışarıdan ölçülen RTT örneği (ör. sunucu onayı); bekleme süresini yeniden ayarlar */
+void uplink_conn_rtt_sample(uint32_t rtt_ms);
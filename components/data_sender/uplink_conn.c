@@ -0,0 +1,821 @@
+#include "uplink_conn.h"
+#include "data_sender.h"
+#include "data_frame.h"
+#include "net_manager.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "lwip/sockets.h"
+#include "nvs.h"
+
+static const char *TAG = "UPLINK";
+
+#define UPLINK_TASK_NAME               "uplink_task"
+#define UPLINK_TASK_STACK_BYTES        3072
+#define UPLINK_TASK_PRIORITY           4      /* telemetry_task (5) altında: ayrıştırma önce gelir */
+#define UPLINK_IDLE_CHECK_MS           1000   /* Boştayken karşı tarafın kapatmasını denetleme */
+#define UPLINK_SELECT_MS               250
+#define UPLINK_ACK_POLL_MS             20     /* Onay beklerken kuyruğa bakma aralığı */
+#define UPLINK_TCP_MSS                 1440   /* Segment tahmini için */
+#define UPLINK_HOLD_RTT_FACTOR         2      /* Bekleme ≈ 2 x srtt, profil aralığında */
+#define UPLINK_RX_BYTES                64     /* Sunucu yanıt satırı ("$ACK$<seq>\r\n") */
+#define UPLINK_HELLO_BYTES             64
+
+/* Sıra numarasının ayrıldığı sınır (bu değerden küçükler kullanılmış olabilir) */
+#define UPLINK_NVS_NAMESPACE           "uplink"
+#define UPLINK_NVS_KEY_SEQ             "seq_limit"
+
+typedef struct {
+    uint32_t end;                      /* Satırın kuyruktaki bitişi */
+    uint32_t seq;                      /* Onay kipinde numara */
+    int64_t  enqueued_us;
+    int64_t  written_us;               /* Sokete verildiği an (RTT örneği) */
+    bool     retransmitted;            /* Karn: yeniden gönderilenden RTT örneği alınmaz */
+} uplink_frame_t;
+
+typedef struct {
+    uplink_conn_config_t   config;
+    SemaphoreHandle_t      mutex;
+    TaskHandle_t           task;
+
+    /* Yalnızca uplink görevi */
+    int                    sock;              /* -1 = bağlı değil */
+    uint32_t               generation;        /* Bağlanırken net_manager bağlantı nesli */
+    char                   hello[UPLINK_HELLO_BYTES];   /* Onay kipinde bağlantının ilk satırı */
+    size_t                 hello_len;
+    size_t                 hello_sent;
+    char                   rx[UPLINK_RX_BYTES];
+    size_t                 rx_len;
+    int64_t                ack_progress_us;   /* Son onay (ya da yola ilk satırın çıkışı) */
+    uint8_t                ack_timeouts_in_row;
+
+    /* Mutex altında (üreticiler de dokunur) */
+    int64_t                next_attempt_us;   /* Geri çekilme bitişi */
+    bool                   flush_requested;
+    bool                   close_requested;
+    net_mode_t             profile_mode;
+    uplink_batch_profile_t profile;
+    uint32_t               queue_len;         /* Kuyruktaki bayt */
+    uint32_t               sent;              /* Kuyruğun başından sokete verilmiş bayt */
+    uint32_t               frame_count;
+    uint32_t               written;           /* Baştan tamamen yazılmış satır (onay kipinde yolda) */
+    uint32_t               seq_limit;         /* NVS'de ayrılmış sınır */
+    uplink_conn_stats_t    stats;
+    uplink_frame_t         frames[UPLINK_QUEUE_FRAMES];
+    char                   queue[UPLINK_QUEUE_BYTES];
+} uplink_conn_t;
+
+static uplink_conn_t s_uplink = { .sock = -1 };
+
+static const uint32_t s_hold_limits_ms[UPLINK_HOLD_BUCKETS] = UPLINK_HOLD_BUCKET_LIMITS_MS;
+
+/* ------------------------------ Yardımcılar ------------------------------ */
+
+static void uplink_lock(uplink_conn_t *up)   { xSemaphoreTake(up->mutex, portMAX_DELAY); }
+static void uplink_unlock(uplink_conn_t *up) { xSemaphoreGive(up->mutex); }
+
+static bool uplink_ack_mode(const uplink_conn_t *up)
+{
+    return up->config.ack_window > 0;
+}
+
+/* Sıra numaraları 32 bitte dönebilir: karşılaştırma farkla */
+static bool uplink_seq_before_or_equal(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) <= 0;
+}
+
+static void uplink_disconnect(uplink_conn_t *up, const char *reason)
+{
+    if (up->sock < 0) return;
+    close(up->sock);
+    up->sock = -1;
+    up->hello_len = 0;
+    up->rx_len    = 0;
+
+    // Yarım kalan satır yeni bağlantıda baştan gider (sunucu yarım satırı atar);
+    // onay kipinde onaylanmamış satırlar da yeniden gönderilir
+    uplink_lock(up);
+    for (uint32_t i = 0; i < up->written; ++i) {
+        up->frames[i].retransmitted = true;
+    }
+    up->stats.retransmits += up->written;
+    up->written = 0;
+    up->sent    = 0;
+    up->stats.inflight = 0;
+    up->stats.disconnects++;
+    uint32_t frames = up->stats.frames_this_connection;
+    uplink_unlock(up);
+    ESP_LOGW(TAG, "Bağlantı kapandı (%s), %u satır gitti", reason, (unsigned)frames);
+}
+
+/* Eşit titreşimli üstel geri çekilme: [b/2, b] aralığında bekle, b'yi ikiye katla (mutex altında) */
+static void uplink_schedule_retry(uplink_conn_t *up, int64_t now_us)
+{
+    uint32_t backoff = up->stats.backoff_ms ? up->stats.backoff_ms * 2 : up->config.backoff_min_ms;
+    if (backoff > up->config.backoff_max_ms) {
+        backoff = up->config.backoff_max_ms;
+    }
+    up->stats.backoff_ms = backoff;
+
+    uint32_t delay_ms = backoff / 2 + esp_random() % (backoff / 2 + 1);
+    up->next_attempt_us = now_us + (int64_t)delay_ms * 1000;
+    ESP_LOGW(TAG, "Bağlanılamadı, %u ms sonra tekrar (%u. hata)",
+             (unsigned)delay_ms, (unsigned)up->stats.connect_failures);
+}
+
+/* ---- Sıra numarası (NVS) ---- */
+
+static uint32_t uplink_seq_load(void)
+{
+    nvs_handle_t handle;
+    uint32_t limit = 0;
+    if (nvs_open(UPLINK_NVS_NAMESPACE, NVS_READONLY, &handle) == ESP_OK) {
+        nvs_get_u32(handle, UPLINK_NVS_KEY_SEQ, &limit);
+        nvs_close(handle);
+    }
+    return limit;
+}
+
+static bool uplink_seq_store(uint32_t limit)
+{
+    nvs_handle_t handle;
+    if (nvs_open(UPLINK_NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
+        ESP_LOGW(TAG, "NVS açılamadı, sıra numarası saklanmadı");
+        return false;
+    }
+    esp_err_t err = nvs_set_u32(handle, UPLINK_NVS_KEY_SEQ, limit);
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    return err == ESP_OK;
+}
+
+/* Ayrılmış numaralardan kalan (mutex altında) */
+static uint32_t uplink_seq_remaining(const uplink_conn_t *up)
+{
+    int32_t remaining = (int32_t)(up->seq_limit - up->stats.seq_next);
+    return remaining > 0 ? (uint32_t)remaining : 0;
+}
+
+/* Sıradaki numarayı verir; ayrılmış blok bittiyse false (mutex altında, NVS'ye dokunmaz) */
+static bool uplink_seq_take(uplink_conn_t *up, uint32_t *out_seq)
+{
+    if (uplink_seq_remaining(up) == 0) {
+        return false;
+    }
+    *out_seq = up->stats.seq_next++;
+    if (up->stats.seq_next == 0) {
+        up->stats.seq_next = 1;          // 0 "hiç" anlamında kalsın
+    }
+    return true;
+}
+
+/* Blok yarılanınca sıradakini önceden ayırır (uplink görevi); NVS yazımı mutex dışında */
+static void uplink_seq_reserve_ahead(uplink_conn_t *up)
+{
+    if (!uplink_ack_mode(up)) return;
+
+    uplink_lock(up);
+    bool low = uplink_seq_remaining(up) <= UPLINK_SEQ_RESERVE / 2;
+    uint32_t limit = up->seq_limit + UPLINK_SEQ_RESERVE;
+    uplink_unlock(up);
+    if (!low) return;
+
+    // Yazılamasa da devam: en kötü ihtimalle yeniden başlatmada numaralar tekrarlanır
+    if (!uplink_seq_store(limit)) {
+        ESP_LOGW(TAG, "Sıra sınırı NVS'ye yazılamadı (%lu)", (unsigned long)limit);
+    }
+    uplink_lock(up);
+    up->seq_limit = limit;               // Yalnızca bu görev değiştirir
+    uplink_unlock(up);
+}
+
+/* ---- Birleştirme profili (mutex altında) ---- */
+
+static uplink_batch_profile_t uplink_profile_for(net_mode_t mode)
+{
+    static const uplink_batch_profile_t ethernet = UPLINK_BATCH_PROFILE_ETHERNET;
+    static const uplink_batch_profile_t wifi     = UPLINK_BATCH_PROFILE_WIFI;
+    static const uplink_batch_profile_t gsm      = UPLINK_BATCH_PROFILE_GSM;
+
+    switch (mode) {
+    case NET_MODE_ETHERNET: return ethernet;
+    case NET_MODE_GSM:      return gsm;
+    default:                return wifi;     // AUTO: henüz seçilmedi, orta profil
+    }
+}
+
+/* Bekleme RTT ile ölçeklenir: RTT yüksekse birkaç yüz ms beklemek toplam gecikmeyi az değiştirir */
+static void uplink_apply_hold(uplink_conn_t *up)
+{
+    uint32_t hold = up->stats.srtt_ms * UPLINK_HOLD_RTT_FACTOR;
+    if (hold < up->profile.min_hold_ms) hold = up->profile.min_hold_ms;
+    if (hold > up->profile.max_hold_ms) hold = up->profile.max_hold_ms;
+    up->stats.hold_ms     = (uint16_t)hold;
+    up->stats.batch_bytes = up->profile.max_bytes;
+}
+
+static void uplink_refresh_profile(uplink_conn_t *up)
+{
+    net_mode_t mode = net_manager_get_active_mode();
+    if (up->profile.max_bytes != 0 && mode == up->profile_mode) return;
+
+    up->profile_mode = mode;
+    up->profile      = uplink_profile_for(mode);
+    if (up->profile.max_bytes > UPLINK_QUEUE_BYTES) up->profile.max_bytes = UPLINK_QUEUE_BYTES;
+    if (up->profile.max_frames > UPLINK_QUEUE_FRAMES) up->profile.max_frames = UPLINK_QUEUE_FRAMES;
+    uplink_apply_hold(up);
+}
+
+/* Düzgünleştirilmiş RTT (RFC 6298 ağırlığı: 1/8) */
+static void uplink_rtt_update(uplink_conn_t *up, uint32_t rtt_ms)
+{
+    up->stats.srtt_ms = up->stats.srtt_ms ? (7 * up->stats.srtt_ms + rtt_ms) / 8 : rtt_ms;
+    uplink_apply_hold(up);
+}
+
+static void uplink_record_hold(uplink_conn_t *up, int64_t enqueued_us, int64_t now_us)
+{
+    uint32_t hold_ms = (uint32_t)((now_us - enqueued_us) / 1000);
+    int bucket = 0;
+    while (bucket < UPLINK_HOLD_BUCKETS && hold_ms > s_hold_limits_ms[bucket]) {
+        ++bucket;
+    }
+    up->stats.hold_histogram[bucket]++;
+}
+
+/* ---- Kuyruk (mutex altında) ---- */
+
+/* Henüz yazılmamış kısım: [written_end, queue_len) */
+static uint32_t uplink_written_end(const uplink_conn_t *up)
+{
+    return up->written ? up->frames[up->written - 1].end : 0;
+}
+
+/* Birleştirme eşiği doldu mu (yalnızca yazılmamış satırlar sayılır) */
+static bool uplink_batch_full(const uplink_conn_t *up)
+{
+    return up->queue_len - uplink_written_end(up) >= up->profile.max_bytes ||
+           up->frame_count - up->written >= up->profile.max_frames;
+}
+
+/* Onay kipinde pencere: baştan en fazla ack_window satır yazılabilir */
+static uint32_t uplink_writable_end(const uplink_conn_t *up)
+{
+    if (!uplink_ack_mode(up) || up->frame_count <= up->config.ack_window) {
+        return up->queue_len;
+    }
+    return up->frames[up->config.ack_window - 1].end;
+}
+
+static void uplink_pop_front(uplink_conn_t *up, uint32_t count)
+{
+    if (count == 0) return;
+
+    uint32_t bytes = up->frames[count - 1].end;
+    memmove(up->queue, up->queue + bytes, up->queue_len - bytes);
+    memmove(up->frames, up->frames + count, (up->frame_count - count) * sizeof(up->frames[0]));
+    up->frame_count -= count;
+    up->written     -= count;
+    up->queue_len   -= bytes;
+    up->sent        -= bytes;
+    for (uint32_t i = 0; i < up->frame_count; ++i) {
+        up->frames[i].end -= bytes;
+    }
+    up->stats.queue_frames = up->frame_count;
+    up->stats.queue_bytes  = up->queue_len;
+}
+
+/* n bayt sokete verildi: biten satırlar sayılır; onay kipi dışında kuyruktan çıkar */
+static void uplink_account_written(uplink_conn_t *up, size_t n, int64_t now_us)
+{
+    up->sent += (uint32_t)n;
+    up->stats.writes++;
+    up->stats.segments += (uint32_t)((n + UPLINK_TCP_MSS - 1) / UPLINK_TCP_MSS);
+
+    uint32_t first = up->written;
+    while (up->written < up->frame_count && up->frames[up->written].end <= up->sent) {
+        uplink_frame_t *frame = &up->frames[up->written++];
+        if (!frame->retransmitted) {
+            uplink_record_hold(up, frame->enqueued_us, now_us);
+        }
+        frame->written_us = now_us;
+    }
+    uint32_t done = up->written - first;
+    up->stats.frames += done;
+    up->stats.frames_this_connection += done;
+    if (up->stats.frames_this_connection > up->stats.max_frames_per_connection) {
+        up->stats.max_frames_per_connection = up->stats.frames_this_connection;
+    }
+
+    if (!uplink_ack_mode(up)) {
+        uplink_pop_front(up, up->written);
+        return;
+    }
+    up->stats.inflight = up->written;
+    if (up->written > up->stats.max_inflight) up->stats.max_inflight = up->written;
+}
+
+/* Sunucu seq'e kadar (dahil) onayladı */
+static uint32_t uplink_apply_ack(uplink_conn_t *up, uint32_t seq, int64_t now_us)
+{
+    uint32_t acked = 0;
+    int64_t rtt_written_us = 0;
+    while (acked < up->written && uplink_seq_before_or_equal(up->frames[acked].seq, seq)) {
+        if (!up->frames[acked].retransmitted) {
+            rtt_written_us = up->frames[acked].written_us;
+        }
+        ++acked;
+    }
+    if (acked == 0) return 0;
+
+    uplink_pop_front(up, acked);
+    up->stats.acked += acked;
+    up->stats.inflight = up->written;
+    up->stats.last_ack_seq = seq;
+    if (rtt_written_us) {
+        uplink_rtt_update(up, (uint32_t)((now_us - rtt_written_us) / 1000));
+    }
+    return acked;
+}
+
+/* Bağlantı yok: bekleyen satırlar düşer (SD'de var) */
+static void uplink_drop_front(uplink_conn_t *up, uint32_t count)
+{
+    if (count == 0) return;
+
+    ESP_LOGW(TAG, "%u satır gönderilemedi (yalnızca SD'de)", (unsigned)count);
+    up->stats.dropped_frames += count;
+    if (up->written < count) {
+        up->written = count;              // pop_front yazılmış sayar; yazılmamışlar da düşüyor
+        up->sent    = up->frames[count - 1].end;
+    }
+    uplink_pop_front(up, count);
+    up->stats.inflight = up->written;
+}
+
+/* ------------------------------ Sunucu yanıtı (uplink görevi) ------------------------------ */
+
+/* Bekleyen yanıtları okur, onayları uygular; karşı taraf kapattıysa false */
+static bool uplink_receive(uplink_conn_t *up)
+{
+    for (;;) {
+        int rcv = recv(up->sock, up->rx + up->rx_len, sizeof(up->rx) - up->rx_len, MSG_DONTWAIT);
+        if (rcv == 0) return false;
+        if (rcv < 0) return errno == EAGAIN || errno == EWOULDBLOCK;
+        up->rx_len += (size_t)rcv;
+
+        // Tam satırlar; onay kipi kapalıyken yanıtlar yalnızca boşaltılır
+        size_t start = 0;
+        for (size_t i = 0; i < up->rx_len; ++i) {
+            if (up->rx[i] != '\n') continue;
+            uint32_t seq;
+            if (uplink_ack_mode(up) && data_frame_parse_ack(up->rx + start, i + 1 - start, &seq)) {
+                int64_t now_us = esp_timer_get_time();
+                uplink_lock(up);
+                uint32_t acked = uplink_apply_ack(up, seq, now_us);
+                uplink_unlock(up);
+                if (acked) {
+                    up->ack_progress_us = now_us;
+                    up->ack_timeouts_in_row = 0;
+                }
+            }
+            start = i + 1;
+        }
+        if (start == 0 && up->rx_len == sizeof(up->rx)) {
+            start = up->rx_len;               // Satır sonu yok: çöp, at
+        }
+        memmove(up->rx, up->rx + start, up->rx_len - start);
+        up->rx_len -= start;
+    }
+}
+
+/* ------------------------------ Bağlantı (uplink görevi) ------------------------------ */
+
+static bool uplink_connect(uplink_conn_t *up)
+{
+    int64_t now_us = esp_timer_get_time();
+    uplink_lock(up);
+    bool waiting = now_us < up->next_attempt_us;
+    uplink_unlock(up);
+    if (waiting || !net_manager_is_connected()) {
+        return false;
+    }
+
+    uint32_t generation = net_manager_get_link_generation();
+    int sock = data_sender_connect_nonblocking(up->config.connect_timeout_ms);
+    int64_t done_us = esp_timer_get_time();
+    if (sock < 0) {
+        uplink_lock(up);
+        up->stats.connect_failures++;
+        uplink_schedule_retry(up, done_us);
+        uplink_unlock(up);
+        return false;
+    }
+
+    // Ölü karşı tarafı satır yazılmasa da fark et
+    int one = 1;
+    setsockopt(sock, SOL_SOCKET, SO_KEEPALIVE, &one, sizeof(one));
+    setsockopt(sock, IPPROTO_TCP, TCP_KEEPIDLE, &up->config.keepalive_idle_sec, sizeof(int));
+    setsockopt(sock, IPPROTO_TCP, TCP_KEEPINTVL, &up->config.keepalive_interval_sec, sizeof(int));
+    setsockopt(sock, IPPROTO_TCP, TCP_KEEPCNT, &up->config.keepalive_count, sizeof(int));
+
+    uint32_t connect_ms = (uint32_t)((done_us - now_us) / 1000);
+    up->sock       = sock;
+    up->generation = generation;
+    up->ack_progress_us = done_us;
+
+    uplink_lock(up);
+    // Onay kipi: sunucuya bu bağlantıda beklenecek ilk numara (öncekiler onaylı ya da SD'de)
+    if (uplink_ack_mode(up)) {
+        uint32_t base = up->frame_count ? up->frames[0].seq : up->stats.seq_next;
+        up->hello_len  = data_frame_build_seq_hello(base, up->hello, sizeof(up->hello));
+        up->hello_sent = 0;
+    }
+    up->next_attempt_us = 0;
+    up->stats.backoff_ms = 0;
+    up->stats.connects++;
+    up->stats.frames_this_connection = 0;
+    up->stats.last_connect_ms   = connect_ms;
+    up->stats.total_connect_ms += connect_ms;
+    if (connect_ms > up->stats.max_connect_ms) {
+        up->stats.max_connect_ms = connect_ms;
+    }
+    uplink_rtt_update(up, connect_ms);   // El sıkışma ≈ 1 RTT (ad önbellekte)
+    uplink_unlock(up);
+    ESP_LOGI(TAG, "Sunucuya bağlanıldı (%u ms)", (unsigned)connect_ms);
+    return true;
+}
+
+/* Arayüz değiştiyse ya da sunucu kapattıysa soketi bırakır */
+static void uplink_check_link(uplink_conn_t *up)
+{
+    if (up->sock < 0) return;
+
+    // Arayüz değiştiyse (ETH ↔ Wi-Fi) eski soketin yolu yok: beklemeden yeniden bağlan
+    if (net_manager_get_link_generation() != up->generation) {
+        uplink_lock(up);
+        up->stats.interface_changes++;
+        up->next_attempt_us  = 0;
+        up->stats.backoff_ms = 0;
+        uplink_unlock(up);
+        uplink_disconnect(up, "arayüz değişti");
+        return;
+    }
+    if (!uplink_receive(up)) {
+        uplink_disconnect(up, "sunucu kapattı");
+    }
+}
+
+/* Bağlantı kurulamadı: onay kipinde satırlar sonraki bağlantıyı bekler, değilse düşer */
+static void uplink_connect_failed(uplink_conn_t *up)
+{
+    if (uplink_ack_mode(up)) return;
+
+    uplink_lock(up);
+    uplink_drop_front(up, up->frame_count);
+    uplink_unlock(up);
+}
+
+/* ------------------------------ Yazma (uplink görevi) ------------------------------ */
+
+/* Soket yazılabilir oldukça pencere içindeki satırları yazar; onay beklemez */
+static void uplink_write_pending(uplink_conn_t *up)
+{
+    uplink_check_link(up);
+
+    bool retried = false;
+    int64_t progress_us = esp_timer_get_time();
+    for (;;) {
+        // 1️⃣ Bağlantı yoksa kur
+        if (up->sock < 0 && !uplink_connect(up)) {
+            uplink_connect_failed(up);
+            return;
+        }
+
+        // Üreticiler yalnızca queue_len ötesine yazar: [sent, writable_end) mutex dışında okunabilir
+        const char *data;
+        size_t pending;
+        bool hello = up->hello_sent < up->hello_len;
+        if (hello) {
+            data    = up->hello + up->hello_sent;
+            pending = up->hello_len - up->hello_sent;
+        } else {
+            uplink_lock(up);
+            uint32_t writable_end = uplink_writable_end(up);
+            data    = up->queue + up->sent;
+            pending = writable_end > up->sent ? writable_end - up->sent : 0;
+            if (up->written == 0) up->ack_progress_us = progress_us;   // Yoldaki ilk satır
+            uplink_unlock(up);
+        }
+        if (pending == 0) return;
+
+        // 2️⃣ Yazılabilirlik ve sunucu yanıtı (onay ya da kapatma) birlikte beklenir
+        fd_set read_set, write_set;
+        FD_ZERO(&read_set);
+        FD_ZERO(&write_set);
+        FD_SET(up->sock, &read_set);
+        FD_SET(up->sock, &write_set);
+        struct timeval timeout = { .tv_sec = 0, .tv_usec = UPLINK_SELECT_MS * 1000 };
+        int ready = select(up->sock + 1, &read_set, &write_set, NULL, &timeout);
+
+        const char *failure = NULL;
+        int64_t now_us = esp_timer_get_time();
+        if (ready < 0) {
+            failure = "select hatası";
+        } else if (ready == 0) {
+            if (now_us - progress_us >= (int64_t)up->config.write_stall_ms * 1000) {
+                uplink_lock(up);
+                up->stats.write_stalls++;
+                uplink_unlock(up);
+                failure = "yazma zaman aşımı";
+            }
+        } else if (FD_ISSET(up->sock, &read_set)) {
+            // Onay kuyruğu kaydırmış olabilir: data/pending bir sonraki turda yeniden alınır
+            if (!uplink_receive(up)) {
+                failure = "sunucu kapattı";
+            }
+        } else if (FD_ISSET(up->sock, &write_set)) {
+            ssize_t written = send(up->sock, data, pending, MSG_DONTWAIT);
+            if (written > 0) {
+                progress_us = now_us;
+                if (hello) {
+                    up->hello_sent += (size_t)written;
+                } else {
+                    uplink_lock(up);
+                    uplink_account_written(up, (size_t)written, now_us);
+                    uplink_unlock(up);
+                }
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                ESP_LOGE(TAG, "send failed (errno=%d)", errno);
+                failure = "yazma hatası";
+            }
+        }
+        if (!failure) continue;
+
+        // 3️⃣ Bağlantı az önce sağlamdı: bir kez hemen yeni bağlantıyla
+        uplink_disconnect(up, failure);
+        if (retried) {
+            uplink_lock(up);
+            uplink_schedule_retry(up, esp_timer_get_time());
+            uplink_unlock(up);
+            uplink_connect_failed(up);
+            return;
+        }
+        retried = true;
+        progress_us = esp_timer_get_time();
+    }
+}
+
+/* Onay kipi: yoldaki satırlar için sunucu yanıtını en fazla wait_ms bekler */
+static void uplink_wait_ack(uplink_conn_t *up, uint32_t wait_ms)
+{
+    if (wait_ms > UPLINK_ACK_POLL_MS) wait_ms = UPLINK_ACK_POLL_MS;
+
+    fd_set read_set;
+    FD_ZERO(&read_set);
+    FD_SET(up->sock, &read_set);
+    struct timeval timeout = { .tv_sec = 0, .tv_usec = (long)wait_ms * 1000 };
+    if (select(up->sock + 1, &read_set, NULL, NULL, &timeout) > 0 && !uplink_receive(up)) {
+        uplink_disconnect(up, "sunucu kapattı");
+        return;
+    }
+    if (esp_timer_get_time() - up->ack_progress_us < (int64_t)up->config.ack_timeout_ms * 1000) {
+        return;
+    }
+
+    // Onay gelmedi: yeni bağlantıda yeniden gönder; sunucu hiç onaylamıyorsa vazgeç
+    uplink_lock(up);
+    up->stats.ack_timeouts++;
+    uplink_unlock(up);
+    uplink_disconnect(up, "onay zaman aşımı");
+    if (++up->ack_timeouts_in_row >= UPLINK_ACK_MAX_TIMEOUTS) {
+        ESP_LOGE(TAG, "Sunucu %u denemedir onay vermiyor", (unsigned)up->ack_timeouts_in_row);
+        uplink_lock(up);
+        uplink_drop_front(up, up->frame_count < up->config.ack_window ? up->frame_count : up->config.ack_window);
+        uplink_unlock(up);
+        up->ack_timeouts_in_row = 0;
+    }
+}
+
+static void uplink_task(void *param)
+{
+    uplink_conn_t *up = param;
+
+    for (;;) {
+        uplink_seq_reserve_ahead(up);
+
+        // 1️⃣ Yazma zamanı mı: eşik doldu, yazılmamış ilk satırın beklemesi bitti ya da istendi
+        uint32_t wait_ms = UPLINK_IDLE_CHECK_MS;
+        bool due = false;
+        uplink_lock(up);
+        uplink_refresh_profile(up);
+        bool close_requested = up->close_requested;
+        up->close_requested = false;
+        bool inflight = up->written > 0;
+        if (up->written < up->frame_count && uplink_writable_end(up) > uplink_written_end(up)) {
+            int64_t remaining_us = up->frames[up->written].enqueued_us + (int64_t)up->stats.hold_ms * 1000 -
+                                   esp_timer_get_time();
+            due = !up->config.coalesce || up->flush_requested || close_requested ||
+                  uplink_batch_full(up) || remaining_us <= 0;
+            if (!due && remaining_us < (int64_t)UPLINK_IDLE_CHECK_MS * 1000) {
+                wait_ms = (uint32_t)((remaining_us + 999) / 1000);
+            }
+        }
+        up->flush_requested = false;
+        uplink_unlock(up);
+
+        // 2️⃣ Yaz; boştayken yalnızca bağlantının sağlığına bak
+        if (due) {
+            uplink_write_pending(up);
+        } else {
+            uplink_check_link(up);
+        }
+        if (close_requested) {
+            uplink_disconnect(up, "istek");
+        }
+        if (due && up->sock >= 0) continue;
+
+        // 3️⃣ Yazılacak yok (ya da geri çekilme): onay bekleniyorsa soket, değilse üreticiler beklenir
+        if (inflight && up->sock >= 0) {
+            uplink_wait_ack(up, wait_ms);
+        } else {
+            TickType_t wait = pdMS_TO_TICKS(wait_ms);
+            ulTaskNotifyTake(pdTRUE, wait ? wait : 1);
+        }
+    }
+}
+
+/* ------------------------------ Dışarıya Açık API ------------------------------ */
+
+bool uplink_conn_init(const uplink_conn_config_t *config)
+{
+    if (s_uplink.mutex) {
+        return true;
+    }
+    const uplink_conn_config_t default_config = UPLINK_CONN_DEFAULT_CONFIG();
+    s_uplink.config = config ? *config : default_config;
+    if (s_uplink.config.backoff_min_ms == 0 ||
+        s_uplink.config.backoff_max_ms < s_uplink.config.backoff_min_ms) {
+        ESP_LOGE(TAG, "Geçersiz geri çekilme aralığı");
+        return false;
+    }
+    if (s_uplink.config.ack_window > UPLINK_QUEUE_FRAMES) {
+        s_uplink.config.ack_window = UPLINK_QUEUE_FRAMES;
+    }
+
+    // Yeniden başlatmada numaralar geri gitmez: son ayrılan sınırdan devam
+    if (uplink_ack_mode(&s_uplink)) {
+        uint32_t limit = uplink_seq_load();
+        s_uplink.stats.seq_next = limit ? limit : 1;
+        s_uplink.seq_limit      = s_uplink.stats.seq_next + UPLINK_SEQ_RESERVE;
+        if (!uplink_seq_store(s_uplink.seq_limit)) {
+            ESP_LOGW(TAG, "Sıra sınırı NVS'ye yazılamadı");
+        }
+        ESP_LOGI(TAG, "Onay kipi: pencere %u satır, ilk numara %lu",
+                 (unsigned)s_uplink.config.ack_window, (unsigned long)s_uplink.stats.seq_next);
+    }
+
+    s_uplink.sock  = -1;
+    s_uplink.mutex = xSemaphoreCreateMutex();
+    if (!s_uplink.mutex) {
+        ESP_LOGE(TAG, "Mutex oluşturulamadı");
+        return false;
+    }
+    uplink_refresh_profile(&s_uplink);
+
+    if (xTaskCreate(uplink_task, UPLINK_TASK_NAME, UPLINK_TASK_STACK_BYTES,
+                    &s_uplink, UPLINK_TASK_PRIORITY, &s_uplink.task) != pdPASS) {
+        ESP_LOGE(TAG, "Gönderim görevi oluşturulamadı");
+        vSemaphoreDelete(s_uplink.mutex);
+        s_uplink.mutex = NULL;
+        s_uplink.task  = NULL;
+        return false;
+    }
+    return true;
+}
+
+bool uplink_conn_is_ready(void)
+{
+    return s_uplink.mutex != NULL && s_uplink.task != NULL;
+}
+
+bool uplink_conn_send(const char *frame, size_t length)
+{
+    if (!uplink_conn_is_ready() || !frame || length == 0) return false;
+    if (!net_manager_is_connected()) return false;
+
+    uplink_conn_t *up = &s_uplink;
+    int64_t now_us = esp_timer_get_time();
+    size_t prefix_room = uplink_ack_mode(up) ? DATA_FRAME_SEQ_PREFIX_BYTES : 0;
+    bool ok = false, wake = false;
+
+    uint32_t seq = 0;
+    uplink_lock(up);
+    if (now_us < up->next_attempt_us) {
+        up->stats.backoff_skips++;
+    } else if (up->queue_len + prefix_room + length > UPLINK_QUEUE_BYTES ||
+               up->frame_count >= UPLINK_QUEUE_FRAMES) {
+        up->stats.queue_full++;
+    } else if (uplink_ack_mode(up) && !uplink_seq_take(up, &seq)) {
+        // Görev yeni bloğu henüz ayıramadı (NVS yavaş): numarasız satır gönderilmez
+        up->stats.seq_exhausted++;
+        wake = true;
+    } else {
+        uplink_frame_t *slot = &up->frames[up->frame_count++];
+        *slot = (uplink_frame_t){ .enqueued_us = now_us, .seq = seq };
+        if (uplink_ack_mode(up)) {
+            up->queue_len += (uint32_t)data_frame_build_seq_prefix(slot->seq, up->queue + up->queue_len,
+                                                                   DATA_FRAME_SEQ_PREFIX_BYTES);
+        }
+        memcpy(up->queue + up->queue_len, frame, length);
+        up->queue_len += (uint32_t)length;
+        slot->end = up->queue_len;
+
+        up->stats.queue_frames = up->frame_count;
+        up->stats.queue_bytes  = up->queue_len;
+        if (up->frame_count > up->stats.peak_queue_frames) up->stats.peak_queue_frames = up->frame_count;
+        if (up->queue_len > up->stats.peak_queue_bytes) up->stats.peak_queue_bytes = up->queue_len;
+
+        // Görev yalnızca bekleme süresini başlatmak ya da eşik dolunca uyandırılır
+        wake = up->frame_count - up->written == 1 || !up->config.coalesce || uplink_batch_full(up) ||
+               (uplink_ack_mode(up) && uplink_seq_remaining(up) == UPLINK_SEQ_RESERVE / 2);
+        ok = true;
+    }
+    uplink_unlock(up);
+
+    if (wake) {
+        xTaskNotifyGive(up->task);
+    }
+    return ok;
+}
+
+bool uplink_conn_flush(void)
+{
+    if (!uplink_conn_is_ready()) return false;
+
+    uplink_lock(&s_uplink);
+    s_uplink.flush_requested = true;
+    uplink_unlock(&s_uplink);
+    xTaskNotifyGive(s_uplink.task);
+    return true;
+}
+
+void uplink_conn_close(void)
+{
+    if (!uplink_conn_is_ready()) return;
+
+    uplink_lock(&s_uplink);
+    s_uplink.close_requested = true;
+    uplink_unlock(&s_uplink);
+    xTaskNotifyGive(s_uplink.task);
+}
+
+void uplink_conn_get_stats(uplink_conn_stats_t *out_stats)
+{
+    if (!out_stats) return;
+    if (!s_uplink.mutex) {
+        *out_stats = s_uplink.stats;
+        return;
+    }
+    uplink_lock(&s_uplink);
+    *out_stats = s_uplink.stats;
+    uplink_unlock(&s_uplink);
+}
+
+uint32_t uplink_conn_hold_percentile(const uplink_conn_stats_t *stats, unsigned percent)
+{
+    if (!stats) return 0;
+
+    uint64_t total = 0;
+    for (int i = 0; i <= UPLINK_HOLD_BUCKETS; ++i) {
+        total += stats->hold_histogram[i];
+    }
+    if (total == 0) return 0;
+
+    uint64_t target = (total * percent + 99) / 100, seen = 0;
+    if (target == 0) target = 1;
+    for (int i = 0; i < UPLINK_HOLD_BUCKETS; ++i) {
+        seen += stats->hold_histogram[i];
+        if (seen >= target) return s_hold_limits_ms[i];
+    }
+    return UINT32_MAX;
+}
+
+void uplink_conn_rtt_sample(uint32_t rtt_ms)
+{
+    if (!s_uplink.mutex) return;
+
+    uplink_lock(&s_uplink);
+    uplink_rtt_update(&s_uplink, rtt_ms);
+    uplink_unlock(&s_uplink);
+}
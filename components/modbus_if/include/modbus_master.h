@@ -0,0 +1,124 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "modbus_rtu.h"
+
+/*
+ * Modbus RTU master: okuma noktaları → birleştirilmiş bloklar → periyodik tarama.
+ *
+ * - Aynı slave + fonksiyon için bitişik (ya da küçük boşluklu) register'lar
+ *   tek isteğe birleştirilir (en fazla MODBUS_MAX_READ_REGISTERS).
+ * - Tarama mutlak zamanla planlanır (next += period): gecikme birikmez,
+ *   kaçırılan turlar atlanıp sayılır.
+ * - Bloklar arka arkaya gönderilir; yanıt beklenen uzunlukta gelince
+ *   yalnızca t3.5 sessizlik beklenip sıradaki istek çıkar.
+ *
+ * Her tur sonunda noktalar sırasıyla kanal değerleri olarak verilir
+ * (okunamayan nokta NaN).
+ */
+
+#define MODBUS_MASTER_MAX_POINTS   (32)
+#define MODBUS_MASTER_MAX_BLOCKS   (16)
+
+/* Art arda bu kadar tur yanıt vermeyen blok "çevrimdışı" sayılır ve yalnızca
+ * her MODBUS_MASTER_OFFLINE_PROBE_CYCLES turda bir (tekrarsız) yoklanır:
+ * kopuk bir slave'in zaman aşımları diğerlerinin tur süresini yemesin. */
+#define MODBUS_MASTER_OFFLINE_FAILURES      (3)
+#define MODBUS_MASTER_OFFLINE_PROBE_CYCLES  (10)
+
+typedef enum {
+    MODBUS_VALUE_U16 = 0,
+    MODBUS_VALUE_S16,
+    MODBUS_VALUE_U32,
+    MODBUS_VALUE_S32,
+    MODBUS_VALUE_F32,
+} modbus_value_type_t;
+
+/* 32 bit değerlerde register sırası */
+typedef enum {
+    MODBUS_WORD_ORDER_HIGH_FIRST = 0,   /* ABCD */
+    MODBUS_WORD_ORDER_LOW_FIRST,        /* CDAB */
+} modbus_word_order_t;
+
+/** Bir kanal = bir okuma noktası; değer = ham * scale + offset */
+typedef struct {
+    uint8_t             slave;
+    uint8_t             function;     /* MODBUS_FC_READ_HOLDING/INPUT_REGISTERS */
+    uint16_t            address;
+    modbus_value_type_t type;
+    modbus_word_order_t word_order;
+    float               scale;
+    float               offset;
+} modbus_point_t;
+
+typedef struct {
+    uint32_t period_ms;        /* Tarama periyodu */
+    uint32_t timeout_ms;       /* Yanıt zaman aşımı */
+    uint32_t baud_rate;        /* t3.5 hesabı için */
+    uint16_t max_gap;          /* Birleştirmede atlanabilecek en fazla register */
+    uint8_t  retries;          /* Blok başına tekrar */
+} modbus_master_config_t;
+
+#define MODBUS_MASTER_DEFAULT_CONFIG()  \
+    {                                   \
+        .period_ms  = 1000,             \
+        .timeout_ms = 200,              \
+        .baud_rate  = 9600,             \
+        .max_gap    = 8,                \
+        .retries    = 1,                \
+    }
+
+typedef struct {
+    uint8_t  slave;
+    uint8_t  function;
+    uint16_t start;
+    uint16_t count;
+    uint32_t failures;      /* Art arda başarısız tur */
+} modbus_block_t;
+
+typedef struct {
+    uint32_t cycles;
+    uint32_t overruns;         /* Periyoda sığmadığı için atlanan tur */
+    uint32_t requests;
+    uint32_t responses;
+    uint32_t timeouts;
+    uint32_t crc_errors;
+    uint32_t exceptions;
+    uint32_t frame_errors;
+    uint32_t offline_skips;    /* Çevrimdışı blok için atlanan istek */
+    uint32_t last_cycle_us;
+    uint32_t max_cycle_us;
+} modbus_master_stats_t;
+
+typedef struct {
+    modbus_master_config_t config;
+    const modbus_port_t   *port;
+
+    modbus_point_t  points[MODBUS_MASTER_MAX_POINTS];
+    uint8_t         point_count;
+    uint8_t         point_block[MODBUS_MASTER_MAX_POINTS];    /* Noktanın bloğu */
+    uint16_t        point_offset[MODBUS_MASTER_MAX_POINTS];   /* Blok içi register */
+
+    modbus_block_t  blocks[MODBUS_MASTER_MAX_BLOCKS];
+    uint8_t         block_count;
+
+    bool            scheduled;        /* İlk tur zamanı belirlendi */
+    int64_t         next_cycle_us;
+    int64_t         last_frame_end_us;
+    modbus_master_stats_t stats;
+} modbus_master_t;
+
+/**
+ * Noktaları kopyalar ve istek bloklarını oluşturur.
+ * @return false  Geçersiz nokta ya da blok sınırı aşıldı
+ */
+bool modbus_master_init(modbus_master_t *master, const modbus_master_config_t *config,
+                        const modbus_port_t *port, const modbus_point_t *points, size_t point_count);
+
+/**
+ * Sıradaki tur zamanına kadar uyur, tüm blokları okur ve kanal değerlerini yazar.
+ * @param out_values   point_count adet (okunamayan nokta NaN)
+ * @return Okunabilen nokta sayısı
+ */
+size_t modbus_master_poll(modbus_master_t *master, float *out_values);
@@ -0,0 +1,48 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include "modbus_rtu.h"
+
+#ifdef ESP_PLATFORM
+#include "driver/uart.h"
+
+/** RS-485 (yarı çift yönlü, DE = RTS pini) Modbus hattı */
+typedef struct {
+    uart_port_t uart_port;
+    int         tx_gpio;
+    int         rx_gpio;
+    int         de_gpio;      /* Sürücü yönlendirme (RTS), UART_PIN_NO_CHANGE = yok */
+    int         baud_rate;
+} modbus_uart_config_t;
+
+/* Kartın boş pinleri: UART2, TX=39, RX=40, DE=41 */
+#define MODBUS_UART_DEFAULT_CONFIG()      \
+    {                                     \
+        .uart_port = UART_NUM_2,          \
+        .tx_gpio   = 39,                  \
+        .rx_gpio   = 40,                  \
+        .de_gpio   = 41,                  \
+        .baud_rate = 9600,                \
+    }
+
+typedef struct {
+    modbus_port_t        port;
+    modbus_uart_config_t config;
+} modbus_uart_port_t;
+
+/** UART sürücüsünü RS-485 modunda kurar ve port fonksiyonlarını bağlar. */
+bool modbus_port_uart_init(modbus_uart_port_t *uart_port, const modbus_uart_config_t *config);
+
+#else
+
+/** Linux: gerçek seri port ya da pty (ör. socat ile açılan slave simülatörü) */
+typedef struct {
+    modbus_port_t port;
+    int           fd;
+} modbus_posix_port_t;
+
+/** tty/pty'yi ham modda açar (8N1, baud_rate). */
+bool modbus_port_posix_open(modbus_posix_port_t *posix_port, const char *device_path, uint32_t baud_rate);
+void modbus_port_posix_close(modbus_posix_port_t *posix_port);
+
+#endif
@@ -0,0 +1,63 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Modbus RTU çerçeve katmanı (FreeRTOS/ESP bağımlılığı yok, host'ta da derlenir).
+ *
+ * İstek : [slave][fc][adres hi][adres lo][adet hi][adet lo][crc lo][crc hi]
+ * Yanıt : [slave][fc][bayt sayısı][veri ...][crc lo][crc hi]
+ * Hata  : [slave][fc | 0x80][istisna kodu][crc lo][crc hi]
+ */
+
+#define MODBUS_FC_READ_HOLDING_REGISTERS  (0x03)
+#define MODBUS_FC_READ_INPUT_REGISTERS    (0x04)
+#define MODBUS_FC_EXCEPTION_FLAG          (0x80)
+
+#define MODBUS_MAX_READ_REGISTERS         (125)
+#define MODBUS_REQUEST_BYTES              (8)
+#define MODBUS_MAX_ADU_BYTES              (256)
+#define MODBUS_EXCEPTION_RESPONSE_BYTES   (5)
+
+typedef enum {
+    MODBUS_OK = 0,
+    MODBUS_ERR_TIMEOUT,
+    MODBUS_ERR_CRC,
+    MODBUS_ERR_EXCEPTION,
+    MODBUS_ERR_FRAME,          /* Beklenmeyen slave/fc/uzunluk */
+    MODBUS_ERR_IO,
+} modbus_result_t;
+
+/**
+ * Platform bağlantısı: UART (cihaz) ya da tty/pty (Linux).
+ * read() istenen baytların tamamı gelene ya da süre dolana kadar bekler.
+ */
+typedef struct {
+    void   *context;
+    int     (*write)(void *context, const uint8_t *bytes, size_t length);
+    int     (*read)(void *context, uint8_t *bytes, size_t length, uint32_t timeout_ms);
+    void    (*flush_input)(void *context);
+    int64_t (*now_us)(void *context);
+    void    (*sleep_until_us)(void *context, int64_t deadline_us);
+} modbus_port_t;
+
+uint16_t modbus_crc16(const uint8_t *bytes, size_t length);
+
+/** FC03/FC04 okuma isteği üretir (MODBUS_REQUEST_BYTES bayt). */
+size_t modbus_build_read_request(uint8_t *out, uint8_t slave, uint8_t function,
+                                 uint16_t address, uint16_t count);
+
+/** Karakter süresine göre çerçeveler arası sessizlik (t3.5, en az 1750 us). */
+uint32_t modbus_frame_gap_us(uint32_t baud_rate);
+
+/**
+ * İsteği gönderir ve yanıtı (beklenen uzunluk kadar, zaman aşımı beklemeden) okur.
+ * @param out_registers  count adet register (host sırasında)
+ * @param out_exception  MODBUS_ERR_EXCEPTION ise istisna kodu
+ */
+modbus_result_t modbus_read_registers(const modbus_port_t *port, uint8_t slave, uint8_t function,
+                                      uint16_t address, uint16_t count, uint32_t timeout_ms,
+                                      uint16_t *out_registers, uint8_t *out_exception);
+
+const char *modbus_result_name(modbus_result_t result);
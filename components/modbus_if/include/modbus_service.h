@@ -0,0 +1,29 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "modbus_master.h"
+#include "modbus_port.h"
+
+/**
+ * Modbus RTU hattını telemetri hattına bağlar.
+ *  - Kendi görevinde modbus_master_poll ile periyodik tarama yapar.
+ *  - Her tur, noktalar sırasıyla kanal olacak şekilde HD32MT normalize
+ *    kaydına çevrilip telemetri halkasına yazılır; parse/gönder/SD yolu
+ *    HD32MT kayıtlarıyla ortaktır.
+ *
+ * telemetry_service_start* çağrısından sonra başlatılmalıdır.
+ */
+
+typedef struct {
+    uint8_t                 instrument_id;   /* HD32MT kimlikleriyle çakışmamalı */
+    modbus_uart_config_t    uart;
+    modbus_master_config_t  master;
+    const modbus_point_t   *points;          /* Kanal sırası = nokta sırası */
+    size_t                  point_count;     /* 1..MODBUS_MASTER_MAX_POINTS */
+} modbus_service_config_t;
+
+bool modbus_service_start(const modbus_service_config_t *config);
+
+/** Son tur istatistikleri (servis çalışmıyorsa false) */
+bool modbus_service_get_stats(modbus_master_stats_t *out_stats);
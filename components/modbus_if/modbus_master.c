@@ -0,0 +1,212 @@
+#include "modbus_master.h"
+
+#include <math.h>
+#include <string.h>
+
+/* ------------------------------- Yardımcı Fonksiyonlar ------------------------------- */
+
+static inline uint16_t point_width(const modbus_point_t *point)
+{
+    return (point->type == MODBUS_VALUE_U16 || point->type == MODBUS_VALUE_S16) ? 1 : 2;
+}
+
+/* (slave, fonksiyon, adres) sırası: birleştirme için */
+static int compare_points(const modbus_point_t *a, const modbus_point_t *b)
+{
+    if (a->slave != b->slave) return (int)a->slave - (int)b->slave;
+    if (a->function != b->function) return (int)a->function - (int)b->function;
+    return (int)a->address - (int)b->address;
+}
+
+static bool build_blocks(modbus_master_t *master)
+{
+    /* Nokta sayısı küçük: ekleme sıralaması yeterli */
+    uint8_t order[MODBUS_MASTER_MAX_POINTS];
+    for (uint8_t i = 0; i < master->point_count; ++i) {
+        uint8_t j = i;
+        while (j > 0 && compare_points(&master->points[order[j - 1]], &master->points[i]) > 0) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    master->block_count = 0;
+    modbus_block_t *block = NULL;
+    for (uint8_t k = 0; k < master->point_count; ++k) {
+        const modbus_point_t *point = &master->points[order[k]];
+        uint16_t width = point_width(point);
+        uint32_t point_end = (uint32_t)point->address + width;
+
+        bool fits = block &&
+                    block->slave == point->slave &&
+                    block->function == point->function &&
+                    point->address <= (uint32_t)block->start + block->count + master->config.max_gap &&
+                    point_end - block->start <= MODBUS_MAX_READ_REGISTERS;
+        if (!fits) {
+            if (master->block_count >= MODBUS_MASTER_MAX_BLOCKS) {
+                return false;
+            }
+            block = &master->blocks[master->block_count++];
+            memset(block, 0, sizeof(*block));
+            block->slave    = point->slave;
+            block->function = point->function;
+            block->start    = point->address;
+        }
+        if (point_end - block->start > block->count) {
+            block->count = (uint16_t)(point_end - block->start);
+        }
+        master->point_block[order[k]]  = (uint8_t)(block - master->blocks);
+        master->point_offset[order[k]] = (uint16_t)(point->address - block->start);
+    }
+    return true;
+}
+
+static float decode_point(const modbus_point_t *point, const uint16_t *registers)
+{
+    uint32_t raw32 = 0;
+    if (point_width(point) == 2) {
+        uint16_t high = point->word_order == MODBUS_WORD_ORDER_HIGH_FIRST ? registers[0] : registers[1];
+        uint16_t low  = point->word_order == MODBUS_WORD_ORDER_HIGH_FIRST ? registers[1] : registers[0];
+        raw32 = ((uint32_t)high << 16) | low;
+    }
+
+    float value;
+    switch (point->type) {
+    case MODBUS_VALUE_U16: value = (float)registers[0]; break;
+    case MODBUS_VALUE_S16: value = (float)(int16_t)registers[0]; break;
+    case MODBUS_VALUE_U32: value = (float)raw32; break;
+    case MODBUS_VALUE_S32: value = (float)(int32_t)raw32; break;
+    case MODBUS_VALUE_F32: memcpy(&value, &raw32, sizeof(value)); break;
+    default:               return NAN;
+    }
+    return value * point->scale + point->offset;
+}
+
+static void count_result(modbus_master_t *master, modbus_result_t result)
+{
+    switch (result) {
+    case MODBUS_OK:            master->stats.responses++;    break;
+    case MODBUS_ERR_TIMEOUT:   master->stats.timeouts++;     break;
+    case MODBUS_ERR_CRC:       master->stats.crc_errors++;   break;
+    case MODBUS_ERR_EXCEPTION: master->stats.exceptions++;   break;
+    default:                   master->stats.frame_errors++; break;
+    }
+}
+
+/* Bloğu okur (tekrarlarla); t3.5 sessizlik önceki çerçevenin bitişinden sayılır */
+static bool read_block(modbus_master_t *master, modbus_block_t *block, uint16_t *registers)
+{
+    const modbus_port_t *port = master->port;
+    const uint32_t gap_us = modbus_frame_gap_us(master->config.baud_rate);
+
+    uint8_t retries = master->config.retries;
+    if (block->failures >= MODBUS_MASTER_OFFLINE_FAILURES) {
+        if ((master->stats.cycles % MODBUS_MASTER_OFFLINE_PROBE_CYCLES) != 0) {
+            master->stats.offline_skips++;
+            return false;
+        }
+        retries = 0;
+    }
+
+    for (uint8_t attempt = 0; attempt <= retries; ++attempt) {
+        /* Önceki çerçeve bittikten sonra t3.5 sessizlik */
+        port->sleep_until_us(port->context, master->last_frame_end_us + gap_us);
+
+        uint8_t exception = 0;
+        master->stats.requests++;
+        modbus_result_t result = modbus_read_registers(port, block->slave, block->function,
+                                                       block->start, block->count,
+                                                       master->config.timeout_ms,
+                                                       registers, &exception);
+        master->last_frame_end_us = port->now_us(port->context);
+        count_result(master, result);
+
+        if (result == MODBUS_OK) {
+            block->failures = 0;
+            return true;
+        }
+        /* İstisna kalıcıdır (yanlış adres vb.): tekrar etme */
+        if (result == MODBUS_ERR_EXCEPTION) {
+            break;
+        }
+    }
+    block->failures++;
+    return false;
+}
+
+/* ------------------------------ Dışarıya Açık API ------------------------------ */
+
+bool modbus_master_init(modbus_master_t *master, const modbus_master_config_t *config,
+                        const modbus_port_t *port, const modbus_point_t *points, size_t point_count)
+{
+    if (!master || !config || !port || !points ||
+        point_count == 0 || point_count > MODBUS_MASTER_MAX_POINTS || config->period_ms == 0) {
+        return false;
+    }
+    memset(master, 0, sizeof(*master));
+    master->config = *config;
+    master->port   = port;
+
+    for (size_t i = 0; i < point_count; ++i) {
+        const modbus_point_t *point = &points[i];
+        if (point->function != MODBUS_FC_READ_HOLDING_REGISTERS &&
+            point->function != MODBUS_FC_READ_INPUT_REGISTERS) {
+            return false;
+        }
+        master->points[i] = *point;
+        if (master->points[i].scale == 0.0f) {
+            master->points[i].scale = 1.0f;
+        }
+    }
+    master->point_count = (uint8_t)point_count;
+    return build_blocks(master);
+}
+
+size_t modbus_master_poll(modbus_master_t *master, float *out_values)
+{
+    const modbus_port_t *port = master->port;
+    const int64_t period_us = (int64_t)master->config.period_ms * 1000;
+    int64_t now_us = port->now_us(port->context);
+
+    /* Mutlak zaman planı: tur süresi ne olursa olsun faz kaymaz */
+    if (!master->scheduled) {
+        master->scheduled     = true;
+        master->next_cycle_us = now_us;
+    } else {
+        master->next_cycle_us += period_us;
+        if (now_us > master->next_cycle_us + period_us) {
+            int64_t skipped = (now_us - master->next_cycle_us) / period_us;
+            master->stats.overruns += (uint32_t)skipped;
+            master->next_cycle_us += skipped * period_us;
+        }
+    }
+    port->sleep_until_us(port->context, master->next_cycle_us);
+    int64_t cycle_start_us = port->now_us(port->context);
+
+    for (uint8_t p = 0; p < master->point_count; ++p) {
+        out_values[p] = NAN;
+    }
+
+    size_t valid = 0;
+    uint16_t registers[MODBUS_MAX_READ_REGISTERS];
+    for (uint8_t b = 0; b < master->block_count; ++b) {
+        if (!read_block(master, &master->blocks[b], registers)) {
+            continue;
+        }
+        for (uint8_t p = 0; p < master->point_count; ++p) {
+            if (master->point_block[p] == b) {
+                out_values[p] = decode_point(&master->points[p], &registers[master->point_offset[p]]);
+                valid++;
+            }
+        }
+    }
+
+    uint32_t cycle_us = (uint32_t)(port->now_us(port->context) - cycle_start_us);
+    master->stats.cycles++;
+    master->stats.last_cycle_us = cycle_us;
+    if (cycle_us > master->stats.max_cycle_us) {
+        master->stats.max_cycle_us = cycle_us;
+    }
+    return valid;
+}
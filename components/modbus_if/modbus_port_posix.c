@@ -0,0 +1,152 @@
+/*
+ * Linux host portu: IDF derlemesine girmez (bileşen CMakeLists'inde yok).
+ * host_test/modbus_pty_test bu dosyayı modbus_rtu.c ve modbus_master.c ile
+ * derler ve posix_openpt ile açılan pty çiftinin diğer ucundaki slave
+ * simülatörüne karşı çalıştırır.
+ */
+#ifndef ESP_PLATFORM
+
+#define _DEFAULT_SOURCE
+#include "modbus_port.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/* ------------------------------- Yardımcı Fonksiyonlar ------------------------------- */
+
+static speed_t to_speed(uint32_t baud_rate)
+{
+    switch (baud_rate) {
+    case 1200:   return B1200;
+    case 2400:   return B2400;
+    case 4800:   return B4800;
+    case 19200:  return B19200;
+    case 38400:  return B38400;
+    case 57600:  return B57600;
+    case 115200: return B115200;
+    default:     return B9600;
+    }
+}
+
+static int64_t monotonic_us(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+/* ------------------------------- Port Fonksiyonları ------------------------------- */
+
+static int posix_port_write(void *context, const uint8_t *bytes, size_t length)
+{
+    modbus_posix_port_t *posix_port = (modbus_posix_port_t *)context;
+    size_t written = 0;
+    while (written < length) {
+        ssize_t n = write(posix_port->fd, bytes + written, length - written);
+        if (n < 0) {
+            if (errno == EINTR || errno == EAGAIN) continue;
+            return -1;
+        }
+        written += (size_t)n;
+    }
+    tcdrain(posix_port->fd);
+    return (int)written;
+}
+
+static int posix_port_read(void *context, uint8_t *bytes, size_t length, uint32_t timeout_ms)
+{
+    modbus_posix_port_t *posix_port = (modbus_posix_port_t *)context;
+    int64_t deadline_us = monotonic_us() + (int64_t)timeout_ms * 1000;
+    size_t received = 0;
+
+    while (received < length) {
+        int64_t remaining_us = deadline_us - monotonic_us();
+        if (remaining_us <= 0) break;
+
+        struct pollfd pfd = { .fd = posix_port->fd, .events = POLLIN };
+        int ready = poll(&pfd, 1, (int)((remaining_us + 999) / 1000));
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready <= 0) break;
+
+        ssize_t n = read(posix_port->fd, bytes + received, length - received);
+        if (n < 0) {
+            if (errno == EINTR || errno == EAGAIN) continue;
+            return -1;
+        }
+        received += (size_t)n;
+    }
+    return (int)received;
+}
+
+static void posix_port_flush_input(void *context)
+{
+    modbus_posix_port_t *posix_port = (modbus_posix_port_t *)context;
+    tcflush(posix_port->fd, TCIFLUSH);
+}
+
+static int64_t posix_port_now_us(void *context)
+{
+    (void)context;
+    return monotonic_us();
+}
+
+static void posix_port_sleep_until_us(void *context, int64_t deadline_us)
+{
+    (void)context;
+    int64_t remaining_us = deadline_us - monotonic_us();
+    if (remaining_us > 0) {
+        struct timespec delay = {
+            .tv_sec  = remaining_us / 1000000,
+            .tv_nsec = (remaining_us % 1000000) * 1000,
+        };
+        while (nanosleep(&delay, &delay) != 0 && errno == EINTR) {
+        }
+    }
+}
+
+/* ------------------------------------ Kurulum ------------------------------------ */
+
+bool modbus_port_posix_open(modbus_posix_port_t *posix_port, const char *device_path, uint32_t baud_rate)
+{
+    if (!posix_port || !device_path) return false;
+
+    posix_port->fd = open(device_path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (posix_port->fd < 0) {
+        return false;
+    }
+
+    struct termios tty;
+    if (tcgetattr(posix_port->fd, &tty) == 0) {
+        cfmakeraw(&tty);
+        cfsetispeed(&tty, to_speed(baud_rate));
+        cfsetospeed(&tty, to_speed(baud_rate));
+        tty.c_cflag |= CLOCAL | CREAD;
+        tty.c_cflag &= ~(CSTOPB | PARENB);
+        tcsetattr(posix_port->fd, TCSANOW, &tty);
+    }
+
+    posix_port->port = (modbus_port_t){
+        .context        = posix_port,
+        .write          = posix_port_write,
+        .read           = posix_port_read,
+        .flush_input    = posix_port_flush_input,
+        .now_us         = posix_port_now_us,
+        .sleep_until_us = posix_port_sleep_until_us,
+    };
+    return true;
+}
+
+void modbus_port_posix_close(modbus_posix_port_t *posix_port)
+{
+    if (posix_port && posix_port->fd >= 0) {
+        close(posix_port->fd);
+        posix_port->fd = -1;
+    }
+}
+
+#endif /* !ESP_PLATFORM */
@@ -0,0 +1,108 @@
+#include "modbus_port.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/uart.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#define MODBUS_UART_RX_BUFFER_BYTES   (512)
+#define MODBUS_UART_TX_BUFFER_BYTES   (0)     /* Yazma, TX FIFO'ya sığana kadar bloklar */
+
+static const char *TAG = "MODBUS_UART";
+
+/* ------------------------------- Port Fonksiyonları ------------------------------- */
+
+static int uart_port_write(void *context, const uint8_t *bytes, size_t length)
+{
+    modbus_uart_port_t *uart_port = (modbus_uart_port_t *)context;
+    int written = uart_write_bytes(uart_port->config.uart_port, bytes, length);
+    /* RS-485: son bit hatta çıkmadan yanıt beklemeye geçme */
+    uart_wait_tx_done(uart_port->config.uart_port, pdMS_TO_TICKS(100));
+    return written;
+}
+
+static int uart_port_read(void *context, uint8_t *bytes, size_t length, uint32_t timeout_ms)
+{
+    modbus_uart_port_t *uart_port = (modbus_uart_port_t *)context;
+    return uart_read_bytes(uart_port->config.uart_port, bytes, length, pdMS_TO_TICKS(timeout_ms));
+}
+
+static void uart_port_flush_input(void *context)
+{
+    modbus_uart_port_t *uart_port = (modbus_uart_port_t *)context;
+    uart_flush_input(uart_port->config.uart_port);
+}
+
+static int64_t uart_port_now_us(void *context)
+{
+    (void)context;
+    return esp_timer_get_time();
+}
+
+static void uart_port_sleep_until_us(void *context, int64_t deadline_us)
+{
+    (void)context;
+    int64_t remaining_us = deadline_us - esp_timer_get_time();
+    if (remaining_us <= 0) {
+        return;
+    }
+    /* Tick'ten kısa bekleme (t3.5 gibi) meşgul beklemeyle, uzunu uyuyarak */
+    const int64_t tick_us = (int64_t)portTICK_PERIOD_MS * 1000;
+    if (remaining_us >= tick_us) {
+        vTaskDelay((TickType_t)(remaining_us / tick_us));
+    }
+    while (esp_timer_get_time() < deadline_us) {
+        /* kalan < 1 tick */
+    }
+}
+
+/* ------------------------------------ Kurulum ------------------------------------ */
+
+bool modbus_port_uart_init(modbus_uart_port_t *uart_port, const modbus_uart_config_t *config)
+{
+    if (!uart_port || !config || config->baud_rate <= 0) {
+        return false;
+    }
+    uart_port->config = *config;
+
+    const uart_config_t uart_configuration = {
+        .baud_rate  = config->baud_rate,
+        .data_bits  = UART_DATA_8_BITS,
+        .parity     = UART_PARITY_DISABLE,
+        .stop_bits  = UART_STOP_BITS_1,
+        .flow_ctrl  = UART_HW_FLOWCTRL_DISABLE,
+        .source_clk = UART_SCLK_APB,
+    };
+
+    esp_err_t err = uart_param_config(config->uart_port, &uart_configuration);
+    if (err == ESP_OK) {
+        err = uart_set_pin(config->uart_port, config->tx_gpio, config->rx_gpio,
+                           config->de_gpio, UART_PIN_NO_CHANGE);
+    }
+    if (err == ESP_OK) {
+        err = uart_driver_install(config->uart_port, MODBUS_UART_RX_BUFFER_BYTES,
+                                  MODBUS_UART_TX_BUFFER_BYTES, 0, NULL, 0);
+    }
+    if (err == ESP_OK) {
+        err = uart_set_mode(config->uart_port, UART_MODE_RS485_HALF_DUPLEX);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "UART%d kurulamadı: %s", (int)config->uart_port, esp_err_to_name(err));
+        return false;
+    }
+
+    uart_port->port = (modbus_port_t){
+        .context        = uart_port,
+        .write          = uart_port_write,
+        .read           = uart_port_read,
+        .flush_input    = uart_port_flush_input,
+        .now_us         = uart_port_now_us,
+        .sleep_until_us = uart_port_sleep_until_us,
+    };
+
+    ESP_LOGI(TAG, "Modbus hattı hazır: UART%d TX=%d RX=%d DE=%d Baud=%d",
+             (int)config->uart_port, config->tx_gpio, config->rx_gpio,
+             config->de_gpio, config->baud_rate);
+    return true;
+}
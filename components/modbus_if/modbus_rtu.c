@@ -0,0 +1,125 @@
+#include "modbus_rtu.h"
+
+/* ------------------------------- Yardımcı Fonksiyonlar ------------------------------- */
+
+uint16_t modbus_crc16(const uint8_t *bytes, size_t length)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; ++i) {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (uint16_t)((crc >> 1) ^ 0xA001) : (uint16_t)(crc >> 1);
+        }
+    }
+    return crc;
+}
+
+static inline void append_crc(uint8_t *frame, size_t length)
+{
+    uint16_t crc = modbus_crc16(frame, length);
+    frame[length]     = (uint8_t)(crc & 0xFF);
+    frame[length + 1] = (uint8_t)(crc >> 8);
+}
+
+static inline bool crc_matches(const uint8_t *frame, size_t length)
+{
+    uint16_t crc = modbus_crc16(frame, length - 2);
+    return frame[length - 2] == (uint8_t)(crc & 0xFF) && frame[length - 1] == (uint8_t)(crc >> 8);
+}
+
+/* ----------------------------------- Çerçeveleme ---------------------------------- */
+
+size_t modbus_build_read_request(uint8_t *out, uint8_t slave, uint8_t function,
+                                 uint16_t address, uint16_t count)
+{
+    out[0] = slave;
+    out[1] = function;
+    out[2] = (uint8_t)(address >> 8);
+    out[3] = (uint8_t)(address & 0xFF);
+    out[4] = (uint8_t)(count >> 8);
+    out[5] = (uint8_t)(count & 0xFF);
+    append_crc(out, 6);
+    return MODBUS_REQUEST_BYTES;
+}
+
+uint32_t modbus_frame_gap_us(uint32_t baud_rate)
+{
+    /* 19200 üstünde standart sabit 1750 us; altında 3.5 karakter (11 bit) */
+    if (baud_rate == 0 || baud_rate > 19200) {
+        return 1750;
+    }
+    return (uint32_t)((3.5 * 11.0 * 1000000.0) / baud_rate) + 1;
+}
+
+modbus_result_t modbus_read_registers(const modbus_port_t *port, uint8_t slave, uint8_t function,
+                                      uint16_t address, uint16_t count, uint32_t timeout_ms,
+                                      uint16_t *out_registers, uint8_t *out_exception)
+{
+    if (!port || !out_registers || count == 0 || count > MODBUS_MAX_READ_REGISTERS) {
+        return MODBUS_ERR_FRAME;
+    }
+
+    uint8_t request[MODBUS_REQUEST_BYTES];
+    modbus_build_read_request(request, slave, function, address, count);
+
+    /* Önceki yanıttan kalan artıkları at */
+    if (port->flush_input) {
+        port->flush_input(port->context);
+    }
+    if (port->write(port->context, request, sizeof(request)) != (int)sizeof(request)) {
+        return MODBUS_ERR_IO;
+    }
+
+    /* Önce başlık: normal yanıtta 3. bayt uzunluk, istisnada kod */
+    uint8_t response[MODBUS_MAX_ADU_BYTES];
+    if (port->read(port->context, response, 3, timeout_ms) != 3) {
+        return MODBUS_ERR_TIMEOUT;
+    }
+    if (response[0] != slave || (response[1] & ~MODBUS_FC_EXCEPTION_FLAG) != function) {
+        return MODBUS_ERR_FRAME;
+    }
+
+    if (response[1] & MODBUS_FC_EXCEPTION_FLAG) {
+        if (port->read(port->context, response + 3, 2, timeout_ms) != 2) {
+            return MODBUS_ERR_TIMEOUT;
+        }
+        if (!crc_matches(response, MODBUS_EXCEPTION_RESPONSE_BYTES)) {
+            return MODBUS_ERR_CRC;
+        }
+        if (out_exception) {
+            *out_exception = response[2];
+        }
+        return MODBUS_ERR_EXCEPTION;
+    }
+
+    /* Kalanı tam beklenen uzunlukta oku: zaman aşımını beklemeden dön */
+    size_t byte_count = response[2];
+    if (byte_count != (size_t)count * 2) {
+        return MODBUS_ERR_FRAME;
+    }
+    size_t remaining = byte_count + 2;
+    if (port->read(port->context, response + 3, remaining, timeout_ms) != (int)remaining) {
+        return MODBUS_ERR_TIMEOUT;
+    }
+    if (!crc_matches(response, 3 + remaining)) {
+        return MODBUS_ERR_CRC;
+    }
+
+    for (uint16_t i = 0; i < count; ++i) {
+        out_registers[i] = (uint16_t)((response[3 + i * 2] << 8) | response[4 + i * 2]);
+    }
+    return MODBUS_OK;
+}
+
+const char *modbus_result_name(modbus_result_t result)
+{
+    switch (result) {
+    case MODBUS_OK:            return "ok";
+    case MODBUS_ERR_TIMEOUT:   return "zaman asimi";
+    case MODBUS_ERR_CRC:       return "crc";
+    case MODBUS_ERR_EXCEPTION: return "istisna";
+    case MODBUS_ERR_FRAME:     return "cerceve";
+    case MODBUS_ERR_IO:        return "io";
+    }
+    return "?";
+}
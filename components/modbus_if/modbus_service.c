@@ -0,0 +1,146 @@
+#include "modbus_service.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "hd32mt_framer.h"
+#include "serial_ring.h"
+#include "telemetry_service.h"
+#include "time_if.h"
+
+#define MODBUS_TASK_STACK_BYTES   4096
+#define MODBUS_TASK_PRIORITY      6      /* Telemetri görevinin üstünde: tarama zamanı kaymasın */
+#define MODBUS_STATS_PERIOD_MS    60000
+
+static const char *TAG = "MODBUS";
+
+typedef struct {
+    uint8_t             instrument_id;
+    modbus_uart_port_t  uart_port;
+    modbus_master_t     master;
+    serial_ring_t      *ring;
+    TaskHandle_t        consumer;
+    uint32_t            ring_full;       /* Halka dolu, tur düştü */
+} modbus_service_t;
+
+static modbus_service_t g_modbus;
+static TaskHandle_t     g_modbus_task = NULL;
+
+/* ------------------------------- Yardımcı Fonksiyonlar ------------------------------- */
+
+/* YYMMDDhhmmss (HD32MT kayıt başlığıyla aynı) */
+static bool modbus_format_timestamp(char *out, size_t out_size)
+{
+    struct tm now;
+    if (time_get_datetime(&now) != ESP_OK) {
+        return false;
+    }
+    int written = snprintf(out, out_size, "%02d%02d%02d%02d%02d%02d",
+                           now.tm_year % 100, now.tm_mon + 1, now.tm_mday,
+                           now.tm_hour, now.tm_min, now.tm_sec);
+    return written == HD32MT_FRAME_TIMESTAMP_LEN;
+}
+
+static void modbus_log_stats(const modbus_service_t *service)
+{
+    const modbus_master_stats_t *stats = &service->master.stats;
+    ESP_LOGI(TAG, "[%u] Tur=%u atlanan=%u | istek=%u yanit=%u zaman asimi=%u crc=%u istisna=%u cerceve=%u | tur=%u us (max %u) | halka dolu=%u",
+             (unsigned)service->instrument_id,
+             (unsigned)stats->cycles, (unsigned)stats->overruns,
+             (unsigned)stats->requests, (unsigned)stats->responses,
+             (unsigned)stats->timeouts, (unsigned)stats->crc_errors,
+             (unsigned)stats->exceptions, (unsigned)stats->frame_errors,
+             (unsigned)stats->last_cycle_us, (unsigned)stats->max_cycle_us,
+             (unsigned)service->ring_full);
+}
+
+/* ------------------------------------ Görev ------------------------------------ */
+
+static void modbus_task(void *param)
+{
+    modbus_service_t *service = (modbus_service_t *)param;
+    float values[MODBUS_MASTER_MAX_POINTS];
+    char record[HD32MT_FRAME_HEADER_LEN + MODBUS_MASTER_MAX_POINTS * 4 + 1];
+    char timestamp[HD32MT_FRAME_TIMESTAMP_LEN + 1];
+    int64_t last_stats_us = esp_timer_get_time();
+
+    for (;;) {
+        size_t valid = modbus_master_poll(&service->master, values);
+
+        if (valid > 0 && modbus_format_timestamp(timestamp, sizeof(timestamp))) {
+            size_t length = hd32mt_record_encode(timestamp, values, service->master.point_count,
+                                                 record, sizeof(record));
+            if (length && serial_ring_push(service->ring, record, length)) {
+                xTaskNotifyGive(service->consumer);
+            } else {
+                service->ring_full++;
+            }
+        }
+
+        if (esp_timer_get_time() - last_stats_us >= (int64_t)MODBUS_STATS_PERIOD_MS * 1000) {
+            modbus_log_stats(service);
+            last_stats_us = esp_timer_get_time();
+        }
+    }
+}
+
+/* ------------------------------ Dışarıya Açık API ------------------------------ */
+
+bool modbus_service_start(const modbus_service_config_t *config)
+{
+    if (!config) {
+        return false;
+    }
+    if (g_modbus_task) {
+        ESP_LOGW(TAG, "Modbus servisi zaten çalışıyor");
+        return true;
+    }
+
+    modbus_service_t *service = &g_modbus;
+    memset(service, 0, sizeof(*service));
+    service->instrument_id = config->instrument_id;
+
+    modbus_master_config_t master_config = config->master;
+    master_config.baud_rate = (uint32_t)config->uart.baud_rate;
+
+    if (!modbus_port_uart_init(&service->uart_port, &config->uart)) {
+        return false;
+    }
+    if (!modbus_master_init(&service->master, &master_config, &service->uart_port.port,
+                            config->points, config->point_count)) {
+        ESP_LOGE(TAG, "Geçersiz nokta listesi (adet=%u, max=%d nokta / %d blok)",
+                 (unsigned)config->point_count, MODBUS_MASTER_MAX_POINTS, MODBUS_MASTER_MAX_BLOCKS);
+        return false;
+    }
+    if (!telemetry_service_add_source(config->instrument_id, (uint8_t)config->point_count,
+                                      &service->ring, &service->consumer)) {
+        return false;
+    }
+
+    BaseType_t ok = xTaskCreate(modbus_task, "modbus_task", MODBUS_TASK_STACK_BYTES,
+                                service, MODBUS_TASK_PRIORITY, &g_modbus_task);
+    if (ok != pdPASS) {
+        ESP_LOGE(TAG, "modbus_task oluşturulamadı");
+        return false;
+    }
+
+    ESP_LOGI(TAG, "[%u] Modbus servisi başlatıldı: %u nokta → %u istek/tur, periyot=%u ms",
+             (unsigned)config->instrument_id, (unsigned)service->master.point_count,
+             (unsigned)service->master.block_count, (unsigned)master_config.period_ms);
+    return true;
+}
+
+bool modbus_service_get_stats(modbus_master_stats_t *out_stats)
+{
+    if (!g_modbus_task || !out_stats) {
+        return false;
+    }
+    *out_stats = g_modbus.master.stats;
+    return true;
+}
@@ -0,0 +1,59 @@
+#ifndef NET_DNS_CACHE_H
+#define NET_DNS_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lwip/sockets.h"
+
+/*
+ * Sunucu adı çözümleme önbelleği (gönderim yolunda getaddrinfo yerine).
+ *
+ *  - Başarılı çözüm NET_DNS_CACHE_TTL_SEC boyunca geçerli (lwIP TTL'i
+ *    dışarı vermediği için sabit süre)
+ *  - Başarısız çözüm NET_DNS_CACHE_NEGATIVE_TTL_SEC boyunca tekrar denenmez
+ *  - DNS hata verirse son bilinen adres NET_DNS_CACHE_MAX_STALE_SEC'e kadar
+ *    kullanılmaya devam eder (sunucu IP'si değişmemiş olabilir)
+ *  - IP alınınca (ETH/Wi-Fi) kayıtlı adlar arka planda yeniden çözülür
+ */
+
+#define NET_DNS_CACHE_ENTRIES            4
+#define NET_DNS_CACHE_HOST_BYTES         64
+#define NET_DNS_CACHE_TTL_SEC            300
+#define NET_DNS_CACHE_NEGATIVE_TTL_SEC   10
+#define NET_DNS_CACHE_MAX_STALE_SEC      86400
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;            /* getaddrinfo çağrısı (ön çözüm dahil) */
+    uint32_t failures;          /* getaddrinfo hatası */
+    uint32_t negative_hits;     /* Yakın zamanda başarısız: denenmeden false */
+    uint32_t stale_served;      /* DNS hatasında eski adres */
+    uint32_t prefetches;        /* IP alınınca yapılan arka plan çözümü */
+    uint32_t last_lookup_ms;
+    uint32_t max_lookup_ms;
+} net_dns_cache_stats_t;
+
+/** Önbelleği ve ön çözüm görevini hazırlar (tekrar çağrılırsa bir şey yapmaz). */
+bool net_dns_cache_init(void);
+
+/** Adı ön çözüm listesine ekler (IP alınınca arka planda çözülür). */
+bool net_dns_cache_register(const char *host);
+
+/**
+ * Adı çözer (önbellekten ya da getaddrinfo ile).
+ * @param port     Adrese yazılacak port
+ * @param out      AF_INET/AF_INET6 adres
+ * @return false   Çözülemedi (ya da negatif önbellekte)
+ */
+bool net_dns_cache_resolve(const char *host, uint16_t port,
+                           struct sockaddr_storage *out, socklen_t *out_len);
+
+/** Adres işe yaramadı (connect başarısız): sonraki çağrı yeniden çözer, eski adres yedekte kalır. */
+void net_dns_cache_expire(const char *host);
+
+/** Kayıtlı adları arka planda yeniden çözer (IP alındığında net_manager çağırır). */
+void net_dns_cache_prefetch(void);
+
+void net_dns_cache_get_stats(net_dns_cache_stats_t *out_stats);
+
+#endif // NET_DNS_CACHE_H
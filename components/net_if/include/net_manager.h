@@ -23,6 +23,15 @@ bool net_manager_is_internet_ok(void);
 bool net_manager_is_connected(void);
 void net_manager_on_eth_got_ip(void);
 
+/**
+ * Bağlantı nesli: arayüz durduğunda/başladığında, link ya da IP değiştiğinde artar.
+ * Açık soket tutan modüller bağlanırken değeri saklar; değiştiyse soketi yeniler.
+ */
+uint32_t net_manager_get_link_generation(void);
+
+/** Şu an kullanılan arayüz (AUTO yalnızca açılışta, seçim yapılmadan önce) */
+net_mode_t net_manager_get_active_mode(void);
+
 
 
 
@@ -0,0 +1,298 @@
+#include "net_dns_cache.h"
+
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "lwip/netdb.h"
+
+static const char *TAG = "NET_DNS";
+
+#define NET_DNS_TASK_STACK_BYTES   3072
+#define NET_DNS_TASK_PRIORITY      4
+
+/* ---- Önbellek girdisi ---- */
+typedef struct {
+    bool                    used;
+    bool                    registered;        /* IP alınınca ön çözülür */
+    bool                    has_address;       /* Son başarılı çözüm (eski olsa da) */
+    char                    host[NET_DNS_CACHE_HOST_BYTES];
+    struct sockaddr_storage address;
+    socklen_t               address_len;
+    int64_t                 resolved_us;
+    int64_t                 expires_us;        /* Pozitif TTL sonu */
+    int64_t                 negative_until_us; /* Bu ana kadar getaddrinfo denenmez */
+} dns_entry_t;
+
+static dns_entry_t           s_entries[NET_DNS_CACHE_ENTRIES];
+static net_dns_cache_stats_t s_stats;
+static SemaphoreHandle_t     s_mutex = NULL;
+static TaskHandle_t          s_task = NULL;
+
+/* -------------------------------------------------------
+ * Yardımcılar (mutex altında çağrılır)
+ * ------------------------------------------------------- */
+static dns_entry_t *dns_find(const char *host)
+{
+    for (int i = 0; i < NET_DNS_CACHE_ENTRIES; ++i) {
+        if (s_entries[i].used && strcmp(s_entries[i].host, host) == 0) {
+            return &s_entries[i];
+        }
+    }
+    return NULL;
+}
+
+/* Yoksa ekler; yer yoksa kayıtsız girdilerin en eskisini çıkarır */
+static dns_entry_t *dns_find_or_add(const char *host)
+{
+    dns_entry_t *entry = dns_find(host);
+    if (entry) return entry;
+
+    dns_entry_t *victim = NULL;
+    for (int i = 0; i < NET_DNS_CACHE_ENTRIES; ++i) {
+        dns_entry_t *candidate = &s_entries[i];
+        if (!candidate->used) {
+            victim = candidate;
+            break;
+        }
+        if (!candidate->registered && (!victim || candidate->resolved_us < victim->resolved_us)) {
+            victim = candidate;
+        }
+    }
+    if (!victim) return NULL;
+
+    memset(victim, 0, sizeof(*victim));
+    victim->used = true;
+    strlcpy(victim->host, host, sizeof(victim->host));
+    return victim;
+}
+
+static bool dns_stale_usable(const dns_entry_t *entry, int64_t now_us)
+{
+    return entry->has_address &&
+           now_us - entry->resolved_us < (int64_t)NET_DNS_CACHE_MAX_STALE_SEC * 1000000;
+}
+
+/* -------------------------------------------------------
+ * Çözümleme (mutex dışında: getaddrinfo saniyeler sürebilir)
+ * ------------------------------------------------------- */
+static bool dns_lookup(const char *host, struct sockaddr_storage *out, socklen_t *out_len)
+{
+    struct addrinfo hints = {0}, *res = NULL;
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    int64_t start_us = esp_timer_get_time();
+    int err = getaddrinfo(host, NULL, &hints, &res);
+    uint32_t lookup_ms = (uint32_t)((esp_timer_get_time() - start_us) / 1000);
+
+    bool ok = err == 0 && res && res->ai_addrlen <= sizeof(*out);
+    if (ok) {
+        memcpy(out, res->ai_addr, res->ai_addrlen);
+        *out_len = (socklen_t)res->ai_addrlen;
+    }
+    if (res) freeaddrinfo(res);
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    s_stats.misses++;
+    s_stats.last_lookup_ms = lookup_ms;
+    if (lookup_ms > s_stats.max_lookup_ms) s_stats.max_lookup_ms = lookup_ms;
+    if (!ok) s_stats.failures++;
+    xSemaphoreGive(s_mutex);
+
+    if (!ok) {
+        ESP_LOGW(TAG, "%s çözülemedi (err=%d, %u ms)", host, err, (unsigned)lookup_ms);
+    }
+    return ok;
+}
+
+/* Adı çözer ve girdiyi günceller; hata durumunda eski adres (varsa) döner */
+static bool dns_refresh(const char *host, struct sockaddr_storage *out, socklen_t *out_len)
+{
+    struct sockaddr_storage address;
+    socklen_t address_len = 0;
+    bool ok = dns_lookup(host, &address, &address_len);
+    int64_t now_us = esp_timer_get_time();
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    dns_entry_t *entry = dns_find_or_add(host);
+    if (ok) {
+        if (entry) {
+            entry->address     = address;
+            entry->address_len = address_len;
+            entry->has_address = true;
+            entry->resolved_us = now_us;
+            entry->expires_us  = now_us + (int64_t)NET_DNS_CACHE_TTL_SEC * 1000000;
+            entry->negative_until_us = 0;
+        }
+    } else if (entry) {
+        entry->negative_until_us = now_us + (int64_t)NET_DNS_CACHE_NEGATIVE_TTL_SEC * 1000000;
+        if (dns_stale_usable(entry, now_us)) {
+            // DNS sunucusu yavaş/yok: sunucu IP'si büyük ihtimalle aynı
+            address     = entry->address;
+            address_len = entry->address_len;
+            s_stats.stale_served++;
+            ok = true;
+        }
+    }
+    xSemaphoreGive(s_mutex);
+
+    if (ok && out) {
+        *out     = address;
+        *out_len = address_len;
+    }
+    return ok;
+}
+
+static void dns_set_port(struct sockaddr_storage *address, uint16_t port)
+{
+    if (address->ss_family == AF_INET) {
+        ((struct sockaddr_in *)address)->sin_port = htons(port);
+    }
+#if LWIP_IPV6
+    else if (address->ss_family == AF_INET6) {
+        ((struct sockaddr_in6 *)address)->sin6_port = htons(port);
+    }
+#endif
+}
+
+/* -------------------------------------------------------
+ * Ön çözüm görevi: IP alınınca kayıtlı adları tazeler
+ * ------------------------------------------------------- */
+static void net_dns_task(void *arg)
+{
+    char hosts[NET_DNS_CACHE_ENTRIES][NET_DNS_CACHE_HOST_BYTES];
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        int count = 0;
+        xSemaphoreTake(s_mutex, portMAX_DELAY);
+        for (int i = 0; i < NET_DNS_CACHE_ENTRIES; ++i) {
+            if (s_entries[i].used && s_entries[i].registered) {
+                strlcpy(hosts[count++], s_entries[i].host, NET_DNS_CACHE_HOST_BYTES);
+            }
+        }
+        xSemaphoreGive(s_mutex);
+
+        for (int i = 0; i < count; ++i) {
+            if (dns_refresh(hosts[i], NULL, NULL)) {
+                ESP_LOGI(TAG, "%s ön çözüldü", hosts[i]);
+            }
+            xSemaphoreTake(s_mutex, portMAX_DELAY);
+            s_stats.prefetches++;
+            xSemaphoreGive(s_mutex);
+        }
+    }
+}
+
+/* -------------------------------------------------------
+ * Dışarıya açık API
+ * ------------------------------------------------------- */
+bool net_dns_cache_init(void)
+{
+    if (s_mutex) return true;
+
+    s_mutex = xSemaphoreCreateMutex();
+    if (!s_mutex) {
+        ESP_LOGE(TAG, "Mutex oluşturulamadı");
+        return false;
+    }
+    if (xTaskCreate(net_dns_task, "net_dns_task", NET_DNS_TASK_STACK_BYTES,
+                    NULL, NET_DNS_TASK_PRIORITY, &s_task) != pdPASS) {
+        ESP_LOGE(TAG, "Ön çözüm görevi oluşturulamadı");
+        s_task = NULL;
+    }
+    return true;
+}
+
+bool net_dns_cache_register(const char *host)
+{
+    if (!s_mutex || !host || !host[0] || strlen(host) >= NET_DNS_CACHE_HOST_BYTES) {
+        return false;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    dns_entry_t *entry = dns_find_or_add(host);
+    if (entry) {
+        entry->registered = true;
+    }
+    xSemaphoreGive(s_mutex);
+
+    if (!entry) {
+        ESP_LOGE(TAG, "Önbellek dolu, %s kaydedilemedi", host);
+        return false;
+    }
+    net_dns_cache_prefetch();
+    return true;
+}
+
+bool net_dns_cache_resolve(const char *host, uint16_t port,
+                           struct sockaddr_storage *out, socklen_t *out_len)
+{
+    if (!s_mutex || !host || !out || !out_len || strlen(host) >= NET_DNS_CACHE_HOST_BYTES) {
+        return false;
+    }
+
+    // 1️⃣ Önbellek: taze adres, ya da yakın zamanda başarısız olmuş ad
+    int64_t now_us = esp_timer_get_time();
+    bool done = false, ok = false;
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    dns_entry_t *entry = dns_find(host);
+    if (entry && entry->has_address && now_us < entry->expires_us) {
+        *out     = entry->address;
+        *out_len = entry->address_len;
+        s_stats.hits++;
+        done = ok = true;
+    } else if (entry && now_us < entry->negative_until_us) {
+        done = true;
+        if (dns_stale_usable(entry, now_us)) {
+            *out     = entry->address;
+            *out_len = entry->address_len;
+            s_stats.stale_served++;
+            ok = true;
+        } else {
+            s_stats.negative_hits++;
+        }
+    }
+    xSemaphoreGive(s_mutex);
+
+    // 2️⃣ Yoksa ya da süresi dolduysa çöz
+    if (!done) {
+        ok = dns_refresh(host, out, out_len);
+    }
+    if (ok) {
+        dns_set_port(out, port);
+    }
+    return ok;
+}
+
+void net_dns_cache_expire(const char *host)
+{
+    if (!s_mutex || !host) return;
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    dns_entry_t *entry = dns_find(host);
+    if (entry) {
+        entry->expires_us = 0;
+    }
+    xSemaphoreGive(s_mutex);
+}
+
+void net_dns_cache_prefetch(void)
+{
+    if (s_task) {
+        xTaskNotifyGive(s_task);
+    }
+}
+
+void net_dns_cache_get_stats(net_dns_cache_stats_t *out_stats)
+{
+    if (!out_stats || !s_mutex) return;
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    *out_stats = s_stats;
+    xSemaphoreGive(s_mutex);
+}
@@ -1,6 +1,7 @@
 #include "net_manager.h"
 #include "ethernet_init.h"
 #include "wifi_init.h"
+#include "net_dns_cache.h"
 #include "esp_event.h"
 #include "esp_eth.h"
 #include "esp_log.h"
@@ -13,6 +14,7 @@
 #include "lwip/inet.h"
 #include "lwip/netdb.h"
 #include "lwip/sockets.h"
+#include <stdatomic.h>
 
 static const char *TAG = "NET_MANAGER";
 
@@ -24,6 +26,7 @@ static bool s_eth_has_ip = false;  // ✅ Yeni: Ethernet IP aldı mı?
 static bool s_event_loop_initialized = false;
 static bool s_manual_override = false;
 static net_mode_t s_manual_mode = NET_MODE_ETHERNET;
+static atomic_uint s_link_generation = 0;  // Arayüz/link/IP her değiştiğinde artar
 
 /* ---- Yardımcı Fonksiyonlar ---- */
 static void stop_current_connection(void);
@@ -38,12 +41,17 @@ static bool wait_for_ethernet_ip(int max_wait_sec);
 void net_manager_on_wifi_event(bool connected)
 {
     s_wifi_connected = connected;
+    atomic_fetch_add(&s_link_generation, 1);
+    if (connected) {
+        net_dns_cache_prefetch();   // İlk satır DNS beklemesin
+    }
     ESP_LOGI(TAG, "Wi-Fi bağlantı durumu: %s", connected ? "UP" : "DOWN");
 }
 
 void net_manager_on_eth_event(bool link_up)
 {
     s_eth_link_up = link_up;
+    atomic_fetch_add(&s_link_generation, 1);
     
     // ✅ Link düştüğünde IP durumunu sıfırla
     if (!link_up) {
@@ -57,6 +65,8 @@ void net_manager_on_eth_event(bool link_up)
 void net_manager_on_eth_got_ip(void)
 {
     s_eth_has_ip = true;
+    atomic_fetch_add(&s_link_generation, 1);
+    net_dns_cache_prefetch();   // İlk satır DNS beklemesin
     ESP_LOGI(TAG, "✅ Ethernet IP alındı!");
 }
 
@@ -165,6 +175,7 @@ static bool ping_test(void)
  * ------------------------------------------------------- */
 static void stop_current_connection(void)
 {
+    atomic_fetch_add(&s_link_generation, 1);
     switch (s_current_mode) {
     case NET_MODE_ETHERNET:
         ESP_LOGW(TAG, "Ethernet durduruluyor...");
@@ -220,6 +231,16 @@ static void start_network(void)
 
 
 
+uint32_t net_manager_get_link_generation(void)
+{
+    return atomic_load(&s_link_generation);
+}
+
+net_mode_t net_manager_get_active_mode(void)
+{
+    return s_current_mode;
+}
+
 bool net_manager_is_connected(void)
 {
     // ETHERNET: hem link UP hem de IP alınmış olmalı
@@ -374,6 +395,7 @@ static void net_manager_task(void *arg)
  * ------------------------------------------------------- */
 void net_manager_create_task(void)
 {
+    net_dns_cache_init();
     xTaskCreatePinnedToCore(net_manager_task, "net_manager_task", 8192, NULL, 5, NULL, 1);
     ESP_LOGI(TAG, "Ağ yöneticisi görevi oluşturuldu.");
 }
\ No newline at end of file
@@ -0,0 +1,322 @@
+#include "hd32mt_download.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs.h"
+
+/* ----------------------------- Kullanıcıya açık ayarlar ----------------------------- */
+
+#define HD32MT_DOWNLOAD_TASK_NAME          "hd32mt_dl"
+#define HD32MT_DOWNLOAD_TASK_STACK_BYTES   (4096)
+#define HD32MT_DOWNLOAD_TASK_PRIORITY      (4)    /* Alıcı görevin (5) altında */
+
+#define HD32MT_CMD_TERMINATOR              "\r"
+#define HD32MT_CMD_STOP                    "$!"
+#define HD32MT_CMD_START                   "$J1"
+#define HD32MT_CMD_DUMP_FMT                "$DP%08lX"
+
+/* Kalınan adres, cihaz başına bir anahtar */
+#define HD32MT_DOWNLOAD_NVS_NAMESPACE      "hd32dl"
+#define HD32MT_DOWNLOAD_NVS_KEY_FMT        "next%u"
+
+/* Halka doluyken yeniden kontrol aralığı (ms) */
+#define HD32MT_DOWNLOAD_BACKLOG_POLL_MS    (50)
+
+/* ------------------------------------------------------------------------------------ */
+
+/* Alıcı görevden indirme görevine giden bildirim bitleri */
+#define DL_EVENT_ACK_OK     (1u << 0)   /* "$+&" */
+#define DL_EVENT_ACK_STOP   (1u << 1)   /* "$!&" */
+#define DL_EVENT_RECORD     (1u << 2)   /* $R0/$R1/$A0 kaydı */
+#define DL_EVENT_ACK_REPLY  (1u << 3)   /* '&' ile biten diğer yanıtlar ("$J1" başlığı) */
+
+static const char *TAG = "HD32MT_DL";
+
+typedef struct {
+    serial_if_t             *serial;
+    hd32mt_download_config_t config;
+    TaskHandle_t             task_handle;
+    int                      original_baud_rate;
+    atomic_uint              block_records;   /* Alıcı görev artırır */
+    serial_if_record_tap_t   tap;             /* Bağlıyken alıcı görev okur */
+    hd32mt_download_stats_t  stats;
+} hd32mt_download_t;
+
+static hd32mt_download_t s_download;
+static atomic_bool       s_running;
+
+/* ------------------------------- Yardımcı Fonksiyonlar ------------------------------- */
+
+static bool load_next_address(uint8_t instrument_id, uint32_t *out_address)
+{
+    char key[16];
+    snprintf(key, sizeof(key), HD32MT_DOWNLOAD_NVS_KEY_FMT, (unsigned)instrument_id);
+
+    nvs_handle_t handle;
+    if (nvs_open(HD32MT_DOWNLOAD_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return false;
+    }
+    esp_err_t err = nvs_get_u32(handle, key, out_address);
+    nvs_close(handle);
+    return err == ESP_OK;
+}
+
+static void store_next_address(uint8_t instrument_id, uint32_t address)
+{
+    char key[16];
+    snprintf(key, sizeof(key), HD32MT_DOWNLOAD_NVS_KEY_FMT, (unsigned)instrument_id);
+
+    nvs_handle_t handle;
+    if (nvs_open(HD32MT_DOWNLOAD_NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
+        ESP_LOGW(TAG, "NVS açılamadı, adres saklanmadı");
+        return;
+    }
+    nvs_set_u32(handle, key, address);
+    nvs_commit(handle);
+    nvs_close(handle);
+}
+
+/* Alıcı görev bağlamında: yanıtları bit olarak indirme görevine aktar */
+static void on_serial_record(void *tap_arg, const char *record, size_t length, bool is_data)
+{
+    hd32mt_download_t *dl = (hd32mt_download_t *)tap_arg;
+    uint32_t bits = 0;
+
+    if (is_data) {
+        atomic_fetch_add_explicit(&dl->block_records, 1, memory_order_relaxed);
+        bits = DL_EVENT_RECORD;
+    } else if (length >= 2 && record[0] == '$' && record[1] == '+') {
+        bits = DL_EVENT_ACK_OK;
+    } else if (length >= 2 && record[0] == '$' && record[1] == '!') {
+        bits = DL_EVENT_ACK_STOP;
+    } else if (length > 0 && record[length - 1] == '&') {
+        bits = DL_EVENT_ACK_REPLY;
+    }
+
+    if (bits && dl->task_handle) {
+        xTaskNotify(dl->task_handle, bits, eSetBits);
+    }
+}
+
+/* İstenen bitlerden biri gelene kadar bekler; gelen bitleri döner (0 = zaman aşımı) */
+static uint32_t wait_for_events(uint32_t wanted_bits, uint32_t timeout_ms)
+{
+    int64_t deadline_us = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+
+    for (;;) {
+        int64_t remaining_us = deadline_us - esp_timer_get_time();
+        if (remaining_us <= 0) {
+            return 0;
+        }
+        uint32_t bits = 0;
+        if (xTaskNotifyWait(0, UINT32_MAX, &bits,
+                            pdMS_TO_TICKS((remaining_us + 999) / 1000)) != pdTRUE) {
+            return 0;
+        }
+        if (bits & wanted_bits) {
+            return bits & wanted_bits;
+        }
+    }
+}
+
+static bool send_command(hd32mt_download_t *dl, const char *command)
+{
+    /* Önceki komuttan kalan bitler yeni onay sanılmasın */
+    xTaskNotifyWait(0, UINT32_MAX, NULL, 0);
+
+    size_t length = strlen(command);
+    if (serial_if_write(dl->serial, command, length) != (int)length ||
+        serial_if_write(dl->serial, HD32MT_CMD_TERMINATOR, strlen(HD32MT_CMD_TERMINATOR)) < 0) {
+        ESP_LOGE(TAG, "Komut yazılamadı: %s", command);
+        return false;
+    }
+    return true;
+}
+
+/* Komutu gönderir, onayı bekler; cevap gelmezse config.max_retries kez tekrarlar */
+static bool send_command_with_ack(hd32mt_download_t *dl, const char *command, uint32_t ack_bits)
+{
+    for (uint8_t attempt = 0; attempt <= dl->config.max_retries; ++attempt) {
+        if (attempt > 0) {
+            dl->stats.retries++;
+        }
+        if (send_command(dl, command) &&
+            wait_for_events(ack_bits, dl->config.ack_timeout_ms)) {
+            return true;
+        }
+    }
+    ESP_LOGW(TAG, "Onay gelmedi: %s", command);
+    return false;
+}
+
+static bool switch_baud_rate(hd32mt_download_t *dl, int baud_rate)
+{
+    if (baud_rate <= 0 || baud_rate == serial_if_get_baud_rate(dl->serial)) {
+        return true;
+    }
+    if (dl->config.baud_switch_command) {
+        char command[32];
+        snprintf(command, sizeof(command), dl->config.baud_switch_command, baud_rate);
+        if (!send_command_with_ack(dl, command, DL_EVENT_ACK_OK)) {
+            return false;
+        }
+    }
+    return serial_if_set_baud_rate(dl->serial, baud_rate);
+}
+
+/* Halka tüketici tarafından boşaltılana kadar yeni blok isteme */
+static void wait_for_backlog(hd32mt_download_t *dl)
+{
+    while (serial_if_get_backlog(dl->serial) > dl->config.max_backlog) {
+        dl->stats.backlog_waits++;
+        vTaskDelay(pdMS_TO_TICKS(HD32MT_DOWNLOAD_BACKLOG_POLL_MS));
+    }
+}
+
+/**
+ * Tek blok: $DP<adres> → "$+&" → kayıtlar → "$!&" ya da sessizlik.
+ * @return Bloktaki kayıt sayısı, komut onaylanmadıysa -1
+ */
+static int32_t download_block(hd32mt_download_t *dl, uint32_t address)
+{
+    char command[24];
+    snprintf(command, sizeof(command), HD32MT_CMD_DUMP_FMT, (unsigned long)address);
+
+    atomic_store(&dl->block_records, 0);
+    if (!send_command_with_ack(dl, command, DL_EVENT_ACK_OK)) {
+        return -1;
+    }
+    dl->stats.blocks++;
+
+    /* Her kayıt sessizlik sayacını yeniler; "$!&" bloğu hemen bitirir */
+    while (wait_for_events(DL_EVENT_RECORD | DL_EVENT_ACK_STOP,
+                           dl->config.block_idle_ms) == DL_EVENT_RECORD) {
+        if (serial_if_get_backlog(dl->serial) > dl->config.max_backlog * 2) {
+            /* Tüketici yetişemiyor: bu bloğu kes, kalanı sonraki istekte */
+            send_command(dl, HD32MT_CMD_STOP);
+            wait_for_events(DL_EVENT_ACK_STOP, dl->config.ack_timeout_ms);
+            break;
+        }
+    }
+    return (int32_t)atomic_load(&dl->block_records);
+}
+
+/* ----------------------------------- İndirme Görevi ---------------------------------- */
+
+static void hd32mt_download_task(void *param)
+{
+    hd32mt_download_t *dl = (hd32mt_download_t *)param;
+    uint8_t instrument_id = serial_if_get_instrument_id(dl->serial);
+    uint32_t address = dl->stats.start_address;
+    bool ok = false;
+
+    dl->task_handle = xTaskGetCurrentTaskHandle();
+    ESP_LOGI(TAG, "[%u] İndirme başladı: adres=0x%08lX",
+             (unsigned)instrument_id, (unsigned long)address);
+
+    dl->tap = (serial_if_record_tap_t){ .fn = on_serial_record, .arg = dl };
+    serial_if_set_record_tap(dl->serial, &dl->tap);
+
+    /* Canlı akışı durdur, sonra (varsa) hızlı moda geç */
+    if (send_command_with_ack(dl, HD32MT_CMD_STOP, DL_EVENT_ACK_STOP) &&
+        switch_baud_rate(dl, dl->config.download_baud_rate)) {
+        for (;;) {
+            wait_for_backlog(dl);
+
+            int32_t received = download_block(dl, address);
+            if (received < 0) {
+                break;
+            }
+            if (received == 0) {
+                ok = true;   /* Bellek sonu */
+                break;
+            }
+            address += (uint32_t)received;
+            dl->stats.records += (uint32_t)received;
+            dl->stats.next_address = address;
+            store_next_address(instrument_id, address);
+        }
+    }
+
+    /* Eski hıza dön ve canlı akışı yeniden aç: "$J1" yanıtı ya da ilk canlı kayıt onaydır */
+    switch_baud_rate(dl, dl->original_baud_rate);
+    send_command_with_ack(dl, HD32MT_CMD_START, DL_EVENT_ACK_REPLY | DL_EVENT_RECORD);
+    serial_if_set_record_tap(dl->serial, NULL);
+
+    dl->stats.finished_us = esp_timer_get_time();
+    dl->stats.succeeded   = ok;
+    dl->stats.running     = false;
+
+    int64_t elapsed_ms = (dl->stats.finished_us - dl->stats.started_us) / 1000;
+    ESP_LOGI(TAG, "[%u] İndirme %s: %u kayit, %u blok, %u tekrar, %lld ms (sonraki adres=0x%08lX)",
+             (unsigned)instrument_id, ok ? "tamamlandı" : "yarıda kaldı",
+             (unsigned)dl->stats.records, (unsigned)dl->stats.blocks,
+             (unsigned)dl->stats.retries, (long long)elapsed_ms,
+             (unsigned long)dl->stats.next_address);
+
+    dl->task_handle = NULL;
+    atomic_store(&s_running, false);
+    vTaskDelete(NULL);
+}
+
+/* ------------------------------ Dışarıya Açık API ------------------------------ */
+
+bool hd32mt_download_start(serial_if_t *serial, const hd32mt_download_config_t *config)
+{
+    if (!serial || !config) {
+        return false;
+    }
+    bool expected = false;
+    if (!atomic_compare_exchange_strong(&s_running, &expected, true)) {
+        ESP_LOGW(TAG, "İndirme zaten çalışıyor");
+        return false;
+    }
+
+    hd32mt_download_t *dl = &s_download;
+    memset(&dl->stats, 0, sizeof(dl->stats));
+    dl->serial             = serial;
+    dl->config             = *config;
+    dl->original_baud_rate = serial_if_get_baud_rate(serial);
+
+    uint32_t address = config->start_address;
+    if (address == HD32MT_DOWNLOAD_RESUME &&
+        !load_next_address(serial_if_get_instrument_id(serial), &address)) {
+        address = 0;
+    }
+    dl->stats.start_address = address;
+    dl->stats.next_address  = address;
+    dl->stats.started_us    = esp_timer_get_time();
+    dl->stats.running       = true;
+
+    BaseType_t ok = xTaskCreate(hd32mt_download_task,
+                                HD32MT_DOWNLOAD_TASK_NAME,
+                                HD32MT_DOWNLOAD_TASK_STACK_BYTES,
+                                dl,
+                                HD32MT_DOWNLOAD_TASK_PRIORITY,
+                                &dl->task_handle);
+    if (ok != pdPASS) {
+        ESP_LOGE(TAG, "İndirme görevi oluşturulamadı");
+        dl->stats.running = false;
+        atomic_store(&s_running, false);
+        return false;
+    }
+    return true;
+}
+
+bool hd32mt_download_is_running(void)
+{
+    return atomic_load(&s_running);
+}
+
+void hd32mt_download_get_stats(hd32mt_download_stats_t *out_stats)
+{
+    if (out_stats) {
+        *out_stats = s_download.stats;
+    }
+}
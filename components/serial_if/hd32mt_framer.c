@@ -0,0 +1,293 @@
+#include "hd32mt_framer.h"
+
+#include <string.h>
+
+/* Metin satırı sonlandırıcıları (veri kaydı dışında) */
+#define HD32MT_FRAMER_ACCEPT_CR          (1)   /* '\r' */
+#define HD32MT_FRAMER_ACCEPT_LF          (1)   /* '\n' */
+#define HD32MT_FRAMER_ACCEPT_AMPERSAND   (1)   /* '&' */
+
+#define HD32MT_PAYLOAD_UNKNOWN           ((size_t)-1)
+
+/* ------------------------------- Yardımcı Fonksiyonlar ------------------------------- */
+
+static inline bool is_line_terminator_character(char ch)
+{
+#if HD32MT_FRAMER_ACCEPT_CR
+    if (ch == '\r') return true;
+#endif
+#if HD32MT_FRAMER_ACCEPT_LF
+    if (ch == '\n') return true;
+#endif
+#if HD32MT_FRAMER_ACCEPT_AMPERSAND
+    if (ch == '&')  return true;
+#endif
+    return false;
+}
+
+/* Önek + tip + bayrak profilin veri kaydı mı */
+static inline bool is_data_prefix(const hd32mt_frame_format_t *format, const char *prefix)
+{
+    return (prefix[1] == format->record_types[0] || prefix[1] == format->record_types[1]) &&
+           (prefix[2] == format->record_flags[0] || prefix[2] == format->record_flags[1]);
+}
+
+static inline bool is_blank_character(char ch)
+{
+    return ch == ' ' || ch == '\t' || ch == '\v' || ch == '\f';
+}
+
+static void start_text(hd32mt_framer_t *framer)
+{
+    framer->state  = HD32MT_FRAMER_TEXT;
+    framer->length = 0;
+    if (framer->channel_count_pending) {
+        framer->channel_count = framer->next_channel_count;
+        framer->channel_count_pending = false;
+    }
+    if (framer->format_pending) {
+        framer->format = framer->next_format;
+        framer->format_pending = false;
+    }
+}
+
+/* Yarım kaydı at ve metin moduna dön (bozuk bayt yeniden işlenecek) */
+static void drop_and_resync(hd32mt_framer_t *framer, uint32_t *reason_counter)
+{
+    (*reason_counter)++;
+    framer->stats.resync_bytes += (uint32_t)framer->length;
+    start_text(framer);
+}
+
+static void emit_text_line(hd32mt_framer_t *framer)
+{
+    /* Sondaki boşlukları kırp (baştakiler zaten alınmadı) */
+    size_t length = framer->length;
+    while (length > 0 && (is_blank_character(framer->buffer[length - 1]))) {
+        length--;
+    }
+    if (length > 0) {
+        framer->stats.text_lines++;
+        if (framer->emit) {
+            framer->emit(framer->emit_context, framer->buffer, length, false);
+        }
+    }
+    start_text(framer);
+}
+
+static void emit_data_record(hd32mt_framer_t *framer)
+{
+    framer->stats.data_records++;
+    if (framer->emit) {
+        framer->emit(framer->emit_context, framer->buffer, framer->length, true);
+    }
+    start_text(framer);
+}
+
+static inline bool append_byte(hd32mt_framer_t *framer, char ch)
+{
+    if (framer->length >= sizeof(framer->buffer)) {
+        framer->stats.drop_oversize++;
+        framer->stats.resync_bytes += (uint32_t)framer->length;
+        start_text(framer);
+        return false;
+    }
+    framer->buffer[framer->length++] = ch;
+    return true;
+}
+
+/**
+ * Tek baytı durum makinesinden geçirir.
+ * @return false  Bayt tüketilmedi (kayıt düştü), metin modunda yeniden işlenmeli
+ */
+static bool feed_byte(hd32mt_framer_t *framer, char ch)
+{
+    switch (framer->state) {
+    case HD32MT_FRAMER_TEXT:
+        if (is_line_terminator_character(ch)) {
+            if (framer->length > 0) {
+                emit_text_line(framer);
+            }
+            return true;
+        }
+        if (framer->length == 0) {
+            if (is_blank_character(ch)) {
+                return true;   /* baştaki boşluklar */
+            }
+            if (ch == framer->format.prefix) {
+                framer->buffer[0] = ch;
+                framer->length = 1;
+                framer->state = HD32MT_FRAMER_PREFIX;
+                return true;
+            }
+        }
+        append_byte(framer, ch);
+        return true;
+
+    case HD32MT_FRAMER_PREFIX:
+        if (is_line_terminator_character(ch)) {
+            framer->state = HD32MT_FRAMER_TEXT;   /* "$!&" gibi kısa komut */
+            return false;
+        }
+        framer->buffer[framer->length++] = ch;
+        if (framer->length == HD32MT_FRAME_PREFIX_LEN) {
+            bool is_data = is_data_prefix(&framer->format, framer->buffer);
+            framer->state = is_data ? HD32MT_FRAMER_TIMESTAMP : HD32MT_FRAMER_TEXT;
+        }
+        return true;
+
+    case HD32MT_FRAMER_TIMESTAMP:
+        if (ch >= '0' && ch <= '9') {
+            framer->buffer[framer->length++] = ch;
+            if (framer->length == HD32MT_FRAME_PREFIX_LEN + HD32MT_FRAME_TIMESTAMP_LEN) {
+                framer->state = HD32MT_FRAMER_SPACE;
+            }
+            return true;
+        }
+        /* Önek ile zaman damgası arasındaki satır sonunu atla */
+        if (framer->length == HD32MT_FRAME_PREFIX_LEN && (ch == '\r' || ch == '\n')) {
+            return true;
+        }
+        drop_and_resync(framer, &framer->stats.drop_bad_timestamp);
+        return false;
+
+    case HD32MT_FRAMER_SPACE:
+        if (ch != ' ') {
+            drop_and_resync(framer, &framer->stats.drop_missing_space);
+            return false;
+        }
+        framer->buffer[framer->length++] = ch;
+        framer->payload_remaining = framer->channel_count
+                                  ? (size_t)framer->channel_count * 4
+                                  : HD32MT_PAYLOAD_UNKNOWN;
+        framer->state = HD32MT_FRAMER_PAYLOAD;
+        return true;
+
+    case HD32MT_FRAMER_PAYLOAD:
+        if (framer->payload_remaining == HD32MT_PAYLOAD_UNKNOWN) {
+            /* N bilinmiyor: yalnızca 4'ün katı konumundaki sonlandırıcı kaydı bitirir */
+            size_t payload_length = framer->length - HD32MT_FRAME_HEADER_LEN;
+            if (ch == framer->format.terminator && payload_length >= 4 && (payload_length % 4) == 0) {
+                if (append_byte(framer, ch)) {
+                    emit_data_record(framer);
+                }
+                return true;
+            }
+            append_byte(framer, ch);
+            return true;
+        }
+        framer->buffer[framer->length++] = ch;
+        if (--framer->payload_remaining == 0) {
+            framer->state = HD32MT_FRAMER_TERMINATOR;
+        }
+        return true;
+
+    case HD32MT_FRAMER_TERMINATOR:
+        if (ch != framer->format.terminator) {
+            drop_and_resync(framer, &framer->stats.drop_bad_terminator);
+            return false;
+        }
+        framer->buffer[framer->length++] = ch;
+        emit_data_record(framer);
+        return true;
+    }
+
+    start_text(framer);
+    return false;
+}
+
+/* ------------------------------ Dışarıya Açık API ------------------------------ */
+
+void hd32mt_framer_init(hd32mt_framer_t *framer, hd32mt_framer_emit_fn emit, void *emit_context)
+{
+    if (!framer) return;
+    memset(framer, 0, sizeof(*framer));
+    framer->emit         = emit;
+    framer->emit_context = emit_context;
+    framer->format       = hd32mt_profile_get(HD32MT_PROFILE_DEFAULT)->frame;
+    start_text(framer);
+}
+
+void hd32mt_framer_set_format(hd32mt_framer_t *framer, const hd32mt_frame_format_t *format)
+{
+    if (!framer || !format) return;
+
+    /* Karakterler yalnızca satır başında ve kayıt içinde okunur: metin satırında hemen */
+    if (framer->state == HD32MT_FRAMER_TEXT) {
+        framer->format         = *format;
+        framer->format_pending = false;
+    } else {
+        framer->next_format    = *format;
+        framer->format_pending = true;
+    }
+}
+
+void hd32mt_framer_set_channel_count(hd32mt_framer_t *framer, uint16_t channel_count)
+{
+    if (!framer) return;
+
+    /* Başlık + N*4 + '&' tampona sığmalı */
+    size_t max_channels = (sizeof(framer->buffer) - HD32MT_FRAME_HEADER_LEN - 1) / 4;
+    if (channel_count > max_channels) {
+        channel_count = (uint16_t)max_channels;
+    }
+    /* N yalnızca başlık bitince okunur: payload dışında hemen uygulanabilir */
+    if (framer->state == HD32MT_FRAMER_PAYLOAD || framer->state == HD32MT_FRAMER_TERMINATOR) {
+        framer->next_channel_count    = channel_count;
+        framer->channel_count_pending = true;
+    } else {
+        framer->channel_count         = channel_count;
+        framer->channel_count_pending = false;
+    }
+}
+
+void hd32mt_framer_reset(hd32mt_framer_t *framer)
+{
+    if (!framer) return;
+    framer->stats.resync_bytes += (uint32_t)framer->length;
+    start_text(framer);
+}
+
+void hd32mt_framer_feed(hd32mt_framer_t *framer, const uint8_t *bytes, size_t byte_count)
+{
+    if (!framer || !bytes) return;
+
+    for (size_t i = 0; i < byte_count; ++i) {
+        char ch = (char)bytes[i];
+        /* Düşen kayıttan sonra bayt metin modunda bir kez daha işlenir */
+        if (!feed_byte(framer, ch)) {
+            feed_byte(framer, ch);
+        }
+    }
+}
+
+size_t hd32mt_record_encode(const char *timestamp, const float *values, size_t value_count,
+                            char *out, size_t out_capacity)
+{
+    if (!timestamp || !out || (value_count && !values)) return 0;
+
+    size_t length = HD32MT_FRAME_HEADER_LEN + value_count * 4 + 1;
+    if (length > out_capacity || length > HD32MT_FRAMER_MAX_RECORD_BYTES) return 0;
+
+    const hd32mt_frame_format_t *format = &hd32mt_profile_get(HD32MT_PROFILE_DEFAULT)->frame;
+    out[0] = format->prefix;
+    out[1] = format->record_types[0];
+    out[2] = format->record_flags[0];
+    for (size_t i = 0; i < HD32MT_FRAME_TIMESTAMP_LEN; ++i) {
+        if (timestamp[i] < '0' || timestamp[i] > '9') return 0;
+        out[HD32MT_FRAME_PREFIX_LEN + i] = timestamp[i];
+    }
+    out[HD32MT_FRAME_HEADER_LEN - 1] = ' ';
+
+    char *payload = out + HD32MT_FRAME_HEADER_LEN;
+    for (size_t i = 0; i < value_count; ++i) {
+        uint32_t bits;
+        memcpy(&bits, &values[i], sizeof(bits));
+        payload[i * 4 + 0] = (char)(bits >> 24);
+        payload[i * 4 + 1] = (char)(bits >> 16);
+        payload[i * 4 + 2] = (char)(bits >> 8);
+        payload[i * 4 + 3] = (char)bits;
+    }
+    out[length - 1] = format->terminator;
+    return length;
+}
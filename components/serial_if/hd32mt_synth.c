@@ -0,0 +1,244 @@
+#include "hd32mt_synth.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define HD32MT_SYNTH_MAX_RATE_HZ        (1000)
+#define HD32MT_SYNTH_CONFIG_VARIABLES   (32)    /* HD32MT_CONFIG_MAX_VARIABLES ile aynı */
+#define HD32MT_SYNTH_DLTYPE             "HD32MT.1"
+
+/* Big-endian bayt dizilimi 0x26/0x0A/0x0D içeren, parser'ın kabul ettiği sonlu değerler */
+static const uint32_t TRICKY_FLOAT_BITS[] = {
+    0x41260A0Du,   /* ~10.38 */
+    0x42260D0Au,   /* ~41.51 */
+    0x3F0A0D26u,   /* ~0.539, son bayt '&' */
+    0x44262626u,   /* ~664.6 */
+    0x260A0D26u,   /* ~4.8e-16 */
+    0x0D0A2626u,   /* ~4.3e-31 */
+};
+
+static const char *const SYNTH_UNITS[] = { "V", "mA", "W/m2", "C", "%" };
+
+/* ------------------------------- Yardımcı Fonksiyonlar ------------------------------- */
+
+/* xorshift32: host ve cihazda aynı dizi */
+static uint32_t synth_random(hd32mt_synth_t *synth)
+{
+    uint32_t x = synth->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    synth->rng = x;
+    return x;
+}
+
+static inline char channel_variable(uint16_t channel)
+{
+    return channel < 26 ? (char)('a' + channel) : 'z';
+}
+
+static inline const char *channel_unit(uint16_t channel)
+{
+    return SYNTH_UNITS[channel % (sizeof(SYNTH_UNITS) / sizeof(SYNTH_UNITS[0]))];
+}
+
+static uint64_t record_time_us(const hd32mt_synth_t *synth, uint32_t record_index)
+{
+    return (uint64_t)record_index * 1000000u / synth->config.record_rate_hz;
+}
+
+/* Akış zamanına göre YYMMDDhhmmss */
+static void format_timestamp(const hd32mt_synth_t *synth, char *out)
+{
+    time_t seconds = (time_t)(synth->config.start_epoch + (int64_t)(synth->now_us / 1000000u));
+    struct tm civil;
+    gmtime_r(&seconds, &civil);
+    char text[32];   // Derleyici alanları 2 haneyle sınırlayamaz (-Wformat-truncation)
+    snprintf(text, sizeof(text), "%02d%02d%02d%02d%02d%02d",
+             civil.tm_year % 100, civil.tm_mon + 1, civil.tm_mday,
+             civil.tm_hour, civil.tm_min, civil.tm_sec);
+    memcpy(out, text, HD32MT_FRAME_TIMESTAMP_LEN);
+}
+
+/* Konfigürasyon bloğunun index'inci satırı; blok bittiyse 0 */
+static size_t config_line(const hd32mt_synth_t *synth, uint32_t index, char *out, size_t cap)
+{
+    const uint16_t channels  = synth->config.channel_count;
+    const uint32_t variables = channels < HD32MT_SYNTH_CONFIG_VARIABLES
+                             ? channels : HD32MT_SYNTH_CONFIG_VARIABLES;
+    int written;
+
+    if (index < variables) {
+        written = snprintf(out, cap, "#const %c=Synth%u,Synthetic,BIP%u\r\n",
+                           channel_variable((uint16_t)index), (unsigned)index + 1, (unsigned)index + 1);
+    } else if ((index -= variables) < variables) {
+        written = snprintf(out, cap, "#unit %c=%s\r\n",
+                           channel_variable((uint16_t)index), channel_unit((uint16_t)index));
+    } else if ((index -= variables) == 0) {
+        written = snprintf(out, cap, "End\r\n[DLType:%s]\r\n[Table1]\r\n1,%u,0,0\r\n",
+                           HD32MT_SYNTH_DLTYPE, (unsigned)channels);
+    } else if (--index < channels) {
+        written = snprintf(out, cap, "Synthetic,%c,Synth%u,%s,SampleAvg,0/0/0\r\n",
+                           channel_variable((uint16_t)index), (unsigned)index + 1,
+                           channel_unit((uint16_t)index));
+    } else if (index == channels) {
+        written = snprintf(out, cap, "{\r\n[scarta],\r\n%s,\r\n}\r\n", synth->fingerprint);
+    } else {
+        return 0;
+    }
+    return (written > 0 && (size_t)written < cap) ? (size_t)written : 0;
+}
+
+static float channel_value(hd32mt_synth_t *synth, uint16_t channel)
+{
+    if (synth->config.tricky_percent &&
+        synth_random(synth) % 100 < synth->config.tricky_percent) {
+        size_t pick = synth_random(synth) % (sizeof(TRICKY_FLOAT_BITS) / sizeof(TRICKY_FLOAT_BITS[0]));
+        float value;
+        memcpy(&value, &TRICKY_FLOAT_BITS[pick], sizeof(value));
+        synth->stats.tricky_values++;
+        return value;
+    }
+    /* Kanal başına farklı seviye + yavaş dalga + küçük gürültü */
+    float phase = (float)(synth->now_us % 60000000u) / 60000000.0f;
+    float noise = (float)((int32_t)(synth_random(synth) % 2001) - 1000) / 1000.0f;
+    return (float)(channel + 1) * 100.0f + 50.0f * sinf(phase * 6.2831853f) + noise;
+}
+
+static size_t build_record(hd32mt_synth_t *synth)
+{
+    uint8_t *out = synth->chunk;
+    size_t length = 0;
+
+    if (synth->config.noise_bytes) {
+        for (uint16_t i = 0; i < synth->config.noise_bytes; ++i) {
+            uint8_t byte = (uint8_t)(synth_random(synth) % 255 + 1);
+            out[length++] = (byte == '$') ? '#' : byte;
+        }
+        out[length++] = '\r';
+        out[length++] = '\n';
+        synth->stats.noise_lines++;
+    }
+
+    bool is_a0 = synth->config.a0_percent && synth_random(synth) % 100 < synth->config.a0_percent;
+    memcpy(out + length, is_a0 ? "$A0\r\n" : "$R0\r\n", 5);
+    length += 5;
+    format_timestamp(synth, (char *)out + length);
+    length += HD32MT_FRAME_TIMESTAMP_LEN;
+    out[length++] = ' ';
+
+    for (uint16_t ch = 0; ch < synth->config.channel_count; ++ch) {
+        float value = channel_value(synth, ch);
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        out[length++] = (uint8_t)(bits >> 24);
+        out[length++] = (uint8_t)(bits >> 16);
+        out[length++] = (uint8_t)(bits >> 8);
+        out[length++] = (uint8_t)bits;
+    }
+    memcpy(out + length, "&\r\n", 3);
+    length += 3;
+
+    synth->stats.records++;
+    return length;
+}
+
+static size_t build_keepalive(hd32mt_synth_t *synth)
+{
+    uint8_t *out = synth->chunk;
+    memcpy(out, "$FA\r\n", 5);
+    format_timestamp(synth, (char *)out + 5);
+    memcpy(out + 5 + HD32MT_FRAME_TIMESTAMP_LEN, "&\r\n", 3);
+    synth->stats.keepalives++;
+    return 5 + HD32MT_FRAME_TIMESTAMP_LEN + 3;
+}
+
+/* ------------------------------ Dışarıya Açık API ------------------------------ */
+
+bool hd32mt_synth_init(hd32mt_synth_t *synth, const hd32mt_synth_config_t *config)
+{
+    if (!synth || !config ||
+        config->channel_count == 0 || config->channel_count > HD32MT_SYNTH_MAX_CHANNELS ||
+        config->record_rate_hz == 0 || config->record_rate_hz > HD32MT_SYNTH_MAX_RATE_HZ ||
+        config->noise_bytes > HD32MT_SYNTH_MAX_NOISE_BYTES ||
+        config->tricky_percent > 100 || config->a0_percent > 100) {
+        return false;
+    }
+    memset(synth, 0, sizeof(*synth));
+    synth->config = *config;
+    hd32mt_synth_rewind(synth);
+    return true;
+}
+
+void hd32mt_synth_rewind(hd32mt_synth_t *synth)
+{
+    if (!synth) return;
+    synth->rng = synth->config.seed ? synth->config.seed : 1;
+
+    /* Parmak izi ayara bağlı: kanal sayısı değişirse şema yeniden öğrenilir */
+    uint32_t fp = synth->rng ^ ((uint32_t)synth->config.channel_count * 0x9E3779B9u);
+    for (int i = 0; i < 40; i += 8) {
+        fp ^= fp << 13;
+        fp ^= fp >> 17;
+        fp ^= fp << 5;
+        snprintf(synth->fingerprint + i, 9, "%08X", (unsigned)fp);
+    }
+
+    synth->config_line       = synth->config.send_config_block ? 0 : UINT32_MAX;
+    synth->record_index      = 0;
+    synth->now_us            = 0;
+    synth->next_record_us    = 0;
+    synth->next_keepalive_us = 0;
+}
+
+bool hd32mt_synth_next(hd32mt_synth_t *synth, const uint8_t **out_chunk, size_t *out_length,
+                       uint32_t *out_delta_us)
+{
+    if (!synth || !out_chunk || !out_length || !out_delta_us) {
+        return false;
+    }
+
+    /* Konfigürasyon bloğu bağlantı anında, beklemeden */
+    if (synth->config_line != UINT32_MAX) {
+        size_t length = config_line(synth, synth->config_line, (char *)synth->chunk, sizeof(synth->chunk));
+        if (length) {
+            synth->config_line++;
+            synth->stats.config_lines++;
+            synth->stats.bytes += length;
+            *out_chunk    = synth->chunk;
+            *out_length   = length;
+            *out_delta_us = 0;
+            return true;
+        }
+        synth->config_line = UINT32_MAX;
+    }
+
+    const bool keepalive = synth->config.keepalive_interval_ms &&
+                           synth->next_keepalive_us < synth->next_record_us;
+    if (!keepalive && synth->config.record_limit &&
+        synth->record_index >= synth->config.record_limit) {
+        return false;
+    }
+
+    uint64_t event_us = keepalive ? synth->next_keepalive_us : synth->next_record_us;
+    uint64_t delta_us = event_us - synth->now_us;
+    synth->now_us = event_us;
+
+    size_t length;
+    if (keepalive) {
+        length = build_keepalive(synth);
+        synth->next_keepalive_us += (uint64_t)synth->config.keepalive_interval_ms * 1000u;
+    } else {
+        length = build_record(synth);
+        synth->record_index++;
+        synth->next_record_us = record_time_us(synth, synth->record_index);
+    }
+
+    synth->stats.bytes += length;
+    *out_chunk    = synth->chunk;
+    *out_length   = length;
+    *out_delta_us = delta_us > UINT32_MAX ? UINT32_MAX : (uint32_t)delta_us;
+    return true;
+}
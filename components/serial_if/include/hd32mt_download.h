@@ -0,0 +1,67 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include "serial_if.h"
+
+/*
+ * HD32MT dahili belleğinden toplu kayıt indirme.
+ *
+ * Komut akışı (DELTA SAMPLE DATA yakalamasından çıkarıldı):
+ *   $!            → "$!&"   canlı akışı durdur
+ *   $DP<8 hex>    → "$+&"   belirtilen kayıt adresinden dökümü başlat
+ *   ... $R1 (ilk), $R0/$A0 kayıtları ...
+ *   "$!&"                    döküm bitti (ya da hat sessizleşir)
+ *   $J1           → "...&"   canlı akışı yeniden aç
+ *
+ * İndirilen kayıtlar normal yoldan geçer: çerçeveleyici → halka →
+ * parse → gönder/SD. Motor yalnızca komutları yollar, yanıtları
+ * serial_if_set_record_tap ile izler ve halka dolduğunda bekler.
+ */
+
+/* Adres NVS'ten okunur (son indirmenin kaldığı yer) */
+#define HD32MT_DOWNLOAD_RESUME  (0xFFFFFFFFu)
+
+typedef struct {
+    uint32_t    start_address;        /* Kayıt adresi ya da HD32MT_DOWNLOAD_RESUME */
+    int         download_baud_rate;   /* İndirme hızı, 0 = mevcut hızda kal */
+    const char *baud_switch_command;  /* Logger'ı hıza geçiren komut ("%d" = baud), NULL = gönderme */
+    uint32_t    ack_timeout_ms;       /* "$+&" / "$!&" bekleme süresi */
+    uint32_t    block_idle_ms;        /* Bu kadar kayıt gelmezse blok bitti sayılır */
+    uint32_t    max_backlog;          /* Halkada bu kadar kayıt varken yeni blok isteme */
+    uint8_t     max_retries;          /* Blok başına komut tekrar sayısı */
+} hd32mt_download_config_t;
+
+#define HD32MT_DOWNLOAD_DEFAULT_CONFIG()               \
+    {                                                  \
+        .start_address       = HD32MT_DOWNLOAD_RESUME, \
+        .download_baud_rate  = 0,                      \
+        .baud_switch_command = NULL,                   \
+        .ack_timeout_ms      = 1000,                   \
+        .block_idle_ms       = 2000,                   \
+        .max_backlog         = 16,                     \
+        .max_retries         = 3,                      \
+    }
+
+typedef struct {
+    bool     running;
+    uint32_t blocks;            /* Onaylanan $DP istekleri */
+    uint32_t records;           /* İndirilen veri kaydı */
+    uint32_t retries;           /* Cevapsız kalıp tekrarlanan komutlar */
+    uint32_t backlog_waits;     /* Halka dolu diye beklenen turlar */
+    uint32_t start_address;
+    uint32_t next_address;      /* Bir sonraki indirmenin başlayacağı adres */
+    int64_t  started_us;
+    int64_t  finished_us;
+    bool     succeeded;
+} hd32mt_download_stats_t;
+
+/**
+ * İndirmeyi arka plan görevinde başlatır. Aynı anda tek indirme çalışır.
+ * Bittiğinde canlı akış "$!" ile geri açılır ve hız eski haline döner.
+ * @return false  Zaten çalışıyor, geçersiz parametre ya da görev açılamadı
+ */
+bool hd32mt_download_start(serial_if_t *serial, const hd32mt_download_config_t *config);
+
+bool hd32mt_download_is_running(void);
+
+void hd32mt_download_get_stats(hd32mt_download_stats_t *out_stats);
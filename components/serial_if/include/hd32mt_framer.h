@@ -0,0 +1,107 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hd32mt_profile.h"
+
+/**
+ * Delta OHM HD32MT protokol çerçeveleyici (binary-safe durum makinesi).
+ *
+ * Veri kaydı (hat üzerinde):
+ *   "$R0" | "$A0"  [CR/LF]  YYMMDDhhmmss  ' '  N x 4 bayt float  '&'
+ *   (bellek dökümünün ilk kaydı "$R1": aynı biçim, bayrak '1')
+ *
+ * Kanal sayısı (N) biliniyorsa payload tam olarak N*4 bayt okunur; içindeki
+ * 0x0A / 0x0D / 0x26 baytları kaydı bölmez. N = 0 ise payload, 4'ün katı
+ * uzunlukta ilk '&' ile biter.
+ *
+ * Veri kaydı dışındaki her şey ($FA, konfigürasyon bloğu, ...) eskisi gibi
+ * '\r', '\n' veya '&' ile biten metin satırı olarak üretilir.
+ *
+ * Üretilen veri kaydı normalize edilmiştir (CR/LF atılır):
+ *   "$R0" YYMMDDhhmmss ' ' <N*4 bayt> '&'   (bayrak korunur: "$R1" ...)
+ *
+ * Önek, tip harfleri, bayraklar ve sonlandırıcı kaydedici profilinden gelir
+ * (hd32mt_framer_set_format); yukarıdakiler varsayılan profilin (HD32MT.1) değerleri.
+ */
+
+#define HD32MT_FRAMER_MAX_RECORD_BYTES  (1024)
+#define HD32MT_FRAME_PREFIX_LEN         (3)
+#define HD32MT_FRAME_TIMESTAMP_LEN      (12)
+#define HD32MT_FRAME_HEADER_LEN         (HD32MT_FRAME_PREFIX_LEN + HD32MT_FRAME_TIMESTAMP_LEN + 1)
+
+typedef enum {
+    HD32MT_FRAMER_TEXT = 0,     /* Metin satırı biriktiriliyor / kayıt aranıyor */
+    HD32MT_FRAMER_PREFIX,       /* '$' sonrası iki karakter bekleniyor */
+    HD32MT_FRAMER_TIMESTAMP,    /* 12 haneli zaman damgası */
+    HD32MT_FRAMER_SPACE,        /* Zaman damgası sonrası ' ' */
+    HD32MT_FRAMER_PAYLOAD,      /* N*4 bayt ham float */
+    HD32MT_FRAMER_TERMINATOR,   /* '&' */
+} hd32mt_framer_state_t;
+
+typedef struct {
+    uint32_t data_records;        /* Üretilen $R0/$A0 kaydı */
+    uint32_t text_lines;          /* Üretilen metin satırı */
+    uint32_t drop_bad_timestamp;  /* Zaman damgasında rakam olmayan bayt */
+    uint32_t drop_missing_space;  /* Zaman damgası sonrası ' ' yok */
+    uint32_t drop_bad_terminator; /* N*4 bayttan sonra '&' yok */
+    uint32_t drop_oversize;       /* Kayıt/satır tampondan uzun */
+    uint32_t resync_bytes;        /* Düşen kayıtlarla atılan bayt */
+} hd32mt_framer_stats_t;
+
+/**
+ * Tamamlanan kayıt için çağrılır. record '\0' ile bitmez, length kesindir.
+ * @param is_data  true: $R0/$A0 veri kaydı, false: metin satırı
+ */
+typedef void (*hd32mt_framer_emit_fn)(void *context, const char *record, size_t length, bool is_data);
+
+typedef struct {
+    hd32mt_framer_state_t state;
+    hd32mt_frame_format_t format;            /* Kayıt başlığı/sonu karakterleri */
+    hd32mt_frame_format_t next_format;
+    bool                  format_pending;    /* Kayıt okunurken değişti: kayıt bitince uygulanır */
+    uint16_t              channel_count;     /* 0 = bilinmiyor */
+    uint16_t              next_channel_count;
+    bool                  channel_count_pending;   /* Payload okunurken değişti: kayıt bitince uygulanır */
+    size_t                payload_remaining;
+    size_t                length;
+    char                  buffer[HD32MT_FRAMER_MAX_RECORD_BYTES];
+
+    hd32mt_framer_emit_fn emit;
+    void                 *emit_context;
+    hd32mt_framer_stats_t stats;
+} hd32mt_framer_t;
+
+/** Varsayılan profilin biçimiyle başlatır. */
+void hd32mt_framer_init(hd32mt_framer_t *framer, hd32mt_framer_emit_fn emit, void *emit_context);
+
+/**
+ * Kayıt karakterlerini profilden alır (format->channel_count kullanılmaz, N
+ * hd32mt_framer_set_channel_count ile). Kayıt okunurken çağrılırsa o kayıt
+ * eski biçimle tamamlanır.
+ */
+void hd32mt_framer_set_format(hd32mt_framer_t *framer, const hd32mt_frame_format_t *format);
+
+/**
+ * Kayıttaki float sayısını ayarlar (0 = bilinmiyor). Payload okunurken
+ * çağrılırsa yarım kayıt eski sayıyla tamamlanır, yenisi sonraki kayıttan
+ * itibaren geçerli olur (kayıt düşmez).
+ */
+void hd32mt_framer_set_channel_count(hd32mt_framer_t *framer, uint16_t channel_count);
+
+/** Yarım kalan kaydı/satırı atar. */
+void hd32mt_framer_reset(hd32mt_framer_t *framer);
+
+/** Ham baytları işler; tamamlanan her kayıt için emit çağrılır. */
+void hd32mt_framer_feed(hd32mt_framer_t *framer, const uint8_t *bytes, size_t byte_count);
+
+/**
+ * Normalize veri kaydı üretir (varsayılan profille çerçeveleyicinin çıktısı):
+ *   "$R0" YYMMDDhhmmss ' ' <N x 4 bayt big-endian float> '&'
+ * HD32MT dışı kaynakların (Modbus vb.) kayıtları aynı hattan geçsin diye.
+ *
+ * @param timestamp  12 haneli YYMMDDhhmmss
+ * @return Yazılan bayt sayısı, 0 = geçersiz girdi / tampon küçük
+ */
+size_t hd32mt_record_encode(const char *timestamp, const float *values, size_t value_count,
+                            char *out, size_t out_capacity);
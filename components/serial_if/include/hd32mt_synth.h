@@ -0,0 +1,91 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hd32mt_framer.h"
+
+/**
+ * Sentetik HD32MT akışı üreteci (yük / uzun süreli dayanıklılık testi).
+ *
+ * Protokole uygun bayt akışı üretir:
+ *  - Bağlantıdaki konfigürasyon bloğu (#const/#unit, [DLType], [Table1], parmak izi)
+ *  - "$FA" + "YYMMDDhhmmss&" canlılık satırları
+ *  - "$R0"/"$A0" CRLF YYMMDDhhmmss ' ' <N x 4 bayt big-endian float> '&' CRLF
+ *  - İsteğe bağlı gürültü satırları ('$' içermez; sayılan kayıt kaybolmaz)
+ *  - İsteğe bağlı "zor" değerler: payload'da 0x26 ('&'), 0x0A, 0x0D baytları
+ *
+ * Çıktı, serial_replay ile aynı parça arayüzündedir ({delta_us, baytlar});
+ * serial_replay_open_synth ile UART'ın girdiği noktadan beslenir ya da
+ * Linux'ta serial_replay_pump_fd ile bir pty'ye yazılır.
+ *
+ * Bu dosya FreeRTOS/ESP bağımlılığı içermez (host'ta da derlenir).
+ */
+
+#define HD32MT_SYNTH_MAX_CHANNELS \
+    ((HD32MT_FRAMER_MAX_RECORD_BYTES - HD32MT_FRAME_HEADER_LEN - 1) / 4)
+#define HD32MT_SYNTH_MAX_NOISE_BYTES   (64)
+/* Gürültü satırı + CRLF'li kayıt */
+#define HD32MT_SYNTH_CHUNK_BYTES       (HD32MT_SYNTH_MAX_NOISE_BYTES + HD32MT_FRAMER_MAX_RECORD_BYTES + 16)
+
+typedef struct {
+    uint16_t channel_count;          /* 1..HD32MT_SYNTH_MAX_CHANNELS */
+    uint32_t record_rate_hz;         /* Saniyedeki kayıt, 1..1000 */
+    uint32_t keepalive_interval_ms;  /* "$FA" aralığı, 0 = yok */
+    bool     send_config_block;      /* Başta konfigürasyon bloğu */
+    uint16_t noise_bytes;            /* Kayıt başına gürültü satırı uzunluğu, 0 = yok */
+    uint8_t  tricky_percent;         /* Değerlerin yüzde kaçı 0x26/0x0A/0x0D içersin */
+    uint8_t  a0_percent;             /* Kayıtların yüzde kaçı "$A0" olsun */
+    uint32_t record_limit;           /* Bu kadar kayıttan sonra biter, 0 = sonsuz */
+    int64_t  start_epoch;            /* İlk kaydın zamanı (UTC) */
+    uint32_t seed;
+} hd32mt_synth_config_t;
+
+#define HD32MT_SYNTH_DEFAULT_CONFIG()           \
+    {                                           \
+        .channel_count         = 4,             \
+        .record_rate_hz        = 1,             \
+        .keepalive_interval_ms = 0,             \
+        .send_config_block     = true,          \
+        .noise_bytes           = 0,             \
+        .tricky_percent        = 0,             \
+        .a0_percent            = 0,             \
+        .record_limit          = 0,             \
+        .start_epoch           = 1722513600,    \
+        .seed                  = 1,             \
+    }
+
+typedef struct {
+    uint32_t records;          /* Üretilen $R0/$A0 kaydı */
+    uint32_t keepalives;
+    uint32_t config_lines;
+    uint32_t noise_lines;
+    uint32_t tricky_values;
+    uint64_t bytes;
+} hd32mt_synth_stats_t;
+
+typedef struct {
+    hd32mt_synth_config_t config;
+    uint32_t              rng;
+    uint32_t              config_line;       /* Sıradaki konfigürasyon satırı */
+    uint32_t              record_index;      /* Bu turdaki kayıt */
+    uint64_t              now_us;            /* Üretilen akışın zamanı */
+    uint64_t              next_record_us;
+    uint64_t              next_keepalive_us;
+    char                  fingerprint[41];
+    uint8_t               chunk[HD32MT_SYNTH_CHUNK_BYTES];
+    hd32mt_synth_stats_t  stats;
+} hd32mt_synth_t;
+
+/** Ayarları doğrular ve üreteci başa alır. */
+bool hd32mt_synth_init(hd32mt_synth_t *synth, const hd32mt_synth_config_t *config);
+
+/** Aynı ayar ve tohumla baştan (sayaçlar korunur). */
+void hd32mt_synth_rewind(hd32mt_synth_t *synth);
+
+/**
+ * Sıradaki parçayı üretir (veri üretecin içindedir, sonraki çağrıya kadar geçerli).
+ * @param out_delta_us  Önceki parçaya göre akış zamanı farkı
+ * @return false        record_limit doldu
+ */
+bool hd32mt_synth_next(hd32mt_synth_t *synth, const uint8_t **out_chunk, size_t *out_length,
+                       uint32_t *out_delta_us);
@@ -1,16 +1,154 @@
 #pragma once
 #include <stdbool.h>
-#include "freertos/queue.h"
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/uart.h"
+#include "serial_ring.h"
+#include "serial_spill.h"
+#include "serial_replay.h"
+#include "hd32mt_framer.h"
+
+/** UART alım modu */
+typedef enum {
+    SERIAL_RX_MODE_POLL = 0,   /* 100 ms okuma penceresi + boşta 10 ms (eski davranış) */
+    SERIAL_RX_MODE_EVENT,      /* Sürücü olay kuyruğu + '&' desen algılama */
+    SERIAL_RX_MODE_REPLAY,     /* UART yerine yakalama dosyasından besleme (test/ölçüm) */
+    SERIAL_RX_MODE_COUNT
+} serial_rx_mode_t;
+
+/**
+ * Son bayt → halkaya yazma gecikmesi (mikrosaniye).
+ * Olay modunda başlangıç '&' desen olayıdır (≈ son bayt). Poll modunda sürücü
+ * tamponunun son büyüdüğü yoklamadır (çözünürlük bir tick); okuma penceresinin
+ * son bayttan sonra kalanı dahildir.
+ *
+ * wait_*: yalnızca poll modu, parça başına. İlk baytın görünmesinden önceki son
+ * boş yoklama → okuma; okuma penceresi ve boşta uyku (~zaman aşımı + 10 ms) dahil.
+ * Olay modunda bayt sürücüde beklemez, sayaçlar 0 kalır.
+ */
+typedef struct {
+    uint32_t records;      /* Ölçülen kayıt sayısı */
+    uint32_t last_us;      /* Son kaydın gecikmesi */
+    uint32_t max_us;       /* En kötü gecikme */
+    uint64_t total_us;     /* Ortalama için toplam */
+    uint32_t chunks;       /* Poll: okunan parça */
+    uint32_t wait_max_us;  /* Poll: en uzun sürücü beklemesi */
+    uint64_t wait_total_us;
+} serial_latency_stats_t;
+
+/** Bir UART / bir HD32MT cihazı için ayarlar */
+typedef struct {
+    uart_port_t      uart_port;
+    int              tx_gpio;
+    int              rx_gpio;
+    int              baud_rate;
+    serial_rx_mode_t rx_mode;
+    uint8_t          instrument_id;          /* Kayıtlara taşınan cihaz kimliği */
+    uint16_t         record_channel_count;   /* $R0/$A0 float sayısı, 0 = bilinmiyor */
+    serial_replay_t *replay;                 /* Sadece SERIAL_RX_MODE_REPLAY, UART kurulmaz */
+} serial_if_config_t;
+
+/* Kartın varsayılan HD32MT portu (UART1, TX=17, RX=16) */
+#define SERIAL_IF_DEFAULT_CONFIG()              \
+    {                                           \
+        .uart_port            = UART_NUM_1,     \
+        .tx_gpio              = 17,             \
+        .rx_gpio              = 16,             \
+        .baud_rate            = 1150200,        \
+        .rx_mode              = SERIAL_RX_MODE_EVENT, \
+        .instrument_id        = 0,              \
+        .record_channel_count = 0,              \
+        .replay               = NULL,           \
+    }
+
+/** UART başına bağlam (opak) */
+typedef struct serial_if serial_if_t;
+
+/**
+ * Bir UART için bağlam oluşturur. UART henüz kurulmaz.
+ * @return NULL  Geçersiz ayar, port zaten kullanımda ya da bellek yok
+ */
+serial_if_t *serial_if_create(const serial_if_config_t *config);
 
 /**
- * Seri okuma görevini başlatır ve tamamlanan satırları verilen kuyruğa yazar.
- * - Her satır NULL-terminated string olarak kuyruğa konur.
- * - Kuyruk oluştururken item size, göndereceğiniz maksimum satır uzunluğu + 1 olmalı.
+ * UART'ı kurar, alıcı görevini başlatır ve tamamlanan kayıtları halkaya yazar.
+ * - Baytlar hd32mt_framer'dan geçer; her kayıt/satır halkaya bir kez kopyalanır.
+ * - Veri kayıtları binary payload içerebilir, uzunluk tanımlayıcıdan alınmalı.
+ * - Her yeni kayıtta consumer_task'a xTaskNotifyGive gönderilir.
+ * - Halka SPSC'dir: her bağlamın kendi halkası olmalı.
  *
- * @param target_queue     xQueueCreate ile oluşturduğun kuyruk.
- * @param max_line_bytes   Kuyrukta her öğe için ayrılan maksimum byte (örn. 1024).
+ * @param target_ring      serial_ring_init ile hazırlanmış SPSC halka.
+ * @param consumer_task    Halkayı tüketen görev (NULL ise bildirim yapılmaz).
  * @return true            Başarılıysa.
  */
-void serial_if_init(void);
-void serial_if_start(void);
-bool serial_start_and_bind_line_queue(QueueHandle_t target_queue, size_t max_line_bytes);
+bool serial_if_start(serial_if_t *ctx, serial_ring_t *target_ring, TaskHandle_t consumer_task);
+
+uint8_t serial_if_get_instrument_id(const serial_if_t *ctx);
+serial_rx_mode_t serial_if_get_rx_mode(const serial_if_t *ctx);
+const char *serial_if_rx_mode_name(serial_rx_mode_t mode);
+
+/** Bağlamın (kendi alım modundaki) gecikme sayaçlarını kopyalar. */
+void serial_if_get_latency_stats(const serial_if_t *ctx, serial_latency_stats_t *out_stats);
+
+/**
+ * $R0/$A0 kayıtlarındaki float sayısını çerçeveleyiciye bildirir.
+ * Biliniyorsa payload tam N*4 bayt okunur (binary-safe); 0 = bilinmiyor
+ * (profilin sabit sayısı varsa o kullanılır).
+ * Her görevden çağrılabilir; alıcı görev sonraki parçadan önce uygular.
+ */
+void serial_if_set_record_channel_count(serial_if_t *ctx, uint16_t channel_count);
+
+/**
+ * Kaydedici profilini çerçeveleyiciye bildirir: önek, tip harfleri, bayraklar,
+ * sonlandırıcı ve (ayarda açık kanal sayısı yoksa) profilin sabit kanal sayısı.
+ * profile statik tablodandır (hd32mt_profile_get/find). Her görevden
+ * çağrılabilir; alıcı görev sonraki parçadan önce uygular.
+ */
+void serial_if_set_profile(serial_if_t *ctx, const hd32mt_profile_t *profile);
+
+/** Çerçeveleme sayaçlarını (üretilen kayıt, düşme nedenleri) kopyalar. */
+void serial_if_get_framer_stats(const serial_if_t *ctx, hd32mt_framer_stats_t *out_stats);
+
+/**
+ * Her tamamlanan kayıt/satır için (halkaya yazılmadan önce, alıcı görev
+ * bağlamında) çağrılır. Komut/yanıt akışlarını izlemek içindir; kısa tutulmalı.
+ */
+typedef void (*serial_if_record_tap_fn)(void *tap_arg, const char *record, size_t length, bool is_data);
+
+/* Fonksiyon ve argümanı tek nesne: alıcı görev ikisini birlikte görür */
+typedef struct {
+    serial_if_record_tap_fn fn;
+    void                   *arg;
+} serial_if_record_tap_t;
+
+/**
+ * Gözlemciyi bağlar (NULL = kaldırır); her görevden çağrılabilir.
+ * tap bağlı kaldığı sürece geçerli kalmalı (çağıranın nesnesi, kopyalanmaz).
+ * Dönüşte önceki gözlemci artık çalışmıyordur: alıcı görev onun içindeyse
+ * çağrı bitene kadar beklenir, bu yüzden gözlemcinin içinden çağrılmamalı.
+ */
+void serial_if_set_record_tap(serial_if_t *ctx, const serial_if_record_tap_t *tap);
+
+/** Cihaza komut gönderir (bloklayan). @return yazılan bayt, hata -1 */
+int serial_if_write(serial_if_t *ctx, const void *data, size_t length);
+
+/** UART hızını değiştirir (önce bekleyen TX'in bitmesini bekler). */
+bool serial_if_set_baud_rate(serial_if_t *ctx, int baud_rate);
+int serial_if_get_baud_rate(const serial_if_t *ctx);
+
+/**
+ * Ana halka dolunca kayıtları düşürmek yerine taşma katmanına yazar.
+ * serial_if_start'tan önce çağrılmalı; tüketici serial_spill_peek ile okumalı.
+ */
+void serial_if_set_overflow(serial_if_t *ctx, serial_spill_t *overflow);
+
+/** Halkada (ve taşma katmanında) tüketilmeyi bekleyen kayıt sayısı (akış kontrolü için). */
+uint32_t serial_if_get_backlog(const serial_if_t *ctx);
+
+/**
+ * UART'tan gelen ham baytları (çerçevelemeden önce) zamanlarıyla birlikte
+ * yakalama dosyasına yazar; sonradan SERIAL_RX_MODE_REPLAY ile oynatılabilir.
+ * serial_if_start'tan önce bağlanmalı. NULL = kaydı durdur.
+ */
+void serial_if_set_capture(serial_if_t *ctx, serial_capture_t *capture);
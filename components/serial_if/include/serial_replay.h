@@ -0,0 +1,136 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "hd32mt_synth.h"
+
+/**
+ * Seri yakalama kaydı / tekrar oynatma.
+ *
+ * Ham UART baytları, geliş zamanlarıyla birlikte kaydedilir ve serial_if'e
+ * UART'ın girdiği noktadan (çerçeveleyiciden önce) geri beslenir. Böylece
+ * çerçeveleme → halka → parse → gönderim hattı sahadaki akışla birebir
+ * ve tekrarlanabilir şekilde ölçülebilir.
+ *
+ * Desteklenen kaynaklar:
+ *  - İkili yakalama ("HDCP"): başlık + { u32 delta_us, u16 uzunluk, baytlar }*
+ *  - Metin dökümü (DELTA SAMPLE DATA.txt): "NNNNNN: " önekli satırlar;
+ *    önek atılır, satır sonu "\r\n" olarak beslenir, satır arası sabit süre.
+ *  - Sentetik üreteç (hd32mt_synth): ayarlanabilir hız/kanal/gürültü ile
+ *    sonsuz ya da record_limit kadar akış.
+ *
+ * Bu dosya FreeRTOS/ESP bağımlılığı içermez; Linux host derlemesinde de
+ * kullanılabilir. Bölümden (esp_partition_mmap) açma yalnızca cihazda vardır.
+ */
+
+#define SERIAL_CAPTURE_MAGIC            "HDCP"
+#define SERIAL_CAPTURE_VERSION          (1)
+#define SERIAL_CAPTURE_HEADER_BYTES     (12)   /* magic(4) + version(2) + flags(2) + body(4) */
+#define SERIAL_CAPTURE_CHUNK_HEADER     (6)    /* delta_us(4) + length(2) */
+
+/* Hız çarpanı: 1 = gerçek zaman, 1000 = 1000 kat hızlı, 0 = beklemeden */
+#define SERIAL_REPLAY_SPEED_REALTIME    (1)
+#define SERIAL_REPLAY_SPEED_MAX         (1000)
+#define SERIAL_REPLAY_SPEED_UNTHROTTLED (0)
+
+/* Metin dökümünde satırlar arası varsayılan süre (eski test_inject_task: 1 sn) */
+#define SERIAL_REPLAY_TEXT_LINE_INTERVAL_US (1000000u)
+
+typedef enum {
+    SERIAL_REPLAY_FORMAT_CAPTURE = 0,   /* İkili, zamanlı */
+    SERIAL_REPLAY_FORMAT_TEXT,          /* Satır numaralı metin dökümü */
+    SERIAL_REPLAY_FORMAT_SYNTH,         /* hd32mt_synth üreteci */
+} serial_replay_format_t;
+
+typedef struct {
+    uint32_t chunks;         /* Beslenen parça */
+    uint64_t bytes;          /* Beslenen bayt */
+    uint32_t passes;         /* Tamamlanan tur (loop ile) */
+    uint32_t late_chunks;    /* Zamanında beslenemeyen parça (hız yetmedi) */
+    uint32_t max_late_us;    /* En büyük gecikme */
+    uint32_t corrupt;        /* Bozuk parça başlığı nedeniyle erken biten tur */
+} serial_replay_stats_t;
+
+typedef struct {
+    const uint8_t         *data;
+    size_t                 size;
+    size_t                 position;
+    serial_replay_format_t format;
+
+    uint32_t               speed_scale;            /* 0 veya 1..SERIAL_REPLAY_SPEED_MAX */
+    uint32_t               text_line_interval_us;
+    bool                   loop;                   /* Sona gelince baştan */
+
+    bool                   pending_line_end;       /* Metin: satır içeriğinden sonra "\r\n" */
+    serial_replay_stats_t  stats;
+
+    hd32mt_synth_t        *synth;                  /* SERIAL_REPLAY_FORMAT_SYNTH */
+    void                  *owned_buffer;           /* Dosyadan yüklendiyse serbest bırakılır */
+    void                  *mmap_handle;            /* Bölümden açıldıysa */
+} serial_replay_t;
+
+/**
+ * Bellekteki yakalamayı açar; biçim başlıktan otomatik anlaşılır.
+ * Veri kopyalanmaz, replay süresince geçerli kalmalı.
+ */
+bool serial_replay_open(serial_replay_t *replay, const uint8_t *data, size_t size);
+
+/** Dosyayı belleğe yükleyip açar (SPIFFS/SD ya da host dosya sistemi). */
+bool serial_replay_open_file(serial_replay_t *replay, const char *path);
+
+#ifdef ESP_PLATFORM
+/** Veri bölümünü belleğe eşleyip (esp_partition_mmap) açar, kopyalamaz. */
+bool serial_replay_open_partition(serial_replay_t *replay, const char *partition_label);
+#endif
+
+/** Sentetik üreteci kaynak olarak açar (üreteç replay süresince geçerli kalmalı). */
+bool serial_replay_open_synth(serial_replay_t *replay, hd32mt_synth_t *synth);
+
+void serial_replay_close(serial_replay_t *replay);
+
+/** Hız çarpanını ayarlar (SERIAL_REPLAY_SPEED_MAX ile sınırlanır). */
+void serial_replay_set_speed(serial_replay_t *replay, uint32_t speed_scale);
+
+/** Başa sarar (sayaçlar korunur). */
+void serial_replay_rewind(serial_replay_t *replay);
+
+/**
+ * Sıradaki parçayı verir.
+ * @param out_delta_us  Önceki parçaya göre yakalama zamanı farkı (ölçeklenmemiş)
+ * @return false        Kaynak bitti
+ */
+bool serial_replay_next(serial_replay_t *replay, const uint8_t **out_chunk, size_t *out_length,
+                        uint32_t *out_delta_us);
+
+/** Yakalama zamanı farkını hız çarpanına göre gerçek bekleme süresine çevirir. */
+uint64_t serial_replay_scale_us(const serial_replay_t *replay, uint64_t capture_us);
+
+#ifndef ESP_PLATFORM
+/**
+ * Linux: kaynağı zamanlamasına uyarak bir dosya tanımlayıcısına yazar
+ * (ör. openpty/socat ile açılan pty'nin master ucu). loop ayarlıysa sürekli.
+ * @return false  Yazma hatası
+ */
+bool serial_replay_pump_fd(serial_replay_t *replay, int fd);
+#endif
+
+/* ------------------------------- Kayıt (yakalama) ------------------------------- */
+
+typedef struct {
+    FILE    *file;
+    int64_t  last_chunk_us;   /* Önceki parçanın son bayt zamanı */
+    uint32_t body_bytes;
+    uint32_t chunks;
+    bool     failed;
+} serial_capture_t;
+
+/** Yakalama dosyasını oluşturur ve başlığı yazar. */
+bool serial_capture_open(serial_capture_t *capture, const char *path);
+
+/** Bir UART parçasını, son bayt zamanıyla birlikte ekler. */
+bool serial_capture_write(serial_capture_t *capture, const uint8_t *bytes, size_t length,
+                          int64_t last_byte_time_us);
+
+/** Başlıktaki gövde uzunluğunu günceller ve dosyayı kapatır. */
+void serial_capture_close(serial_capture_t *capture);
@@ -0,0 +1,80 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+/**
+ * Tek üretici / tek tüketici (SPSC) kilitsiz bayt halkası.
+ *
+ * - Üretici (serial_receiver_task) tamamlanan satırı halkaya BİR kez kopyalar.
+ * - Tüketici (telemetry_task) (offset, length) tanımlayıcısını alır ve
+ *   baytları halkanın içinde, kopyalamadan ayrıştırır.
+ * - Her kayıt halkada bitişik tutulur; sona sığmayan kayıt için kalan
+ *   kısım atlanır ve kayıt 0. ofsetten başlar.
+ * - Kayıtların sonuna '\0' eklenir; length bu baytı içermez.
+ *
+ * Sayaçlar serbest koşan 32-bit değerlerdir, taşma sorun değildir.
+ */
+
+/* Serbest koşan 32-bit sayaçların farkı doğru kalsın diye üst sınır */
+#define SERIAL_RING_MAX_DATA_BYTES  (1u << 30)
+
+typedef struct {
+    uint32_t end;      /* Kayıt bırakılınca data_tail'in alacağı değer */
+    uint32_t offset;   /* Kaydın halka içindeki başlangıcı */
+    uint16_t length;   /* Kayıt uzunluğu ('\0' hariç) */
+} serial_ring_desc_t;
+
+typedef struct {
+    uint32_t pushed;            /* Halkaya yazılan kayıt */
+    uint32_t dropped_full;      /* Yer olmadığı için düşürülen kayıt */
+    uint32_t peak_data_bytes;   /* Görülen en yüksek bayt doluluğu */
+    uint32_t peak_descs;        /* Görülen en yüksek kayıt doluluğu */
+} serial_ring_stats_t;
+
+typedef struct {
+    uint8_t            *data;
+    uint32_t            data_size;    /* 2'nin kuvveti olmalı */
+    serial_ring_desc_t *descs;
+    uint32_t            desc_count;   /* 2'nin kuvveti olmalı */
+
+    /* Üretici tarafı */
+    uint32_t            data_head;
+    atomic_uint         desc_head;
+
+    /* Tüketici tarafı */
+    atomic_uint         data_tail;
+    atomic_uint         desc_tail;
+
+    serial_ring_stats_t stats;
+} serial_ring_t;
+
+/**
+ * Halkayı çağıranın verdiği belleklerle hazırlar.
+ * @param data_size   2'nin kuvveti, en fazla SERIAL_RING_MAX_DATA_BYTES
+ * @param desc_count  2'nin kuvveti
+ */
+bool serial_ring_init(serial_ring_t *ring,
+                      uint8_t *data, size_t data_size,
+                      serial_ring_desc_t *descs, size_t desc_count);
+
+/** Üretici: kaydı halkaya kopyalar. Yer yoksa false döner (kayıt düşer). */
+bool serial_ring_push(serial_ring_t *ring, const void *record, size_t length);
+
+/** Tüketici: sıradaki kaydı çıkarmadan döndürür. Boşsa false. */
+bool serial_ring_peek(serial_ring_t *ring, serial_ring_desc_t *out_desc);
+
+/** Tüketici: tanımlayıcının gösterdiği kayda halka içinden erişim. */
+static inline const char *serial_ring_record(const serial_ring_t *ring,
+                                             const serial_ring_desc_t *desc)
+{
+    return (const char *)&ring->data[desc->offset];
+}
+
+/** Tüketici: peek ile alınan kaydı serbest bırakır. */
+void serial_ring_release(serial_ring_t *ring, const serial_ring_desc_t *desc);
+
+/** Anlık doluluk: bayt sayısı üretici, kayıt sayısı her iki taraftan okunabilir. */
+uint32_t serial_ring_used_bytes(const serial_ring_t *ring);
+uint32_t serial_ring_pending(const serial_ring_t *ring);
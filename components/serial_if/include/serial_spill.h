@@ -0,0 +1,86 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdatomic.h>
+#include "serial_ring.h"
+
+/**
+ * Ana halka dolunca devreye giren taşma katmanı.
+ *
+ *  Katman 1: Büyük PSRAM halkası (PSRAM yoksa daha küçük dahili RAM halkası)
+ *  Katman 2: SD kart dosyası (isteğe bağlı, yalnızca tüketici görev yazar)
+ *
+ * Sıra kuralı:
+ *  - Ana halka bir kez dolunca üretici, taşma tamamen boşalana kadar
+ *    yeni kayıtları da taşma halkasına yazar (yeni kayıt eskisini geçemez).
+ *  - Tüketici taşma halkası yüksek su seviyesini aşınca EN ESKİ kayıtları
+ *    SD dosyasına taşır; bu yüzden okuma sırası: ana → SD → PSRAM.
+ *
+ * Üretici: alıcı görev, tüketici: telemetri görevi (SPSC korunur).
+ */
+
+typedef struct {
+    uint32_t spilled;        /* Taşma halkasına yazılan kayıt */
+    uint32_t sd_spilled;     /* Taşma halkasından SD'ye taşınan kayıt */
+    uint32_t recovered;      /* Taşma katmanlarından sırayla geri okunan kayıt */
+    uint32_t lost;           /* Hiçbir katmana sığmayıp kaybolan kayıt (üretici) */
+    uint32_t sd_lost;        /* SD dosyası okunamadığı için kaybolan kayıt (tüketici) */
+    uint32_t sd_errors;      /* SD okuma/yazma hatası */
+    uint32_t peak_pending;   /* Taşma katmanlarında görülen en çok kayıt */
+} serial_spill_stats_t;
+
+typedef struct {
+    /* Katman 1 */
+    serial_ring_t        ring;
+    uint8_t             *ring_data;
+    serial_ring_desc_t  *ring_descs;
+    bool                 ring_in_psram;
+    atomic_bool          active;         /* Üretici taşma halkasına yazıyor */
+
+    /* Katman 2 (tüketici tarafı) */
+    FILE                *sd_file;
+    char                 sd_path[48];
+    uint32_t             sd_read_offset;
+    uint32_t             sd_write_offset;
+    atomic_uint          sd_records;     /* SD'de okunmayı bekleyen kayıt */
+    char                *sd_read_buffer; /* SD'den okunan kayıt ('\0' ile) */
+
+    serial_spill_stats_t stats;
+} serial_spill_t;
+
+/** Tüketicinin işlediği kayıt: hangi katmandan geldiği release için saklanır */
+typedef struct {
+    const char        *record;
+    size_t             length;
+    serial_ring_t     *source_ring;   /* NULL ise SD katmanı */
+    serial_ring_desc_t desc;
+    uint32_t           sd_next_offset;
+} serial_spill_item_t;
+
+/**
+ * Taşma katmanını hazırlar. PSRAM varsa oradan, yoksa dahili RAM'den
+ * (SERIAL_SPILL_FALLBACK_* boyutlarında) yer ayrılır.
+ * @param sd_path  SD dosyası (ör. "/sdcard/spill_0.bin"), NULL = SD katmanı yok
+ */
+bool serial_spill_init(serial_spill_t *spill, const char *sd_path);
+
+/** Üretici: kaydı sırayı bozmadan ana halkaya ya da taşma halkasına yazar. */
+bool serial_spill_push(serial_spill_t *spill, serial_ring_t *primary,
+                       const void *record, size_t length);
+
+/** Tüketici: sıradaki kaydı (ana → SD → PSRAM) çıkarmadan döndürür. */
+bool serial_spill_peek(serial_spill_t *spill, serial_ring_t *primary, serial_spill_item_t *out_item);
+
+/** Tüketici: peek ile alınan kaydı bırakır. */
+void serial_spill_release(serial_spill_t *spill, const serial_spill_item_t *item);
+
+/**
+ * Tüketici: taşma halkası yüksek su seviyesini aştıysa en eski kayıtları
+ * SD'ye taşır. Tüketici görev her turda çağırır.
+ */
+void serial_spill_service(serial_spill_t *spill);
+
+/** Taşma katmanlarında bekleyen toplam kayıt (PSRAM + SD). */
+uint32_t serial_spill_pending(const serial_spill_t *spill);
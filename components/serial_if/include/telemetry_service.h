@@ -1,15 +1,162 @@
 #pragma once
 #include <stdbool.h>
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "serial_if.h"
+#include "hd32mt_download.h"
+#include "hd32mt_alarm.h"
+
+/* Aynı kabinde okunabilecek en fazla kaynak (HD32MT cihazları + Modbus hattı) */
+#define TELEMETRY_MAX_INSTRUMENTS 4
+
+/**
+ * Pencereli gönderim: kayıtlar pencere boyunca kanal başına özetlenir
+ * (ort/min/max/sapma/adet/ilk/son) ve pencere başına tek "AGG" satırı gider.
+ *
+ *  window_sec      0 = cfg_if send_interval_sec; 1 = her kayıt ayrı satır (pencere yok)
+ *  align_to_clock  Pencereler saat sınırlarında (epoch % window_sec == 0) başlar
+ *  raw_to_sd       Ham kayıtlar ayrıca SD'ye yazılır (sunucuya yalnızca özet gider)
+ */
+typedef struct {
+    uint32_t window_sec;
+    bool     align_to_clock;
+    bool     raw_to_sd;
+} telemetry_aggregation_config_t;
+
+#define TELEMETRY_AGGREGATION_DEFAULT_CONFIG() { \
+    .window_sec     = 0,                           \
+    .align_to_clock = true,                        \
+    .raw_to_sd      = true,                        \
+}
+
+/** Servis başlatılmadan önce çağrılmalıdır; çağrılmazsa varsayılan ayar kullanılır. */
+void telemetry_service_set_aggregation(const telemetry_aggregation_config_t *config);
+
+/**
+ * İstisna ile raporlama (yalnızca kayıt başına gönderimde, window_sec = 1):
+ * kanal, son gönderilen değerinden max(absolute, percent% * |değer|) kadar
+ * uzaklaşınca ya da heartbeat_sec boyunca gönderilmediyse raporlanır.
+ * Değişen kanallar seyrek "DELTA" satırıyla, hepsi değiştiyse tam satırla
+ * gider; SD'ye her kayıt tam yazılır.
+ */
+typedef struct {
+    bool     enabled;
+    float    absolute;        /* Tüm kanallar için varsayılan bant */
+    float    percent;
+    uint32_t heartbeat_sec;   /* Kanal başına en uzun sessizlik, 0 = yok */
+} telemetry_deadband_config_t;
+
+#define TELEMETRY_DEADBAND_DEFAULT_CONFIG() { \
+    .enabled       = false,                     \
+    .absolute      = 0.0f,                      \
+    .percent       = 0.0f,                      \
+    .heartbeat_sec = 300,                       \
+}
+
+/** Servis başlatılmadan önce çağrılmalıdır. */
+void telemetry_service_set_deadband(const telemetry_deadband_config_t *config);
+
+/**
+ * Tek kanalın bandı (kaynak eklendikten sonra, ör. ışınım kanalına geniş bant).
+ * Kapasite değişse de korunur. Servis çalışırken her görevden çağrılabilir.
+ * @param channel  0'dan başlayan kanal
+ */
+bool telemetry_service_set_channel_deadband(uint8_t instrument_id, uint8_t channel,
+                                            float absolute, float percent);
+
+/**
+ * Kanal alarm kuralı (bkz. hd32mt_alarm.h). Kurallar kayıt çözülür çözülmez
+ * değerlendirilir; olaylar alarm hızlı hattından (alarm_sender) gider,
+ * kayıt ayrıca normal yoldan da geçer. İlk kural alarm hattını başlatır.
+ * Servis çalışırken her görevden çağrılabilir.
+ *
+ * @param channel  0'dan başlayan kanal (türetilmiş kanallar dahil)
+ * @param rule     NULL ise kanalın kuralı kaldırılır
+ */
+bool telemetry_service_set_alarm_rule(uint8_t instrument_id, uint8_t channel,
+                                      const hd32mt_alarm_rule_t *rule);
 
 /**
  * Telemetri hattını başlatır:
  *  - Serial RX görevini başlatır (ham satır üretir)
- *  - Satırları alan bir "işleme" görevini başlatır (parse + send [+yakında SD])
+ *  - Satırları alan bir "işleme" görevini başlatır (parse + SD; sunucu
+ *    satırları uplink_conn kuyruğuna bırakılır, ağ beklenmez)
+ *
+ * Varsayılan tek cihazlık kurulum (SERIAL_IF_DEFAULT_CONFIG) kullanılır.
  *
  * @param total_channel_count  Web tarafında beklenen toplam kanal sayısı (ör. 10)
  * @return true                Başarıyla başlatıldıysa
  */
 bool telemetry_service_start(int total_channel_count);
+
+/**
+ * Birden fazla HD32MT cihazı için telemetri hattını başlatır.
+ *  - Her cihaz kendi UART bağlamı, alıcı görevi ve halkasıyla çalışır.
+ *  - Tek bir işleme görevi halkaları sırayla tüketir; kayıtlar
+ *    instrument_id ile etiketlenip gönderilir.
+ *
+ * @param instruments          Cihaz ayarları (instrument_id'ler farklı olmalı)
+ * @param instrument_count     1..TELEMETRY_MAX_INSTRUMENTS
+ * @param total_channel_count  Web tarafında beklenen toplam kanal sayısı (ör. 10)
+ * @return true                Başarıyla başlatıldıysa
+ */
+bool telemetry_service_start_instruments(const serial_if_config_t *instruments,
+                                         size_t instrument_count,
+                                         int total_channel_count);
+
+/**
+ * Cihazın dahili belleğindeki kayıtları toplu indirir (arka planda).
+ * İndirilen kayıtlar canlı kayıtlarla aynı parse/gönder/SD yolundan geçer.
+ *
+ * @param config  NULL ise HD32MT_DOWNLOAD_DEFAULT_CONFIG (NVS'teki adresten devam)
+ * @return true   İndirme görevi başlatıldıysa
+ */
+bool telemetry_service_download_history(uint8_t instrument_id,
+                                        const hd32mt_download_config_t *config);
+
+/** Kaynak başına uçtan uca sayaçlar (çerçeve → halka → parse → gönderim) */
+typedef struct {
+    uint32_t framed_records;   /* Çerçeveleyicinin ürettiği veri kaydı (UART kaynakları) */
+    uint32_t framer_drops;     /* Bozuk başlık/sonlandırıcı/boyut nedeniyle atılan */
+    uint32_t ring_pushed;      /* Halkaya giren kayıt/satır */
+    uint32_t ring_dropped;     /* Halka (ve taşma katmanı yoksa) dolu */
+    uint32_t ring_depth;       /* Anlık: ayrıştırılmayı bekleyen kayıt */
+    uint32_t ring_peak_depth;
+    uint32_t spill_lost;       /* Taşma katmanında kaybolan */
+    uint32_t parsed;           /* Çözülen veri kaydı */
+    uint32_t parse_errors;
+    uint32_t send_errors;      /* Ne sunucuya ne SD'ye gidebildi */
+    uint32_t truncated;        /* Kanal kapasitesinden geniş kayıt (kapasite büyütülür) */
+    uint32_t windows_sent;     /* Gönderilen pencere özeti */
+    uint32_t deadband_suppressed;  /* Hiç kanalı raporlanmadığı için satırı gitmeyen kayıt */
+    uint32_t deadband_channels;    /* Süzgeçten geçen geçerli kanal */
+    uint32_t deadband_reported;    /* Raporlanan kanal (bastırma oranı = 1 - reported/channels) */
+    uint32_t alarms_raised;
+    uint32_t alarms_cleared;
+    uint32_t alarms_dropped;       /* Alarm hattının kuyruğu dolu/kapalı */
+} telemetry_source_stats_t;
+
+bool telemetry_service_get_source_stats(uint8_t instrument_id, telemetry_source_stats_t *out_stats);
+
+/**
+ * UART'sız bir kayıt kaynağı (ör. Modbus master) ekler.
+ * Kaynak, HD32MT normalize kaydı ("$R0" ts ' ' <N*4 bayt> '&", bkz.
+ * hd32mt_record_encode) üretip halkaya yazar ve tüketici göreve bildirim
+ * gönderir; kayıtlar HD32MT kayıtlarıyla aynı parse/gönder/SD yolundan geçer.
+ *
+ * Telemetri servisi başlatıldıktan sonra çağrılmalıdır.
+ *
+ * @param channel_count Kayıttaki kanal sayısı (kayıt havuzu kapasitesi);
+ *                      0 ise önbellekteki şemadan ya da varsayılan
+ * @param out_ring      Kaynağın tek üreticili halkası
+ * @param out_consumer  Her push sonrası xTaskNotifyGive ile uyandırılacak görev
+ */
+bool telemetry_service_add_source(uint8_t instrument_id,
+                                  uint8_t channel_count,
+                                  serial_ring_t **out_ring,
+                                  TaskHandle_t *out_consumer);
+
 bool telemetry_send_test_frame(int total_channels,
                                const char *formatted_timestamp,
                                const float *channel_values,
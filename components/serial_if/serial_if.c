@@ -1,8 +1,9 @@
 // main/serial_if.c
 
+#include <stdatomic.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -10,88 +11,92 @@
 
 #include "driver/uart.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 #include "serial_if.h"
+#include "serial_ring.h"
+#include "serial_spill.h"
+#include "hd32mt_framer.h"
 
 /* ----------------------------- Kullanıcıya açık ayarlar ----------------------------- */
-/* Gerekirse bu pin/baud değerlerini projene göre değiştir. */
-#define SERIAL_UART_PORT_NUMBER            (UART_NUM_1)
-#define SERIAL_UART_TX_GPIO_NUMBER         (17)
-#define SERIAL_UART_RX_GPIO_NUMBER         (16)
-#define SERIAL_UART_BAUD_RATE              (1150200)
+/* Varsayılan port/pin/baud SERIAL_IF_DEFAULT_CONFIG() içinde (serial_if.h). */
 
 /* UART sürücüsünün dahili RX buffer'ı (bayt) */
 #define SERIAL_UART_DRIVER_RX_BUFFER_BYTES (2048)
 
-/* Okuma döngüsü zaman aşımı (ms) */
+/* Okuma döngüsü zaman aşımı (ms) — sadece SERIAL_RX_MODE_POLL */
 #define SERIAL_UART_READ_TIMEOUT_MS        (100)
+#define SERIAL_UART_IDLE_DELAY_MS          (10)    /* Boş pencereden sonra */
+#define SERIAL_UART_POLL_SAMPLE_TICKS      (1)     /* Pencere içinde tampon yoklama aralığı */
 
-/* Satır sonlandırıcı kabul edilen karakterler */
-#define SERIAL_ACCEPT_CR                   (1)   /* '\r' */
-#define SERIAL_ACCEPT_LF                   (1)   /* '\n' */
-#define SERIAL_ACCEPT_AMPERSAND            (1)   /* '&' */
+/* Olay modu: sürücü olay kuyruğu ve '&' desen algılama ayarları */
+#define SERIAL_UART_EVENT_QUEUE_LENGTH     (20)
+#define SERIAL_PATTERN_CHAR                ('&')
+#define SERIAL_PATTERN_CHAR_COUNT          (1)
+#define SERIAL_PATTERN_CHR_TOUT            (9)   /* baud-cycle, sürücü varsayılanı */
+#define SERIAL_PATTERN_POST_IDLE           (0)
+#define SERIAL_PATTERN_PRE_IDLE            (0)
 
 /* Task ayarları */
-#define SERIAL_RECEIVER_TASK_NAME          "serial_receiver_task"
+#define SERIAL_RECEIVER_TASK_NAME          "serial_rx_%u"
 #define SERIAL_RECEIVER_TASK_STACK_BYTES   (4096)
 #define SERIAL_RECEIVER_TASK_PRIORITY      (5)
 
+/* requested_channel_count: bekleyen değişiklik yok */
+#define SERIAL_CHANNEL_COUNT_UNCHANGED     (UINT32_MAX)
+
 /* ------------------------------------------------------------------------------------ */
 
 static const char *LOG_TAG_SERIAL_IF = "SERIAL_IF";
 
-/* Bu modülün iç durumu */
-static QueueHandle_t target_line_queue_handle = NULL;   /* Dışarıdan bağlanan kuyruk */
-static size_t        max_line_bytes_for_queue = 0;      /* Kuyruktaki öğe boyutu */
-static TaskHandle_t  serial_receiver_task_handle = NULL;
-static bool          uart_initialized = false;
+/* UART başına bir bağlam: eski dosya seviyesindeki durumun tamamı burada */
+struct serial_if {
+    serial_if_config_t     config;
 
-/* Satır biriktirme tamponu (tek görev tarafından kullanılır) */
-static char   line_accumulator_buffer[1024];
-static size_t line_accumulator_length = 0;
+    serial_ring_t         *target_ring;            /* Dışarıdan bağlanan halka */
+    serial_spill_t        *overflow;               /* Halka dolunca taşma katmanı, NULL olabilir */
+    serial_capture_t      *capture;                /* Ham bayt kaydı, NULL olabilir */
+    TaskHandle_t           consumer_task_handle;   /* Yeni kayıtta uyandırılacak görev */
+    TaskHandle_t           receiver_task_handle;
+    bool                   uart_initialized;
+    QueueHandle_t          uart_event_queue_handle; /* Sadece olay modunda */
 
-/* ------------------------------- Yardımcı Fonksiyonlar ------------------------------- */
+    /* Her kayıtta (halkaya yazmadan önce) çağrılan gözlemci, NULL olabilir.
+     * Başka görevden değişir: tek atomik işaretçi, alıcı görev bir kez okur;
+     * record_tap_busy değiştirenin eski gözlemcinin bitmesini beklemesi için */
+    _Atomic(const serial_if_record_tap_t *) record_tap;
+    atomic_bool            record_tap_busy;
 
-static inline bool is_line_terminator_character(char ch)
-{
-#if SERIAL_ACCEPT_CR
-    if (ch == '\r') return true;
-#endif
-#if SERIAL_ACCEPT_LF
-    if (ch == '\n') return true;
-#endif
-#if SERIAL_ACCEPT_AMPERSAND
-    if (ch == '&')  return true;
-#endif
-    return false;
-}
+    /* Son bayt → halkaya yazma gecikme sayaçları */
+    serial_latency_stats_t latency_stats;
 
-static void trim_line_in_place(char *line)
-{
-    if (!line) return;
+    /* Protokol çerçeveleyici (yalnızca bu bağlamın alıcı görevi kullanır) */
+    hd32mt_framer_t        record_framer;
+    int64_t                current_chunk_last_byte_us;   /* İşlenen parçanın son bayt zamanı */
 
-    /* Baştaki boşlukları kırp */
-    while (*line && isspace((unsigned char)*line)) {
-        memmove(line, line + 1, strlen(line));  /* sola kaydır */
-    }
+    /* Başka görevden istenen kanal sayısı ve profil; alıcı görev parçalar arasında uygular */
+    atomic_uint            requested_channel_count;
+    _Atomic(const hd32mt_profile_t *) requested_profile;
+    uint8_t                profile_channel_count;   /* Profilin sabit N'i (alıcı görev) */
 
-    /* Sondaki boşlukları kırp */
-    size_t length = strlen(line);
-    while (length > 0 && isspace((unsigned char)line[length - 1])) {
-        line[--length] = '\0';
-    }
-}
+    /* Okuma buffer'ı (tek seferde UART'tan çekilen ham baytlar) */
+    uint8_t                uart_read_buffer[SERIAL_UART_DRIVER_RX_BUFFER_BYTES];
+};
+
+/* Aynı UART için ikinci bağlam açılmasın */
+static serial_if_t *port_owner[UART_NUM_MAX];
 
 /* ----------------------------------- UART Kurulumu ---------------------------------- */
 
-static esp_err_t initialize_uart_once(void)
+static esp_err_t initialize_uart_once(serial_if_t *ctx)
 {
-    if (uart_initialized) {
+    if (ctx->uart_initialized || ctx->config.rx_mode == SERIAL_RX_MODE_REPLAY) {
         return ESP_OK;
     }
 
+    const serial_if_config_t *cfg = &ctx->config;
     const uart_config_t uart_configuration = {
-        .baud_rate  = SERIAL_UART_BAUD_RATE,
+        .baud_rate  = cfg->baud_rate,
         .data_bits  = UART_DATA_8_BITS,
         .parity     = UART_PARITY_DISABLE,
         .stop_bits  = UART_STOP_BITS_1,
@@ -99,153 +104,564 @@ static esp_err_t initialize_uart_once(void)
         .source_clk = UART_SCLK_APB,
     };
 
-    ESP_ERROR_CHECK(uart_param_config(SERIAL_UART_PORT_NUMBER, &uart_configuration));
-    ESP_ERROR_CHECK(uart_set_pin(SERIAL_UART_PORT_NUMBER,
-                                 SERIAL_UART_TX_GPIO_NUMBER,
-                                 SERIAL_UART_RX_GPIO_NUMBER,
-                                 UART_PIN_NO_CHANGE,
-                                 UART_PIN_NO_CHANGE));
-    /* Sadece RX buffer kullanıyoruz (TX için driver buffer ayırmıyoruz) */
-    ESP_ERROR_CHECK(uart_driver_install(SERIAL_UART_PORT_NUMBER,
-                                        SERIAL_UART_DRIVER_RX_BUFFER_BYTES,
-                                        0, 0, NULL, 0));
+    esp_err_t err = uart_param_config(cfg->uart_port, &uart_configuration);
+    if (err == ESP_OK) {
+        err = uart_set_pin(cfg->uart_port, cfg->tx_gpio, cfg->rx_gpio,
+                           UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
 
-    uart_initialized = true;
+    if (cfg->rx_mode == SERIAL_RX_MODE_EVENT) {
+        /* Olay kuyruğu + '&' desen algılama: görev kayıt tamamlanana kadar bloklanır */
+        err = uart_driver_install(cfg->uart_port,
+                                  SERIAL_UART_DRIVER_RX_BUFFER_BYTES,
+                                  0,
+                                  SERIAL_UART_EVENT_QUEUE_LENGTH,
+                                  &ctx->uart_event_queue_handle,
+                                  0);
+        if (err == ESP_OK) {
+            err = uart_enable_pattern_det_baud_intr(cfg->uart_port,
+                                                    SERIAL_PATTERN_CHAR,
+                                                    SERIAL_PATTERN_CHAR_COUNT,
+                                                    SERIAL_PATTERN_CHR_TOUT,
+                                                    SERIAL_PATTERN_POST_IDLE,
+                                                    SERIAL_PATTERN_PRE_IDLE);
+        }
+        if (err == ESP_OK) {
+            err = uart_pattern_queue_reset(cfg->uart_port, SERIAL_UART_EVENT_QUEUE_LENGTH);
+        }
+    } else {
+        /* Sadece RX buffer kullanıyoruz (TX için driver buffer ayırmıyoruz) */
+        err = uart_driver_install(cfg->uart_port,
+                                  SERIAL_UART_DRIVER_RX_BUFFER_BYTES,
+                                  0, 0, NULL, 0);
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    ctx->uart_initialized = true;
 
     ESP_LOGI(LOG_TAG_SERIAL_IF,
-             "UART hazir: UART%ld TX=%d RX=%d Baud=%d",
-             (long)SERIAL_UART_PORT_NUMBER,
-             SERIAL_UART_TX_GPIO_NUMBER,
-             SERIAL_UART_RX_GPIO_NUMBER,
-             SERIAL_UART_BAUD_RATE);
+             "UART hazir: cihaz=%u UART%ld TX=%d RX=%d Baud=%d Mod=%s",
+             (unsigned)cfg->instrument_id,
+             (long)cfg->uart_port,
+             cfg->tx_gpio,
+             cfg->rx_gpio,
+             cfg->baud_rate,
+             serial_if_rx_mode_name(cfg->rx_mode));
 
     return ESP_OK;
 }
 
-/* ----------------------------------- Alıcı Görev ------------------------------------ */
+/* ------------------------------- Kayıt Çerçeveleme ---------------------------------- */
 
-static void serial_receiver_task(void *task_parameters)
+/* Poll: parçanın ilk baytı sürücüde ne kadar bekledi (üst sınır) */
+static void record_driver_wait(serial_if_t *ctx, int64_t last_empty_time_us)
 {
-    (void)task_parameters;
+    int64_t wait_us = esp_timer_get_time() - last_empty_time_us;
+    if (wait_us < 0) wait_us = 0;
 
-    /* Okuma buffer'ı (tek seferde UART'tan çekilen ham baytlar) */
-    uint8_t uart_read_buffer[SERIAL_UART_DRIVER_RX_BUFFER_BYTES];
+    serial_latency_stats_t *stats = &ctx->latency_stats;
+    stats->chunks++;
+    stats->wait_total_us += (uint64_t)wait_us;
+    if ((uint32_t)wait_us > stats->wait_max_us) stats->wait_max_us = (uint32_t)wait_us;
+}
+
+static void record_enqueue_latency(serial_if_t *ctx, int64_t last_byte_time_us)
+{
+    int64_t latency_us = esp_timer_get_time() - last_byte_time_us;
+    if (latency_us < 0) latency_us = 0;
+
+    serial_latency_stats_t *stats = &ctx->latency_stats;
+    stats->records++;
+    stats->last_us   = (uint32_t)latency_us;
+    stats->total_us += (uint64_t)latency_us;
+    if (stats->last_us > stats->max_us) stats->max_us = stats->last_us;
+}
+
+/* Çerçeveleyici tamamlanan kaydı verir → halkaya bir kez kopyala */
+static void on_framed_record(void *context, const char *record, size_t length, bool is_data)
+{
+    serial_if_t *ctx = (serial_if_t *)context;
+
+    atomic_store(&ctx->record_tap_busy, true);
+    const serial_if_record_tap_t *tap = atomic_load(&ctx->record_tap);
+    if (tap) {
+        tap->fn(tap->arg, record, length, is_data);
+    }
+    atomic_store(&ctx->record_tap_busy, false);
+
+    bool pushed = ctx->overflow
+                ? serial_spill_push(ctx->overflow, ctx->target_ring, record, length)
+                : serial_ring_push(ctx->target_ring, record, length);
+    if (pushed) {
+        if (is_data) {
+            record_enqueue_latency(ctx, ctx->current_chunk_last_byte_us);
+        }
+        if (ctx->consumer_task_handle) {
+            xTaskNotifyGive(ctx->consumer_task_handle);
+        }
+    } else {
+        ESP_LOGW(LOG_TAG_SERIAL_IF,
+                 "[%u] Halka%s dolu, %s dusuruldu (%u bayt)",
+                 (unsigned)ctx->config.instrument_id,
+                 ctx->overflow ? " ve tasma katmani" : "",
+                 is_data ? "kayit" : "satir", (unsigned)length);
+    }
+}
+
+/**
+ * Ham baytları protokol çerçeveleyiciden geçirir.
+ * @param last_byte_time_us  Bu parçanın son baytının (tahmini) geliş zamanı
+ */
+static void process_received_bytes(serial_if_t *ctx, const uint8_t *bytes, int byte_count,
+                                   int64_t last_byte_time_us)
+{
+    /* Çerçeveleyici yalnızca bu görevde: istenen kanal sayısı ve profil burada devralınır */
+    bool channel_count_changed = false;
+    unsigned requested = atomic_exchange_explicit(&ctx->requested_channel_count,
+                                                  SERIAL_CHANNEL_COUNT_UNCHANGED,
+                                                  memory_order_acquire);
+    if (requested != SERIAL_CHANNEL_COUNT_UNCHANGED) {
+        ctx->config.record_channel_count = (uint16_t)requested;
+        channel_count_changed = true;
+    }
+    const hd32mt_profile_t *profile = atomic_exchange_explicit(&ctx->requested_profile, NULL,
+                                                               memory_order_acquire);
+    if (profile) {
+        hd32mt_framer_set_format(&ctx->record_framer, &profile->frame);
+        ctx->profile_channel_count = profile->frame.channel_count;
+        channel_count_changed = true;
+        ESP_LOGI(LOG_TAG_SERIAL_IF, "[%u] Cerceve profili: %s",
+                 (unsigned)ctx->config.instrument_id, profile->dl_type);
+    }
+    if (channel_count_changed) {
+        /* Ayarda açık sayı önce, yoksa profilin sabit sayısı (0 = uzunluktan) */
+        uint16_t channel_count = ctx->config.record_channel_count
+                               ? ctx->config.record_channel_count : ctx->profile_channel_count;
+        hd32mt_framer_set_channel_count(&ctx->record_framer, channel_count);
+        ESP_LOGI(LOG_TAG_SERIAL_IF, "[%u] Kayit kanal sayisi: %u",
+                 (unsigned)ctx->config.instrument_id, (unsigned)channel_count);
+    }
 
-    /* Satır biriktirme başlangıcı */
-    line_accumulator_length = 0;
-    line_accumulator_buffer[0] = '\0';
+    ctx->current_chunk_last_byte_us = last_byte_time_us;
+    if (ctx->capture) {
+        serial_capture_write(ctx->capture, bytes, (size_t)byte_count, last_byte_time_us);
+    }
+    hd32mt_framer_feed(&ctx->record_framer, bytes, (size_t)byte_count);
+}
 
-    const TickType_t read_timeout_ticks = pdMS_TO_TICKS(SERIAL_UART_READ_TIMEOUT_MS);
+/* ----------------------------------- Alıcı Görev ------------------------------------ */
 
-    ESP_LOGI(LOG_TAG_SERIAL_IF, "Serial receiver task basladi.");
+static void serial_receive_loop_poll(serial_if_t *ctx)
+{
+    const uart_port_t port = ctx->config.uart_port;
+    const int64_t read_timeout_us = (int64_t)SERIAL_UART_READ_TIMEOUT_MS * 1000;
+    int64_t last_empty_time_us = esp_timer_get_time();   /* Yeni bayt görülmeyen son yoklama */
 
     for (;;) {
-        /* UART'tan baytları oku */
-        int bytes_read = uart_read_bytes(SERIAL_UART_PORT_NUMBER,
-                                         uart_read_buffer,
-                                         sizeof(uart_read_buffer),
-                                         read_timeout_ticks);
+        /*
+         * uart_read_bytes(tampon boyu, zaman aşımı) ile aynı pencere, ama kısa
+         * yoklamalarla: sürücü baytların geliş anını vermez, tampon her
+         * büyüdüğünde o yoklama son baytın zamanı sayılır. Pencere tampon
+         * dolunca ya da zaman aşımında biter.
+         */
+        const int64_t window_start_us = esp_timer_get_time();
+        int64_t last_byte_time_us = 0;
+        size_t seen_bytes = 0;
+        for (;;) {
+            size_t buffered_bytes = 0;
+            uart_get_buffered_data_len(port, &buffered_bytes);
+            int64_t now_us = esp_timer_get_time();
+            if (buffered_bytes > seen_bytes) {
+                seen_bytes = buffered_bytes;
+                last_byte_time_us = now_us;
+            } else if (seen_bytes == 0) {
+                last_empty_time_us = now_us;
+            }
+            if (seen_bytes >= sizeof(ctx->uart_read_buffer) || now_us - window_start_us >= read_timeout_us) {
+                break;
+            }
+            vTaskDelay(SERIAL_UART_POLL_SAMPLE_TICKS);
+        }
+
+        if (seen_bytes == 0) {
+            /* Veri yok → küçük bekleme (bu sırada gelen bayt beklemeye eklenir) */
+            vTaskDelay(pdMS_TO_TICKS(SERIAL_UART_IDLE_DELAY_MS));
+            continue;
+        }
+        if (seen_bytes > sizeof(ctx->uart_read_buffer)) {
+            seen_bytes = sizeof(ctx->uart_read_buffer);
+        }
 
+        int bytes_read = uart_read_bytes(port, ctx->uart_read_buffer, seen_bytes, 0);
         if (bytes_read <= 0) {
-            /* Veri yok → küçük bekleme */
-            vTaskDelay(pdMS_TO_TICKS(10));
             continue;
         }
+        record_driver_wait(ctx, last_empty_time_us);
+        last_empty_time_us = esp_timer_get_time();
 
-        /* Gelen baytları satırlara böl */
-        for (int i = 0; i < bytes_read; ++i) {
-            char incoming_character = (char)uart_read_buffer[i];
-
-            /* Satır sonuna kadar biriktir */
-            if (!is_line_terminator_character(incoming_character)) {
-
-                /* Biriktirme tamponu taşmasın */
-                if (line_accumulator_length < (sizeof(line_accumulator_buffer) - 1)) {
-                    line_accumulator_buffer[line_accumulator_length++] = incoming_character;
-                    line_accumulator_buffer[line_accumulator_length]   = '\0';
-                } else {
-                    /* Satır aşırı uzadı → sıfırla ve uyar */
-                    ESP_LOGW(LOG_TAG_SERIAL_IF,
-                             "Satir uzunluk siniri asildi (%u). Satir temizleniyor.",
-                             (unsigned)sizeof(line_accumulator_buffer));
-                    line_accumulator_length = 0;
-                    line_accumulator_buffer[0] = '\0';
-                }
-                continue;
+        process_received_bytes(ctx, ctx->uart_read_buffer, bytes_read, last_byte_time_us);
+    }
+}
+
+static void serial_receive_loop_event(serial_if_t *ctx)
+{
+    const uart_port_t port = ctx->config.uart_port;
+    uart_event_t uart_event;
+
+    for (;;) {
+        /* Sürücü olayı gelene kadar blokla (polling/uyandırma yok) */
+        if (xQueueReceive(ctx->uart_event_queue_handle, &uart_event, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        int64_t event_time_us = esp_timer_get_time();
+
+        switch (uart_event.type) {
+        case UART_PATTERN_DET: {
+            /* '&' sürücü tamponunda: kaydı sonlandırıcıyla birlikte tek seferde oku */
+            int pattern_position = uart_pattern_pop_pos(port);
+            if (pattern_position < 0) {
+                /* Desen kuyruğu taştı → konumlar güvenilmez, tamponu boşalt */
+                ESP_LOGW(LOG_TAG_SERIAL_IF, "Desen kuyrugu tasti, RX temizleniyor");
+                uart_flush_input(port);
+                uart_pattern_queue_reset(port, SERIAL_UART_EVENT_QUEUE_LENGTH);
+                hd32mt_framer_reset(&ctx->record_framer);
+                break;
             }
 
-            /* Satır sonlandırıcı gördük → boş satırı geç */
-            if (line_accumulator_length == 0) {
-                continue;
+            int to_read = pattern_position + 1;
+            if (to_read > (int)sizeof(ctx->uart_read_buffer)) {
+                to_read = sizeof(ctx->uart_read_buffer);
+            }
+            int bytes_read = uart_read_bytes(port, ctx->uart_read_buffer, to_read, 0);
+            if (bytes_read > 0) {
+                process_received_bytes(ctx, ctx->uart_read_buffer, bytes_read, event_time_us);
             }
+            break;
+        }
 
-            /* Satırı temizle (baş/son boşluk) */
-            trim_line_in_place(line_accumulator_buffer);
+        case UART_DATA: {
+            /*
+             * '&' içermeyen metin satırları (konfigürasyon bloğu vb.) için:
+             * hat sustuysa (RX TOUT) ve bekleyen desen yoksa mevcut baytları al.
+             * Kayıt ortasındaki parçalar desen olayına bırakılır.
+             */
+            if (!uart_event.timeout_flag || uart_pattern_get_pos(port) >= 0) {
+                break;
+            }
+            size_t buffered_bytes = 0;
+            uart_get_buffered_data_len(port, &buffered_bytes);
+            if (buffered_bytes > sizeof(ctx->uart_read_buffer)) {
+                buffered_bytes = sizeof(ctx->uart_read_buffer);
+            }
+            if (buffered_bytes == 0) {
+                break;
+            }
+            int bytes_read = uart_read_bytes(port, ctx->uart_read_buffer, buffered_bytes, 0);
+            if (bytes_read > 0) {
+                process_received_bytes(ctx, ctx->uart_read_buffer, bytes_read, event_time_us);
+            }
+            break;
+        }
 
-            /* Null sonlandirildigindan emin ol */
-            line_accumulator_buffer[sizeof(line_accumulator_buffer) - 1] = '\0';
+        case UART_FIFO_OVF:
+        case UART_BUFFER_FULL:
+            ESP_LOGW(LOG_TAG_SERIAL_IF, "UART tasmasi (olay=%d), RX temizleniyor",
+                     (int)uart_event.type);
+            uart_flush_input(port);
+            xQueueReset(ctx->uart_event_queue_handle);
+            uart_pattern_queue_reset(port, SERIAL_UART_EVENT_QUEUE_LENGTH);
+            hd32mt_framer_reset(&ctx->record_framer);
+            break;
+
+        default:
+            break;
+        }
+    }
+}
 
-            /* Satır boyutu, kuyruk öğe boyutunu aşmamalı */
-            size_t line_length_bytes = strlen(line_accumulator_buffer) + 1; /* '\0' dahil */
-            if (line_length_bytes > max_line_bytes_for_queue) {
-                ESP_LOGW(LOG_TAG_SERIAL_IF,
-                         "Satir, kuyruk oge boyutunu asiyor (satir=%u, limit=%u). Satir atlandi.",
-                         (unsigned)line_length_bytes,
-                         (unsigned)max_line_bytes_for_queue);
+static void serial_receive_loop_replay(serial_if_t *ctx)
+{
+    serial_replay_t *replay = ctx->config.replay;
+    const int64_t tick_us = (int64_t)portTICK_PERIOD_MS * 1000;
+    /* Beklemeden modda tüketici geride kalınca dur (ölçüm = sürdürülebilir hız) */
+    const uint32_t backlog_limit = ctx->target_ring->desc_count / 2;
+
+    do {
+        const int64_t start_us = esp_timer_get_time();
+        uint64_t capture_us = 0;
+        const uint8_t *chunk;
+        size_t chunk_length;
+        uint32_t delta_us;
+
+        while (serial_replay_next(replay, &chunk, &chunk_length, &delta_us)) {
+            capture_us += delta_us;
+            int64_t now_us = esp_timer_get_time();
+            int64_t last_byte_time_us;
+
+            if (replay->speed_scale == SERIAL_REPLAY_SPEED_UNTHROTTLED) {
+                while (serial_if_get_backlog(ctx) > backlog_limit) {
+                    vTaskDelay(1);
+                }
+                last_byte_time_us = esp_timer_get_time();
             } else {
-                /* Kuyruğa gönder (hedef kuyruğa bir kopya olarak) */
-                BaseType_t enqueue_result = xQueueSend(
-                    target_line_queue_handle,
-                    (void *)line_accumulator_buffer,
-                    0 /* bekleme yok; doluysa düşür */);
-
-                if (enqueue_result != pdTRUE) {
-                    ESP_LOGW(LOG_TAG_SERIAL_IF,
-                             "Kuyruk dolu, satir dusuruldu: '%s'",
-                             line_accumulator_buffer);
+                /* Hedef zaman başlangıca göre: gecikmeler birikmez */
+                int64_t due_us  = start_us + (int64_t)serial_replay_scale_us(replay, capture_us);
+                int64_t wait_us = due_us - now_us;
+                if (wait_us >= tick_us) {
+                    vTaskDelay((TickType_t)(wait_us / tick_us));
+                } else if (wait_us < 0) {
+                    replay->stats.late_chunks++;
+                    if ((uint32_t)-wait_us > replay->stats.max_late_us) {
+                        replay->stats.max_late_us = (uint32_t)-wait_us;
+                    }
                 }
+                last_byte_time_us = due_us;
             }
 
-            /* Yeni satır için biriktirmeyi sıfırla */
-            line_accumulator_length = 0;
-            line_accumulator_buffer[0] = '\0';
-        } /* for (bytes_read) */
-    } /* for (;;) */
+            process_received_bytes(ctx, chunk, (int)chunk_length, last_byte_time_us);
+        }
+
+        replay->stats.passes++;
+        int64_t elapsed_us = esp_timer_get_time() - start_us;
+        ESP_LOGI(LOG_TAG_SERIAL_IF,
+                 "[%u] Replay turu %u bitti: %u parca, %llu bayt, %lld ms, gec=%u (max %u us), bozuk=%u",
+                 (unsigned)ctx->config.instrument_id, (unsigned)replay->stats.passes,
+                 (unsigned)replay->stats.chunks, (unsigned long long)replay->stats.bytes,
+                 (long long)(elapsed_us / 1000), (unsigned)replay->stats.late_chunks,
+                 (unsigned)replay->stats.max_late_us, (unsigned)replay->stats.corrupt);
+
+        serial_replay_rewind(replay);
+        hd32mt_framer_reset(&ctx->record_framer);
+    } while (replay->loop);
+}
+
+static void serial_receiver_task(void *task_parameters)
+{
+    serial_if_t *ctx = (serial_if_t *)task_parameters;
+
+    /* Çerçeveleyici başlangıcı */
+    hd32mt_framer_reset(&ctx->record_framer);
+
+    ESP_LOGI(LOG_TAG_SERIAL_IF, "Serial receiver task basladi (cihaz=%u, %s).",
+             (unsigned)ctx->config.instrument_id,
+             serial_if_rx_mode_name(ctx->config.rx_mode));
+
+    switch (ctx->config.rx_mode) {
+    case SERIAL_RX_MODE_EVENT:
+        serial_receive_loop_event(ctx);
+        break;
+    case SERIAL_RX_MODE_REPLAY:
+        serial_receive_loop_replay(ctx);
+        break;
+    default:
+        serial_receive_loop_poll(ctx);
+        break;
+    }
+
+    /* Sadece replay bitince buraya gelinir */
+    ctx->receiver_task_handle = NULL;
+    vTaskDelete(NULL);
 }
 
 /* ------------------------------ Dışarıya Açık API ------------------------------ */
 
-bool serial_start_and_bind_line_queue(QueueHandle_t target_queue, size_t max_line_bytes)
+serial_if_t *serial_if_create(const serial_if_config_t *config)
+{
+    if (!config || config->uart_port < 0 || config->uart_port >= UART_NUM_MAX ||
+        config->rx_mode >= SERIAL_RX_MODE_COUNT || config->baud_rate <= 0) {
+        ESP_LOGE(LOG_TAG_SERIAL_IF, "Gecersiz serial_if konfigurasyonu");
+        return NULL;
+    }
+    const bool uses_uart = config->rx_mode != SERIAL_RX_MODE_REPLAY;
+    if (!uses_uart && config->replay == NULL) {
+        ESP_LOGE(LOG_TAG_SERIAL_IF, "Replay modu icin kaynak verilmedi");
+        return NULL;
+    }
+    if (uses_uart && port_owner[config->uart_port] != NULL) {
+        ESP_LOGE(LOG_TAG_SERIAL_IF, "UART%d zaten kullaniliyor", (int)config->uart_port);
+        return NULL;
+    }
+
+    serial_if_t *ctx = calloc(1, sizeof(*ctx));
+    if (!ctx) {
+        ESP_LOGE(LOG_TAG_SERIAL_IF, "serial_if baglami icin bellek yok");
+        return NULL;
+    }
+
+    ctx->config = *config;
+    hd32mt_framer_init(&ctx->record_framer, on_framed_record, ctx);
+    hd32mt_framer_set_channel_count(&ctx->record_framer, config->record_channel_count);
+    atomic_init(&ctx->requested_channel_count, SERIAL_CHANNEL_COUNT_UNCHANGED);
+    atomic_init(&ctx->requested_profile, NULL);
+    atomic_init(&ctx->record_tap, NULL);
+    atomic_init(&ctx->record_tap_busy, false);
+
+    if (uses_uart) {
+        port_owner[config->uart_port] = ctx;
+    }
+    return ctx;
+}
+
+uint8_t serial_if_get_instrument_id(const serial_if_t *ctx)
+{
+    return ctx ? ctx->config.instrument_id : 0;
+}
+
+serial_rx_mode_t serial_if_get_rx_mode(const serial_if_t *ctx)
+{
+    return ctx ? ctx->config.rx_mode : SERIAL_RX_MODE_POLL;
+}
+
+const char *serial_if_rx_mode_name(serial_rx_mode_t mode)
+{
+    switch (mode) {
+    case SERIAL_RX_MODE_EVENT:  return "event";
+    case SERIAL_RX_MODE_REPLAY: return "replay";
+    default:                    return "poll";
+    }
+}
+
+void serial_if_set_capture(serial_if_t *ctx, serial_capture_t *capture)
+{
+    if (!ctx) return;
+    ctx->capture = capture;
+}
+
+void serial_if_get_latency_stats(const serial_if_t *ctx, serial_latency_stats_t *out_stats)
+{
+    if (ctx && out_stats) {
+        *out_stats = ctx->latency_stats;
+    }
+}
+
+void serial_if_set_record_channel_count(serial_if_t *ctx, uint16_t channel_count)
+{
+    if (!ctx) return;
+    /* Alıcı görev çerçeveleyiciyi kullanıyor olabilir: sonraki parçada uygular */
+    atomic_store_explicit(&ctx->requested_channel_count, channel_count, memory_order_release);
+}
+
+void serial_if_set_profile(serial_if_t *ctx, const hd32mt_profile_t *profile)
+{
+    if (!ctx || !profile) return;
+    atomic_store_explicit(&ctx->requested_profile, profile, memory_order_release);
+}
+
+void serial_if_get_framer_stats(const serial_if_t *ctx, hd32mt_framer_stats_t *out_stats)
+{
+    if (ctx && out_stats) {
+        *out_stats = ctx->record_framer.stats;
+    }
+}
+
+void serial_if_set_record_tap(serial_if_t *ctx, const serial_if_record_tap_t *tap)
+{
+    if (!ctx || (tap && !tap->fn)) return;
+    atomic_store(&ctx->record_tap, tap);
+
+    /* Alıcı görev eski işaretçiyi okuduysa busy'yi ondan önce kurmuştur (seq_cst):
+     * busy düşene kadar bekle, dönüşten sonra eski gözlemci çağrılmaz */
+    if (xTaskGetCurrentTaskHandle() != ctx->receiver_task_handle) {
+        while (atomic_load(&ctx->record_tap_busy)) {
+            vTaskDelay(1);
+        }
+    }
+}
+
+int serial_if_write(serial_if_t *ctx, const void *data, size_t length)
+{
+    if (!ctx || !data || !ctx->uart_initialized) {
+        return -1;
+    }
+    return uart_write_bytes(ctx->config.uart_port, data, length);
+}
+
+bool serial_if_set_baud_rate(serial_if_t *ctx, int baud_rate)
+{
+    if (!ctx || !ctx->uart_initialized || baud_rate <= 0) {
+        return false;
+    }
+    /* Giden komutun son baytı hatta çıkmadan hız değişmesin */
+    uart_wait_tx_done(ctx->config.uart_port, pdMS_TO_TICKS(100));
+    if (uart_set_baudrate(ctx->config.uart_port, (uint32_t)baud_rate) != ESP_OK) {
+        return false;
+    }
+    /* Geçişteki bozuk baytları çerçeveleyici kendi başına atlar (resync) */
+    ctx->config.baud_rate = baud_rate;
+    ESP_LOGI(LOG_TAG_SERIAL_IF, "[%u] Baud=%d",
+             (unsigned)ctx->config.instrument_id, baud_rate);
+    return true;
+}
+
+int serial_if_get_baud_rate(const serial_if_t *ctx)
+{
+    return ctx ? ctx->config.baud_rate : 0;
+}
+
+uint32_t serial_if_get_backlog(const serial_if_t *ctx)
+{
+    if (!ctx || !ctx->target_ring) {
+        return 0;
+    }
+    uint32_t pending = serial_ring_pending(ctx->target_ring);
+    if (ctx->overflow) {
+        pending += serial_spill_pending(ctx->overflow);
+    }
+    return pending;
+}
+
+void serial_if_set_overflow(serial_if_t *ctx, serial_spill_t *overflow)
 {
-    if (target_queue == NULL || max_line_bytes == 0) {
-        ESP_LOGE(LOG_TAG_SERIAL_IF, "Gecersiz parametre: queue veya max_line_bytes bos");
+    if (!ctx) return;
+    if (ctx->receiver_task_handle) {
+        ESP_LOGW(LOG_TAG_SERIAL_IF, "Tasma katmani serial_if_start'tan once baglanmali");
+        return;
+    }
+    ctx->overflow = overflow;
+}
+
+bool serial_if_start(serial_if_t *ctx, serial_ring_t *target, TaskHandle_t consumer_task)
+{
+    if (ctx == NULL || target == NULL || target->data == NULL) {
+        ESP_LOGE(LOG_TAG_SERIAL_IF, "Gecersiz parametre: baglam veya halka bos");
         return false;
     }
 
     /* UART’ı bir kez hazırla */
-    if (initialize_uart_once() != ESP_OK) {
-        ESP_LOGE(LOG_TAG_SERIAL_IF, "UART baslatilamadi");
+    esp_err_t err = initialize_uart_once(ctx);
+    if (err != ESP_OK) {
+        ESP_LOGE(LOG_TAG_SERIAL_IF, "UART%d baslatilamadi: %s",
+                 (int)ctx->config.uart_port, esp_err_to_name(err));
         return false;
     }
 
-    /* Hedef kuyruğu ve öğe boyutunu kaydet */
-    target_line_queue_handle  = target_queue;
-    max_line_bytes_for_queue  = max_line_bytes;
+    /* Hedef halkayı ve tüketici görevi kaydet */
+    ctx->target_ring          = target;
+    ctx->consumer_task_handle = consumer_task;
 
     /* Görev zaten varsa yeniden oluşturma */
-    if (serial_receiver_task_handle != NULL) {
-        vTaskDelete(serial_receiver_task_handle);
-        serial_receiver_task_handle = NULL;
+    if (ctx->receiver_task_handle != NULL) {
+        vTaskDelete(ctx->receiver_task_handle);
+        ctx->receiver_task_handle = NULL;
     }
 
     /* Alıcı görevini oluştur */
+    char task_name[16];
+    snprintf(task_name, sizeof(task_name), SERIAL_RECEIVER_TASK_NAME,
+             (unsigned)ctx->config.instrument_id);
+
     BaseType_t task_ok = xTaskCreate(
         serial_receiver_task,
-        SERIAL_RECEIVER_TASK_NAME,
+        task_name,
         SERIAL_RECEIVER_TASK_STACK_BYTES,
-        NULL,
+        ctx,
         SERIAL_RECEIVER_TASK_PRIORITY,
-        &serial_receiver_task_handle);
+        &ctx->receiver_task_handle);
 
     if (task_ok != pdPASS) {
         ESP_LOGE(LOG_TAG_SERIAL_IF, "Serial receiver task olusmadi");
@@ -253,9 +669,11 @@ bool serial_start_and_bind_line_queue(QueueHandle_t target_queue, size_t max_lin
     }
 
     ESP_LOGI(LOG_TAG_SERIAL_IF,
-             "Serial baglandi: queue=%p, item_size=%u",
-             (void *)target_line_queue_handle,
-             (unsigned)max_line_bytes_for_queue);
+             "Serial baglandi: cihaz=%u ring=%p, data=%u bayt, desc=%u",
+             (unsigned)ctx->config.instrument_id,
+             (void *)ctx->target_ring,
+             (unsigned)ctx->target_ring->data_size,
+             (unsigned)ctx->target_ring->desc_count);
 
     return true;
 }
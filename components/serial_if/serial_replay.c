@@ -0,0 +1,407 @@
+#include "serial_replay.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_partition.h"
+#else
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+/* Metin dökümü satır öneki: "000123: " */
+#define SERIAL_REPLAY_TEXT_PREFIX_DIGITS   (6)
+#define SERIAL_REPLAY_TEXT_PREFIX_BYTES    (SERIAL_REPLAY_TEXT_PREFIX_DIGITS + 2)
+
+/* Başlık tamamlanmadan kapanan yakalama (güç kesildi vb.) */
+#define SERIAL_CAPTURE_BODY_UNKNOWN        (0xFFFFFFFFu)
+
+static const char SERIAL_REPLAY_LINE_END[] = "\r\n";
+
+/* ------------------------------- Yardımcı Fonksiyonlar ------------------------------- */
+
+static inline uint16_t read_le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t read_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void write_le16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void write_le32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static bool has_text_prefix(const uint8_t *line, size_t length)
+{
+    if (length < SERIAL_REPLAY_TEXT_PREFIX_BYTES) {
+        return false;
+    }
+    for (int i = 0; i < SERIAL_REPLAY_TEXT_PREFIX_DIGITS; ++i) {
+        if (line[i] < '0' || line[i] > '9') {
+            return false;
+        }
+    }
+    return line[SERIAL_REPLAY_TEXT_PREFIX_DIGITS] == ':' &&
+           line[SERIAL_REPLAY_TEXT_PREFIX_DIGITS + 1] == ' ';
+}
+
+/* Silinmiş flash (0xFF) ile biten bölümde gerçek metin uzunluğu */
+static size_t trim_erased_tail(const uint8_t *data, size_t size)
+{
+    const uint8_t *erased = memchr(data, 0xFF, size);
+    return erased ? (size_t)(erased - data) : size;
+}
+
+static bool next_capture_chunk(serial_replay_t *replay, const uint8_t **out_chunk,
+                               size_t *out_length, uint32_t *out_delta_us)
+{
+    if (replay->size - replay->position < SERIAL_CAPTURE_CHUNK_HEADER) {
+        return false;
+    }
+    const uint8_t *header = replay->data + replay->position;
+    uint32_t delta_us = read_le32(header);
+    uint16_t length   = read_le16(header + 4);
+
+    if (length == 0 || replay->size - replay->position - SERIAL_CAPTURE_CHUNK_HEADER < length) {
+        replay->stats.corrupt++;
+        replay->position = replay->size;
+        return false;
+    }
+
+    *out_chunk    = header + SERIAL_CAPTURE_CHUNK_HEADER;
+    *out_length   = length;
+    *out_delta_us = delta_us;
+    replay->position += SERIAL_CAPTURE_CHUNK_HEADER + length;
+    return true;
+}
+
+static bool next_text_chunk(serial_replay_t *replay, const uint8_t **out_chunk,
+                            size_t *out_length, uint32_t *out_delta_us)
+{
+    /* Satır içeriğinden sonra satır sonunu ayrı parça olarak ver (veri salt okunur) */
+    if (replay->pending_line_end) {
+        replay->pending_line_end = false;
+        *out_chunk    = (const uint8_t *)SERIAL_REPLAY_LINE_END;
+        *out_length   = sizeof(SERIAL_REPLAY_LINE_END) - 1;
+        *out_delta_us = 0;
+        return true;
+    }
+
+    while (replay->position < replay->size) {
+        const uint8_t *line = replay->data + replay->position;
+        size_t remaining = replay->size - replay->position;
+        const uint8_t *newline = memchr(line, '\n', remaining);
+        size_t line_length = newline ? (size_t)(newline - line) : remaining;
+        replay->position += newline ? line_length + 1 : line_length;
+
+        if (line_length > 0 && line[line_length - 1] == '\r') {
+            line_length--;
+        }
+        if (has_text_prefix(line, line_length)) {
+            line        += SERIAL_REPLAY_TEXT_PREFIX_BYTES;
+            line_length -= SERIAL_REPLAY_TEXT_PREFIX_BYTES;
+        }
+        if (line_length == 0) {
+            continue;
+        }
+
+        replay->pending_line_end = true;
+        *out_chunk    = line;
+        *out_length   = line_length;
+        *out_delta_us = replay->text_line_interval_us;
+        return true;
+    }
+    return false;
+}
+
+/* ------------------------------------ Açma/Kapama ------------------------------------ */
+
+bool serial_replay_open(serial_replay_t *replay, const uint8_t *data, size_t size)
+{
+    if (!replay || !data || size == 0) {
+        return false;
+    }
+    memset(replay, 0, sizeof(*replay));
+    replay->speed_scale           = SERIAL_REPLAY_SPEED_REALTIME;
+    replay->text_line_interval_us = SERIAL_REPLAY_TEXT_LINE_INTERVAL_US;
+
+    if (size >= SERIAL_CAPTURE_HEADER_BYTES &&
+        memcmp(data, SERIAL_CAPTURE_MAGIC, 4) == 0) {
+        if (read_le16(data + 4) != SERIAL_CAPTURE_VERSION) {
+            return false;
+        }
+        uint32_t body_bytes = read_le32(data + 8);
+        size_t available = size - SERIAL_CAPTURE_HEADER_BYTES;
+        replay->format = SERIAL_REPLAY_FORMAT_CAPTURE;
+        replay->data   = data + SERIAL_CAPTURE_HEADER_BYTES;
+        replay->size   = (body_bytes == SERIAL_CAPTURE_BODY_UNKNOWN || body_bytes > available)
+                       ? available : body_bytes;
+    } else {
+        replay->format = SERIAL_REPLAY_FORMAT_TEXT;
+        replay->data   = data;
+        replay->size   = trim_erased_tail(data, size);
+    }
+    return replay->size > 0;
+}
+
+bool serial_replay_open_file(serial_replay_t *replay, const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+    }
+    uint8_t *buffer = (size > 0) ? malloc((size_t)size) : NULL;
+    bool ok = buffer && fread(buffer, 1, (size_t)size, file) == (size_t)size;
+    fclose(file);
+
+    if (!ok || !serial_replay_open(replay, buffer, (size_t)size)) {
+        free(buffer);
+        return false;
+    }
+    replay->owned_buffer = buffer;
+    return true;
+}
+
+#ifdef ESP_PLATFORM
+bool serial_replay_open_partition(serial_replay_t *replay, const char *partition_label)
+{
+    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                                ESP_PARTITION_SUBTYPE_ANY,
+                                                                partition_label);
+    if (!partition) {
+        return false;
+    }
+
+    const void *mapped = NULL;
+    esp_partition_mmap_handle_t handle;
+    if (esp_partition_mmap(partition, 0, partition->size, ESP_PARTITION_MMAP_DATA,
+                           &mapped, &handle) != ESP_OK) {
+        return false;
+    }
+    if (!serial_replay_open(replay, mapped, partition->size)) {
+        esp_partition_munmap(handle);
+        return false;
+    }
+    replay->mmap_handle = (void *)(uintptr_t)handle;
+    return true;
+}
+#endif
+
+bool serial_replay_open_synth(serial_replay_t *replay, hd32mt_synth_t *synth)
+{
+    if (!replay || !synth) {
+        return false;
+    }
+    memset(replay, 0, sizeof(*replay));
+    replay->speed_scale = SERIAL_REPLAY_SPEED_REALTIME;
+    replay->format      = SERIAL_REPLAY_FORMAT_SYNTH;
+    replay->synth       = synth;
+    return true;
+}
+
+void serial_replay_close(serial_replay_t *replay)
+{
+    if (!replay) return;
+#ifdef ESP_PLATFORM
+    if (replay->mmap_handle) {
+        esp_partition_munmap((esp_partition_mmap_handle_t)(uintptr_t)replay->mmap_handle);
+    }
+#endif
+    free(replay->owned_buffer);
+    memset(replay, 0, sizeof(*replay));
+}
+
+/* ------------------------------------ Oynatma ------------------------------------ */
+
+void serial_replay_set_speed(serial_replay_t *replay, uint32_t speed_scale)
+{
+    if (!replay) return;
+    replay->speed_scale = speed_scale > SERIAL_REPLAY_SPEED_MAX ? SERIAL_REPLAY_SPEED_MAX : speed_scale;
+}
+
+void serial_replay_rewind(serial_replay_t *replay)
+{
+    if (!replay) return;
+    replay->position = 0;
+    replay->pending_line_end = false;
+    if (replay->synth) {
+        hd32mt_synth_rewind(replay->synth);
+    }
+}
+
+bool serial_replay_next(serial_replay_t *replay, const uint8_t **out_chunk, size_t *out_length,
+                        uint32_t *out_delta_us)
+{
+    if (!replay || (!replay->data && !replay->synth) || !out_chunk || !out_length || !out_delta_us) {
+        return false;
+    }
+
+    bool ok;
+    switch (replay->format) {
+    case SERIAL_REPLAY_FORMAT_CAPTURE:
+        ok = next_capture_chunk(replay, out_chunk, out_length, out_delta_us);
+        break;
+    case SERIAL_REPLAY_FORMAT_SYNTH:
+        ok = hd32mt_synth_next(replay->synth, out_chunk, out_length, out_delta_us);
+        break;
+    default:
+        ok = next_text_chunk(replay, out_chunk, out_length, out_delta_us);
+        break;
+    }
+    if (ok) {
+        replay->stats.chunks++;
+        replay->stats.bytes += *out_length;
+    }
+    return ok;
+}
+
+uint64_t serial_replay_scale_us(const serial_replay_t *replay, uint64_t capture_us)
+{
+    if (!replay || replay->speed_scale == SERIAL_REPLAY_SPEED_UNTHROTTLED) {
+        return 0;
+    }
+    return capture_us / replay->speed_scale;
+}
+
+#ifndef ESP_PLATFORM
+static int64_t monotonic_us(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+bool serial_replay_pump_fd(serial_replay_t *replay, int fd)
+{
+    if (!replay || fd < 0) {
+        return false;
+    }
+
+    do {
+        /* serial_if replay döngüsüyle aynı: mutlak zamanlama, gecikme birikmez */
+        const int64_t start_us = monotonic_us();
+        uint64_t capture_us = 0;
+        const uint8_t *chunk;
+        size_t chunk_length;
+        uint32_t delta_us;
+
+        while (serial_replay_next(replay, &chunk, &chunk_length, &delta_us)) {
+            capture_us += delta_us;
+            int64_t wait_us = start_us + (int64_t)serial_replay_scale_us(replay, capture_us) - monotonic_us();
+            if (wait_us > 0) {
+                struct timespec delay = { .tv_sec = wait_us / 1000000, .tv_nsec = (wait_us % 1000000) * 1000 };
+                while (nanosleep(&delay, &delay) != 0 && errno == EINTR) {
+                }
+            } else if (wait_us < 0 && replay->speed_scale != SERIAL_REPLAY_SPEED_UNTHROTTLED) {
+                replay->stats.late_chunks++;
+                if ((uint32_t)-wait_us > replay->stats.max_late_us) {
+                    replay->stats.max_late_us = (uint32_t)-wait_us;
+                }
+            }
+
+            size_t written = 0;
+            while (written < chunk_length) {
+                ssize_t n = write(fd, chunk + written, chunk_length - written);
+                if (n < 0) {
+                    if (errno == EINTR || errno == EAGAIN) continue;
+                    return false;
+                }
+                written += (size_t)n;
+            }
+        }
+        replay->stats.passes++;
+        serial_replay_rewind(replay);
+    } while (replay->loop);
+    return true;
+}
+#endif
+
+/* ------------------------------- Kayıt (yakalama) ------------------------------- */
+
+bool serial_capture_open(serial_capture_t *capture, const char *path)
+{
+    if (!capture || !path) return false;
+    memset(capture, 0, sizeof(*capture));
+
+    capture->file = fopen(path, "wb");
+    if (!capture->file) {
+        return false;
+    }
+
+    uint8_t header[SERIAL_CAPTURE_HEADER_BYTES];
+    memcpy(header, SERIAL_CAPTURE_MAGIC, 4);
+    write_le16(header + 4, SERIAL_CAPTURE_VERSION);
+    write_le16(header + 6, 0);
+    write_le32(header + 8, SERIAL_CAPTURE_BODY_UNKNOWN);
+    if (fwrite(header, 1, sizeof(header), capture->file) != sizeof(header)) {
+        fclose(capture->file);
+        capture->file = NULL;
+        return false;
+    }
+    return true;
+}
+
+bool serial_capture_write(serial_capture_t *capture, const uint8_t *bytes, size_t length,
+                          int64_t last_byte_time_us)
+{
+    if (!capture || !capture->file || capture->failed || !bytes) {
+        return false;
+    }
+
+    /* İlk parça t=0; sonrakiler bir öncekine göre fark */
+    int64_t delta_us = capture->chunks ? last_byte_time_us - capture->last_chunk_us : 0;
+    if (delta_us < 0) delta_us = 0;
+    if (delta_us > UINT32_MAX) delta_us = UINT32_MAX;
+    capture->last_chunk_us = last_byte_time_us;
+
+    while (length > 0) {
+        uint16_t part = length > UINT16_MAX ? UINT16_MAX : (uint16_t)length;
+        uint8_t header[SERIAL_CAPTURE_CHUNK_HEADER];
+        write_le32(header, (uint32_t)delta_us);
+        write_le16(header + 4, part);
+        if (fwrite(header, 1, sizeof(header), capture->file) != sizeof(header) ||
+            fwrite(bytes, 1, part, capture->file) != part) {
+            capture->failed = true;
+            return false;
+        }
+        capture->body_bytes += (uint32_t)(sizeof(header) + part);
+        capture->chunks++;
+        bytes  += part;
+        length -= part;
+        delta_us = 0;
+    }
+    return true;
+}
+
+void serial_capture_close(serial_capture_t *capture)
+{
+    if (!capture || !capture->file) return;
+
+    uint8_t body[4];
+    write_le32(body, capture->body_bytes);
+    if (fseek(capture->file, 8, SEEK_SET) == 0) {
+        fwrite(body, 1, sizeof(body), capture->file);
+    }
+    fclose(capture->file);
+    capture->file = NULL;
+}
@@ -0,0 +1,114 @@
+#include "serial_ring.h"
+
+#include <string.h>
+
+/* ------------------------------- Yardımcı Fonksiyonlar ------------------------------- */
+
+uint32_t serial_ring_used_bytes(const serial_ring_t *ring)
+{
+    uint32_t tail = atomic_load_explicit((atomic_uint *)&ring->data_tail, memory_order_acquire);
+    return ring->data_head - tail;
+}
+
+uint32_t serial_ring_pending(const serial_ring_t *ring)
+{
+    uint32_t head = atomic_load_explicit((atomic_uint *)&ring->desc_head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit((atomic_uint *)&ring->desc_tail, memory_order_acquire);
+    return head - tail;
+}
+
+/* ----------------------------------- Kurulum ---------------------------------- */
+
+bool serial_ring_init(serial_ring_t *ring,
+                      uint8_t *data, size_t data_size,
+                      serial_ring_desc_t *descs, size_t desc_count)
+{
+    if (!ring || !data || !descs) return false;
+    if (data_size < 2 || data_size > SERIAL_RING_MAX_DATA_BYTES) return false;
+    if ((data_size & (data_size - 1)) != 0) return false;
+    if (desc_count == 0 || (desc_count & (desc_count - 1)) != 0) return false;
+
+    memset(ring, 0, sizeof(*ring));
+    ring->data       = data;
+    ring->data_size  = (uint32_t)data_size;
+    ring->descs      = descs;
+    ring->desc_count = (uint32_t)desc_count;
+
+    atomic_init(&ring->desc_head, 0);
+    atomic_init(&ring->desc_tail, 0);
+    atomic_init(&ring->data_tail, 0);
+    return true;
+}
+
+/* ----------------------------------- Üretici ---------------------------------- */
+
+bool serial_ring_push(serial_ring_t *ring, const void *record, size_t length)
+{
+    const uint32_t needed = (uint32_t)length + 1;  /* '\0' dahil */
+    if (!ring || !record || length > UINT16_MAX || needed > ring->data_size) {
+        if (ring) ring->stats.dropped_full++;
+        return false;
+    }
+
+    uint32_t desc_head = atomic_load_explicit(&ring->desc_head, memory_order_relaxed);
+    uint32_t desc_tail = atomic_load_explicit(&ring->desc_tail, memory_order_acquire);
+    if (desc_head - desc_tail >= ring->desc_count) {
+        ring->stats.dropped_full++;
+        return false;
+    }
+
+    uint32_t data_tail = atomic_load_explicit(&ring->data_tail, memory_order_acquire);
+    uint32_t used      = ring->data_head - data_tail;
+    uint32_t position  = ring->data_head & (ring->data_size - 1);
+    uint32_t contig    = ring->data_size - position;
+
+    /* Sona sığmıyorsa kalan kısmı atla ve başa sar */
+    uint32_t padding = (needed > contig) ? contig : 0;
+    if (used + padding + needed > ring->data_size) {
+        ring->stats.dropped_full++;
+        return false;
+    }
+    if (padding) {
+        position = 0;
+    }
+
+    memcpy(&ring->data[position], record, length);
+    ring->data[position + length] = '\0';
+    ring->data_head += padding + needed;
+
+    serial_ring_desc_t *desc = &ring->descs[desc_head & (ring->desc_count - 1)];
+    desc->offset = position;
+    desc->length = (uint16_t)length;
+    desc->end    = ring->data_head;
+
+    atomic_store_explicit(&ring->desc_head, desc_head + 1, memory_order_release);
+
+    ring->stats.pushed++;
+    used = ring->data_head - data_tail;
+    if (used > ring->stats.peak_data_bytes) ring->stats.peak_data_bytes = used;
+    if (desc_head + 1 - desc_tail > ring->stats.peak_descs) ring->stats.peak_descs = desc_head + 1 - desc_tail;
+    return true;
+}
+
+/* ----------------------------------- Tüketici --------------------------------- */
+
+bool serial_ring_peek(serial_ring_t *ring, serial_ring_desc_t *out_desc)
+{
+    if (!ring || !out_desc) return false;
+
+    uint32_t tail = atomic_load_explicit(&ring->desc_tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->desc_head, memory_order_acquire);
+    if (head == tail) return false;
+
+    *out_desc = ring->descs[tail & (ring->desc_count - 1)];
+    return true;
+}
+
+void serial_ring_release(serial_ring_t *ring, const serial_ring_desc_t *desc)
+{
+    if (!ring || !desc) return;
+
+    uint32_t tail = atomic_load_explicit(&ring->desc_tail, memory_order_relaxed);
+    atomic_store_explicit(&ring->data_tail, desc->end, memory_order_release);
+    atomic_store_explicit(&ring->desc_tail, tail + 1, memory_order_release);
+}
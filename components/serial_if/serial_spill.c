@@ -0,0 +1,270 @@
+#include "serial_spill.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+
+#include "storage_spiffs.h"
+
+/* ----------------------------- Kullanıcıya açık ayarlar ----------------------------- */
+
+/* PSRAM halkası: 256 KB veri + 4096 kayıt (5 sn'lik soket beklemesinin çok üstü) */
+#define SERIAL_SPILL_PSRAM_DATA_BYTES      (256 * 1024)
+#define SERIAL_SPILL_PSRAM_DESC_COUNT      (4096)
+
+/* PSRAM yoksa dahili RAM'de daha küçük halka */
+#define SERIAL_SPILL_FALLBACK_DATA_BYTES   (16 * 1024)
+#define SERIAL_SPILL_FALLBACK_DESC_COUNT   (256)
+
+/* Halka bu orandan (yüzde) fazla dolunca en eski kayıtlar SD'ye taşınır */
+#define SERIAL_SPILL_SD_HIGH_WATERMARK_PCT (75)
+/* Tek serviste SD'ye taşınacak en fazla kayıt (tüketiciyi uzun bloklamasın) */
+#define SERIAL_SPILL_SD_BATCH_RECORDS      (64)
+/* SD dosyası bu boyutu geçmez; geçerse kayıtlar PSRAM'de bekler */
+#define SERIAL_SPILL_SD_MAX_BYTES          (8u * 1024u * 1024u)
+
+/* SD kaydı: 2 bayt uzunluk (little-endian) + kayıt baytları */
+#define SERIAL_SPILL_SD_HEADER_BYTES       (2)
+#define SERIAL_SPILL_SD_MAX_RECORD_BYTES   (2048)
+
+/* ------------------------------------------------------------------------------------ */
+
+static const char *TAG = "SERIAL_SPILL";
+
+/* ------------------------------- Yardımcı Fonksiyonlar ------------------------------- */
+
+static bool allocate_ring(serial_spill_t *spill, size_t data_bytes, size_t desc_count, uint32_t caps)
+{
+    spill->ring_data  = heap_caps_malloc(data_bytes, caps);
+    spill->ring_descs = heap_caps_malloc(desc_count * sizeof(serial_ring_desc_t), caps);
+    if (spill->ring_data && spill->ring_descs &&
+        serial_ring_init(&spill->ring, spill->ring_data, data_bytes, spill->ring_descs, desc_count)) {
+        return true;
+    }
+    heap_caps_free(spill->ring_data);
+    heap_caps_free(spill->ring_descs);
+    spill->ring_data  = NULL;
+    spill->ring_descs = NULL;
+    return false;
+}
+
+static uint32_t update_peak(serial_spill_t *spill)
+{
+    uint32_t pending = serial_spill_pending(spill);
+    if (pending > spill->stats.peak_pending) {
+        spill->stats.peak_pending = pending;
+    }
+    return pending;
+}
+
+/* SD dosyasını baştan aç (boşaldığında da yeniden kullanılır) */
+static bool sd_reset_file(serial_spill_t *spill)
+{
+    if (spill->sd_file) {
+        fclose(spill->sd_file);
+    }
+    spill->sd_file = fopen(spill->sd_path, "w+b");
+    spill->sd_read_offset  = 0;
+    spill->sd_write_offset = 0;
+    return spill->sd_file != NULL;
+}
+
+static bool sd_available(serial_spill_t *spill)
+{
+    if (!spill->sd_read_buffer || !storage_is_available()) {
+        return false;
+    }
+    if (!spill->sd_file && !sd_reset_file(spill)) {
+        spill->stats.sd_errors++;
+        return false;
+    }
+    return true;
+}
+
+static bool sd_append(serial_spill_t *spill, const char *record, size_t length)
+{
+    uint8_t header[SERIAL_SPILL_SD_HEADER_BYTES] = { (uint8_t)length, (uint8_t)(length >> 8) };
+
+    if (fseek(spill->sd_file, (long)spill->sd_write_offset, SEEK_SET) != 0 ||
+        fwrite(header, 1, sizeof(header), spill->sd_file) != sizeof(header) ||
+        fwrite(record, 1, length, spill->sd_file) != length) {
+        spill->stats.sd_errors++;
+        return false;
+    }
+    spill->sd_write_offset += (uint32_t)(sizeof(header) + length);
+    return true;
+}
+
+/* ------------------------------------ Kurulum ------------------------------------ */
+
+bool serial_spill_init(serial_spill_t *spill, const char *sd_path)
+{
+    if (!spill) return false;
+    memset(spill, 0, sizeof(*spill));
+    atomic_init(&spill->active, false);
+    atomic_init(&spill->sd_records, 0);
+
+    spill->ring_in_psram = allocate_ring(spill,
+                                         SERIAL_SPILL_PSRAM_DATA_BYTES,
+                                         SERIAL_SPILL_PSRAM_DESC_COUNT,
+                                         MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!spill->ring_in_psram &&
+        !allocate_ring(spill,
+                       SERIAL_SPILL_FALLBACK_DATA_BYTES,
+                       SERIAL_SPILL_FALLBACK_DESC_COUNT,
+                       MALLOC_CAP_8BIT)) {
+        ESP_LOGE(TAG, "Taşma halkası için bellek yok");
+        return false;
+    }
+
+    if (sd_path) {
+        strncpy(spill->sd_path, sd_path, sizeof(spill->sd_path) - 1);
+        spill->sd_read_buffer = malloc(SERIAL_SPILL_SD_MAX_RECORD_BYTES + 1);
+        if (!spill->sd_read_buffer) {
+            ESP_LOGW(TAG, "SD katmanı için bellek yok, yalnızca RAM kullanılacak");
+        }
+    }
+
+    ESP_LOGI(TAG, "Taşma halkası: %u KB %s, %u kayit, SD=%s",
+             (unsigned)(spill->ring.data_size / 1024),
+             spill->ring_in_psram ? "PSRAM" : "dahili RAM",
+             (unsigned)spill->ring.desc_count,
+             spill->sd_read_buffer ? spill->sd_path : "yok");
+    return true;
+}
+
+/* ----------------------------------- Üretici ---------------------------------- */
+
+bool serial_spill_push(serial_spill_t *spill, serial_ring_t *primary,
+                       const void *record, size_t length)
+{
+    if (atomic_load(&spill->active)) {
+        /*
+         * Tüketici SD'ye taşırken önce sd_records'u artırır, sonra halkadan
+         * bırakır; bu sırayla okunduğunda "ikisi de boş" yanlış görülmez.
+         */
+        if (serial_ring_pending(&spill->ring) == 0 && atomic_load(&spill->sd_records) == 0) {
+            atomic_store(&spill->active, false);
+        }
+    }
+
+    if (!atomic_load(&spill->active)) {
+        if (serial_ring_push(primary, record, length)) {
+            return true;
+        }
+        atomic_store(&spill->active, true);
+    }
+
+    if (serial_ring_push(&spill->ring, record, length)) {
+        spill->stats.spilled++;
+        update_peak(spill);
+        return true;
+    }
+    spill->stats.lost++;
+    return false;
+}
+
+/* ----------------------------------- Tüketici ---------------------------------- */
+
+bool serial_spill_peek(serial_spill_t *spill, serial_ring_t *primary, serial_spill_item_t *out_item)
+{
+    /* 1) Ana halka: taşmadan önce gelen en eski kayıtlar */
+    if (serial_ring_peek(primary, &out_item->desc)) {
+        out_item->source_ring = primary;
+        out_item->record = serial_ring_record(primary, &out_item->desc);
+        out_item->length = out_item->desc.length;
+        return true;
+    }
+
+    /* 2) SD: PSRAM halkasından taşınmış, halkada kalanlardan eski kayıtlar */
+    if (atomic_load(&spill->sd_records) > 0) {
+        uint8_t header[SERIAL_SPILL_SD_HEADER_BYTES];
+        size_t length = 0;
+        bool ok = fseek(spill->sd_file, (long)spill->sd_read_offset, SEEK_SET) == 0 &&
+                  fread(header, 1, sizeof(header), spill->sd_file) == sizeof(header);
+        if (ok) {
+            length = (size_t)header[0] | ((size_t)header[1] << 8);
+            ok = length <= SERIAL_SPILL_SD_MAX_RECORD_BYTES &&
+                 fread(spill->sd_read_buffer, 1, length, spill->sd_file) == length;
+        }
+        if (ok) {
+            spill->sd_read_buffer[length] = '\0';
+            out_item->source_ring    = NULL;
+            out_item->record         = spill->sd_read_buffer;
+            out_item->length         = length;
+            out_item->sd_next_offset = spill->sd_read_offset + (uint32_t)(sizeof(header) + length);
+            return true;
+        }
+
+        /* Dosya okunamıyor: kalan SD kayıtları kayıp sayılır, PSRAM'den devam */
+        uint32_t dropped = atomic_exchange(&spill->sd_records, 0);
+        spill->stats.sd_errors++;
+        spill->stats.sd_lost += dropped;
+        ESP_LOGE(TAG, "SD taşma dosyası okunamadı, %u kayit kayboldu", (unsigned)dropped);
+        sd_reset_file(spill);
+    }
+
+    /* 3) PSRAM halkası: en yeni taşma kayıtları */
+    if (serial_ring_peek(&spill->ring, &out_item->desc)) {
+        out_item->source_ring = &spill->ring;
+        out_item->record = serial_ring_record(&spill->ring, &out_item->desc);
+        out_item->length = out_item->desc.length;
+        return true;
+    }
+    return false;
+}
+
+void serial_spill_release(serial_spill_t *spill, const serial_spill_item_t *item)
+{
+    if (item->source_ring) {
+        serial_ring_release(item->source_ring, &item->desc);
+        if (item->source_ring == &spill->ring) {
+            spill->stats.recovered++;
+        }
+        return;
+    }
+
+    spill->sd_read_offset = item->sd_next_offset;
+    spill->stats.recovered++;
+    if (atomic_fetch_sub(&spill->sd_records, 1) == 1) {
+        /* SD boşaldı: dosyayı kısalt ki bir sonraki taşma baştan başlasın */
+        sd_reset_file(spill);
+    }
+}
+
+void serial_spill_service(serial_spill_t *spill)
+{
+    uint32_t high_watermark = spill->ring.desc_count * SERIAL_SPILL_SD_HIGH_WATERMARK_PCT / 100;
+    uint32_t high_bytes     = spill->ring.data_size  * SERIAL_SPILL_SD_HIGH_WATERMARK_PCT / 100;
+    if (serial_ring_pending(&spill->ring) < high_watermark &&
+        serial_ring_used_bytes(&spill->ring) < high_bytes) {
+        return;
+    }
+    if (!sd_available(spill)) {
+        return;
+    }
+
+    serial_ring_desc_t desc;
+    for (int moved = 0; moved < SERIAL_SPILL_SD_BATCH_RECORDS; ++moved) {
+        if (spill->sd_write_offset >= SERIAL_SPILL_SD_MAX_BYTES ||
+            !serial_ring_peek(&spill->ring, &desc)) {
+            break;
+        }
+        if (!sd_append(spill, serial_ring_record(&spill->ring, &desc), desc.length)) {
+            break;
+        }
+        /* Önce SD sayacı, sonra halkadan bırak (üreticideki kontrol için) */
+        atomic_fetch_add(&spill->sd_records, 1);
+        serial_ring_release(&spill->ring, &desc);
+        spill->stats.sd_spilled++;
+    }
+    fflush(spill->sd_file);
+}
+
+uint32_t serial_spill_pending(const serial_spill_t *spill)
+{
+    return serial_ring_pending(&spill->ring) +
+           atomic_load((atomic_uint *)&spill->sd_records);
+}
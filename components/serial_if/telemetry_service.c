@@ -1,70 +1,829 @@
 #include "telemetry_service.h"
 
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "freertos/queue.h"
+#include "freertos/semphr.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 #include "serial_if.h"
+#include "hd32mt_download.h"
 #include "data_parser.h"
+#include "hd32mt_config.h"
+#include "hd32mt_record_arena.h"
+#include "hd32mt_formula.h"
+#include "hd32mt_profile.h"
+#include "hd32mt_aggregate.h"
+#include "hd32mt_deadband.h"
+#include "hd32mt_alarm.h"
 #include "data_sender.h"
+#include "alarm_sender.h"
+#include "uplink_conn.h"
 #include "time_if.h"
+#include "cfg_if.h"
 
-#define TELEMETRY_LINE_MAX_BYTES     1024
-#define TELEMETRY_QUEUE_LENGTH       16
-#define TELEMETRY_TASK_STACK_BYTES   4096
+/* Cihaz başına SPSC halka: 4 KB veri + 64 tanımlayıcı (eski 16 x 1024 kuyruk yerine) */
+#define TELEMETRY_RING_DATA_BYTES    4096
+#define TELEMETRY_RING_DESC_COUNT    64
+#define TELEMETRY_TASK_STACK_BYTES   6144   /* Şema kopyası + şema satırı yığında */
 #define TELEMETRY_TASK_PRIORITY      5
+#define TELEMETRY_STATS_PERIOD_MS    60000
+
+/* Kaynak başına kayıt havuzu: kanal sayısı şemadan, şema yoksa varsayılan */
+#define TELEMETRY_RECORD_SLOTS               2
+#define TELEMETRY_DEFAULT_CHANNEL_CAPACITY   10
+
+/* Pencereli gönderimde kayıt gelmezse pencere, sonundan bu kadar sonra kapanır */
+#define TELEMETRY_WINDOW_GRACE_SEC   2
+#define TELEMETRY_WINDOW_POLL_MS     1000
+
+/* Bir kayıttan alarm hattına giden en fazla durum değişimi */
+#define TELEMETRY_ALARM_EVENTS       8
+
+/* Taşma katmanının SD dosyası (cihaz başına) */
+#define TELEMETRY_SPILL_SD_PATH_FMT  "/sdcard/spill_%u.bin"
 
 static const char *TAG = "TELEMETRY";
-static QueueHandle_t g_line_queue = NULL;
+
+/* Bir kaynak: HD32MT (kendi UART bağlamı) ya da harici üretici (serial = NULL) */
+typedef struct {
+    serial_if_t        *serial;
+    uint8_t             instrument_id;
+    serial_ring_t       ring;
+    uint8_t            *ring_data;
+    serial_ring_desc_t *ring_descs;
+    serial_spill_t      spill;          /* Ana halka dolunca PSRAM/SD taşma katmanı */
+    bool                spill_ready;
+    hd32mt_config_parser_t config_parser;  /* Bağlantıdaki konfigürasyon bloğu */
+    hd32mt_schema_t     schema;         /* Kanal isim/birimleri (NVS önbellekli) */
+    bool                schema_valid;
+    uint16_t            schema_id;      /* Kayıtlara yazılan kısa kimlik */
+    const hd32mt_profile_t *profile;    /* Şemanın DLType'ından seçilen çözücü */
+    hd32mt_timestamp_cache_t timestamps;   /* Son kaydın gün tabanı */
+    hd32mt_record_arena_t records;      /* Kanal kapasitesi kaynağa göre */
+    hd32mt_formula_set_t formulas;      /* Şemadaki türetilmiş kanallar (derlenmiş) */
+    bool                schema_sent;    /* Bu oturumda sunucuya gitti mi */
+    uint32_t            schema_session; /* schema_sent'in geçerli olduğu sunucu oturumu */
+    bool                schema_stored;  /* Bu şema SD'ye yazıldı mı */
+    uint32_t            last_pushed;    /* İstatistik penceresi başı */
+    uint32_t            parsed;         /* Çözülen veri kaydı */
+    uint32_t            parse_errors;
+    uint32_t            send_errors;    /* Ne sunucuya ne SD'ye gidebildi */
+    uint32_t            truncated;      /* Kapasiteden fazla kanallı kayıt */
+    hd32mt_aggregator_t window;         /* Pencereli gönderimde açık pencere */
+    int64_t             window_deadline_us;  /* Kayıt gelmezse pencerenin kapanacağı an */
+    uint32_t            windows_sent;
+    hd32mt_deadband_filter_t deadband;  /* Kayıt başına gönderimde değişen kanallar */
+    SemaphoreHandle_t   settings_mutex; /* deadband/alarms: API başka görevden kural ve bant değiştirir */
+    hd32mt_alarm_set_t  alarms;         /* Kanal alarm kuralları ve durumları */
+    uint32_t            alarms_dropped;
+} telemetry_instrument_t;
+
+static telemetry_instrument_t g_instruments[TELEMETRY_MAX_INSTRUMENTS];
+/* Görev çalışırken kaynak eklenebilir: sayı, kaynak hazırlandıktan sonra artar */
+static _Atomic size_t         g_instrument_count = 0;
+static TaskHandle_t           g_telemetry_task = NULL;
 static int g_total_channel_count = 10;
+static telemetry_aggregation_config_t g_aggregation = TELEMETRY_AGGREGATION_DEFAULT_CONFIG();
+static telemetry_deadband_config_t    g_deadband    = TELEMETRY_DEADBAND_DEFAULT_CONFIG();
+
+/* ----------------------------- KANAL AYARLARI ----------------------------- */
+
+/* telemetry_service_set_* çağıranın görevinde çalışır; telemetri görevi filtreyi
+ * yeniden kurarken/uygularken ve alarmları değerlendirirken aynı kilidi tutar */
+static void telemetry_settings_lock(telemetry_instrument_t *inst)   { xSemaphoreTake(inst->settings_mutex, portMAX_DELAY); }
+static void telemetry_settings_unlock(telemetry_instrument_t *inst) { xSemaphoreGive(inst->settings_mutex); }
+
+/* ----------------------------- İSTATİSTİK ----------------------------- */
+
+static void telemetry_log_instrument_stats(telemetry_instrument_t *inst, double elapsed_s)
+{
+    serial_ring_t *ring = &inst->ring;
+    uint32_t pushed = ring->stats.pushed;
+
+    ESP_LOGI(TAG, "[%u] Halka: %.1f kayit/sn, anlik=%u kayit, tepe=%u/%u bayt, %u/%u kayit, dusen=%u",
+             (unsigned)inst->instrument_id,
+             (double)(pushed - inst->last_pushed) / elapsed_s,
+             (unsigned)serial_ring_pending(ring),
+             (unsigned)ring->stats.peak_data_bytes, (unsigned)ring->data_size,
+             (unsigned)ring->stats.peak_descs, (unsigned)ring->desc_count,
+             (unsigned)ring->stats.dropped_full);
+    ESP_LOGI(TAG, "[%u] Islenen: %u kayit, parse hatasi=%u, gonderim hatasi=%u, kirpilan=%u (%u kanal)",
+             (unsigned)inst->instrument_id, (unsigned)inst->parsed,
+             (unsigned)inst->parse_errors, (unsigned)inst->send_errors,
+             (unsigned)inst->truncated, (unsigned)inst->records.channel_capacity);
+    if (inst->window.channels) {
+        ESP_LOGI(TAG, "[%u] Pencere: %u sn, gonderilen=%u, kayit=%u, saat geri=%u",
+                 (unsigned)inst->instrument_id, (unsigned)inst->window.config.window_sec,
+                 (unsigned)inst->windows_sent, (unsigned)inst->window.stats.records,
+                 (unsigned)inst->window.stats.clock_jumps);
+    }
+    if (inst->deadband.bands) {
+        const hd32mt_deadband_stats_t *db = &inst->deadband.stats;
+        ESP_LOGI(TAG, "[%u] Deadband: bastirilan kayit=%u/%u, kanal=%u/%u (%%%.1f bastirma), heartbeat=%u",
+                 (unsigned)inst->instrument_id, (unsigned)db->suppressed, (unsigned)db->records,
+                 (unsigned)db->reported, (unsigned)db->channels,
+                 db->channels ? 100.0 * (double)(db->channels - db->reported) / (double)db->channels : 0.0,
+                 (unsigned)db->heartbeats);
+    }
+
+    telemetry_settings_lock(inst);
+    uint32_t alarm_rules = inst->alarms.rule_mask;
+    telemetry_settings_unlock(inst);
+    if (alarm_rules) {
+        ESP_LOGI(TAG, "[%u] Alarm: kural=%u kanal, olusan=%u, temizlenen=%u, dusen=%u",
+                 (unsigned)inst->instrument_id, (unsigned)__builtin_popcount(alarm_rules),
+                 (unsigned)inst->alarms.stats.raised, (unsigned)inst->alarms.stats.cleared,
+                 (unsigned)inst->alarms_dropped);
+    }
+
+    if (!inst->serial) {
+        inst->last_pushed = pushed;
+        return;
+    }
+
+    hd32mt_framer_stats_t framer;
+    serial_if_get_framer_stats(inst->serial, &framer);
+    ESP_LOGI(TAG, "[%u] Cerceve: kayit=%u satir=%u | dusen: ts=%u bosluk=%u son=%u uzun=%u (%u bayt)",
+             (unsigned)inst->instrument_id,
+             (unsigned)framer.data_records, (unsigned)framer.text_lines,
+             (unsigned)framer.drop_bad_timestamp, (unsigned)framer.drop_missing_space,
+             (unsigned)framer.drop_bad_terminator, (unsigned)framer.drop_oversize,
+             (unsigned)framer.resync_bytes);
+
+    if (inst->spill_ready) {
+        const serial_spill_stats_t *spill = &inst->spill.stats;
+        ESP_LOGI(TAG, "[%u] Tasma: yazilan=%u sd=%u geri=%u kayip=%u (sd=%u) bekleyen=%u tepe=%u",
+                 (unsigned)inst->instrument_id,
+                 (unsigned)spill->spilled, (unsigned)spill->sd_spilled,
+                 (unsigned)spill->recovered, (unsigned)spill->lost, (unsigned)spill->sd_lost,
+                 (unsigned)serial_spill_pending(&inst->spill), (unsigned)spill->peak_pending);
+    }
+
+    serial_latency_stats_t latency;
+    serial_if_get_latency_stats(inst->serial, &latency);
+    if (latency.records > 0) {
+        serial_rx_mode_t rx_mode = serial_if_get_rx_mode(inst->serial);
+        ESP_LOGI(TAG, "[%u] RX gecikme (%s): son=%u us, ort=%u us, max=%u us (%u kayit)%s",
+                 (unsigned)inst->instrument_id,
+                 serial_if_rx_mode_name(rx_mode),
+                 (unsigned)latency.last_us,
+                 (unsigned)(latency.total_us / latency.records),
+                 (unsigned)latency.max_us,
+                 (unsigned)latency.records,
+                 rx_mode == SERIAL_RX_MODE_POLL ? " (son bayt yoklamadan)" : "");
+    }
+    if (latency.chunks > 0) {
+        ESP_LOGI(TAG, "[%u] RX surucu bekleme (poll): ort=%u us, max=%u us (%u parca)",
+                 (unsigned)inst->instrument_id,
+                 (unsigned)(latency.wait_total_us / latency.chunks),
+                 (unsigned)latency.wait_max_us, (unsigned)latency.chunks);
+    }
+
+    inst->last_pushed = pushed;
+}
+
+static void telemetry_log_stats(int64_t *last_us)
+{
+    int64_t now_us = esp_timer_get_time();
+    int64_t elapsed_us = now_us - *last_us;
+    if (elapsed_us <= 0) return;
+    double elapsed_s = (double)elapsed_us / 1e6;
+
+    uint32_t total = 0;
+    for (size_t i = 0; i < g_instrument_count; ++i) {
+        total += g_instruments[i].ring.stats.pushed - g_instruments[i].last_pushed;
+        telemetry_log_instrument_stats(&g_instruments[i], elapsed_s);
+    }
+    ESP_LOGI(TAG, "Toplam: %.1f kayit/sn (%u cihaz)",
+             (double)total / elapsed_s, (unsigned)g_instrument_count);
+
+    if (uplink_conn_is_ready()) {
+        uplink_conn_stats_t uplink;
+        uplink_conn_get_stats(&uplink);
+        ESP_LOGI(TAG, "Sunucu baglantisi: satir=%u (bu baglanti %u, max %u) baglanma=%u hata=%u kopma=%u arayuz=%u | connect son=%u ort=%u max=%u ms, bekleme=%u ms",
+                 (unsigned)uplink.frames, (unsigned)uplink.frames_this_connection,
+                 (unsigned)uplink.max_frames_per_connection, (unsigned)uplink.connects,
+                 (unsigned)uplink.connect_failures, (unsigned)uplink.disconnects,
+                 (unsigned)uplink.interface_changes, (unsigned)uplink.last_connect_ms,
+                 uplink.connects ? (unsigned)(uplink.total_connect_ms / uplink.connects) : 0u,
+                 (unsigned)uplink.max_connect_ms, (unsigned)uplink.backoff_ms);
+        ESP_LOGI(TAG, "Birlestirme: yazma=%u segment=%u (%.2f paket/kayit) dusen=%u | bekleme p50=%u p90=%u p99=%u ms (sinir %u ms, %u B, srtt %u ms)",
+                 (unsigned)uplink.writes, (unsigned)uplink.segments,
+                 uplink.frames ? (double)uplink.segments / uplink.frames : 0.0,
+                 (unsigned)uplink.dropped_frames,
+                 (unsigned)uplink_conn_hold_percentile(&uplink, 50),
+                 (unsigned)uplink_conn_hold_percentile(&uplink, 90),
+                 (unsigned)uplink_conn_hold_percentile(&uplink, 99),
+                 (unsigned)uplink.hold_ms, (unsigned)uplink.batch_bytes, (unsigned)uplink.srtt_ms);
+        ESP_LOGI(TAG, "Giden kuyruk: anlik=%u satir/%u B, tepe=%u/%u satir, %u/%u B, dolu=%u, yazma takilmasi=%u",
+                 (unsigned)uplink.queue_frames, (unsigned)uplink.queue_bytes,
+                 (unsigned)uplink.peak_queue_frames, (unsigned)UPLINK_QUEUE_FRAMES,
+                 (unsigned)uplink.peak_queue_bytes, (unsigned)UPLINK_QUEUE_BYTES,
+                 (unsigned)uplink.queue_full, (unsigned)uplink.write_stalls);
+        if (uplink.seq_next) {
+            ESP_LOGI(TAG, "Onay: onaylanan=%u yolda=%u (max %u) yeniden=%u zaman asimi=%u | sira=%lu son onay=%lu numara yok=%u",
+                     (unsigned)uplink.acked, (unsigned)uplink.inflight, (unsigned)uplink.max_inflight,
+                     (unsigned)uplink.retransmits, (unsigned)uplink.ack_timeouts,
+                     (unsigned long)uplink.seq_next, (unsigned long)uplink.last_ack_seq,
+                     (unsigned)uplink.seq_exhausted);
+        }
+    }
+
+    if (alarm_sender_is_running()) {
+        alarm_sender_stats_t alarm;
+        alarm_sender_get_stats(&alarm);
+        ESP_LOGI(TAG, "Alarm hatti: giden=%u (hazir=%u) hata=%u dusen=%u | sure son=%u ort=%u max=%u ms, butce asimi=%u",
+                 (unsigned)alarm.sent, (unsigned)alarm.warm_hits, (unsigned)alarm.failed,
+                 (unsigned)alarm.dropped, (unsigned)alarm.last_latency_ms,
+                 alarm.sent ? (unsigned)(alarm.total_latency_ms / alarm.sent) : 0u,
+                 (unsigned)alarm.max_latency_ms, (unsigned)alarm.over_budget);
+    }
+
+    *last_us = now_us;
+}
 
 /* ----------------------------- TELEMETRY PIPELINE ----------------------------- */
 
+/* Oturumun kaydedici profili: şemadaki DLType, bilinmiyorsa varsayılan */
+static void telemetry_select_profile(telemetry_instrument_t *inst)
+{
+    const hd32mt_profile_t *profile = inst->schema_valid ? hd32mt_profile_find(inst->schema.dl_type) : NULL;
+    if (!profile) {
+        profile = hd32mt_profile_get(HD32MT_PROFILE_DEFAULT);
+        if (inst->schema_valid && inst->schema.dl_type[0]) {
+            ESP_LOGW(TAG, "[%u] Bilinmeyen DLType '%s', %s profili kullanılıyor",
+                     (unsigned)inst->instrument_id, inst->schema.dl_type, profile->dl_type);
+        }
+    }
+    if (profile != inst->profile) {
+        ESP_LOGI(TAG, "[%u] Kaydedici profili: %s", (unsigned)inst->instrument_id, profile->dl_type);
+        inst->profile = profile;
+        inst->timestamps.valid = false;   /* Tarih düzeni değişmiş olabilir */
+        /* Çerçeveleyici aynı profilin karakterleri ve sabit kanal sayısıyla (ayarda açık sayı yoksa) */
+        serial_if_set_profile(inst->serial, profile);
+    }
+}
+
+static void telemetry_release_item(telemetry_instrument_t *inst, const serial_spill_item_t *item)
+{
+    if (inst->spill_ready) {
+        serial_spill_release(&inst->spill, item);
+    } else {
+        serial_ring_release(&inst->ring, &item->desc);
+    }
+}
+
+/* Şemadaki formüllerden cihazın kaydetmediği (türetilmiş) kanalları derler */
+static void telemetry_compile_formulas(telemetry_instrument_t *inst)
+{
+    hd32mt_formula_set_init(&inst->formulas,
+                            inst->schema_valid ? inst->schema.variables : NULL,
+                            inst->schema_valid ? inst->schema.sensor_count : 0);
+    if (!inst->schema_valid || inst->schema.formulas[0] == '\0') {
+        return;
+    }
+
+    unsigned failed = 0;
+    const char *line = inst->schema.formulas;
+    while (*line) {
+        const char *end = strchr(line, '\n');
+        size_t length = end ? (size_t)(end - line) : strlen(line);
+        if (!hd32mt_formula_set_add(&inst->formulas, line, length, true)) {
+            failed++;
+        }
+        line += length + (end ? 1 : 0);
+    }
+    ESP_LOGI(TAG, "[%u] Türetilmiş kanal: %u formül, %u kanal (%u derlenemedi)",
+             (unsigned)inst->instrument_id, (unsigned)inst->formulas.rule_count,
+             (unsigned)(inst->formulas.channel_count - inst->formulas.recorded_channels), failed);
+}
+
+/* ----------------------------- PENCERELİ GÖNDERİM ----------------------------- */
+
+/* Açık pencerenin özetini gönderir ve pencereyi kapatır */
+static void telemetry_close_window(telemetry_instrument_t *inst)
+{
+    hd32mt_window_summary_t summary;
+    if (!hd32mt_aggregator_summary(&inst->window, &summary)) {
+        return;
+    }
+    if (data_sender_send_window(&summary)) {
+        inst->windows_sent++;
+    } else {
+        inst->send_errors++;
+    }
+    hd32mt_aggregator_reset(&inst->window);
+}
+
+/* Pencere durumu kayıt havuzunun kapasitesinde; kapasite değişince açık pencere kapanır */
+static void telemetry_init_window(telemetry_instrument_t *inst)
+{
+    if (g_aggregation.window_sec <= 1) {
+        return;
+    }
+    if (inst->window.channels && inst->window.capacity == inst->records.channel_capacity) {
+        return;
+    }
+    telemetry_close_window(inst);
+    hd32mt_aggregator_deinit(&inst->window);
+
+    const hd32mt_aggregate_config_t config = {
+        .window_sec     = g_aggregation.window_sec,
+        .align_to_clock = g_aggregation.align_to_clock,
+    };
+    if (!hd32mt_aggregator_init(&inst->window, &config, inst->records.channel_capacity)) {
+        ESP_LOGE(TAG, "[%u] Pencere oluşturulamadı, kayıtlar tek tek gönderilecek",
+                 (unsigned)inst->instrument_id);
+    }
+}
+
+/* Kaydı pencereye ekler; kayıt yeni pencereye düşüyorsa önce eskisi gönderilir */
+static bool telemetry_aggregate_record(telemetry_instrument_t *inst, const hd32mt_record_t *record)
+{
+    if (hd32mt_aggregator_window_done(&inst->window, record->epoch) ||
+        (inst->window.open && inst->window.schema_id != record->schema_id)) {
+        telemetry_close_window(inst);
+    }
+    bool opened = !inst->window.open;
+    hd32mt_aggregator_add(&inst->window, record);
+    if (opened) {
+        // Kayıt zamanı cihaz saatidir: kapanış anı kayda göreli, yerel zamanlayıcıyla
+        uint32_t remaining = hd32mt_aggregator_window_end(&inst->window) - record->epoch;
+        inst->window_deadline_us = esp_timer_get_time() +
+                                   (int64_t)(remaining + TELEMETRY_WINDOW_GRACE_SEC) * 1000000;
+    }
+
+    if (g_aggregation.raw_to_sd) {
+        return data_sender_store_record(record, g_total_channel_count);
+    }
+    return true;
+}
+
+/* Kayıt akışı durduysa süresi dolan pencereleri kapatır */
+static void telemetry_expire_windows(void)
+{
+    int64_t now_us = esp_timer_get_time();
+    for (size_t i = 0; i < g_instrument_count; ++i) {
+        telemetry_instrument_t *inst = &g_instruments[i];
+        if (inst->window.open && now_us >= inst->window_deadline_us) {
+            telemetry_close_window(inst);
+        }
+    }
+}
+
+/* ----------------------------- DEADBAND ----------------------------- */
+
+/* Filtre kayıt havuzunun kapasitesinde; yeniden kurulurken kanal bantları korunur */
+static void telemetry_init_deadband(telemetry_instrument_t *inst)
+{
+    if (!g_deadband.enabled || g_aggregation.window_sec > 1) {
+        return;
+    }
+    uint8_t capacity = inst->records.channel_capacity;
+    telemetry_settings_lock(inst);
+    if (inst->deadband.bands && inst->deadband.capacity == capacity) {
+        telemetry_settings_unlock(inst);
+        return;
+    }
+
+    hd32mt_deadband_t bands[HD32MT_MAX_CHANNELS];
+    uint8_t kept = inst->deadband.capacity < capacity ? inst->deadband.capacity : capacity;
+    if (kept) {
+        memcpy(bands, inst->deadband.bands, kept * sizeof(bands[0]));
+    }
+    hd32mt_deadband_stats_t stats = inst->deadband.stats;
+    hd32mt_deadband_deinit(&inst->deadband);
+
+    const hd32mt_deadband_t band = { .absolute = g_deadband.absolute, .percent = g_deadband.percent };
+    if (!hd32mt_deadband_init(&inst->deadband, capacity, &band, g_deadband.heartbeat_sec)) {
+        telemetry_settings_unlock(inst);
+        ESP_LOGE(TAG, "[%u] Deadband kurulamadı, tüm kayıtlar gönderilecek",
+                 (unsigned)inst->instrument_id);
+        return;
+    }
+    for (uint8_t i = 0; i < kept; ++i) {
+        hd32mt_deadband_set(&inst->deadband, i, &bands[i]);
+    }
+    inst->deadband.stats = stats;
+    telemetry_settings_unlock(inst);
+}
+
+static void telemetry_invalidate_deadband(telemetry_instrument_t *inst)
+{
+    telemetry_settings_lock(inst);
+    hd32mt_deadband_invalidate(&inst->deadband);
+    telemetry_settings_unlock(inst);
+}
+
+/* Yalnızca bandı aşan kanallar; gönderilemezse sonraki kayıt tam raporlanır */
+static bool telemetry_send_changes(telemetry_instrument_t *inst, const hd32mt_record_t *record)
+{
+    telemetry_settings_lock(inst);
+    uint32_t report = hd32mt_deadband_apply(&inst->deadband, record);
+    telemetry_settings_unlock(inst);
+    if (report == 0) {
+        return data_sender_store_record(record, g_total_channel_count);
+    }
+
+    uint32_t valid = record->valid_mask;
+    if (record->channel_count < 32) {
+        valid &= (1u << record->channel_count) - 1u;
+    }
+    // Hepsi değiştiyse tam satır daha kısa ve sunucunun zaten bildiği biçimde
+    bool ok = report == valid
+            ? data_sender_send_frame_from_record(record, g_total_channel_count, NULL)
+            : data_sender_send_changes(record, report, g_total_channel_count);
+    if (!ok) {
+        telemetry_invalidate_deadband(inst);
+    }
+    return ok;
+}
+
+static void telemetry_feed_config_line(telemetry_instrument_t *inst, const char *line, size_t length)
+{
+    hd32mt_schema_t learned;
+    if (!hd32mt_config_feed_line(&inst->config_parser, line, length, &learned)) {
+        return;
+    }
+    if (learned.sensor_count == 0) {
+        ESP_LOGW(TAG, "[%u] Konfigürasyon bloğunda kanal yok, şema değişmedi",
+                 (unsigned)inst->instrument_id);
+        return;
+    }
+
+    // Aynı parmak izi: önbellekteki şema zaten doğru, yeniden öğrenme/gönderim yok
+    if (inst->schema_valid && learned.fingerprint[0] &&
+        strcmp(learned.fingerprint, inst->schema.fingerprint) == 0) {
+        ESP_LOGI(TAG, "[%u] Şema değişmedi (%s)", (unsigned)inst->instrument_id, learned.fingerprint);
+        return;
+    }
+
+    inst->schema       = learned;
+    inst->schema_valid = true;
+    inst->schema_id    = hd32mt_schema_id(&inst->schema);
+    inst->schema_sent  = false;
+    inst->schema_stored = false;
+    hd32mt_schema_store(inst->instrument_id, &inst->schema);
+    /* Çerçeveleyicinin kanal sayısı şemadan alınmaz: [Table1] satırları kayıttaki
+     * float sayısı değildir; ayardaki açık sayı, yoksa profilin sabit sayısı kullanılır */
+    telemetry_select_profile(inst);
+    telemetry_compile_formulas(inst);
+
+    // Kayıt havuzu yeni kanal sayısına (kayıtlar arasında havuz boştur)
+    if (hd32mt_record_arena_resize(&inst->records, inst->formulas.channel_count)) {
+        ESP_LOGI(TAG, "[%u] Kanal kapasitesi: %u", (unsigned)inst->instrument_id,
+                 (unsigned)inst->formulas.channel_count);
+    }
+    telemetry_init_window(inst);
+    telemetry_init_deadband(inst);
+    telemetry_invalidate_deadband(inst);   /* Yeni şemada sunucu tam kayıtla başlar */
+}
+
+/* Cihazın halkasından (ya da taşma katmanından) bir kayıt işler; boşsa false döner */
+static bool telemetry_process_one(telemetry_instrument_t *inst)
+{
+    serial_spill_item_t item;
+    if (inst->spill_ready) {
+        if (!serial_spill_peek(&inst->spill, &inst->ring, &item)) {
+            return false;
+        }
+    } else {
+        if (!serial_ring_peek(&inst->ring, &item.desc)) {
+            return false;
+        }
+        item.source_ring = &inst->ring;
+        item.record = serial_ring_record(&inst->ring, &item.desc);
+        item.length = item.desc.length;
+    }
+    const char *received_line = item.record;
+
+    // Metin satırları (konfigürasyon bloğu, komut yanıtları) veri değildir
+    if (!hd32mt_profile_is_data_record(inst->profile, received_line, item.length)) {
+        telemetry_feed_config_line(inst, received_line, item.length);
+        telemetry_release_item(inst, &item);
+        return true;
+    }
+
+    // 1️⃣ Satırı halkanın içinde, havuzdan alınan kayda ayrıştır; sonra yeri hemen bırak
+    hd32mt_record_t *record = hd32mt_record_arena_alloc(&inst->records);
+    if (!record) {
+        ESP_LOGE(TAG, "[%u] Kayıt havuzu dolu, satır atlandı", (unsigned)inst->instrument_id);
+        telemetry_release_item(inst, &item);
+        inst->parse_errors++;
+        return true;
+    }
+    bool parsed = inst->profile->decode(received_line, item.length, &inst->timestamps, record);
+    if (!parsed) {
+        ESP_LOGW(TAG, "[%u] Geçersiz satır: %.*s",
+                 (unsigned)inst->instrument_id, (int)item.length, received_line);
+    }
+    telemetry_release_item(inst, &item);
+    if (!parsed) {
+        hd32mt_record_arena_free(&inst->records, record);
+        inst->parse_errors++;
+        return true;
+    }
+    inst->parsed++;
+    record->instrument_id = inst->instrument_id;
+    record->schema_id     = inst->schema_id;
+
+    // Kayıt kapasiteden geniş: bu kayıt kırpılır, havuz sonraki kayıtlar için büyütülür
+    uint8_t payload_channels = record->payload_channels;
+    if (payload_channels > record->channel_count) {
+        if (inst->truncated++ == 0) {
+            ESP_LOGW(TAG, "[%u] Kayıtta %u kanal var, kapasite %u",
+                     (unsigned)inst->instrument_id, (unsigned)payload_channels,
+                     (unsigned)record->capacity);
+        }
+    }
+
+    // Türetilmiş kanallar yalnızca kayıt şemayla aynı düzendeyse
+    if (inst->formulas.rule_count && payload_channels == inst->formulas.recorded_channels) {
+        hd32mt_formula_set_apply(&inst->formulas, record);
+    }
+
+    // Alarmlar şema/ağ/SD beklemeden hızlı hatta; kayıt normal yoldan da gider
+    hd32mt_alarm_event_t events[TELEMETRY_ALARM_EVENTS];
+    size_t event_count = 0;
+    telemetry_settings_lock(inst);
+    if (inst->alarms.rule_mask) {
+        event_count = hd32mt_alarm_evaluate(&inst->alarms, record, events, TELEMETRY_ALARM_EVENTS);
+    }
+    telemetry_settings_unlock(inst);
+    if (event_count && !alarm_sender_post(inst->instrument_id, record->epoch, events, event_count)) {
+        inst->alarms_dropped++;
+    }
+    if (inst->schema_valid) {
+        // Şema sunucu oturumunda bir kez (yeni bağlantıda yeniden); gidemezse sonraki
+        // kayıtta yalnızca ağa tekrar denenir, SD'ye şema başına bir kez yazılır
+        uint32_t session = data_sender_get_session();
+        if (inst->schema_sent && inst->schema_session != session) {
+            inst->schema_sent = false;
+        }
+        if (!inst->schema_sent) {
+            inst->schema_sent    = data_sender_send_schema(&inst->schema, inst->instrument_id,
+                                                           !inst->schema_stored);
+            inst->schema_stored  = true;
+            inst->schema_session = session;
+        }
+    }
+
+    // 2️⃣ Gönderim: pencere varsa özete girer, yoksa satır olarak (internet yoksa SD'ye)
+    bool ok;
+    if (inst->window.channels) {
+        ok = telemetry_aggregate_record(inst, record);
+    } else if (inst->deadband.bands) {
+        ok = telemetry_send_changes(inst, record);
+    } else {
+        ok = data_sender_send_frame_from_record(record,
+                                                g_total_channel_count,
+                                                NULL);
+    }
+    hd32mt_record_arena_free(&inst->records, record);
+    if (!ok) {
+        inst->send_errors++;
+    }
+    if (payload_channels > inst->records.channel_capacity) {
+        hd32mt_record_arena_resize(&inst->records, payload_channels > HD32MT_MAX_CHANNELS
+                                                   ? HD32MT_MAX_CHANNELS : payload_channels);
+        telemetry_init_window(inst);
+        telemetry_init_deadband(inst);
+    }
+    ESP_LOGD(TAG, "[%u] Frame işlendi: %s", (unsigned)inst->instrument_id, ok ? "OK" : "FAIL");
+    return true;
+}
+
 static void telemetry_task(void *param)
 {
     (void)param;
-    char received_line[TELEMETRY_LINE_MAX_BYTES];
+    int64_t last_stats_us = esp_timer_get_time();
+    /* Pencereli gönderimde kayıt gelmese de pencereler zamanında kapanmalı */
+    TickType_t wait = pdMS_TO_TICKS(g_aggregation.window_sec > 1 ? TELEMETRY_WINDOW_POLL_MS
+                                                                  : TELEMETRY_STATS_PERIOD_MS);
 
     for (;;) {
-        if (xQueueReceive(g_line_queue, &received_line, portMAX_DELAY) == pdTRUE) {
+        ulTaskNotifyTake(pdTRUE, wait);
 
-            // 1️⃣ Satırı ayrıştır
-            hd32mt_data_t record = {0};
-            if (!parse_hd32mt_record(received_line, &record)) {
-                ESP_LOGW(TAG, "Geçersiz satır: %s", received_line);
-                continue;
+        /* Cihazlar arasında sırayla birer kayıt: biri diğerini aç bırakmasın */
+        bool any;
+        do {
+            any = false;
+            for (size_t i = 0; i < g_instrument_count; ++i) {
+                if (g_instruments[i].spill_ready) {
+                    serial_spill_service(&g_instruments[i].spill);
+                }
+                any |= telemetry_process_one(&g_instruments[i]);
             }
+        } while (any);
+        telemetry_expire_windows();
 
-            // 2️⃣ Gönderim (internet varsa gönderir, yoksa SD'ye kaydeder)
-            bool ok = data_sender_send_frame_from_record(&record,
-                                                         g_total_channel_count,
-                                                         NULL);
-            ESP_LOGI(TAG, "Frame işlendi: %s", ok ? "OK" : "FAIL");
+        if (esp_timer_get_time() - last_stats_us >= (int64_t)TELEMETRY_STATS_PERIOD_MS * 1000) {
+            telemetry_log_stats(&last_stats_us);
         }
     }
 }
 
 /* ----------------------------- SERVİS BAŞLATMA ----------------------------- */
 
-bool telemetry_service_start(int total_channel_count)
+static bool telemetry_init_ring(telemetry_instrument_t *inst, uint8_t instrument_id)
+{
+    inst->instrument_id = instrument_id;
+    inst->ring_data  = malloc(TELEMETRY_RING_DATA_BYTES);
+    inst->ring_descs = malloc(TELEMETRY_RING_DESC_COUNT * sizeof(serial_ring_desc_t));
+    if (!inst->ring_data || !inst->ring_descs ||
+        !serial_ring_init(&inst->ring,
+                          inst->ring_data, TELEMETRY_RING_DATA_BYTES,
+                          inst->ring_descs, TELEMETRY_RING_DESC_COUNT)) {
+        ESP_LOGE(TAG, "[%u] Halka oluşturulamadı", (unsigned)instrument_id);
+        return false;
+    }
+    return true;
+}
+
+/* Kanal kapasitesi: açık değer > önbellekteki şema (+ türetilmiş kanallar) > varsayılan */
+static bool telemetry_init_records(telemetry_instrument_t *inst, uint8_t channel_count)
+{
+    inst->settings_mutex = xSemaphoreCreateMutex();
+    if (!inst->settings_mutex) {
+        ESP_LOGE(TAG, "[%u] Ayar kilidi oluşturulamadı", (unsigned)inst->instrument_id);
+        return false;
+    }
+    telemetry_select_profile(inst);
+    telemetry_compile_formulas(inst);
+    if (channel_count == 0) {
+        channel_count = (inst->schema_valid && inst->schema.sensor_count)
+                      ? inst->formulas.channel_count : TELEMETRY_DEFAULT_CHANNEL_CAPACITY;
+    }
+    if (channel_count > HD32MT_MAX_CHANNELS) {
+        channel_count = HD32MT_MAX_CHANNELS;
+    }
+    if (!hd32mt_record_arena_init(&inst->records, TELEMETRY_RECORD_SLOTS, channel_count)) {
+        ESP_LOGE(TAG, "[%u] Kayıt havuzu oluşturulamadı", (unsigned)inst->instrument_id);
+        return false;
+    }
+    telemetry_init_window(inst);
+    telemetry_init_deadband(inst);
+    return true;
+}
+
+static telemetry_instrument_t *telemetry_find_instrument(uint8_t instrument_id)
+{
+    for (size_t i = 0; i < g_instrument_count; ++i) {
+        if (g_instruments[i].instrument_id == instrument_id) {
+            return &g_instruments[i];
+        }
+    }
+    return NULL;
+}
+
+static bool telemetry_bind_instrument(telemetry_instrument_t *inst, const serial_if_config_t *config)
+{
+    if (!telemetry_init_ring(inst, config->instrument_id)) {
+        return false;
+    }
+
+    inst->serial = serial_if_create(config);
+    if (!inst->serial) {
+        ESP_LOGE(TAG, "[%u] Serial bağlamı oluşturulamadı", (unsigned)config->instrument_id);
+        return false;
+    }
+
+    /* Önceki oturumda öğrenilen şema: blok gelmeden etiketler hazır */
+    hd32mt_config_init(&inst->config_parser);
+    inst->schema_valid = hd32mt_schema_load(config->instrument_id, &inst->schema);
+    inst->schema_id    = inst->schema_valid ? hd32mt_schema_id(&inst->schema) : 0;
+    inst->schema_sent  = false;
+    if (!telemetry_init_records(inst, 0)) {
+        return false;
+    }
+
+    /* Taşma katmanı olmadan da çalışır, yalnızca patlamalarda kayıt düşer */
+    char spill_path[32];
+    snprintf(spill_path, sizeof(spill_path), TELEMETRY_SPILL_SD_PATH_FMT,
+             (unsigned)config->instrument_id);
+    inst->spill_ready = serial_spill_init(&inst->spill, spill_path);
+    if (inst->spill_ready) {
+        serial_if_set_overflow(inst->serial, &inst->spill);
+    } else {
+        ESP_LOGW(TAG, "[%u] Taşma katmanı yok, halka dolunca kayıt düşecek",
+                 (unsigned)config->instrument_id);
+    }
+    return true;
+}
+
+void telemetry_service_set_aggregation(const telemetry_aggregation_config_t *config)
+{
+    if (!config || g_telemetry_task) {
+        ESP_LOGW(TAG, "Pencere ayarı yalnızca servis başlamadan değiştirilebilir");
+        return;
+    }
+    g_aggregation = *config;
+}
+
+void telemetry_service_set_deadband(const telemetry_deadband_config_t *config)
+{
+    if (!config || g_telemetry_task) {
+        ESP_LOGW(TAG, "Deadband ayarı yalnızca servis başlamadan değiştirilebilir");
+        return;
+    }
+    g_deadband = *config;
+}
+
+bool telemetry_service_set_alarm_rule(uint8_t instrument_id, uint8_t channel,
+                                      const hd32mt_alarm_rule_t *rule)
+{
+    telemetry_instrument_t *inst = telemetry_find_instrument(instrument_id);
+    if (!inst) {
+        ESP_LOGE(TAG, "[%u] Kaynak bulunamadı, alarm kuralı eklenmedi", (unsigned)instrument_id);
+        return false;
+    }
+    if (rule && !alarm_sender_start(NULL)) {
+        return false;
+    }
+    // Kurallar/durumlar telemetri görevinde değerlendirilirken değişmesin
+    telemetry_settings_lock(inst);
+    bool ok = hd32mt_alarm_set_rule(&inst->alarms, channel, rule);
+    telemetry_settings_unlock(inst);
+    if (!ok) {
+        ESP_LOGE(TAG, "[%u] Geçersiz alarm kuralı (kanal %u)", (unsigned)instrument_id, (unsigned)channel);
+        return false;
+    }
+    return true;
+}
+
+bool telemetry_service_set_channel_deadband(uint8_t instrument_id, uint8_t channel,
+                                            float absolute, float percent)
+{
+    telemetry_instrument_t *inst = telemetry_find_instrument(instrument_id);
+    if (!inst) {
+        ESP_LOGE(TAG, "[%u] Kaynak bulunamadı, deadband değişmedi", (unsigned)instrument_id);
+        return false;
+    }
+    const hd32mt_deadband_t band = { .absolute = absolute, .percent = percent };
+
+    // Telemetri görevi filtreyi kapasite değişiminde yeniden ayırabilir: kilit altında
+    telemetry_settings_lock(inst);
+    bool enabled = inst->deadband.bands != NULL;
+    bool ok = enabled && hd32mt_deadband_set(&inst->deadband, channel, &band);
+    telemetry_settings_unlock(inst);
+    if (!enabled) {
+        ESP_LOGE(TAG, "[%u] Deadband etkin değil", (unsigned)instrument_id);
+    }
+    return ok;
+}
+
+/* window_sec = 0: gönderim aralığı cihaz ayarından */
+static void telemetry_resolve_window(void)
+{
+    if (g_aggregation.window_sec == 0) {
+        const device_cfg_t *cfg = cfg_get();
+        g_aggregation.window_sec = (cfg && cfg->send_interval_sec > 0) ? (uint32_t)cfg->send_interval_sec : 1;
+    }
+    if (g_aggregation.window_sec > 1) {
+        ESP_LOGI(TAG, "Pencereli gönderim: %u sn%s%s", (unsigned)g_aggregation.window_sec,
+                 g_aggregation.align_to_clock ? ", saate hizalı" : "",
+                 g_aggregation.raw_to_sd ? ", ham kayıt SD'de" : "");
+        if (g_deadband.enabled) {
+            ESP_LOGW(TAG, "Deadband yalnızca kayıt başına gönderimde kullanılır, kapalı");
+        }
+    } else if (g_deadband.enabled) {
+        ESP_LOGI(TAG, "Deadband: %.2f / %%%.1f, heartbeat %u sn",
+                 (double)g_deadband.absolute, (double)g_deadband.percent,
+                 (unsigned)g_deadband.heartbeat_sec);
+    }
+}
+
+bool telemetry_service_start_instruments(const serial_if_config_t *instruments,
+                                         size_t instrument_count,
+                                         int total_channel_count)
 {
+    if (!instruments || instrument_count == 0 || instrument_count > TELEMETRY_MAX_INSTRUMENTS) {
+        ESP_LOGE(TAG, "Geçersiz cihaz listesi (adet=%u, max=%d)",
+                 (unsigned)instrument_count, TELEMETRY_MAX_INSTRUMENTS);
+        return false;
+    }
+    if (g_telemetry_task) {
+        ESP_LOGW(TAG, "Telemetri servisi zaten çalışıyor");
+        return true;
+    }
+
     if (total_channel_count <= 0)
         total_channel_count = 10;
 
     g_total_channel_count = total_channel_count;
+    telemetry_resolve_window();
 
-    if (!g_line_queue) {
-        g_line_queue = xQueueCreate(TELEMETRY_QUEUE_LENGTH, TELEMETRY_LINE_MAX_BYTES);
-        if (!g_line_queue) {
-            ESP_LOGE(TAG, "Kuyruk oluşturulamadı");
+    for (size_t i = 0; i < instrument_count; ++i) {
+        if (!telemetry_bind_instrument(&g_instruments[i], &instruments[i])) {
             return false;
         }
-    }
-
-    if (!serial_start_and_bind_line_queue(g_line_queue, TELEMETRY_LINE_MAX_BYTES)) {
-        ESP_LOGE(TAG, "Serial başlatılamadı");
-        return false;
+        g_instrument_count = i + 1;
     }
 
     BaseType_t ok = xTaskCreate(telemetry_task,
@@ -72,12 +831,116 @@ bool telemetry_service_start(int total_channel_count)
                                 TELEMETRY_TASK_STACK_BYTES,
                                 NULL,
                                 TELEMETRY_TASK_PRIORITY,
-                                NULL);
+                                &g_telemetry_task);
     if (ok != pdPASS) {
         ESP_LOGE(TAG, "telemetry_task oluşturulamadı");
         return false;
     }
 
-    ESP_LOGI(TAG, "Telemetri servisi başlatıldı (kanal sayısı=%d)", g_total_channel_count);
+    for (size_t i = 0; i < g_instrument_count; ++i) {
+        if (!serial_if_start(g_instruments[i].serial, &g_instruments[i].ring, g_telemetry_task)) {
+            ESP_LOGE(TAG, "[%u] Serial başlatılamadı", (unsigned)g_instruments[i].instrument_id);
+            return false;
+        }
+    }
+
+    ESP_LOGI(TAG, "Telemetri servisi başlatıldı (cihaz=%u, kanal sayısı=%d)",
+             (unsigned)g_instrument_count, g_total_channel_count);
+    return true;
+}
+
+bool telemetry_service_download_history(uint8_t instrument_id,
+                                        const hd32mt_download_config_t *config)
+{
+    telemetry_instrument_t *inst = telemetry_find_instrument(instrument_id);
+    if (!inst || !inst->serial) {
+        ESP_LOGE(TAG, "[%u] HD32MT cihazı bulunamadı, indirme başlatılmadı", (unsigned)instrument_id);
+        return false;
+    }
+    hd32mt_download_config_t default_config = HD32MT_DOWNLOAD_DEFAULT_CONFIG();
+    return hd32mt_download_start(inst->serial, config ? config : &default_config);
+}
+
+bool telemetry_service_get_source_stats(uint8_t instrument_id, telemetry_source_stats_t *out_stats)
+{
+    telemetry_instrument_t *inst = telemetry_find_instrument(instrument_id);
+    if (!inst || !out_stats) {
+        return false;
+    }
+    memset(out_stats, 0, sizeof(*out_stats));
+    out_stats->ring_pushed  = inst->ring.stats.pushed;
+    out_stats->ring_dropped = inst->ring.stats.dropped_full;
+    out_stats->ring_depth      = serial_ring_pending(&inst->ring);
+    out_stats->ring_peak_depth = inst->ring.stats.peak_descs;
+    if (inst->spill_ready) {
+        out_stats->spill_lost = inst->spill.stats.lost + inst->spill.stats.sd_lost;
+    }
+    if (inst->serial) {
+        hd32mt_framer_stats_t framer;
+        serial_if_get_framer_stats(inst->serial, &framer);
+        out_stats->framed_records = framer.data_records;
+        out_stats->framer_drops   = framer.drop_bad_timestamp + framer.drop_missing_space +
+                                    framer.drop_bad_terminator + framer.drop_oversize;
+    }
+    out_stats->parsed       = inst->parsed;
+    out_stats->parse_errors = inst->parse_errors;
+    out_stats->send_errors  = inst->send_errors;
+    out_stats->truncated    = inst->truncated;
+    out_stats->windows_sent = inst->windows_sent;
+    out_stats->deadband_suppressed = inst->deadband.stats.suppressed;
+    out_stats->deadband_channels   = inst->deadband.stats.channels;
+    out_stats->deadband_reported   = inst->deadband.stats.reported;
+    out_stats->alarms_raised  = inst->alarms.stats.raised;
+    out_stats->alarms_cleared = inst->alarms.stats.cleared;
+    out_stats->alarms_dropped = inst->alarms_dropped;
+    return true;
+}
+
+bool telemetry_service_add_source(uint8_t instrument_id,
+                                  uint8_t channel_count,
+                                  serial_ring_t **out_ring,
+                                  TaskHandle_t *out_consumer)
+{
+    if (!out_ring || !out_consumer) {
+        return false;
+    }
+    if (!g_telemetry_task) {
+        ESP_LOGE(TAG, "[%u] Telemetri servisi çalışmıyor, kaynak eklenemedi", (unsigned)instrument_id);
+        return false;
+    }
+    if (telemetry_find_instrument(instrument_id)) {
+        ESP_LOGE(TAG, "[%u] Bu kimlikte kaynak zaten var", (unsigned)instrument_id);
+        return false;
+    }
+    size_t index = g_instrument_count;
+    if (index >= TELEMETRY_MAX_INSTRUMENTS) {
+        ESP_LOGE(TAG, "[%u] Kaynak sınırı dolu (max=%d)", (unsigned)instrument_id, TELEMETRY_MAX_INSTRUMENTS);
+        return false;
+    }
+
+    telemetry_instrument_t *inst = &g_instruments[index];
+    memset(inst, 0, sizeof(*inst));
+    if (!telemetry_init_ring(inst, instrument_id)) {
+        return false;
+    }
+    hd32mt_config_init(&inst->config_parser);
+    inst->schema_valid = hd32mt_schema_load(instrument_id, &inst->schema);
+    inst->schema_id    = inst->schema_valid ? hd32mt_schema_id(&inst->schema) : 0;
+    if (!telemetry_init_records(inst, channel_count)) {
+        return false;
+    }
+
+    /* Kaynak tamamen hazır olduktan sonra görev görsün */
+    g_instrument_count = index + 1;
+
+    *out_ring     = &inst->ring;
+    *out_consumer = g_telemetry_task;
+    ESP_LOGI(TAG, "[%u] Harici kaynak eklendi", (unsigned)instrument_id);
     return true;
 }
+
+bool telemetry_service_start(int total_channel_count)
+{
+    const serial_if_config_t default_instrument = SERIAL_IF_DEFAULT_CONFIG();
+    return telemetry_service_start_instruments(&default_instrument, 1, total_channel_count);
+}
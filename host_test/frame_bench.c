@@ -0,0 +1,359 @@
+/*
+ * Kayıt başına maliyet: çözümleme (tek tek / toplu) ve sunucu satırı biçimleme.
+ *
+ *   frame_bench [--quick] [<DELTA SAMPLE DATA.txt>]
+ *
+ * Kayıt kümeleri:
+ *  - "gercekci": hd32mt_synth, 4 kanal (sahadaki cihazın konfigürasyon bloğu)
+ *  - "en kotu":  hd32mt_synth, 32 kanal, değerlerin %30'u 0x26/0x0A/0x0D içerir
+ *  - "ornek":    DELTA SAMPLE DATA.txt'nin çerçeveleyiciden geçen veri kayıtları
+ *
+ * İki çözümleme yolunun çıktısı kayıt kayıt karşılaştırılır, dar (4 kanallık)
+ * kayda çözümlemede kırpma sayılır, data_frame_format_fixed2 snprintf("%.2f")
+ * ile karşılaştırılır; fark varsa çıkış kodu 1'dir (ctest bu yüzden --quick
+ * ile çalıştırır).
+ */
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "data_frame.h"
+#include "data_parser.h"
+#include "host_sample.h"
+
+#define BENCH_ROUNDS_FULL     (200)
+#define BENCH_ROUNDS_QUICK    (2)
+#define BENCH_RECORDS         (2000)
+#define BENCH_NARROW_CHANNELS (4)
+#define BENCH_SLOT_BYTES      HD32MT_RECORD_BYTES(HD32MT_MAX_CHANNELS)
+#define BENCH_LINE_BYTES      (512)    /* DATA_SENDER_MAX_LINE_BYTES */
+#define FIXED2_RANDOM_VALUES  (2000000)
+#define FIXED2_QUICK_VALUES   (200000)
+
+/* ---------------------------- Ayrılan bellek sayacı ---------------------------- */
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *pointer, size_t size);
+
+static size_t s_alloc_calls;
+static size_t s_alloc_bytes;
+
+void *__wrap_malloc(size_t size)
+{
+    s_alloc_calls++;
+    s_alloc_bytes += size;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size)
+{
+    s_alloc_calls++;
+    s_alloc_bytes += count * size;
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *pointer, size_t size)
+{
+    s_alloc_calls++;
+    s_alloc_bytes += size;
+    return __real_realloc(pointer, size);
+}
+
+typedef struct {
+    const char *name;
+    uint64_t    start_ns;
+    size_t      start_calls;
+    size_t      start_bytes;
+} bench_timer_t;
+
+static void bench_begin(bench_timer_t *timer, const char *name)
+{
+    timer->name        = name;
+    timer->start_calls = s_alloc_calls;
+    timer->start_bytes = s_alloc_bytes;
+    timer->start_ns    = host_now_ns();
+}
+
+static void bench_end(const bench_timer_t *timer, const char *set, size_t records)
+{
+    uint64_t elapsed = host_now_ns() - timer->start_ns;
+    printf("  %-10s %-22s %8.1f ns/kayit  %8zu ayirma  %10zu B\n",
+           set, timer->name, records ? (double)elapsed / (double)records : 0.0,
+           s_alloc_calls - timer->start_calls, s_alloc_bytes - timer->start_bytes);
+}
+
+/* ------------------------------- Kayıt kümeleri ------------------------------- */
+
+typedef struct {
+    const char         *name;
+    host_sample_t       sample;
+    hd32mt_frame_ref_t *frames;        /* Yalnızca veri kayıtları */
+    size_t              frame_count;
+} bench_set_t;
+
+static bool bench_set_finish(bench_set_t *set)
+{
+    set->frames = calloc(set->sample.data_count ? set->sample.data_count : 1, sizeof(set->frames[0]));
+    if (!set->frames) return false;
+    for (size_t i = 0; i < set->sample.record_count; ++i) {
+        const host_sample_record_t *record = &set->sample.records[i];
+        if (!record->is_data) continue;
+        set->frames[set->frame_count++] = (hd32mt_frame_ref_t){ record->data, record->length };
+    }
+    return true;
+}
+
+static bool bench_set_synth(bench_set_t *set, const char *name, uint16_t channels, uint8_t tricky_percent)
+{
+    hd32mt_synth_config_t config = HD32MT_SYNTH_DEFAULT_CONFIG();
+    config.channel_count  = channels;
+    config.record_rate_hz = 10;          // Gün dönümleri de geçilsin (BENCH_RECORDS / 10 sn)
+    config.start_epoch    = 1735689500;  // 31.12.2024 23:58:20
+    config.tricky_percent = tricky_percent;
+    config.record_limit   = BENCH_RECORDS;
+    set->name = name;
+    return host_sample_load_synth(&set->sample, &config) && bench_set_finish(set);
+}
+
+static bool bench_set_file(bench_set_t *set, const char *name, const char *path)
+{
+    set->name = name;
+    return host_sample_load(&set->sample, path, 0) && bench_set_finish(set);
+}
+
+static void bench_set_free(bench_set_t *set)
+{
+    free(set->frames);
+    host_sample_free(&set->sample);
+}
+
+/* ---------------------------------- Ölçümler ---------------------------------- */
+
+/* Toplu yolun i. satırı tek kayıtlık çıktıyla aynı mı */
+static bool columns_match(const hd32mt_record_columns_t *columns, size_t row, const hd32mt_record_t *record)
+{
+    if (columns->epochs[row] != record->epoch ||
+        columns->valid_masks[row] != record->valid_mask ||
+        columns->channel_counts[row] != record->channel_count) {
+        return false;
+    }
+    for (uint8_t ch = 0; ch < record->channel_count; ++ch) {
+        if (!hd32mt_record_channel_valid(record, ch)) continue;
+        float value = columns->values[(size_t)ch * columns->capacity + row];
+        if (memcmp(&value, &record->values[ch], sizeof(value)) != 0) return false;
+    }
+    return true;
+}
+
+static bool run_set(const bench_set_t *set, int rounds)
+{
+    if (set->frame_count == 0) {
+        printf("  %-10s veri kaydi yok\n", set->name);
+        return true;
+    }
+
+    // Tamponlar ölçümden önce ayrılır: ölçülen döngülerde ayırma 0 olmalı
+    const size_t count = set->frame_count;
+    char *storage = malloc(BENCH_SLOT_BYTES * count);
+    bool *decoded_flags = calloc(count, sizeof(decoded_flags[0]));
+    hd32mt_record_columns_t columns = {
+        .capacity         = count,
+        .channel_capacity = HD32MT_MAX_CHANNELS,
+        .epochs           = malloc(count * sizeof(uint32_t)),
+        .valid_masks      = malloc(count * sizeof(uint32_t)),
+        .channel_counts   = malloc(count),
+        .values           = malloc(count * HD32MT_MAX_CHANNELS * sizeof(float)),
+    };
+    char line[BENCH_LINE_BYTES];
+    if (!storage || !decoded_flags || !columns.epochs || !columns.valid_masks ||
+        !columns.channel_counts || !columns.values) {
+        fprintf(stderr, "bellek yok\n");
+        return false;
+    }
+
+    bool ok = true;
+    size_t decoded = 0;
+    bench_timer_t timer;
+
+    // 1️⃣ Tek tek (halka tüketicisinin yolu), kaynak başına zaman önbelleği
+    bench_begin(&timer, "parse_hd32mt_frame");
+    for (int r = 0; r < rounds; ++r) {
+        hd32mt_timestamp_cache_t cache = {0};
+        decoded = 0;
+        for (size_t i = 0; i < count; ++i) {
+            hd32mt_record_t *record = hd32mt_record_init(storage + i * BENCH_SLOT_BYTES, HD32MT_MAX_CHANNELS);
+            decoded_flags[i] = parse_hd32mt_frame(set->frames[i].data, set->frames[i].length, &cache, record);
+            decoded += decoded_flags[i];
+        }
+    }
+    bench_end(&timer, set->name, count * (size_t)rounds);
+
+    // 2️⃣ Toplu (indirme/SD/replay yolu), sütun çıktısı
+    bench_begin(&timer, "parse_hd32mt_frames");
+    for (int r = 0; r < rounds; ++r) {
+        columns.count = columns.errors = columns.truncated = 0;
+        parse_hd32mt_frames(set->frames, count, &columns);
+    }
+    bench_end(&timer, set->name, count * (size_t)rounds);
+
+    // 3️⃣ İki yol aynı kayıtları aynı değerlerle çözmeli (başarısızlar atlanır)
+    size_t row = 0;
+    size_t mismatches = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!decoded_flags[i]) continue;
+        const hd32mt_record_t *record = (const hd32mt_record_t *)(storage + i * BENCH_SLOT_BYTES);
+        if (row >= columns.count || !columns_match(&columns, row, record)) mismatches++;
+        row++;
+    }
+    if (columns.count != decoded || mismatches) {
+        fprintf(stderr, "%s: toplu %zu, tek tek %zu kayit, %zu fark\n",
+                set->name, columns.count, decoded, mismatches);
+        ok = false;
+    }
+
+    // 4️⃣ Dar kayıt: fazla kanal kırpılır, payload'daki sayı raporlanır
+    size_t truncated = 0;
+    for (size_t i = 0; i < count && ok; ++i) {
+        if (!decoded_flags[i]) continue;
+        const hd32mt_record_t *full = (const hd32mt_record_t *)(storage + i * BENCH_SLOT_BYTES);
+        _Alignas(hd32mt_record_t) char narrow_storage[HD32MT_RECORD_BYTES(BENCH_NARROW_CHANNELS)];
+        hd32mt_record_t *narrow = hd32mt_record_init(narrow_storage, BENCH_NARROW_CHANNELS);
+        const uint8_t expected = full->channel_count < BENCH_NARROW_CHANNELS
+                               ? full->channel_count : BENCH_NARROW_CHANNELS;
+        bool same = parse_hd32mt_frame(set->frames[i].data, set->frames[i].length, NULL, narrow) &&
+                    narrow->channel_count == expected && narrow->payload_channels == full->payload_channels;
+        for (uint8_t ch = 0; same && ch < expected; ++ch) {
+            same = hd32mt_record_channel_valid(narrow, ch) == hd32mt_record_channel_valid(full, ch) &&
+                   (!hd32mt_record_channel_valid(full, ch) ||
+                    memcmp(&narrow->values[ch], &full->values[ch], sizeof(float)) == 0);
+        }
+        if (!same) {
+            fprintf(stderr, "%s: %zu. kayit %u kanala yanlis kirpildi\n", set->name, i, BENCH_NARROW_CHANNELS);
+            ok = false;
+        }
+        truncated += full->payload_channels > BENCH_NARROW_CHANNELS;
+    }
+    columns.channel_capacity = BENCH_NARROW_CHANNELS;
+    columns.count = columns.errors = columns.truncated = 0;
+    parse_hd32mt_frames(set->frames, count, &columns);
+    if (columns.truncated != truncated) {
+        fprintf(stderr, "%s: toplu %zu, tek tek %zu kirpilan kayit\n", set->name, columns.truncated, truncated);
+        ok = false;
+    }
+
+    // 5️⃣ Sunucu satırı (zaman biçimleme dahil)
+    size_t line_bytes = 0;
+    bench_begin(&timer, "data_frame_build");
+    for (int r = 0; r < rounds; ++r) {
+        line_bytes = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (!decoded_flags[i]) continue;
+            const hd32mt_record_t *record = (const hd32mt_record_t *)(storage + i * BENCH_SLOT_BYTES);
+            char timestamp[DATA_FRAME_TIMESTAMP_BYTES];
+            data_frame_format_epoch(record->epoch, timestamp, sizeof(timestamp));
+            size_t length = data_frame_build(record, record->channel_count, timestamp, line, sizeof(line));
+            if (length == 0) ok = false;
+            line_bytes += length;
+        }
+    }
+    bench_end(&timer, set->name, count * (size_t)rounds);
+    printf("  %-10s %zu kayit (%zu cozuldu, %u kanalda %zu kirpildi), ortalama satir %.1f B\n",
+           set->name, count, decoded, BENCH_NARROW_CHANNELS, truncated,
+           decoded ? (double)line_bytes / (double)decoded : 0.0);
+
+    free(storage);
+    free(decoded_flags);
+    free(columns.epochs);
+    free(columns.valid_masks);
+    free(columns.channel_counts);
+    free(columns.values);
+    return ok;
+}
+
+/* ---------------------- data_frame_format_fixed2 doğruluğu ---------------------- */
+
+static bool fixed2_matches(float value)
+{
+    char expected[DATA_FRAME_MAX_VALUE_CHARS];
+    char actual[DATA_FRAME_MAX_VALUE_CHARS + 1];
+    snprintf(expected, sizeof(expected), "%.2f", value);
+    size_t length = data_frame_format_fixed2(value, actual);
+    actual[length] = '\0';
+    if (strcmp(expected, actual) != 0) {
+        fprintf(stderr, "fixed2(%a): \"%s\", printf \"%s\"\n", (double)value, actual, expected);
+        return false;
+    }
+    return true;
+}
+
+static bool check_fixed2(size_t random_values)
+{
+    static const float EDGES[] = {
+        0.0f, -0.0f, 0.004f, 0.005f, 0.015f, 0.125f, -0.001f, -0.005f, 1.005f, 2.675f,
+        99.995f, 999999.99f, -999999.99f, 1e6f, 16777216.0f, 1e15f, -1e15f, 1e16f,
+        INFINITY, -INFINITY, NAN,
+    };
+    size_t failures = 0;
+    for (size_t i = 0; i < sizeof(EDGES) / sizeof(EDGES[0]); ++i) {
+        failures += !fixed2_matches(EDGES[i]);
+    }
+
+    // Kuruş sınırlarının hemen iki yanı (x.xx5 civarı) ve rastgele bit desenleri
+    uint32_t rng = 0x2545F491u;
+    for (size_t i = 0; i < random_values && failures < 10; ++i) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        float value;
+        if (i & 1) {
+            memcpy(&value, &rng, sizeof(value));
+        } else {
+            float boundary = (float)((int32_t)(rng % 200000000u) - 100000000) / 1000.0f + 0.005f;
+            value = (i & 2) ? nextafterf(boundary, INFINITY) : nextafterf(boundary, -INFINITY);
+        }
+        failures += !fixed2_matches(value);
+    }
+    printf("  fixed2 == printf(\"%%.2f\"): %zu sinir + %zu rastgele deger, %zu fark\n",
+           sizeof(EDGES) / sizeof(EDGES[0]), random_values, failures);
+    return failures == 0;
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = false;
+    const char *sample_path = NULL;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            quick = true;
+        } else {
+            sample_path = argv[i];
+        }
+    }
+    const int rounds = quick ? BENCH_ROUNDS_QUICK : BENCH_ROUNDS_FULL;
+
+    bench_set_t sets[3] = {0};
+    size_t set_count = 0;
+    if (!bench_set_synth(&sets[set_count++], "gercekci", 4, 0) ||
+        !bench_set_synth(&sets[set_count++], "en kotu", HD32MT_MAX_CHANNELS, 30)) {
+        fprintf(stderr, "sentetik kayitlar uretilemedi\n");
+        return 1;
+    }
+    if (sample_path && !bench_set_file(&sets[set_count++], "ornek", sample_path)) {
+        fprintf(stderr, "%s okunamadi\n", sample_path);
+        return 1;
+    }
+
+    bool ok = true;
+    printf("frame_bench: %d tur\n", rounds);
+    for (size_t i = 0; i < set_count; ++i) {
+        ok &= run_set(&sets[i], rounds);
+        bench_set_free(&sets[i]);
+    }
+    ok &= check_fixed2(quick ? FIXED2_QUICK_VALUES : FIXED2_RANDOM_VALUES);
+
+    printf("frame_bench: %s\n", ok ? "OK" : "HATA");
+    return ok ? 0 : 1;
+}
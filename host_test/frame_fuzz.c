@@ -0,0 +1,141 @@
+/*
+ * UART baytları → hd32mt_framer → data_parser → data_frame_build zinciri için fuzz girişi.
+ *
+ * Girdinin ilk iki baytı ayardır, kalanı UART'tan gelen akış:
+ *   [0]  çerçeveleyici kanal sayısı (% HD32MT_MAX_CHANNELS + 1, 0 = bilinmiyor)
+ *   [1]  parça boyu (0 = tek parça), akış bu boylarda beslenir
+ *
+ * Denetlenen değişmezler (bozulursa abort):
+ *  - Kayıt/satır tampon sınırını aşmaz
+ *  - Önbellekli / önbelleksiz / toplu çözümleme aynı sonucu verir
+ *  - Çözülen her kayıt DATA_SENDER_MAX_LINE_BYTES'lık satıra sığar, satır "\r\n" ile biter
+ *  - data_frame_format_fixed2 == snprintf("%.2f") (payload'daki her float için)
+ *
+ * gcc'de fuzz_driver.c, clang'da libFuzzer (-DHOST_TEST_LIBFUZZER=ON) çağırır.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "data_frame.h"
+#include "data_parser.h"
+#include "hd32mt_framer.h"
+
+#define FUZZ_LINE_BYTES  (512)   /* DATA_SENDER_MAX_LINE_BYTES */
+
+#define FUZZ_CHECK(condition)                                                        \
+    do {                                                                             \
+        if (!(condition)) {                                                          \
+            fprintf(stderr, "%s:%d: değişmez bozuldu: %s\n", __FILE__, __LINE__, #condition); \
+            abort();                                                                 \
+        }                                                                            \
+    } while (0)
+
+typedef struct {
+    hd32mt_timestamp_cache_t cache;     /* Kaynak başına önbellek (serial_if tüketicisi gibi) */
+    uint32_t                 data_records;
+} fuzz_context_t;
+
+static bool records_equal(const hd32mt_record_t *a, const hd32mt_record_t *b)
+{
+    if (a->epoch != b->epoch || a->valid_mask != b->valid_mask ||
+        a->channel_count != b->channel_count || a->payload_channels != b->payload_channels) {
+        return false;
+    }
+    return memcmp(a->values, b->values, a->channel_count * sizeof(float)) == 0;
+}
+
+static void check_fixed2(float value)
+{
+    char expected[DATA_FRAME_MAX_VALUE_CHARS];
+    char actual[DATA_FRAME_MAX_VALUE_CHARS + 1];
+    int expected_length = snprintf(expected, sizeof(expected), "%.2f", value);
+    size_t length = data_frame_format_fixed2(value, actual);
+    FUZZ_CHECK(expected_length > 0 && (size_t)expected_length < sizeof(expected));
+    FUZZ_CHECK(length == (size_t)expected_length);
+    actual[length] = '\0';
+    FUZZ_CHECK(strcmp(expected, actual) == 0);
+}
+
+static void check_data_record(fuzz_context_t *fuzz, const char *record, size_t length)
+{
+    _Alignas(hd32mt_record_t) char cached_storage[HD32MT_RECORD_BYTES(HD32MT_MAX_CHANNELS)];
+    _Alignas(hd32mt_record_t) char plain_storage[HD32MT_RECORD_BYTES(HD32MT_MAX_CHANNELS)];
+    hd32mt_record_t *cached = hd32mt_record_init(cached_storage, HD32MT_MAX_CHANNELS);
+    hd32mt_record_t *plain  = hd32mt_record_init(plain_storage, HD32MT_MAX_CHANNELS);
+
+    // 1️⃣ Önbellek yalnızca hızlandırır: sonuç tam hesapla aynı
+    bool cached_ok = parse_hd32mt_frame(record, length, &fuzz->cache, cached);
+    bool plain_ok  = parse_hd32mt_frame(record, length, NULL, plain);
+    FUZZ_CHECK(cached_ok == plain_ok);
+    if (!cached_ok) return;
+    FUZZ_CHECK(records_equal(cached, plain));
+    FUZZ_CHECK(cached->channel_count <= cached->capacity);
+    FUZZ_CHECK(cached->channel_count == 32 || (cached->valid_mask >> cached->channel_count) == 0);
+
+    // 2️⃣ Toplu çözümleme aynı kuralları uygular
+    uint32_t epoch, valid_mask;
+    uint8_t channel_count;
+    float values[HD32MT_MAX_CHANNELS];
+    hd32mt_record_columns_t columns = {
+        .capacity         = 1,
+        .channel_capacity = HD32MT_MAX_CHANNELS,
+        .epochs           = &epoch,
+        .valid_masks      = &valid_mask,
+        .channel_counts   = &channel_count,
+        .values           = values,
+    };
+    hd32mt_frame_ref_t frame = { record, length };
+    FUZZ_CHECK(parse_hd32mt_frames(&frame, 1, &columns) == 1);
+    FUZZ_CHECK(epoch == plain->epoch && valid_mask == plain->valid_mask);
+    FUZZ_CHECK(channel_count == plain->channel_count);
+    FUZZ_CHECK(memcmp(values, plain->values, channel_count * sizeof(float)) == 0);
+
+    // 3️⃣ Sunucu satırı: her kayıt sabit tampona sığmalı
+    char timestamp[DATA_FRAME_TIMESTAMP_BYTES];
+    char line[FUZZ_LINE_BYTES];
+    data_frame_format_epoch(plain->epoch, timestamp, sizeof(timestamp));
+    size_t line_length = data_frame_build(plain, HD32MT_MAX_CHANNELS, timestamp, line, sizeof(line));
+    FUZZ_CHECK(line_length > 2 && line_length < sizeof(line));
+    FUZZ_CHECK(line[line_length] == '\0' && strlen(line) == line_length);
+    FUZZ_CHECK(memcmp(line + line_length - 2, "\r\n", 2) == 0);
+
+    for (uint8_t i = 0; i < plain->channel_count; ++i) {
+        check_fixed2(plain->values[i]);
+    }
+    fuzz->data_records++;
+}
+
+static void on_record(void *context, const char *record, size_t length, bool is_data)
+{
+    FUZZ_CHECK(length > 0 && length <= HD32MT_FRAMER_MAX_RECORD_BYTES);
+    if (is_data) {
+        FUZZ_CHECK(length > HD32MT_FRAME_HEADER_LEN && record[0] == '$');
+        check_data_record(context, record, length);
+    }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    if (size < 2) return 0;
+
+    static hd32mt_framer_t framer;   // 1 KB tampon: yığında değil
+    fuzz_context_t fuzz = {0};
+    hd32mt_framer_init(&framer, on_record, &fuzz);
+    hd32mt_framer_set_channel_count(&framer, data[0] % (HD32MT_MAX_CHANNELS + 1));
+
+    const size_t chunk = data[1] ? data[1] : size;
+    const uint8_t *stream = data + 2;
+    size_t remaining = size - 2;
+    while (remaining) {
+        size_t length = remaining < chunk ? remaining : chunk;
+        hd32mt_framer_feed(&framer, stream, length);
+        stream += length;
+        remaining -= length;
+    }
+
+    const hd32mt_framer_stats_t *stats = &framer.stats;
+    FUZZ_CHECK(stats->data_records >= fuzz.data_records);
+    FUZZ_CHECK(framer.length <= HD32MT_FRAMER_MAX_RECORD_BYTES);
+    return 0;
+}
@@ -0,0 +1,215 @@
+/*
+ * gcc için frame_fuzz sürücüsü (libFuzzer yokken): tohumlar + belirlenimci mutasyonlar.
+ *
+ *   frame_fuzz <DELTA SAMPLE DATA.txt> [tur]          Tohumları ve mutasyonlarını çalıştırır
+ *   frame_fuzz --corpus <dizin> <DELTA SAMPLE DATA.txt>  Tohumları libFuzzer için dosyaya yazar
+ *
+ * Tohumlar:
+ *  - Örnek dökümün tüm akışı ve her kaydı/satırı (kanal sayısı 0 ve 4 ile)
+ *  - hd32mt_synth akışları (4 / 32 kanal, payload'da 0x26/0x0A/0x0D)
+ *  - Gün/ay/yıl dönümlü ve bozuk zaman damgalı hd32mt_record_encode kayıtları
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "data_parser.h"
+#include "hd32mt_framer.h"
+#include "host_sample.h"
+
+#define FUZZ_DEFAULT_ROUNDS   (20000)
+#define FUZZ_MAX_INPUT_BYTES  (8192)
+#define FUZZ_MAX_SEEDS        (1024)
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+typedef struct {
+    uint8_t *data;
+    size_t   size;
+} fuzz_seed_t;
+
+static fuzz_seed_t s_seeds[FUZZ_MAX_SEEDS];
+static size_t      s_seed_count;
+
+/* Tohum = { kanal sayısı, parça boyu } + akış */
+static void add_seed(uint8_t channel_count, uint8_t chunk, const void *stream, size_t length)
+{
+    if (s_seed_count >= FUZZ_MAX_SEEDS) return;
+    if (length > FUZZ_MAX_INPUT_BYTES - 2) length = FUZZ_MAX_INPUT_BYTES - 2;
+    uint8_t *seed = malloc(length + 2);
+    if (!seed) return;
+    seed[0] = channel_count;
+    seed[1] = chunk;
+    memcpy(seed + 2, stream, length);
+    s_seeds[s_seed_count++] = (fuzz_seed_t){ seed, length + 2 };
+}
+
+static void add_sample_seeds(const host_sample_t *sample)
+{
+    // Bütün akış 8 KB'lık dilimlerle; UART okuma boyları gibi parça parça
+    for (size_t offset = 0; offset < sample->stream_length; offset += FUZZ_MAX_INPUT_BYTES - 2) {
+        size_t length = sample->stream_length - offset;
+        add_seed(0, 64, sample->stream + offset, length);
+        add_seed(4, 0, sample->stream + offset, length);
+    }
+    for (size_t i = 0; i < sample->record_count; ++i) {
+        add_seed(sample->records[i].is_data ? 4 : 0, 0, sample->records[i].data, sample->records[i].length);
+    }
+}
+
+static void add_synth_seed(uint16_t channels, uint8_t tricky_percent, uint8_t chunk)
+{
+    hd32mt_synth_config_t config = HD32MT_SYNTH_DEFAULT_CONFIG();
+    config.channel_count  = channels;
+    config.tricky_percent = tricky_percent;
+    config.noise_bytes    = 16;
+    config.record_limit   = 20;
+    host_sample_t sample;
+    if (host_sample_load_synth(&sample, &config)) {
+        add_seed((uint8_t)channels, chunk, sample.stream, sample.stream_length);
+        host_sample_free(&sample);
+    }
+}
+
+static void add_encoded_seeds(void)
+{
+    static const char *const TIMESTAMPS[] = {
+        "240229235959", "240301000000", "241231235959", "250101000000",
+        "000101000000", "991231235959", "240230120000", "241301000000",
+        "24010100006x", "240101246060",
+    };
+    const float values[4] = { 21.5f, -0.005f, 1e6f, 999999.9f };
+    char record[HD32MT_FRAMER_MAX_RECORD_BYTES];
+    for (size_t i = 0; i < sizeof(TIMESTAMPS) / sizeof(TIMESTAMPS[0]); ++i) {
+        size_t length = hd32mt_record_encode(TIMESTAMPS[i], values, 4, record, sizeof(record));
+        if (length) add_seed(4, 0, record, length);
+    }
+}
+
+/* ------------------------------- Mutasyonlar ------------------------------- */
+
+static uint32_t s_rng = 0x9E3779B9u;
+
+static uint32_t next_random(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+static size_t mutate(uint8_t *buffer, size_t size, size_t capacity)
+{
+    static const uint8_t INTERESTING[] = { '$', '&', '\r', '\n', ' ', 'R', 'A', '0', '9', 0x00, 0xFF, 0x7F };
+    int steps = 1 + (int)(next_random() % 8);
+    for (int s = 0; s < steps && size > 0; ++s) {
+        size_t at = next_random() % size;
+        switch (next_random() % 6) {
+        case 0:    // Bit çevir
+            buffer[at] ^= (uint8_t)(1u << (next_random() % 8));
+            break;
+        case 1:    // Protokol baytı yaz
+            buffer[at] = INTERESTING[next_random() % sizeof(INTERESTING)];
+            break;
+        case 2:    // Bayt ekle
+            if (size < capacity) {
+                memmove(buffer + at + 1, buffer + at, size - at);
+                buffer[at] = INTERESTING[next_random() % sizeof(INTERESTING)];
+                size++;
+            }
+            break;
+        case 3:    // Aralık sil
+            if (size > 2) {
+                size_t length = 1 + next_random() % (size - at < 16 ? size - at : 16);
+                memmove(buffer + at, buffer + at + length, size - at - length);
+                size -= length;
+            }
+            break;
+        case 4: {  // Başka tohumdan parça ekle (kayıt sınırlarını karıştırır)
+            const fuzz_seed_t *other = &s_seeds[next_random() % s_seed_count];
+            size_t from = next_random() % other->size;
+            size_t length = other->size - from;
+            if (length > 64) length = 64;
+            if (length > capacity - at) length = capacity - at;
+            memcpy(buffer + at, other->data + from, length);
+            if (at + length > size) size = at + length;
+            break;
+        }
+        default:   // Kısalt
+            size = at + 1;
+            break;
+        }
+    }
+    return size;
+}
+
+/* ---------------------------------- Giriş ---------------------------------- */
+
+static bool write_corpus(const char *directory)
+{
+    for (size_t i = 0; i < s_seed_count; ++i) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/seed_%04zu", directory, i);
+        FILE *file = fopen(path, "wb");
+        if (!file) {
+            fprintf(stderr, "%s yazilamadi\n", path);
+            return false;
+        }
+        fwrite(s_seeds[i].data, 1, s_seeds[i].size, file);
+        fclose(file);
+    }
+    printf("frame_fuzz: %zu tohum %s dizinine yazildi\n", s_seed_count, directory);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const char *corpus = NULL;
+    int arg = 1;
+    if (arg + 1 < argc && strcmp(argv[arg], "--corpus") == 0) {
+        corpus = argv[arg + 1];
+        arg += 2;
+    }
+    if (arg >= argc) {
+        fprintf(stderr, "kullanim: %s [--corpus <dizin>] <DELTA SAMPLE DATA.txt> [tur]\n", argv[0]);
+        return 2;
+    }
+    const char *sample_path = argv[arg++];
+    long rounds = arg < argc ? strtol(argv[arg], NULL, 10) : FUZZ_DEFAULT_ROUNDS;
+
+    // 1️⃣ Tohumlar
+    host_sample_t sample;
+    if (!host_sample_load(&sample, sample_path, 0)) {
+        fprintf(stderr, "%s okunamadi\n", sample_path);
+        return 1;
+    }
+    add_sample_seeds(&sample);
+    host_sample_free(&sample);
+    add_synth_seed(4, 0, 0);
+    add_synth_seed(4, 50, 7);
+    add_synth_seed(HD32MT_MAX_CHANNELS, 30, 13);
+    add_synth_seed(HD32MT_MAX_CHANNELS + 1, 30, 0);   // Şemadan fazla kanal
+    add_encoded_seeds();
+
+    if (corpus) {
+        return write_corpus(corpus) ? 0 : 1;
+    }
+
+    // 2️⃣ Tohumların kendisi, sonra mutasyonları
+    for (size_t i = 0; i < s_seed_count; ++i) {
+        LLVMFuzzerTestOneInput(s_seeds[i].data, s_seeds[i].size);
+    }
+    static uint8_t input[FUZZ_MAX_INPUT_BYTES];
+    for (long r = 0; r < rounds; ++r) {
+        const fuzz_seed_t *seed = &s_seeds[next_random() % s_seed_count];
+        memcpy(input, seed->data, seed->size);
+        size_t size = mutate(input, seed->size, sizeof(input));
+        LLVMFuzzerTestOneInput(input, size);
+    }
+
+    printf("frame_fuzz: %zu tohum, %ld mutasyon, hata yok\n", s_seed_count, rounds);
+    for (size_t i = 0; i < s_seed_count; ++i) {
+        free(s_seeds[i].data);
+    }
+    return 0;
+}
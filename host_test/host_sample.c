@@ -0,0 +1,125 @@
+#include "host_sample.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hd32mt_framer.h"
+#include "serial_replay.h"
+
+typedef struct {
+    host_sample_t *sample;
+    size_t         record_capacity;
+    size_t         bytes_used;
+    size_t         bytes_capacity;
+} sample_builder_t;
+
+static bool grow(void **buffer, size_t *capacity, size_t needed, size_t item_size)
+{
+    if (needed <= *capacity) return true;
+    size_t next = *capacity ? *capacity * 2 : 256;
+    while (next < needed) next *= 2;
+    void *grown = realloc(*buffer, next * item_size);
+    if (!grown) return false;
+    *buffer   = grown;
+    *capacity = next;
+    return true;
+}
+
+static void on_record(void *context, const char *record, size_t length, bool is_data)
+{
+    sample_builder_t *builder = context;
+    host_sample_t *sample = builder->sample;
+
+    if (!grow((void **)&sample->records, &builder->record_capacity, sample->record_count + 1,
+              sizeof(sample->records[0])) ||
+        !grow((void **)&sample->record_bytes, &builder->bytes_capacity, builder->bytes_used + length, 1)) {
+        return;
+    }
+    memcpy(sample->record_bytes + builder->bytes_used, record, length);
+    /* Adres, tampon büyüdükçe değişir: önce konum saklanır, sonda çevrilir */
+    sample->records[sample->record_count++] = (host_sample_record_t){
+        .data    = (const char *)(uintptr_t)builder->bytes_used,
+        .length  = length,
+        .is_data = is_data,
+    };
+    builder->bytes_used += length;
+    if (is_data) sample->data_count++;
+}
+
+/* sample->stream → çerçeveleyici → kayıtlar */
+static bool frame_stream(host_sample_t *sample, uint16_t channel_count)
+{
+    static hd32mt_framer_t framer;
+    sample_builder_t builder = { .sample = sample };
+    hd32mt_framer_init(&framer, on_record, &builder);
+    hd32mt_framer_set_channel_count(&framer, channel_count);
+    hd32mt_framer_feed(&framer, sample->stream, sample->stream_length);
+
+    for (size_t i = 0; i < sample->record_count; ++i) {
+        sample->records[i].data = sample->record_bytes + (uintptr_t)sample->records[i].data;
+    }
+    return sample->record_count > 0;
+}
+
+/* Replay kaynağını sonuna kadar okur; kaynak her durumda kapatılır */
+static bool load_replay(host_sample_t *sample, serial_replay_t *replay, uint16_t channel_count)
+{
+    // 1️⃣ Replay parçaları → ham akış (UART'ın vereceği baytlar)
+    size_t stream_capacity = 0;
+    const uint8_t *chunk;
+    size_t chunk_length;
+    uint32_t delta_us;
+    while (serial_replay_next(replay, &chunk, &chunk_length, &delta_us)) {
+        if (!grow((void **)&sample->stream, &stream_capacity, sample->stream_length + chunk_length, 1)) {
+            serial_replay_close(replay);
+            host_sample_free(sample);
+            return false;
+        }
+        memcpy(sample->stream + sample->stream_length, chunk, chunk_length);
+        sample->stream_length += chunk_length;
+    }
+    serial_replay_close(replay);
+
+    // 2️⃣ Akış → çerçeveleyici → kayıtlar
+    return frame_stream(sample, channel_count);
+}
+
+bool host_sample_load(host_sample_t *sample, const char *path, uint16_t channel_count)
+{
+    memset(sample, 0, sizeof(*sample));
+
+    serial_replay_t replay;
+    if (!serial_replay_open_file(&replay, path)) {
+        return false;
+    }
+    return load_replay(sample, &replay, channel_count);
+}
+
+bool host_sample_load_synth(host_sample_t *sample, const hd32mt_synth_config_t *config)
+{
+    memset(sample, 0, sizeof(*sample));
+    if (config->record_limit == 0) return false;   // Sonsuz akış belleğe sığmaz
+
+    static hd32mt_synth_t synth;
+    serial_replay_t replay;
+    if (!hd32mt_synth_init(&synth, config) || !serial_replay_open_synth(&replay, &synth)) {
+        return false;
+    }
+    return load_replay(sample, &replay, config->channel_count);
+}
+
+void host_sample_free(host_sample_t *sample)
+{
+    free(sample->stream);
+    free(sample->records);
+    free(sample->record_bytes);
+    memset(sample, 0, sizeof(*sample));
+}
+
+uint64_t host_now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hd32mt_synth.h"
+
+/*
+ * Host testleri için örnek akış: DELTA SAMPLE DATA.txt, HDCP yakalaması ya da
+ * hd32mt_synth serial_replay ile okunur, baytlar hd32mt_framer'dan geçirilir.
+ *
+ *  - stream:  UART'tan gelecek ham baytlar (replay'in beslediği sırayla)
+ *  - records: çerçeveleyicinin ürettiği kayıt/satırlar (halkaya gidenler)
+ */
+
+typedef struct {
+    const char *data;        /* stream'den bağımsız kopya */
+    size_t      length;
+    bool        is_data;     /* $R0/$A0 veri kaydı */
+} host_sample_record_t;
+
+typedef struct {
+    uint8_t              *stream;
+    size_t                stream_length;
+    host_sample_record_t *records;
+    size_t                record_count;
+    size_t                data_count;
+    char                 *record_bytes;   /* records[].data bunun içinde */
+} host_sample_t;
+
+/**
+ * @param channel_count  Çerçeveleyiciye verilecek kanal sayısı (0 = bilinmiyor)
+ * @return false         Dosya açılamadı ya da kayıt çıkmadı
+ */
+bool host_sample_load(host_sample_t *sample, const char *path, uint16_t channel_count);
+/**
+ * Aynısı, kaynak olarak sentetik üreteç (config->record_limit kadar kayıt).
+ * Çerçeveleyici config->channel_count ile çalışır.
+ */
+bool host_sample_load_synth(host_sample_t *sample, const hd32mt_synth_config_t *config);
+void host_sample_free(host_sample_t *sample);
+
+/** Monoton saat (ns), ölçümler için */
+uint64_t host_now_ns(void);
@@ -0,0 +1,278 @@
+/*
+ * Modbus RTU master + modbus_port_posix, bir pty çiftinin öbür ucundaki slave
+ * simülatörüne karşı (socat gerekmez: posix_openpt).
+ *
+ *   modbus_pty_test
+ *
+ * Simülatör (iş parçacığı, pty master ucu):
+ *  - slave 1: FC03 / FC04, adres < SIM_REGISTER_COUNT; ilk FC04 yanıtının CRC'si bozuk
+ *  - slave 2: her istekte istisna 02 (geçersiz adres)
+ *  - slave 7: yok (yanıt verilmez)
+ *
+ * Denetlenen: değer çözümü (U16/S16/U32/F32, kelime sırası, ölçek), bitişik
+ * noktaların tek isteğe birleşmesi, CRC hatasında tekrar, istisna ve zaman aşımı
+ * sayaçları, çevrimdışı bloğun yalnızca yoklama turlarında sorulması.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "modbus_master.h"
+#include "modbus_port.h"
+
+#define SIM_REGISTER_COUNT   (100)
+#define SIM_MAX_SLAVES       (8)
+#define TEST_CYCLES          (12)
+#define TEST_SLAVE           (1)
+#define TEST_SLAVE_EXCEPTION (2)
+#define TEST_SLAVE_MISSING   (7)
+
+/* ------------------------------- Slave simülatörü ------------------------------- */
+
+typedef struct {
+    int         fd;                                   /* pty master ucu */
+    atomic_bool stop;
+    uint16_t    holding[SIM_REGISTER_COUNT];
+    uint16_t    input[SIM_REGISTER_COUNT];
+    uint32_t    requests[SIM_MAX_SLAVES];             /* Slave başına gelen istek */
+    uint32_t    bad_requests;                         /* CRC/uzunluk hatalı istek */
+    uint32_t    corrupt_next_input;                   /* Bu kadar FC04 yanıtının CRC'si bozulur */
+} slave_sim_t;
+
+static void sim_write(slave_sim_t *sim, const uint8_t *bytes, size_t length)
+{
+    size_t written = 0;
+    while (written < length) {
+        ssize_t n = write(sim->fd, bytes + written, length - written);
+        if (n < 0) {
+            if (errno == EINTR || errno == EAGAIN) continue;
+            return;
+        }
+        written += (size_t)n;
+    }
+}
+
+static void sim_answer(slave_sim_t *sim, const uint8_t *request)
+{
+    const uint8_t slave     = request[0];
+    const uint8_t function  = request[1];
+    const uint16_t address  = (uint16_t)((request[2] << 8) | request[3]);
+    const uint16_t count    = (uint16_t)((request[4] << 8) | request[5]);
+    sim->requests[slave % SIM_MAX_SLAVES]++;
+
+    uint8_t response[MODBUS_MAX_ADU_BYTES];
+    size_t length;
+    const uint16_t *registers = function == MODBUS_FC_READ_INPUT_REGISTERS ? sim->input : sim->holding;
+    if (slave == TEST_SLAVE_MISSING) {
+        return;
+    }
+    if (slave == TEST_SLAVE_EXCEPTION || count == 0 || count > MODBUS_MAX_READ_REGISTERS ||
+        (uint32_t)address + count > SIM_REGISTER_COUNT ||
+        (function != MODBUS_FC_READ_HOLDING_REGISTERS && function != MODBUS_FC_READ_INPUT_REGISTERS)) {
+        response[0] = slave;
+        response[1] = function | MODBUS_FC_EXCEPTION_FLAG;
+        response[2] = 0x02;
+        length = 3;
+    } else {
+        response[0] = slave;
+        response[1] = function;
+        response[2] = (uint8_t)(count * 2);
+        for (uint16_t i = 0; i < count; ++i) {
+            response[3 + i * 2] = (uint8_t)(registers[address + i] >> 8);
+            response[4 + i * 2] = (uint8_t)(registers[address + i] & 0xFF);
+        }
+        length = 3 + (size_t)count * 2;
+    }
+
+    uint16_t crc = modbus_crc16(response, length);
+    response[length++] = (uint8_t)(crc & 0xFF);
+    response[length++] = (uint8_t)(crc >> 8);
+    if (function == MODBUS_FC_READ_INPUT_REGISTERS && sim->corrupt_next_input) {
+        sim->corrupt_next_input--;
+        response[length - 1] ^= 0x5A;
+    }
+    sim_write(sim, response, length);
+}
+
+static void *sim_thread(void *argument)
+{
+    slave_sim_t *sim = argument;
+    uint8_t request[MODBUS_REQUEST_BYTES];
+    size_t received = 0;
+
+    while (!atomic_load(&sim->stop)) {
+        struct pollfd pfd = { .fd = sim->fd, .events = POLLIN };
+        if (poll(&pfd, 1, 10) <= 0) {
+            received = 0;   // Hat sustu: yarım istek atılır (t3.5 gibi)
+            continue;
+        }
+        ssize_t n = read(sim->fd, request + received, sizeof(request) - received);
+        if (n <= 0) continue;
+        received += (size_t)n;
+        if (received < sizeof(request)) continue;
+
+        received = 0;
+        uint16_t crc = modbus_crc16(request, 6);
+        if (request[6] != (crc & 0xFF) || request[7] != (crc >> 8)) {
+            sim->bad_requests++;
+            continue;
+        }
+        sim_answer(sim, request);
+    }
+    return NULL;
+}
+
+static int open_pty_pair(char *slave_path, size_t slave_path_cap)
+{
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0 ||
+        ptsname_r(fd, slave_path, slave_path_cap) != 0) {
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    struct termios tty;
+    if (tcgetattr(fd, &tty) == 0) {
+        cfmakeraw(&tty);
+        tcsetattr(fd, TCSANOW, &tty);
+    }
+    return fd;
+}
+
+/* ------------------------------------ Test ------------------------------------ */
+
+static bool s_ok = true;
+
+#define TEST_EXPECT(condition)                                              \
+    do {                                                                    \
+        if (!(condition)) {                                                 \
+            fprintf(stderr, "  beklenmedi (%d): %s\n", __LINE__, #condition); \
+            s_ok = false;                                                   \
+        }                                                                   \
+    } while (0)
+
+static bool close_to(float value, float expected)
+{
+    return fabsf(value - expected) <= 1e-4f * fmaxf(1.0f, fabsf(expected));
+}
+
+int main(void)
+{
+    static slave_sim_t sim;
+    char slave_path[64];
+    sim.fd = open_pty_pair(slave_path, sizeof(slave_path));
+    if (sim.fd < 0) {
+        fprintf(stderr, "pty acilamadi: %s\n", strerror(errno));
+        return 1;
+    }
+
+    // Slave 1 register'ları
+    const float f32_value = 21.5f;
+    uint32_t f32_bits;
+    memcpy(&f32_bits, &f32_value, sizeof(f32_bits));
+    sim.holding[0]  = 1234;                          // U16
+    sim.holding[1]  = (uint16_t)-200;                // S16, ölçek 0.5
+    sim.holding[2]  = 0x0001;                        // U32 ABCD = 100000
+    sim.holding[3]  = 0x86A0;
+    sim.holding[4]  = (uint16_t)(f32_bits & 0xFFFF); // F32 CDAB
+    sim.holding[5]  = (uint16_t)(f32_bits >> 16);
+    sim.holding[10] = 250;                           // U16 * 0.1 - 5
+    sim.input[0]    = 42;
+    sim.corrupt_next_input = 1;
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, sim_thread, &sim);
+
+    modbus_posix_port_t posix_port;
+    if (!modbus_port_posix_open(&posix_port, slave_path, 115200)) {
+        fprintf(stderr, "%s acilamadi\n", slave_path);
+        return 1;
+    }
+
+    const modbus_point_t points[] = {
+        { .slave = TEST_SLAVE, .function = MODBUS_FC_READ_HOLDING_REGISTERS, .address = 0,  .type = MODBUS_VALUE_U16 },
+        { .slave = TEST_SLAVE, .function = MODBUS_FC_READ_HOLDING_REGISTERS, .address = 1,  .type = MODBUS_VALUE_S16, .scale = 0.5f },
+        { .slave = TEST_SLAVE, .function = MODBUS_FC_READ_HOLDING_REGISTERS, .address = 2,  .type = MODBUS_VALUE_U32 },
+        { .slave = TEST_SLAVE, .function = MODBUS_FC_READ_HOLDING_REGISTERS, .address = 4,  .type = MODBUS_VALUE_F32,
+          .word_order = MODBUS_WORD_ORDER_LOW_FIRST },
+        { .slave = TEST_SLAVE, .function = MODBUS_FC_READ_HOLDING_REGISTERS, .address = 10, .type = MODBUS_VALUE_U16,
+          .scale = 0.1f, .offset = -5.0f },
+        { .slave = TEST_SLAVE, .function = MODBUS_FC_READ_INPUT_REGISTERS,   .address = 0,  .type = MODBUS_VALUE_U16 },
+        { .slave = TEST_SLAVE_EXCEPTION, .function = MODBUS_FC_READ_HOLDING_REGISTERS, .address = 200, .type = MODBUS_VALUE_U16 },
+        { .slave = TEST_SLAVE_MISSING,   .function = MODBUS_FC_READ_HOLDING_REGISTERS, .address = 0,   .type = MODBUS_VALUE_U16 },
+    };
+    const size_t point_count = sizeof(points) / sizeof(points[0]);
+    const float expected[] = { 1234.0f, -100.0f, 100000.0f, 21.5f, 20.0f, 42.0f, NAN, NAN };
+
+    modbus_master_config_t config = MODBUS_MASTER_DEFAULT_CONFIG();
+    config.period_ms  = 20;
+    config.timeout_ms = 20;
+    config.baud_rate  = 115200;
+
+    static modbus_master_t master;
+    TEST_EXPECT(modbus_master_init(&master, &config, &posix_port.port, points, point_count));
+
+    // 1️⃣ Birleştirme: slave 1 FC03 0..10 tek blok, FC04, slave 2, slave 7
+    TEST_EXPECT(master.block_count == 4);
+    TEST_EXPECT(master.blocks[0].slave == TEST_SLAVE && master.blocks[0].start == 0 && master.blocks[0].count == 11);
+
+    // 2️⃣ Turlar
+    float values[MODBUS_MASTER_MAX_POINTS];
+    for (int cycle = 0; cycle < TEST_CYCLES; ++cycle) {
+        size_t valid = modbus_master_poll(&master, values);
+        TEST_EXPECT(valid == 6);
+        for (size_t p = 0; p < point_count; ++p) {
+            if (isnan(expected[p])) {
+                TEST_EXPECT(isnan(values[p]));
+            } else if (!close_to(values[p], expected[p])) {
+                fprintf(stderr, "  tur %d nokta %zu: %g, beklenen %g\n", cycle, p, values[p], expected[p]);
+                s_ok = false;
+            }
+        }
+    }
+
+    atomic_store(&sim.stop, true);
+    pthread_join(thread, NULL);
+    modbus_port_posix_close(&posix_port);
+    close(sim.fd);
+
+    // 3️⃣ Sayaçlar. Çevrimdışı: ilk MODBUS_MASTER_OFFLINE_FAILURES tur hatalı, sonra yalnızca
+    //    cycles % MODBUS_MASTER_OFFLINE_PROBE_CYCLES == 0 turunda tekrarsız yoklama
+    const uint32_t failing_cycles = MODBUS_MASTER_OFFLINE_FAILURES;
+    uint32_t probes = 0;
+    for (uint32_t cycle = failing_cycles; cycle < TEST_CYCLES; ++cycle) {
+        probes += (cycle % MODBUS_MASTER_OFFLINE_PROBE_CYCLES) == 0;
+    }
+    const uint32_t skipped = TEST_CYCLES - failing_cycles - probes;
+    const modbus_master_stats_t *stats = &master.stats;
+
+    TEST_EXPECT(stats->cycles == TEST_CYCLES);
+    TEST_EXPECT(stats->responses == 2 * TEST_CYCLES);
+    TEST_EXPECT(stats->crc_errors == 1);
+    TEST_EXPECT(stats->exceptions == failing_cycles + probes);
+    TEST_EXPECT(stats->timeouts == failing_cycles * (1u + config.retries) + probes);
+    TEST_EXPECT(stats->frame_errors == 0);
+    TEST_EXPECT(stats->offline_skips == 2 * skipped);
+    TEST_EXPECT(sim.requests[TEST_SLAVE] == 2 * TEST_CYCLES + 1);
+    TEST_EXPECT(sim.requests[TEST_SLAVE_EXCEPTION] == failing_cycles + probes);
+    TEST_EXPECT(sim.requests[TEST_SLAVE_MISSING] == failing_cycles * (1u + config.retries) + probes);
+    TEST_EXPECT(stats->requests == sim.requests[TEST_SLAVE] + sim.requests[TEST_SLAVE_EXCEPTION] +
+                                   sim.requests[TEST_SLAVE_MISSING]);
+    TEST_EXPECT(sim.bad_requests == 0);
+
+    printf("modbus_pty_test: %s, %u tur, %u istek, %u yanit, %u crc, %u istisna, %u zaman asimi, "
+           "%u atlanan, tur max %u us\n",
+           slave_path, (unsigned)stats->cycles, (unsigned)stats->requests, (unsigned)stats->responses,
+           (unsigned)stats->crc_errors, (unsigned)stats->exceptions, (unsigned)stats->timeouts,
+           (unsigned)stats->offline_skips, (unsigned)stats->max_cycle_us);
+    printf("modbus_pty_test: %s\n", s_ok ? "OK" : "HATA");
+    return s_ok ? 0 : 1;
+}
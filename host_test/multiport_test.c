@@ -0,0 +1,288 @@
+/*
+ * Çoklu port: birden fazla serial_if bağlamı aynı anda, her biri kendi sahte
+ * UART'ı, halkası ve tüketici göreviyle (telemetry_service'in cihaz başına düzeni).
+ *
+ *   multiport_test <DELTA SAMPLE DATA.txt>
+ *
+ * Portlar (2 ve 3 portlu iki tur):
+ *  - 0: DELTA SAMPLE DATA.txt, kanal sayısı bilinmiyor
+ *  - 1: hd32mt_synth 4 kanal, payload'da 0x26/0x0A/0x0D
+ *  - 2: hd32mt_synth 8 kanal, payload'da 0x26/0x0A/0x0D, "$A0" kayıtları
+ *
+ * Baytlar sahte UART'tan varsayılan baud hızında gelir (poll modu). Her port için
+ * beklenen, aynı akışın tek başına çerçevelenmesidir (host_sample).
+ * Denetlenen: çerçeveleyici/gecikme sayaçları, halkadan gelen kayıtların sırası ve
+ * içeriği (başka portun kaydı karışmaz), çözülen kanal sayısı, cihaz kimliği.
+ */
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "data_parser.h"
+#include "esp_timer.h"
+#include "host_rtos.h"
+#include "host_sample.h"
+#include "serial_if.h"
+
+/* Bir poll okuması (2048 B) örnek dosyada 64'ten fazla kısa satır taşır; halka
+ * tek okumayı her zaman alacak boyutta (gerçek cihaz bu hızda patlama yapmaz). */
+#define TEST_RING_DATA_BYTES   (8192)
+#define TEST_RING_DESC_COUNT   (256)
+#define TEST_SYNTH_RECORDS     (4000)
+#define TEST_TIMEOUT_US        (30 * 1000000LL)
+#define TEST_MAX_PORTS         (3)
+
+typedef struct {
+    const char *name;
+    uint16_t    channel_count;       /* Çerçeveleyiciye verilen, 0 = örnek dosya */
+    uint8_t     tricky_percent;
+    uint8_t     a0_percent;
+    uint32_t    seed;
+} port_source_t;
+
+static const port_source_t PORT_SOURCES[TEST_MAX_PORTS] = {
+    { .name = "ornek" },
+    { .name = "synth4", .channel_count = 4, .tricky_percent = 20, .seed = 2 },
+    { .name = "synth8", .channel_count = 8, .tricky_percent = 20, .a0_percent = 30, .seed = 3 },
+};
+
+typedef struct {
+    const port_source_t *source;
+    serial_if_t         *serial;
+    host_sample_t        expected;
+    uint64_t             expected_digest;
+    uint32_t             expected_parsed;
+
+    serial_ring_t        ring;
+    uint8_t              ring_data[TEST_RING_DATA_BYTES];
+    serial_ring_desc_t   ring_descs[TEST_RING_DESC_COUNT];
+
+    /* Tüketici görevi */
+    TaskHandle_t         consumer;
+    atomic_bool          stop;
+    atomic_uint          consumed;
+    uint64_t             digest;
+    uint32_t             parsed;
+    uint32_t             wrong_channels;
+} test_port_t;
+
+static uint64_t digest_record(uint64_t digest, const char *record, size_t length)
+{
+    digest = (digest ^ length) * 0x100000001B3ull;
+    for (size_t i = 0; i < length; ++i) {
+        digest = (digest ^ (uint8_t)record[i]) * 0x100000001B3ull;
+    }
+    return digest;
+}
+
+/* Beklenen: çözülen kaydın kanalı, biliniyorsa çerçeveleyiciye verilen sayı */
+static bool parse_record(const test_port_t *port, hd32mt_timestamp_cache_t *cache,
+                         const char *record, size_t length, bool *out_channels_ok)
+{
+    _Alignas(hd32mt_record_t) char storage[HD32MT_RECORD_BYTES(HD32MT_MAX_CHANNELS)];
+    hd32mt_record_t *parsed = hd32mt_record_init(storage, HD32MT_MAX_CHANNELS);
+    if (!parse_hd32mt_frame(record, length, cache, parsed)) return false;
+    *out_channels_ok = port->source->channel_count == 0 ||
+                       parsed->channel_count == port->source->channel_count;
+    return true;
+}
+
+static void consumer_task(void *parameters)
+{
+    test_port_t *port = parameters;
+    uint64_t digest = 0xCBF29CE484222325ull;
+    hd32mt_timestamp_cache_t cache = {0};
+
+    for (;;) {
+        bool stopping = atomic_load(&port->stop);
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+
+        serial_ring_desc_t desc;
+        while (serial_ring_peek(&port->ring, &desc)) {
+            const char *record = serial_ring_record(&port->ring, &desc);
+            digest = digest_record(digest, record, desc.length);
+            bool channels_ok = true;
+            if (parse_record(port, &cache, record, desc.length, &channels_ok)) {
+                port->parsed++;
+                port->wrong_channels += !channels_ok;
+            }
+            serial_ring_release(&port->ring, &desc);
+            atomic_fetch_add(&port->consumed, 1);
+        }
+        if (stopping) break;   // Durdurma isteğinden sonra halka bir kez daha boşaltıldı
+    }
+    port->digest = digest;
+    vTaskDelete(NULL);
+}
+
+/* --------------------------------- Kurulum --------------------------------- */
+
+static bool open_source(test_port_t *port, const char *sample_path)
+{
+    const port_source_t *source = port->source;
+    if (source->channel_count == 0) {
+        return host_sample_load(&port->expected, sample_path, 0);
+    }
+
+    hd32mt_synth_config_t config = HD32MT_SYNTH_DEFAULT_CONFIG();
+    config.channel_count  = source->channel_count;
+    config.tricky_percent = source->tricky_percent;
+    config.a0_percent     = source->a0_percent;
+    config.seed           = source->seed;
+    config.noise_bytes    = 8;
+    config.record_limit   = TEST_SYNTH_RECORDS;
+    return host_sample_load_synth(&port->expected, &config);
+}
+
+static bool setup_port(test_port_t *port, uint8_t index, uart_port_t uart_port, const char *sample_path)
+{
+    memset(port, 0, sizeof(*port));
+    port->source = &PORT_SOURCES[index];
+    if (!open_source(port, sample_path)) {
+        fprintf(stderr, "[%s] kaynak acilamadi\n", port->source->name);
+        return false;
+    }
+    host_uart_attach(uart_port, port->expected.stream, port->expected.stream_length);
+
+    // Beklenen özet ve çözülen kayıt sayısı, kaynağın tek başına çerçevelenmesinden
+    hd32mt_timestamp_cache_t cache = {0};
+    port->expected_digest = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < port->expected.record_count; ++i) {
+        const host_sample_record_t *record = &port->expected.records[i];
+        bool channels_ok;
+        port->expected_digest = digest_record(port->expected_digest, record->data, record->length);
+        port->expected_parsed += parse_record(port, &cache, record->data, record->length, &channels_ok);
+    }
+
+    serial_if_config_t config = SERIAL_IF_DEFAULT_CONFIG();
+    config.uart_port            = uart_port;
+    config.rx_mode              = SERIAL_RX_MODE_POLL;   // Sahte UART'ta olay kuyruğu yok
+    config.instrument_id        = index;
+    config.record_channel_count = port->source->channel_count;
+    port->serial = serial_if_create(&config);
+
+    return port->serial &&
+           serial_ring_init(&port->ring, port->ring_data, sizeof(port->ring_data),
+                            port->ring_descs, TEST_RING_DESC_COUNT) &&
+           xTaskCreate(consumer_task, "consumer", 4096, port, 5, &port->consumer) == pdPASS;
+}
+
+/* --------------------------------- Denetim --------------------------------- */
+
+static bool check_port(const test_port_t *port, uint8_t index)
+{
+    hd32mt_framer_stats_t framer;
+    serial_latency_stats_t latency;
+    serial_if_get_framer_stats(port->serial, &framer);
+    serial_if_get_latency_stats(port->serial, &latency);
+
+    const size_t expected_text = port->expected.record_count - port->expected.data_count;
+    const uint32_t consumed = atomic_load(&port->consumed);
+    bool ok = true;
+
+#define PORT_EXPECT(condition)                                                      \
+    do {                                                                            \
+        if (!(condition)) {                                                         \
+            fprintf(stderr, "  [%s] beklenmedi: %s\n", port->source->name, #condition); \
+            ok = false;                                                             \
+        }                                                                           \
+    } while (0)
+
+    PORT_EXPECT(serial_if_get_instrument_id(port->serial) == index);
+    PORT_EXPECT(framer.data_records == port->expected.data_count);
+    PORT_EXPECT(framer.text_lines == expected_text);
+    PORT_EXPECT(latency.records == framer.data_records);
+    PORT_EXPECT(port->ring.stats.dropped_full == 0);
+    PORT_EXPECT(consumed == port->expected.record_count);
+    PORT_EXPECT(port->digest == port->expected_digest);
+    PORT_EXPECT(port->parsed == port->expected_parsed);
+    PORT_EXPECT(port->wrong_channels == 0);
+    if (port->source->channel_count != 0) {
+        PORT_EXPECT(framer.data_records == TEST_SYNTH_RECORDS);
+        PORT_EXPECT(port->parsed == TEST_SYNTH_RECORDS);
+        PORT_EXPECT(framer.drop_bad_timestamp + framer.drop_missing_space +
+                    framer.drop_bad_terminator + framer.drop_oversize == 0);
+    }
+#undef PORT_EXPECT
+
+    printf("  [%u] %-8s %6u kayit + %5u satir, cozulen %6u, gecikme ort %6.0f / max %6u us, tepe %2u kayit%s\n",
+           (unsigned)index, port->source->name, (unsigned)framer.data_records, (unsigned)framer.text_lines,
+           (unsigned)port->parsed,
+           latency.records ? (double)latency.total_us / (double)latency.records : 0.0,
+           (unsigned)latency.max_us, (unsigned)port->ring.stats.peak_descs, ok ? "" : "  HATA");
+    return ok;
+}
+
+/*
+ * serial_if'te bağlam kapatma yok: önceki turun alıcıları boş UART'larını yoklamaya
+ * devam eder, bu yüzden her tur kendi portlarını ve yeni UART numaralarını kullanır.
+ */
+static bool run_ports(test_port_t *ports, uint8_t port_count, uart_port_t first_uart,
+                      const char *sample_path)
+{
+    printf("multiport_test: %u port\n", (unsigned)port_count);
+
+    for (uint8_t i = 0; i < port_count; ++i) {
+        if (!setup_port(&ports[i], i, first_uart + i, sample_path)) return false;
+    }
+
+    // 1️⃣ Tüm alıcılar birlikte başlar (tüketici görevleri zaten çalışıyor)
+    const uint32_t tasks = host_rtos_task_count();   // Tüketiciler + önceki turun alıcıları
+    int64_t start_us = esp_timer_get_time();
+    for (uint8_t i = 0; i < port_count; ++i) {
+        if (!serial_if_start(ports[i].serial, &ports[i].ring, ports[i].consumer)) {
+            fprintf(stderr, "[%u] serial_if_start basarisiz\n", (unsigned)i);
+            return false;
+        }
+    }
+
+    // 2️⃣ Her port kendi akışının tüm kayıtlarını teslim edene kadar
+    bool done = true;
+    for (uint8_t i = 0; i < port_count; ++i) {
+        while (atomic_load(&ports[i].consumed) < ports[i].expected.record_count &&
+               esp_timer_get_time() - start_us < TEST_TIMEOUT_US) {
+            vTaskDelay(pdMS_TO_TICKS(1));
+        }
+        done &= atomic_load(&ports[i].consumed) >= ports[i].expected.record_count;
+    }
+    double elapsed_s = (double)(esp_timer_get_time() - start_us) / 1e6;
+
+    // Tüketiciler halkayı son kez boşaltıp biter (fazla kayıt varsa sayaçta görünür);
+    // alıcılar boş UART'ı yoklamaya devam eder
+    for (uint8_t i = 0; i < port_count; ++i) {
+        atomic_store(&ports[i].stop, true);
+        xTaskNotifyGive(ports[i].consumer);
+    }
+    while (host_rtos_task_count() > tasks) {   // - tüketiciler + bu turun alıcıları
+        vTaskDelay(1);
+    }
+
+    // 3️⃣ Port başına sayaçlar
+    bool ok = done;
+    if (!done) fprintf(stderr, "  zaman asimi\n");
+    uint64_t total = 0;
+    size_t total_bytes = 0;
+    for (uint8_t i = 0; i < port_count; ++i) {
+        ok &= check_port(&ports[i], i);
+        total += atomic_load(&ports[i].consumed);
+        total_bytes += ports[i].expected.stream_length;
+    }
+    printf("  toplam %llu kayit/satir, %zu bayt, %.3f sn, %.0f kayit/sn\n",
+           (unsigned long long)total, total_bytes, elapsed_s, (double)total / elapsed_s);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "kullanim: %s <DELTA SAMPLE DATA.txt>\n", argv[0]);
+        return 2;
+    }
+
+    static test_port_t two_ports[2], three_ports[3];
+    bool ok = run_ports(two_ports, 2, UART_NUM_0, argv[1]);
+    ok &= run_ports(three_ports, 3, UART_NUM_2, argv[1]);
+    printf("multiport_test: %s\n", ok ? "OK" : "HATA");
+    return ok ? 0 : 1;
+}
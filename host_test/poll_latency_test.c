@@ -0,0 +1,136 @@
+/*
+ * Poll modu gecikme ölçümü: sahte UART kayıtları cihaz gibi aralıklı verir,
+ * serial_if'in raporladığı gecikme gerçek son bayt zamanıyla karşılaştırılır.
+ *
+ *   poll_latency_test
+ *
+ * Her kayıt ayrı bir grup (TEST_PERIOD_US aralıkla); okuma penceresi (100 ms) ve
+ * boşta uyku (10 ms) ile faz kaydıkça gecikme 0..pencere arasında dağılır.
+ * Gerçek gecikme, kaydın halkaya yazılmadan hemen önce çağrılan gözlemcide
+ * (serial_if_set_record_tap) host_uart_byte_time_us ile hesaplanır.
+ *
+ * Denetlenen: ölçülen ortalama gerçek ortalamaya TEST_TOLERANCE_US içinde
+ * yakın (okuma dönüşünden ölçülseydi ≈ 0 olurdu); sürücü beklemesi raporlanır
+ * ve hiçbir kaydın gerçek gecikmesinden kısa değildir.
+ */
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_timer.h"
+#include "hd32mt_framer.h"
+#include "host_rtos.h"
+#include "serial_if.h"
+
+#define TEST_RECORDS        (16)
+#define TEST_CHANNELS       (4)
+#define TEST_PERIOD_US      (150 * 1000)   /* Pencere + boşta uykudan uzun: faz kayar */
+#define TEST_TOLERANCE_US   (5 * 1000)     /* Yoklama (1 tick), boşta uykuda gelen kaydın geç görülmesi, zamanlama */
+#define TEST_TIMEOUT_US     (10 * 1000000LL)
+#define TEST_RECORD_BYTES   (HD32MT_FRAME_HEADER_LEN + TEST_CHANNELS * 4 + 1)
+
+typedef struct {
+    uart_port_t port;
+    atomic_uint data_records;
+    int64_t     true_total_us;
+    int64_t     true_max_us;
+} latency_probe_t;
+
+/* Alıcı görevde, halkaya yazmadan hemen önce: son baytın gerçek gelişinden bu ana */
+static void on_record(void *tap_arg, const char *record, size_t length, bool is_data)
+{
+    (void)record;
+    (void)length;
+    latency_probe_t *probe = tap_arg;
+    if (!is_data) return;
+
+    unsigned index = atomic_load(&probe->data_records);
+    int64_t arrived_us = host_uart_byte_time_us(probe->port, (size_t)(index + 1) * TEST_RECORD_BYTES);
+    int64_t latency_us = esp_timer_get_time() - arrived_us;
+    probe->true_total_us += latency_us;
+    if (latency_us > probe->true_max_us) probe->true_max_us = latency_us;
+    atomic_store(&probe->data_records, index + 1);
+}
+
+int main(void)
+{
+    // 1️⃣ Eşit uzunlukta kayıtlar: her grup tam bir kayıt
+    static uint8_t stream[TEST_RECORDS * TEST_RECORD_BYTES];
+    for (int i = 0; i < TEST_RECORDS; ++i) {
+        char timestamp[16];
+        snprintf(timestamp, sizeof(timestamp), "2408011200%02d", i);
+        const float values[TEST_CHANNELS] = { 1.0f * (float)i, 2.5f, -3.0f, 1000.0f };
+        if (hd32mt_record_encode(timestamp, values, TEST_CHANNELS, (char *)stream + i * TEST_RECORD_BYTES,
+                                 TEST_RECORD_BYTES) != TEST_RECORD_BYTES) {
+            fprintf(stderr, "kayit uretilemedi\n");
+            return 1;
+        }
+    }
+
+    serial_if_config_t config = SERIAL_IF_DEFAULT_CONFIG();
+    config.rx_mode              = SERIAL_RX_MODE_POLL;
+    config.record_channel_count = TEST_CHANNELS;
+    host_uart_attach(config.uart_port, stream, sizeof(stream));
+    host_uart_set_bursts(config.uart_port, TEST_RECORD_BYTES, TEST_PERIOD_US);
+
+    static serial_ring_t ring;
+    static uint8_t ring_data[4096];
+    static serial_ring_desc_t ring_descs[64];
+    serial_if_t *serial = serial_if_create(&config);
+    if (!serial || !serial_ring_init(&ring, ring_data, sizeof(ring_data), ring_descs, 64)) {
+        fprintf(stderr, "serial_if kurulamadi\n");
+        return 1;
+    }
+    latency_probe_t probe = { .port = config.uart_port };
+    const serial_if_record_tap_t tap = { .fn = on_record, .arg = &probe };
+    serial_if_set_record_tap(serial, &tap);
+
+    // 2️⃣ Tüm kayıtlar gelene kadar halkayı boşalt
+    if (!serial_if_start(serial, &ring, NULL)) {
+        fprintf(stderr, "serial_if_start basarisiz\n");
+        return 1;
+    }
+    const int64_t deadline_us = esp_timer_get_time() + TEST_TIMEOUT_US;
+    while (atomic_load(&probe.data_records) < TEST_RECORDS && esp_timer_get_time() < deadline_us) {
+        serial_ring_desc_t desc;
+        while (serial_ring_peek(&ring, &desc)) {
+            serial_ring_release(&ring, &desc);
+        }
+        vTaskDelay(10);
+    }
+    serial_if_set_record_tap(serial, NULL);
+
+    // 3️⃣ Denetim
+    serial_latency_stats_t latency;
+    serial_if_get_latency_stats(serial, &latency);
+    const unsigned records = atomic_load(&probe.data_records);
+    const int64_t true_mean_us = records ? probe.true_total_us / records : 0;
+    const int64_t measured_mean_us = latency.records ? (int64_t)(latency.total_us / latency.records) : 0;
+    bool ok = true;
+
+#define LATENCY_EXPECT(condition)                                    \
+    do {                                                             \
+        if (!(condition)) {                                          \
+            fprintf(stderr, "  beklenmedi: %s\n", #condition);       \
+            ok = false;                                              \
+        }                                                            \
+    } while (0)
+
+    LATENCY_EXPECT(records == TEST_RECORDS);
+    LATENCY_EXPECT(latency.records == records);
+    LATENCY_EXPECT(true_mean_us > TEST_TOLERANCE_US);
+    LATENCY_EXPECT(measured_mean_us >= true_mean_us - TEST_TOLERANCE_US);
+    LATENCY_EXPECT(measured_mean_us <= true_mean_us + TEST_TOLERANCE_US);
+    LATENCY_EXPECT(latency.chunks >= 1 && latency.chunks <= records);
+    LATENCY_EXPECT(latency.wait_max_us >= probe.true_max_us - TEST_TOLERANCE_US);
+#undef LATENCY_EXPECT
+
+    printf("poll_latency_test: %u kayit, gercek ort=%.1f ms max=%.1f ms, olculen ort=%.1f ms max=%.1f ms\n",
+           records, (double)true_mean_us / 1000.0, (double)probe.true_max_us / 1000.0,
+           (double)measured_mean_us / 1000.0, (double)latency.max_us / 1000.0);
+    printf("poll_latency_test: surucu bekleme ort=%.1f ms max=%.1f ms (%u parca)\n",
+           latency.chunks ? (double)latency.wait_total_us / latency.chunks / 1000.0 : 0.0,
+           (double)latency.wait_max_us / 1000.0, (unsigned)latency.chunks);
+    printf("poll_latency_test: %s\n", ok ? "OK" : "HATA");
+    return ok ? 0 : 1;
+}
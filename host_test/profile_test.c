@@ -0,0 +1,224 @@
+/*
+ * Profil sabitleri uçtan uca: her profil için o profilin hat biçiminde kayıtlar
+ * üretilir, serial_if (poll, sahte UART) → halka → profilin çözücüsü.
+ *
+ *   profile_test
+ *
+ * Host derlemesinde HD32MT_PROFILE_TEST_ENTRIES tanımlıdır: varsayılan HD32MT.1'in
+ * yanında her sabiti farklı TEST.LE profili ('#', 'M'/'N', '5'/'6', DDMMYY,
+ * F32_LE, N = 3, '%') de sınanır.
+ *
+ * Kayıtlar: önek + tip (sırayla iki tip) + bayrak (ilk kayıtta döküm bayrağı),
+ * "\r\n", profilin düzeninde zaman damgası, ' ', N float (profilin kodlamasında,
+ * ilk kanal hatta sonlandırıcı/CR/LF/önek baytları), sonlandırıcı.
+ * Kanal sayısı profilde yoksa ayardan verilir (TEST_CONFIG_CHANNELS).
+ *
+ * Denetlenen: serial_if_set_profile ile tüm kayıtlar çerçevelenir ve düşen yoktur;
+ * epoch YYMMDD karşılığının çözümüyle, değerler bit bit aynıdır; varsayılan
+ * biçimdeki çerçeveleyici başka profilin akışından veri kaydı çıkarmaz.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "data_parser.h"
+#include "esp_timer.h"
+#include "hd32mt_framer.h"
+#include "hd32mt_profile.h"
+#include "host_rtos.h"
+#include "serial_if.h"
+
+#define TEST_RECORDS          (24)
+#define TEST_CONFIG_CHANNELS  (4)     /* Profilde N yoksa */
+#define TEST_RING_DATA_BYTES  (4096)
+#define TEST_RING_DESC_COUNT  (64)
+#define TEST_TIMEOUT_US       (10 * 1000000LL)
+#define TEST_WIRE_BYTES       (TEST_RECORDS * (HD32MT_FRAME_HEADER_LEN + 2 + HD32MT_MAX_CHANNELS * 4 + 1))
+
+typedef struct {
+    uint8_t  wire[TEST_WIRE_BYTES];
+    size_t   wire_length;
+    uint8_t  channels;
+    uint32_t epochs[TEST_RECORDS];
+    uint32_t bits[TEST_RECORDS][HD32MT_MAX_CHANNELS];
+} profile_stream_t;
+
+/* Hattaki 4 bayt ↔ float bitleri (profilin kodlaması) */
+static uint32_t wire_to_bits(const uint8_t *wire, hd32mt_payload_encoding_t encoding)
+{
+    if (encoding == HD32MT_ENCODING_F32_BE) {
+        return (uint32_t)wire[0] << 24 | (uint32_t)wire[1] << 16 | (uint32_t)wire[2] << 8 | wire[3];
+    }
+    return (uint32_t)wire[3] << 24 | (uint32_t)wire[2] << 16 | (uint32_t)wire[1] << 8 | wire[0];
+}
+
+static void bits_to_wire(uint32_t bits, hd32mt_payload_encoding_t encoding, uint8_t *wire)
+{
+    for (int k = 0; k < 4; ++k) {
+        int shift = encoding == HD32MT_ENCODING_F32_BE ? 24 - 8 * k : 8 * k;
+        wire[k] = (uint8_t)(bits >> shift);
+    }
+}
+
+static bool build_stream(const hd32mt_profile_t *profile, profile_stream_t *stream)
+{
+    const hd32mt_frame_format_t *frame = &profile->frame;
+    stream->channels    = frame->channel_count ? frame->channel_count : TEST_CONFIG_CHANNELS;
+    stream->wire_length = 0;
+
+    /* Hatta önce sonlandırıcı, CR, LF, önek: çerçeveleyici yalnızca N*4'e bakmalı */
+    const uint8_t tricky[4] = { (uint8_t)frame->terminator, '\r', '\n', (uint8_t)frame->prefix };
+    for (int i = 0; i < TEST_RECORDS; ++i) {
+        // 1️⃣ Zaman: gün her 8 kayıtta değişir; beklenen epoch YYMMDD biçiminden
+        const int day = 1 + i / 8, second = i % 60;
+        char reference[HD32MT_FRAME_TIMESTAMP_LEN + 1];
+        char timestamp[HD32MT_FRAME_TIMESTAMP_LEN + 1];
+        snprintf(reference, sizeof(reference), "2408%02d1200%02d", day, second);
+        if (profile->layout == HD32MT_TIMESTAMP_DDMMYY) {
+            snprintf(timestamp, sizeof(timestamp), "%02d08241200%02d", day, second);
+        } else {
+            memcpy(timestamp, reference, sizeof(timestamp));
+        }
+        if (!hd32mt_timestamp_to_epoch(reference, &stream->epochs[i])) return false;
+
+        // 2️⃣ Başlık: tip sırayla, ilk kayıt döküm bayrağıyla; önekten sonra satır sonu
+        uint8_t *out = stream->wire + stream->wire_length;
+        size_t n = 0;
+        out[n++] = (uint8_t)frame->prefix;
+        out[n++] = (uint8_t)frame->record_types[i % 2];
+        out[n++] = (uint8_t)frame->record_flags[i == 0 ? 1 : 0];
+        out[n++] = '\r';
+        out[n++] = '\n';
+        memcpy(out + n, timestamp, HD32MT_FRAME_TIMESTAMP_LEN);
+        n += HD32MT_FRAME_TIMESTAMP_LEN;
+        out[n++] = ' ';
+
+        // 3️⃣ Payload: ilk kanal zor baytlar, diğerleri kayda özgü değerler
+        for (uint8_t c = 0; c < stream->channels; ++c) {
+            uint32_t bits;
+            if (c == 0) {
+                bits = wire_to_bits(tricky, profile->encoding);
+            } else {
+                float value = (float)(i * 10 + c) + 0.25f;
+                memcpy(&bits, &value, sizeof(bits));
+            }
+            stream->bits[i][c] = bits;
+            bits_to_wire(bits, profile->encoding, out + n);
+            n += 4;
+        }
+        out[n++] = (uint8_t)frame->terminator;
+        stream->wire_length += n;
+    }
+    return true;
+}
+
+static bool run_profile(const hd32mt_profile_t *profile)
+{
+    static profile_stream_t stream;
+    if (!build_stream(profile, &stream)) {
+        fprintf(stderr, "%s: kayitlar uretilemedi\n", profile->dl_type);
+        return false;
+    }
+
+    // 4️⃣ serial_if: her profil kendi portunda, profil başlamadan bildirilir
+    serial_if_config_t config = SERIAL_IF_DEFAULT_CONFIG();
+    config.rx_mode              = SERIAL_RX_MODE_POLL;
+    config.uart_port            = UART_NUM_1 + (uart_port_t)profile->id;
+    config.record_channel_count = profile->frame.channel_count ? 0 : TEST_CONFIG_CHANNELS;
+    host_uart_attach(config.uart_port, stream.wire, stream.wire_length);
+
+    static serial_ring_t ring;
+    static uint8_t ring_data[TEST_RING_DATA_BYTES];
+    static serial_ring_desc_t ring_descs[TEST_RING_DESC_COUNT];
+    serial_if_t *serial = serial_if_create(&config);
+    if (!serial || !serial_ring_init(&ring, ring_data, sizeof(ring_data), ring_descs, TEST_RING_DESC_COUNT)) {
+        fprintf(stderr, "%s: serial_if kurulamadi\n", profile->dl_type);
+        return false;
+    }
+    serial_if_set_profile(serial, profile);
+    if (!serial_if_start(serial, &ring, NULL)) {
+        fprintf(stderr, "%s: serial_if_start basarisiz\n", profile->dl_type);
+        return false;
+    }
+
+    // 5️⃣ Halkayı profilin çözücüsüyle tüket
+    hd32mt_timestamp_cache_t timestamps = { 0 };
+    uint32_t data_records = 0, decoded = 0, epoch_errors = 0, value_errors = 0, other_lines = 0;
+    const int64_t deadline_us = esp_timer_get_time() + TEST_TIMEOUT_US;
+    while (data_records < TEST_RECORDS && esp_timer_get_time() < deadline_us) {
+        serial_ring_desc_t desc;
+        while (serial_ring_peek(&ring, &desc)) {
+            const char *line = serial_ring_record(&ring, &desc);
+            if (!hd32mt_profile_is_data_record(profile, line, desc.length) || data_records >= TEST_RECORDS) {
+                other_lines++;
+                serial_ring_release(&ring, &desc);
+                continue;
+            }
+            _Alignas(hd32mt_record_t) char storage[HD32MT_RECORD_BYTES(HD32MT_MAX_CHANNELS)];
+            hd32mt_record_t *record = hd32mt_record_init(storage, HD32MT_MAX_CHANNELS);
+            if (profile->decode(line, desc.length, &timestamps, record) &&
+                record->payload_channels == stream.channels) {
+                decoded++;
+                epoch_errors += record->epoch != stream.epochs[data_records];
+                for (uint8_t c = 0; c < stream.channels; ++c) {
+                    uint32_t bits;
+                    memcpy(&bits, &record->values[c], sizeof(bits));
+                    value_errors += bits != stream.bits[data_records][c];
+                }
+            }
+            data_records++;
+            serial_ring_release(&ring, &desc);
+        }
+        vTaskDelay(1);
+    }
+
+    // 6️⃣ Denetim
+    hd32mt_framer_stats_t framer;
+    serial_if_get_framer_stats(serial, &framer);
+    static hd32mt_framer_t fallback;
+    hd32mt_framer_init(&fallback, NULL, NULL);
+    hd32mt_framer_feed(&fallback, stream.wire, stream.wire_length);
+    bool ok = true;
+
+#define PROFILE_EXPECT(condition)                                            \
+    do {                                                                     \
+        if (!(condition)) {                                                  \
+            fprintf(stderr, "  %s beklenmedi: %s\n", profile->dl_type, #condition); \
+            ok = false;                                                      \
+        }                                                                    \
+    } while (0)
+
+    PROFILE_EXPECT(framer.data_records == TEST_RECORDS);
+    PROFILE_EXPECT(framer.drop_bad_timestamp == 0);
+    PROFILE_EXPECT(framer.drop_missing_space == 0);
+    PROFILE_EXPECT(framer.drop_bad_terminator == 0);
+    PROFILE_EXPECT(framer.drop_oversize == 0);
+    PROFILE_EXPECT(ring.stats.dropped_full == 0);
+    PROFILE_EXPECT(data_records == TEST_RECORDS);
+    PROFILE_EXPECT(other_lines == 0);
+    PROFILE_EXPECT(decoded == TEST_RECORDS);
+    PROFILE_EXPECT(epoch_errors == 0);
+    PROFILE_EXPECT(value_errors == 0);
+    if (profile->id != HD32MT_PROFILE_DEFAULT) {
+        PROFILE_EXPECT(fallback.stats.data_records == 0);
+    }
+#undef PROFILE_EXPECT
+
+    printf("profile_test: %s '%c%c%c' N=%u, %u/%u kayit cozuldu, varsayilan bicim %u veri kaydi gordu\n",
+           profile->dl_type, profile->frame.prefix, profile->frame.record_types[0], profile->frame.record_flags[0],
+           (unsigned)stream.channels, (unsigned)decoded, (unsigned)TEST_RECORDS,
+           (unsigned)fallback.stats.data_records);
+    return ok;
+}
+
+int main(void)
+{
+    bool ok = HD32MT_PROFILE_COUNT > 1;
+    if (!ok) {
+        fprintf(stderr, "test profili yok (HD32MT_PROFILE_TEST_ENTRIES)\n");
+    }
+    for (int id = 0; id < HD32MT_PROFILE_COUNT; ++id) {
+        ok &= run_profile(hd32mt_profile_get((hd32mt_profile_id_t)id));
+    }
+    printf("profile_test: %s\n", ok ? "OK" : "HATA");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,282 @@
+/*
+ * UART alıcı → telemetri görevi hattı: SPSC bayt halkası ile eski kuyruk yolu.
+ *
+ *   ring_bench [--quick] <DELTA SAMPLE DATA.txt>
+ *
+ * Örnek döküm çerçeveleyiciden geçirilir; üretilen kayıt/satırlar bir üretici
+ * iş parçacığından hız sınırı olmadan tekrar tekrar gönderilir, tüketici iş
+ * parçacığı her kaydın baytlarını okur.
+ *
+ *  - halka:  serial_ring (4 KB + 64 tanımlayıcı, telemetry_service ayarları),
+ *            kayıt bir kez kopyalanır, tüketici halka içinden okur,
+ *            uyandırma xTaskNotifyGive gibi sayaçlı semafor ile
+ *  - kuyruk: eski xQueueCreate(16, 1024) yolu; FreeRTOS kuyruğu gibi kilit
+ *            altında öğenin tamamı (1024 B) gönderirken ve alırken kopyalanır
+ *
+ * Her iki yolda üretici, hedef doluysa bekler (kayıt düşmez); tüketicinin
+ * gördüğü bayt özeti kaynağınkiyle aynı olmalıdır (sıra + içerik).
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_sample.h"
+#include "serial_ring.h"
+
+/* telemetry_service.c: TELEMETRY_RING_DATA_BYTES / TELEMETRY_RING_DESC_COUNT */
+#define BENCH_RING_DATA_BYTES   (4096)
+#define BENCH_RING_DESC_COUNT   (64)
+/* Eski yol: TELEMETRY_QUEUE_LENGTH x TELEMETRY_LINE_MAX_BYTES */
+#define BENCH_QUEUE_LENGTH      (16)
+#define BENCH_QUEUE_ITEM_BYTES  (1024)
+
+#define BENCH_RECORDS_FULL      (4000000u)
+#define BENCH_RECORDS_QUICK     (200000u)
+
+/* Sıraya duyarlı özet (FNV-1a, uzunluk dahil) */
+static uint64_t digest_record(uint64_t digest, const char *record, size_t length)
+{
+    digest = (digest ^ length) * 0x100000001B3ull;
+    for (size_t i = 0; i < length; ++i) {
+        digest = (digest ^ (uint8_t)record[i]) * 0x100000001B3ull;
+    }
+    return digest;
+}
+
+typedef struct {
+    const host_sample_t *sample;
+    uint32_t             records;        /* Gönderilecek kayıt */
+    uint64_t             digest;         /* Tüketicinin gördüğü */
+    uint32_t             full_waits;     /* Üreticinin hedef dolu diye beklediği */
+    uint32_t             peak_records;   /* Aynı anda bekleyen en çok kayıt */
+    uint32_t             peak_bytes;     /* Bekleyen kayıtların kapladığı en çok bayt */
+} bench_run_t;
+
+static const host_sample_record_t *source_record(const bench_run_t *run, uint32_t index)
+{
+    return &run->sample->records[index % run->sample->record_count];
+}
+
+/* --------------------------------- SPSC halka --------------------------------- */
+
+typedef struct {
+    bench_run_t  *run;
+    serial_ring_t ring;
+    sem_t         notify;
+} ring_path_t;
+
+static void *ring_producer(void *argument)
+{
+    ring_path_t *path = argument;
+    for (uint32_t i = 0; i < path->run->records; ++i) {
+        const host_sample_record_t *record = source_record(path->run, i);
+        while (!serial_ring_push(&path->ring, record->data, record->length)) {
+            path->run->full_waits++;
+            sched_yield();
+        }
+        sem_post(&path->notify);   // xTaskNotifyGive
+    }
+    return NULL;
+}
+
+static void *ring_consumer(void *argument)
+{
+    ring_path_t *path = argument;
+    uint64_t digest = 0xCBF29CE484222325ull;
+    uint32_t consumed = 0;
+    while (consumed < path->run->records) {
+        sem_wait(&path->notify);   // ulTaskNotifyTake
+        serial_ring_desc_t desc;
+        while (serial_ring_peek(&path->ring, &desc)) {
+            digest = digest_record(digest, serial_ring_record(&path->ring, &desc), desc.length);
+            serial_ring_release(&path->ring, &desc);
+            consumed++;
+        }
+    }
+    path->run->digest = digest;
+    return NULL;
+}
+
+static bool run_ring(bench_run_t *run, size_t *static_bytes)
+{
+    static uint8_t            data[BENCH_RING_DATA_BYTES];
+    static serial_ring_desc_t descs[BENCH_RING_DESC_COUNT];
+    static ring_path_t        path;
+    path.run = run;
+    if (!serial_ring_init(&path.ring, data, sizeof(data), descs, BENCH_RING_DESC_COUNT) ||
+        sem_init(&path.notify, 0, 0) != 0) {
+        return false;
+    }
+
+    pthread_t producer, consumer;
+    pthread_create(&consumer, NULL, ring_consumer, &path);
+    pthread_create(&producer, NULL, ring_producer, &path);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+    sem_destroy(&path.notify);
+
+    run->peak_records = path.ring.stats.peak_descs;
+    run->peak_bytes   = path.ring.stats.peak_data_bytes;
+    *static_bytes = sizeof(data) + sizeof(descs) + sizeof(path.ring);
+    return true;
+}
+
+/* ------------------------- Eski yol: 16 x 1024 B kuyruk ------------------------- */
+
+typedef struct {
+    uint16_t length;                                   /* Eski yolda strlen */
+    char     bytes[BENCH_QUEUE_ITEM_BYTES - sizeof(uint16_t)];
+} queue_item_t;
+
+typedef struct {
+    bench_run_t    *run;
+    queue_item_t    items[BENCH_QUEUE_LENGTH];
+    uint32_t        head;
+    uint32_t        tail;
+    pthread_mutex_t lock;                              /* taskENTER_CRITICAL */
+    pthread_cond_t  not_empty;
+} queue_path_t;
+
+static void *queue_producer(void *argument)
+{
+    queue_path_t *path = argument;
+    queue_item_t line;   // serial_receiver_task'ın line_accumulator_buffer'ı
+    for (uint32_t i = 0; i < path->run->records; ++i) {
+        const host_sample_record_t *record = source_record(path->run, i);
+        line.length = (uint16_t)record->length;
+        memcpy(line.bytes, record->data, record->length);
+
+        for (;;) {   // xQueueSend: öğenin tamamı kilit altında kopyalanır
+            pthread_mutex_lock(&path->lock);
+            if (path->head - path->tail < BENCH_QUEUE_LENGTH) {
+                memcpy(&path->items[path->head % BENCH_QUEUE_LENGTH], &line, sizeof(line));
+                path->head++;
+                uint32_t depth = path->head - path->tail;
+                if (depth > path->run->peak_records) path->run->peak_records = depth;
+                pthread_cond_signal(&path->not_empty);
+                pthread_mutex_unlock(&path->lock);
+                break;
+            }
+            pthread_mutex_unlock(&path->lock);
+            path->run->full_waits++;
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *queue_consumer(void *argument)
+{
+    queue_path_t *path = argument;
+    static queue_item_t received;   // telemetry_task'ın received_line'ı
+    uint64_t digest = 0xCBF29CE484222325ull;
+    for (uint32_t consumed = 0; consumed < path->run->records; ++consumed) {
+        pthread_mutex_lock(&path->lock);   // xQueueReceive(portMAX_DELAY)
+        while (path->head == path->tail) {
+            pthread_cond_wait(&path->not_empty, &path->lock);
+        }
+        memcpy(&received, &path->items[path->tail % BENCH_QUEUE_LENGTH], sizeof(received));
+        path->tail++;
+        pthread_mutex_unlock(&path->lock);
+
+        digest = digest_record(digest, received.bytes, received.length);
+    }
+    path->run->digest = digest;
+    return NULL;
+}
+
+static bool run_queue(bench_run_t *run, size_t *static_bytes)
+{
+    static queue_path_t path;
+    path.run  = run;
+    path.head = path.tail = 0;
+    if (pthread_mutex_init(&path.lock, NULL) != 0 || pthread_cond_init(&path.not_empty, NULL) != 0) {
+        return false;
+    }
+
+    pthread_t producer, consumer;
+    pthread_create(&consumer, NULL, queue_consumer, &path);
+    pthread_create(&producer, NULL, queue_producer, &path);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+    pthread_cond_destroy(&path.not_empty);
+    pthread_mutex_destroy(&path.lock);
+
+    run->peak_bytes = run->peak_records * BENCH_QUEUE_ITEM_BYTES;
+    // Kuyruk depolaması + tüketicinin alma tamponu
+    *static_bytes = sizeof(path.items) + BENCH_QUEUE_ITEM_BYTES;
+    return true;
+}
+
+/* ----------------------------------- Giriş ----------------------------------- */
+
+typedef bool (*bench_path_fn)(bench_run_t *run, size_t *static_bytes);
+
+static bool measure(const char *name, bench_path_fn path_fn, const host_sample_t *sample,
+                    uint32_t records, uint64_t expected_digest)
+{
+    bench_run_t run = { .sample = sample, .records = records };
+    size_t static_bytes = 0;
+    uint64_t start = host_now_ns();
+    if (!path_fn(&run, &static_bytes)) {
+        fprintf(stderr, "%s: kurulamadi\n", name);
+        return false;
+    }
+    double seconds = (double)(host_now_ns() - start) / 1e9;
+
+    bool ok = run.digest == expected_digest;
+    printf("  %-7s %11.0f kayit/sn  RAM %6zu B  tepe %3u kayit / %6u B  dolu bekleme %u%s\n",
+           name, (double)records / seconds, static_bytes, (unsigned)run.peak_records,
+           (unsigned)run.peak_bytes, (unsigned)run.full_waits, ok ? "" : "  OZET FARKLI");
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = false;
+    const char *sample_path = NULL;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            quick = true;
+        } else {
+            sample_path = argv[i];
+        }
+    }
+    if (!sample_path) {
+        fprintf(stderr, "kullanim: %s [--quick] <DELTA SAMPLE DATA.txt>\n", argv[0]);
+        return 2;
+    }
+
+    host_sample_t sample;
+    if (!host_sample_load(&sample, sample_path, 0)) {
+        fprintf(stderr, "%s okunamadi\n", sample_path);
+        return 1;
+    }
+    size_t sample_bytes = 0;
+    for (size_t i = 0; i < sample.record_count; ++i) {
+        if (sample.records[i].length > sizeof(((queue_item_t *)0)->bytes)) {
+            fprintf(stderr, "kayit kuyruk ogesinden uzun: %zu B\n", sample.records[i].length);
+            return 1;
+        }
+        sample_bytes += sample.records[i].length;
+    }
+
+    const uint32_t records = quick ? BENCH_RECORDS_QUICK : BENCH_RECORDS_FULL;
+    uint64_t expected = 0xCBF29CE484222325ull;
+    for (uint32_t i = 0; i < records; ++i) {
+        const host_sample_record_t *record = &sample.records[i % sample.record_count];
+        expected = digest_record(expected, record->data, record->length);
+    }
+
+    printf("ring_bench: %zu kayit/satir (ortalama %.1f B), %u kayit gonderiliyor\n",
+           sample.record_count, (double)sample_bytes / (double)sample.record_count, (unsigned)records);
+    bool ok = measure("halka", run_ring, &sample, records, expected);
+    ok &= measure("kuyruk", run_queue, &sample, records, expected);
+
+    host_sample_free(&sample);
+    printf("ring_bench: %s\n", ok ? "OK" : "HATA");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+/*
+ * Örnek dökümün konfigürasyon bloğu ve kayıtları, telemetry_service'in yolundan:
+ * serial_if (replay) → halka → metin satırları hd32mt_config_feed_line'a, veri
+ * kayıtları şemanın DLType'ından seçilen profilin çözücüsüne.
+ *
+ *   schema_stream_test <DELTA SAMPLE DATA.txt>
+ *
+ * serial_if telemetry_bind_instrument'taki gibi kurulur (kanal sayısı ayarda yok),
+ * seçilen profil telemetry_select_profile gibi serial_if_set_profile ile bildirilir.
+ * Denetlenen: şema öğrenilir ve profil bulunur; bloktan sonra gelen veri kayıtları
+ * çerçeveleyicinin akışı tek başına (host_sample) çerçevelediği kadardır, serial_if
+ * yolu dosyanın kendi bozuk başlıklarından (gövdesiz "$R0") fazlasını düşürmez ve
+ * hepsi çözülür.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "data_parser.h"
+#include "hd32mt_framer.h"
+#include "hd32mt_config.h"
+#include "hd32mt_profile.h"
+#include "host_rtos.h"
+#include "host_sample.h"
+#include "serial_if.h"
+
+#define TEST_RING_DATA_BYTES   (4096)   /* telemetry_service ayarları */
+#define TEST_RING_DESC_COUNT   (64)
+
+typedef struct {
+    serial_if_t             *serial;
+    hd32mt_config_parser_t   config_parser;
+    hd32mt_schema_t          schema;
+    bool                     schema_valid;
+    const hd32mt_profile_t  *profile;
+    hd32mt_timestamp_cache_t timestamps;
+
+    uint32_t                 data_records;
+    uint32_t                 data_after_schema;
+    uint32_t                 decoded;
+    uint8_t                  max_payload_channels;
+} consumer_t;
+
+/* telemetry_feed_config_line: şema ve profil değişir, çerçeveleyici profili izler */
+static void feed_config_line(consumer_t *consumer, const char *line, size_t length)
+{
+    hd32mt_schema_t learned;
+    if (!hd32mt_config_feed_line(&consumer->config_parser, line, length, &learned) ||
+        learned.sensor_count == 0) {
+        return;
+    }
+    consumer->schema       = learned;
+    consumer->schema_valid = true;
+
+    const hd32mt_profile_t *profile = hd32mt_profile_find(learned.dl_type);
+    if (!profile) {
+        profile = hd32mt_profile_get(HD32MT_PROFILE_DEFAULT);
+    }
+    if (profile != consumer->profile) {
+        consumer->profile = profile;
+        serial_if_set_profile(consumer->serial, profile);
+    }
+}
+
+/* telemetry_process_one'ın çözümleme kısmı */
+static void consume_record(consumer_t *consumer, const char *line, size_t length)
+{
+    if (!hd32mt_profile_is_data_record(consumer->profile, line, length)) {
+        feed_config_line(consumer, line, length);
+        return;
+    }
+
+    consumer->data_records++;
+    consumer->data_after_schema += consumer->schema_valid;
+
+    _Alignas(hd32mt_record_t) char storage[HD32MT_RECORD_BYTES(HD32MT_MAX_CHANNELS)];
+    hd32mt_record_t *record = hd32mt_record_init(storage, HD32MT_MAX_CHANNELS);
+    if (consumer->profile->decode(line, length, &consumer->timestamps, record)) {
+        consumer->decoded++;
+        if (record->payload_channels > consumer->max_payload_channels) {
+            consumer->max_payload_channels = record->payload_channels;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "kullanim: %s <DELTA SAMPLE DATA.txt>\n", argv[0]);
+        return 2;
+    }
+
+    host_sample_t expected;
+    serial_replay_t replay;
+    if (!host_sample_load(&expected, argv[1], 0) || !serial_replay_open_file(&replay, argv[1])) {
+        fprintf(stderr, "%s okunamadi\n", argv[1]);
+        return 1;
+    }
+    serial_replay_set_speed(&replay, SERIAL_REPLAY_SPEED_UNTHROTTLED);
+
+    static serial_ring_t ring;
+    static uint8_t ring_data[TEST_RING_DATA_BYTES];
+    static serial_ring_desc_t ring_descs[TEST_RING_DESC_COUNT];
+    serial_if_config_t config = SERIAL_IF_DEFAULT_CONFIG();
+    config.rx_mode = SERIAL_RX_MODE_REPLAY;
+    config.replay  = &replay;
+    serial_if_t *serial = serial_if_create(&config);
+    if (!serial || !serial_ring_init(&ring, ring_data, sizeof(ring_data), ring_descs, TEST_RING_DESC_COUNT)) {
+        fprintf(stderr, "serial_if kurulamadi\n");
+        return 1;
+    }
+
+    // 1️⃣ Replay bitene kadar halkayı telemetri gibi tüket (alıcı görev turu bitince çıkar)
+    consumer_t consumer = { .serial = serial, .profile = hd32mt_profile_get(HD32MT_PROFILE_DEFAULT) };
+    hd32mt_config_init(&consumer.config_parser);
+    const uint32_t tasks = host_rtos_task_count();
+    if (!serial_if_start(serial, &ring, NULL)) {
+        fprintf(stderr, "serial_if_start basarisiz\n");
+        return 1;
+    }
+    for (;;) {
+        bool receiver_done = host_rtos_task_count() == tasks;
+        serial_ring_desc_t desc;
+        bool any = false;
+        while (serial_ring_peek(&ring, &desc)) {
+            consume_record(&consumer, serial_ring_record(&ring, &desc), desc.length);
+            serial_ring_release(&ring, &desc);
+            any = true;
+        }
+        if (receiver_done && !any) break;
+        vTaskDelay(1);
+    }
+
+    // 2️⃣ Denetim: aynı akış tek parça çerçeveleyiciden geçince düşenler referans
+    hd32mt_framer_stats_t framer;
+    serial_if_get_framer_stats(serial, &framer);
+    static hd32mt_framer_t reference;
+    hd32mt_framer_init(&reference, NULL, NULL);
+    hd32mt_framer_feed(&reference, expected.stream, expected.stream_length);
+    bool ok = true;
+
+#define SCHEMA_EXPECT(condition)                                     \
+    do {                                                             \
+        if (!(condition)) {                                          \
+            fprintf(stderr, "  beklenmedi: %s\n", #condition);       \
+            ok = false;                                              \
+        }                                                            \
+    } while (0)
+
+    SCHEMA_EXPECT(consumer.schema_valid);
+    SCHEMA_EXPECT(hd32mt_profile_find(consumer.schema.dl_type) != NULL);
+    SCHEMA_EXPECT(expected.data_count > 0);
+    SCHEMA_EXPECT(framer.data_records == expected.data_count);
+    SCHEMA_EXPECT(framer.drop_bad_timestamp == reference.stats.drop_bad_timestamp);
+    SCHEMA_EXPECT(framer.drop_missing_space == reference.stats.drop_missing_space);
+    SCHEMA_EXPECT(framer.drop_bad_terminator == reference.stats.drop_bad_terminator);
+    SCHEMA_EXPECT(ring.stats.dropped_full == 0);
+    SCHEMA_EXPECT(consumer.data_records == expected.data_count);
+    SCHEMA_EXPECT(consumer.data_after_schema == consumer.data_records);
+    SCHEMA_EXPECT(consumer.decoded == consumer.data_records);
+#undef SCHEMA_EXPECT
+
+    printf("schema_stream_test: sema %s, %u kanal satiri (%s); %u veri kaydi (bloktan sonra %u), "
+           "cozulen %u, kayitta en cok %u kanal\n",
+           consumer.schema_valid ? consumer.schema.fingerprint : "-", (unsigned)consumer.schema.sensor_count,
+           consumer.schema.dl_type, (unsigned)consumer.data_records, (unsigned)consumer.data_after_schema,
+           (unsigned)consumer.decoded, (unsigned)consumer.max_payload_channels);
+    printf("schema_stream_test: %s\n", ok ? "OK" : "HATA");
+
+    host_sample_free(&expected);
+    return ok ? 0 : 1;
+}
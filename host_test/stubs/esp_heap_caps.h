@@ -0,0 +1,18 @@
+#pragma once
+/* Host derlemesi: PSRAM yok, her istek dahili RAM'den (malloc) */
+#include <stdint.h>
+#include <stdlib.h>
+
+#define MALLOC_CAP_8BIT     (1u << 2)
+#define MALLOC_CAP_SPIRAM   (1u << 10)
+#define MALLOC_CAP_INTERNAL (1u << 11)
+
+static inline void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    return (caps & MALLOC_CAP_SPIRAM) ? NULL : malloc(size);
+}
+
+static inline void heap_caps_free(void *pointer)
+{
+    free(pointer);
+}
@@ -0,0 +1,12 @@
+#pragma once
+/* Host derlemesi: ESP günlükleri kapalı (ölçümü bozmasın), argümanlar yine de derlenir */
+#include <stdio.h>
+
+#define HOST_LOG_DISCARD(tag, format, ...) \
+    do { if (0) fprintf(stderr, "%s: " format "\n", tag, ##__VA_ARGS__); } while (0)
+
+#define ESP_LOGE(tag, format, ...) HOST_LOG_DISCARD(tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) HOST_LOG_DISCARD(tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) HOST_LOG_DISCARD(tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) HOST_LOG_DISCARD(tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) HOST_LOG_DISCARD(tag, format, ##__VA_ARGS__)
@@ -0,0 +1,16 @@
+#pragma once
+/* Host derlemesi: FreeRTOS türleri; görevler host_rtos.c'de pthread ile */
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int      BaseType_t;
+typedef unsigned UBaseType_t;
+
+#define pdFALSE              ((BaseType_t)0)
+#define pdTRUE               ((BaseType_t)1)
+#define pdPASS               pdTRUE
+#define pdFAIL               pdFALSE
+#define portMAX_DELAY        ((TickType_t)UINT32_MAX)
+/* Cihazdaki 100 Hz yerine 1 kHz: kısa vTaskDelay beklemeleri ölçümü uzatmasın */
+#define portTICK_PERIOD_MS   (1)
+#define pdMS_TO_TICKS(ms)    ((TickType_t)(ms) / portTICK_PERIOD_MS)
@@ -0,0 +1,8 @@
+#pragma once
+/* Host derlemesi: UART olay kuyruğu yok (olay modu host'ta çalışmaz) */
+#include "freertos/FreeRTOS.h"
+
+typedef struct host_queue *QueueHandle_t;
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait);
+BaseType_t xQueueReset(QueueHandle_t queue);
@@ -0,0 +1,352 @@
+/*
+ * Host derlemesi için FreeRTOS görev/bildirim ve UART sürücüsü yerine geçenler.
+ *  - Görev: ayrık pthread, bildirim sayacı kilit + koşul değişkeniyle
+ *  - UART: host_uart_attach ile beslenen sahte port, baytlar baud hızında gelir
+ */
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "driver/uart.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "host_rtos.h"
+#include "storage_spiffs.h"
+
+struct host_task {
+    pthread_t       thread;
+    TaskFunction_t  function;
+    void           *parameters;
+    pthread_mutex_t lock;
+    pthread_cond_t  notified;
+    uint32_t        notify_count;
+    char            name[16];
+};
+
+static __thread struct host_task *s_current_task;
+static atomic_uint s_task_count;
+
+/* ---------------------------------- Görevler ---------------------------------- */
+
+static void *task_entry(void *argument)
+{
+    struct host_task *task = argument;
+    s_current_task = task;
+    task->function(task->parameters);
+    atomic_fetch_sub(&s_task_count, 1);
+    return NULL;   // FreeRTOS'ta görev dönmemeli; host'ta yalnızca iş parçacığı biter
+}
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char *name, uint32_t stack_depth,
+                       void *parameters, UBaseType_t priority, TaskHandle_t *out_handle)
+{
+    (void)stack_depth;
+    (void)priority;
+    struct host_task *task = calloc(1, sizeof(*task));
+    if (!task) return pdFAIL;
+
+    task->function   = function;
+    task->parameters = parameters;
+    snprintf(task->name, sizeof(task->name), "%s", name ? name : "");
+    pthread_mutex_init(&task->lock, NULL);
+    pthread_cond_init(&task->notified, NULL);
+
+    // Tanıtıcı görev başlamadan yazılır: görev kendi tanıtıcısını okuyabilir
+    if (out_handle) *out_handle = task;
+    atomic_fetch_add(&s_task_count, 1);
+    if (pthread_create(&task->thread, NULL, task_entry, task) != 0) {
+        atomic_fetch_sub(&s_task_count, 1);
+        if (out_handle) *out_handle = NULL;
+        free(task);
+        return pdFAIL;
+    }
+    pthread_detach(task->thread);
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (task != NULL && task != s_current_task) {
+        fprintf(stderr, "host_rtos: baska gorevi silmek desteklenmiyor (%s)\n", task->name);
+        abort();
+    }
+    // Başka görevler tanıtıcıyı tutuyor olabilir (bildirim): yapı serbest bırakılmaz
+    atomic_fetch_sub(&s_task_count, 1);
+    pthread_exit(NULL);
+}
+
+uint32_t host_rtos_task_count(void)
+{
+    return atomic_load(&s_task_count);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    int64_t us = (int64_t)ticks * portTICK_PERIOD_MS * 1000;
+    struct timespec delay = { .tv_sec = us / 1000000, .tv_nsec = (us % 1000000) * 1000 };
+    nanosleep(&delay, NULL);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return s_current_task;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    if (!task) return pdFAIL;
+    pthread_mutex_lock(&task->lock);
+    task->notify_count++;
+    pthread_cond_signal(&task->notified);
+    pthread_mutex_unlock(&task->lock);
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    struct host_task *task = s_current_task;
+    if (!task) return 0;
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    if (ticks_to_wait != portMAX_DELAY) {
+        int64_t ns = deadline.tv_nsec + (int64_t)ticks_to_wait * portTICK_PERIOD_MS * 1000000;
+        deadline.tv_sec += ns / 1000000000;
+        deadline.tv_nsec = ns % 1000000000;
+    }
+
+    pthread_mutex_lock(&task->lock);
+    while (task->notify_count == 0) {
+        int waited = ticks_to_wait == portMAX_DELAY
+                   ? pthread_cond_wait(&task->notified, &task->lock)
+                   : pthread_cond_timedwait(&task->notified, &task->lock, &deadline);
+        if (waited != 0) break;
+    }
+    uint32_t count = task->notify_count;
+    if (count) task->notify_count = clear_on_exit ? 0 : count - 1;
+    pthread_mutex_unlock(&task->lock);
+    return count;
+}
+
+/* --------------------------------- Kuyruklar --------------------------------- */
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait)
+{
+    (void)queue;
+    (void)item;
+    vTaskDelay(ticks_to_wait == portMAX_DELAY ? 1000 : ticks_to_wait);
+    return pdFALSE;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue)
+{
+    (void)queue;
+    return pdPASS;
+}
+
+/* ------------------------------------ UART ------------------------------------ */
+
+typedef struct {
+    const uint8_t *bytes;
+    size_t         length;
+    size_t         read;          /* Sürücüden alınan (ya da atılan) */
+    int            baud_rate;
+    int64_t        start_us;      /* İlk okuma; 0 = akış başlamadı */
+    size_t         burst_bytes;   /* 0 = kesintisiz */
+    uint32_t       period_us;
+    bool           installed;
+} host_uart_t;
+
+static host_uart_t s_uarts[UART_NUM_MAX];
+
+static host_uart_t *host_uart(uart_port_t port)
+{
+    return (port >= 0 && port < UART_NUM_MAX) ? &s_uarts[port] : NULL;
+}
+
+/* Şu ana kadar hatta gelen bayt (10 bit/bayt, varsa grup aralarında sessizlik) */
+static size_t uart_arrived(host_uart_t *uart, int64_t now_us)
+{
+    if (uart->start_us == 0) uart->start_us = now_us;
+    uint64_t elapsed_us = (uint64_t)(now_us - uart->start_us);
+    uint64_t arrived;
+    if (uart->burst_bytes) {
+        uint64_t bursts = elapsed_us / uart->period_us;
+        uint64_t in_burst = (elapsed_us - bursts * uart->period_us) * (uint64_t)uart->baud_rate / 10000000u;
+        if (in_burst > uart->burst_bytes) in_burst = uart->burst_bytes;
+        arrived = bursts * uart->burst_bytes + in_burst;
+    } else {
+        arrived = elapsed_us * (uint64_t)uart->baud_rate / 10000000u;
+    }
+    return arrived < uart->length ? (size_t)arrived : uart->length;
+}
+
+/* count. baytın geleceği an */
+static int64_t uart_arrival_us(const host_uart_t *uart, size_t count)
+{
+    uint64_t offset_us = 0;
+    if (uart->burst_bytes && count > 0) {
+        uint64_t bursts = (count - 1) / uart->burst_bytes;
+        count -= (size_t)(bursts * uart->burst_bytes);
+        offset_us = bursts * uart->period_us;
+    }
+    return uart->start_us + (int64_t)(offset_us + (uint64_t)count * 10000000u / (uint64_t)uart->baud_rate);
+}
+
+void host_uart_attach(uart_port_t port, const uint8_t *bytes, size_t length)
+{
+    host_uart_t *uart = host_uart(port);
+    if (!uart) return;
+    uart->bytes    = bytes;
+    uart->length   = length;
+    uart->read     = 0;
+    uart->start_us = 0;
+    uart->burst_bytes = 0;
+}
+
+void host_uart_set_bursts(uart_port_t port, size_t burst_bytes, uint32_t period_us)
+{
+    host_uart_t *uart = host_uart(port);
+    if (!uart) return;
+    uart->burst_bytes = period_us ? burst_bytes : 0;
+    uart->period_us   = period_us;
+}
+
+int64_t host_uart_byte_time_us(uart_port_t port, size_t count)
+{
+    host_uart_t *uart = host_uart(port);
+    return (uart && uart->start_us) ? uart_arrival_us(uart, count) : 0;
+}
+
+esp_err_t uart_param_config(uart_port_t port, const uart_config_t *config)
+{
+    host_uart_t *uart = host_uart(port);
+    if (!uart || !config || config->baud_rate <= 0) return ESP_ERR_INVALID_ARG;
+    uart->baud_rate = config->baud_rate;
+    return ESP_OK;
+}
+
+esp_err_t uart_set_pin(uart_port_t port, int tx, int rx, int rts, int cts)
+{
+    (void)tx; (void)rx; (void)rts; (void)cts;
+    return host_uart(port) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t uart_driver_install(uart_port_t port, int rx_buffer_size, int tx_buffer_size,
+                              int queue_size, QueueHandle_t *out_queue, int intr_alloc_flags)
+{
+    (void)rx_buffer_size; (void)tx_buffer_size; (void)intr_alloc_flags;
+    host_uart_t *uart = host_uart(port);
+    if (!uart || uart->baud_rate <= 0) return ESP_ERR_INVALID_STATE;
+    if (queue_size > 0 || out_queue) return ESP_ERR_NOT_SUPPORTED;   // Olay modu yok
+    uart->installed = true;
+    return ESP_OK;
+}
+
+esp_err_t uart_enable_pattern_det_baud_intr(uart_port_t port, char pattern_chr, uint8_t chr_num,
+                                            int chr_tout, int post_idle, int pre_idle)
+{
+    (void)port; (void)pattern_chr; (void)chr_num; (void)chr_tout; (void)post_idle; (void)pre_idle;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t uart_pattern_queue_reset(uart_port_t port, int queue_length)
+{
+    (void)port;
+    (void)queue_length;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+int uart_pattern_pop_pos(uart_port_t port)
+{
+    (void)port;
+    return -1;
+}
+
+int uart_pattern_get_pos(uart_port_t port)
+{
+    (void)port;
+    return -1;
+}
+
+/* IDF gibi: length bayt gelene ya da süre dolana kadar bekler, geleni döner */
+int uart_read_bytes(uart_port_t port, void *buffer, uint32_t length, TickType_t ticks_to_wait)
+{
+    host_uart_t *uart = host_uart(port);
+    if (!uart || !uart->installed) return -1;
+
+    const int64_t start_us = esp_timer_get_time();
+    const int64_t deadline_us = ticks_to_wait == portMAX_DELAY
+                              ? INT64_MAX
+                              : start_us + (int64_t)ticks_to_wait * portTICK_PERIOD_MS * 1000;
+    for (;;) {
+        int64_t now_us = esp_timer_get_time();
+        size_t available = uart_arrived(uart, now_us) - uart->read;
+        if (available >= length || now_us >= deadline_us) {
+            size_t count = available < length ? available : length;
+            memcpy(buffer, uart->bytes + uart->read, count);
+            uart->read += count;
+            return (int)count;
+        }
+
+        // İstenen son baytın gelişine ya da süre sonuna kadar uyu
+        int64_t wake_us = uart->read + length <= uart->length
+                        ? uart_arrival_us(uart, uart->read + length)
+                        : deadline_us;
+        if (wake_us > deadline_us) wake_us = deadline_us;
+        int64_t sleep_us = wake_us - now_us;
+        if (sleep_us < 100) sleep_us = 100;   // Yuvarlamada boş dönmesin
+        struct timespec delay = { .tv_sec = sleep_us / 1000000, .tv_nsec = (sleep_us % 1000000) * 1000 };
+        nanosleep(&delay, NULL);
+    }
+}
+
+int uart_write_bytes(uart_port_t port, const void *data, size_t length)
+{
+    (void)data;
+    return host_uart(port) ? (int)length : -1;   // Karşıda cihaz yok: gönderilen atılır
+}
+
+esp_err_t uart_flush_input(uart_port_t port)
+{
+    host_uart_t *uart = host_uart(port);
+    if (!uart) return ESP_ERR_INVALID_ARG;
+    if (uart->bytes) uart->read = uart_arrived(uart, esp_timer_get_time());
+    return ESP_OK;
+}
+
+esp_err_t uart_get_buffered_data_len(uart_port_t port, size_t *out_size)
+{
+    host_uart_t *uart = host_uart(port);
+    if (!uart || !out_size) return ESP_ERR_INVALID_ARG;
+    *out_size = uart->bytes ? uart_arrived(uart, esp_timer_get_time()) - uart->read : 0;
+    return ESP_OK;
+}
+
+esp_err_t uart_wait_tx_done(uart_port_t port, TickType_t ticks_to_wait)
+{
+    (void)port;
+    (void)ticks_to_wait;
+    return ESP_OK;
+}
+
+esp_err_t uart_set_baudrate(uart_port_t port, uint32_t baud_rate)
+{
+    host_uart_t *uart = host_uart(port);
+    if (!uart || baud_rate == 0) return ESP_ERR_INVALID_ARG;
+    uart->baud_rate = (int)baud_rate;
+    return ESP_OK;
+}
+
+/* ----------------------------- Depolama (serial_spill) ----------------------------- */
+
+/* Host dosya sistemi her zaman hazır: SD katmanı yerel dosyaya yazar */
+bool storage_is_available(void)
+{
+    return true;
+}
@@ -0,0 +1,25 @@
+#pragma once
+/* Host'a özgü: FreeRTOS/IDF'de karşılığı olmayan test yardımcıları */
+#include <stddef.h>
+#include <stdint.h>
+#include "driver/uart.h"
+
+/** Çalışan (bitmemiş) görev sayısı */
+uint32_t host_rtos_task_count(void);
+
+/**
+ * Sahte UART'a gelecek baytlar (kopyalanmaz, port açıkken geçerli kalmalı).
+ * Baytlar ilk okumadan itibaren uart_param_config'deki baud hızında
+ * (bayt başına 10 bit) sürücü tamponuna düşer. Port başlamadan çağrılmalı.
+ */
+void host_uart_attach(uart_port_t port, const uint8_t *bytes, size_t length);
+
+/**
+ * Baytlar kesintisiz değil, burst_bytes'lık gruplar halinde her period_us'de bir
+ * gelir (cihazın kayıt aralığı gibi); grup içinde baud hızında. 0 = kesintisiz.
+ * host_uart_attach'tan sonra, port başlamadan çağrılmalı.
+ */
+void host_uart_set_bursts(uart_port_t port, size_t burst_bytes, uint32_t period_us);
+
+/** count. baytın hatta geldiği an (esp_timer), akış başlamadıysa 0 */
+int64_t host_uart_byte_time_us(uart_port_t port, size_t count);
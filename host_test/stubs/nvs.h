@@ -0,0 +1,66 @@
+#pragma once
+/* Host derlemesi: NVS yok, her açma denemesi başarısız (şema önbelleği boş başlar) */
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef uint32_t nvs_handle_t;
+
+typedef enum {
+    NVS_READONLY,
+    NVS_READWRITE,
+} nvs_open_mode_t;
+
+static inline esp_err_t nvs_open(const char *name, nvs_open_mode_t mode, nvs_handle_t *out_handle)
+{
+    (void)name;
+    (void)mode;
+    (void)out_handle;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static inline void nvs_close(nvs_handle_t handle)
+{
+    (void)handle;
+}
+
+static inline esp_err_t nvs_get_str(nvs_handle_t handle, const char *key, char *out_value, size_t *length)
+{
+    (void)handle;
+    (void)key;
+    (void)out_value;
+    (void)length;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static inline esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    (void)handle;
+    (void)key;
+    (void)out_value;
+    (void)length;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static inline esp_err_t nvs_set_str(nvs_handle_t handle, const char *key, const char *value)
+{
+    (void)handle;
+    (void)key;
+    (void)value;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static inline esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    (void)handle;
+    (void)key;
+    (void)value;
+    (void)length;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static inline esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    (void)handle;
+    return ESP_ERR_NOT_SUPPORTED;
+}
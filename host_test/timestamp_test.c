@@ -0,0 +1,230 @@
+/*
+ * Artımlı zaman damgası çözücü (hd32mt_timestamp_cache_t): doğruluk ve maliyet.
+ *
+ *   timestamp_test [--quick]
+ *
+ * Doğruluk: 2000-2099 arası ardışık "YYMMDDhhmmss" dizileri önbellekli çözülür;
+ * her sonuç önbelleksiz çağrıyla (her seferinde days_from_civil) ve timegm ile
+ * karşılaştırılır. Diziler gün, ay, yıl ve artık gün sınırlarından geçer;
+ * önbelleğin gün değişimi sayısı beklenenle aynı olmalıdır. Geçersiz tarihler
+ * önbellek doluyken de reddedilmeli ve önbelleği bozmamalıdır.
+ *
+ * Ölçüm: saniyede bir kayıt (sahadaki kayıt aralığı), önbellekli / önbelleksiz.
+ * Toplu / tek tek kayıt çözümlemesinin karşılaştırması frame_bench'tedir.
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "data_parser.h"
+#include "host_sample.h"
+
+#define TEST_FIRST_YEAR       (2000)
+#define TEST_LAST_YEAR        (2099)
+#define TEST_WALK_STEP_S      (26017)        /* 7 sa 13 dk 37 sn: her saat dilimine düşer */
+#define TEST_EDGE_SECONDS     (30)           /* Gece yarısı çevresinde saniye saniye */
+#define BENCH_RECORDS_FULL    (20000000u)
+#define BENCH_RECORDS_QUICK   (1000000u)
+#define BENCH_TIMESTAMP_BYTES (13)
+
+static bool s_ok = true;
+
+static void format_timestamp(time_t epoch, char *out)
+{
+    struct tm tm;
+    char text[32];
+    gmtime_r(&epoch, &tm);
+    snprintf(text, sizeof(text), "%02d%02d%02d%02d%02d%02d", tm.tm_year % 100, tm.tm_mon + 1,
+             tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+    memcpy(out, text, BENCH_TIMESTAMP_BYTES);
+}
+
+static time_t civil_epoch(int year, int month, int day, int hour, int minute, int second)
+{
+    struct tm tm = { .tm_year = year - 1900, .tm_mon = month - 1, .tm_mday = day,
+                     .tm_hour = hour, .tm_min = minute, .tm_sec = second };
+    return timegm(&tm);
+}
+
+/* ---------------------------------- Doğruluk ---------------------------------- */
+
+typedef struct {
+    hd32mt_timestamp_cache_t cache;
+    char     last_day[6];
+    uint32_t expected_changes;
+    uint32_t checked;
+} walk_t;
+
+static void walk_check(walk_t *walk, time_t epoch)
+{
+    char timestamp[BENCH_TIMESTAMP_BYTES];
+    format_timestamp(epoch, timestamp);
+
+    uint32_t cached = 0, uncached = 0;
+    bool cached_ok   = hd32mt_timestamp_decode(&walk->cache, timestamp, &cached);
+    bool uncached_ok = hd32mt_timestamp_decode(NULL, timestamp, &uncached);
+    if (!cached_ok || !uncached_ok || cached != uncached || cached != (uint32_t)epoch) {
+        fprintf(stderr, "  %s: onbellekli %d/%u, onbelleksiz %d/%u, timegm %u\n", timestamp,
+                cached_ok, (unsigned)cached, uncached_ok, (unsigned)uncached, (unsigned)epoch);
+        s_ok = false;
+    }
+    if (walk->checked == 0 || memcmp(walk->last_day, timestamp, sizeof(walk->last_day)) != 0) {
+        memcpy(walk->last_day, timestamp, sizeof(walk->last_day));
+        walk->expected_changes++;
+    }
+    walk->checked++;
+}
+
+static void walk_finish(const walk_t *walk, const char *name)
+{
+    bool ok = walk->cache.day_changes == walk->expected_changes;
+    printf("  %-14s %9u damga  %7u gun degisimi%s\n", name, (unsigned)walk->checked,
+           (unsigned)walk->cache.day_changes, ok ? "" : "  SAYI FARKLI");
+    s_ok &= ok;
+}
+
+/* Tek önbellekle 100 yıl boyunca düzensiz adımlı yürüyüş */
+static void test_walk(void)
+{
+    walk_t walk = {0};
+    const time_t end = civil_epoch(TEST_LAST_YEAR + 1, 1, 1, 0, 0, 0);
+    for (time_t epoch = civil_epoch(TEST_FIRST_YEAR, 1, 1, 0, 0, 0); epoch < end; epoch += TEST_WALK_STEP_S) {
+        walk_check(&walk, epoch);
+    }
+    walk_finish(&walk, "yuruyus");
+}
+
+/* Her ay başı (yıl başları ve 28/29 Şubat → 1 Mart dahil) gece yarısının iki yanı */
+static void test_month_edges(void)
+{
+    walk_t walk = {0};
+    for (int year = TEST_FIRST_YEAR; year <= TEST_LAST_YEAR; ++year) {
+        for (int month = 1; month <= 12; ++month) {
+            const time_t midnight = civil_epoch(year, month, 1, 0, 0, 0);
+            if (year == TEST_FIRST_YEAR && month == 1) {
+                walk_check(&walk, midnight);   // 1999 çözücünün aralığında değil
+                continue;
+            }
+            for (time_t epoch = midnight - TEST_EDGE_SECONDS; epoch < midnight + TEST_EDGE_SECONDS; ++epoch) {
+                walk_check(&walk, epoch);
+            }
+        }
+    }
+    walk_finish(&walk, "ay sinirlari");
+}
+
+/* Geçersiz tarih önbellek doluyken de reddedilir, önbelleği değiştirmez */
+static void test_invalid(void)
+{
+    static const char *const INVALID[] = {
+        "010229120000",   // 2001 artık değil
+        "000230120000",
+        "000431120000",
+        "000001120000",
+        "001301120000",
+        "000100120000",
+        "991232000000",
+        "240229240000",
+        "240229236000",
+        "240229235960",
+        "24022a120000",
+        "240229 20000",
+    };
+    static const struct { const char *timestamp; int year, month, day; } VALID[] = {
+        { "000229000000", 2000, 2, 29 },   // 400'e bölünür: artık
+        { "240229235959", 2024, 2, 29 },
+        { "991231235959", 2099, 12, 31 },
+    };
+
+    hd32mt_timestamp_cache_t cache = {0};
+    size_t checked = 0;
+    for (size_t v = 0; v < sizeof(VALID) / sizeof(VALID[0]); ++v) {
+        const char *timestamp = VALID[v].timestamp;
+        const time_t expected = civil_epoch(VALID[v].year, VALID[v].month, VALID[v].day,
+                                            (timestamp[6] - '0') * 10 + (timestamp[7] - '0'),
+                                            (timestamp[8] - '0') * 10 + (timestamp[9] - '0'),
+                                            (timestamp[10] - '0') * 10 + (timestamp[11] - '0'));
+        uint32_t epoch = 0;
+        if (!hd32mt_timestamp_decode(&cache, timestamp, &epoch) || epoch != (uint32_t)expected) {
+            fprintf(stderr, "  %s: gecerli tarih reddedildi/yanlis (%u)\n", timestamp, (unsigned)epoch);
+            s_ok = false;
+            continue;
+        }
+        for (size_t i = 0; i < sizeof(INVALID) / sizeof(INVALID[0]); ++i, ++checked) {
+            const hd32mt_timestamp_cache_t before = cache;
+            uint32_t ignored;
+            if (hd32mt_timestamp_decode(&cache, INVALID[i], &ignored) ||
+                hd32mt_timestamp_decode(NULL, INVALID[i], &ignored)) {
+                fprintf(stderr, "  %s: gecersiz tarih kabul edildi\n", INVALID[i]);
+                s_ok = false;
+            }
+            if (memcmp(cache.day, before.day, sizeof(cache.day)) != 0 ||
+                cache.day_epoch != before.day_epoch || cache.day_changes != before.day_changes) {
+                fprintf(stderr, "  %s: gecersiz tarih onbellegi degistirdi\n", INVALID[i]);
+                s_ok = false;
+            }
+        }
+        // Aynı gün önbellekten çözülmeye devam eder
+        if (!hd32mt_timestamp_decode(&cache, timestamp, &epoch) || epoch != (uint32_t)expected) {
+            fprintf(stderr, "  %s: gecersiz tarihten sonra yanlis\n", timestamp);
+            s_ok = false;
+        }
+    }
+    printf("  %-14s %9zu damga\n", "gecersiz", checked);
+}
+
+/* ----------------------------------- Ölçüm ----------------------------------- */
+
+static void bench(uint32_t records)
+{
+    char *timestamps = malloc((size_t)records * BENCH_TIMESTAMP_BYTES);
+    if (!timestamps) {
+        fprintf(stderr, "bellek yok\n");
+        s_ok = false;
+        return;
+    }
+    // Ay sonu + artık gün: 2024-02-28 12:00:00'dan saniyede bir kayıt
+    const time_t start = civil_epoch(2024, 2, 28, 12, 0, 0);
+    for (uint32_t i = 0; i < records; ++i) {
+        format_timestamp(start + i, timestamps + (size_t)i * BENCH_TIMESTAMP_BYTES);
+    }
+
+    uint64_t sums[2] = {0};
+    double ns_per[2];
+    hd32mt_timestamp_cache_t cache = {0};
+    for (int cached = 0; cached < 2; ++cached) {
+        uint64_t begin = host_now_ns();
+        for (uint32_t i = 0; i < records; ++i) {
+            uint32_t epoch = 0;
+            hd32mt_timestamp_decode(cached ? &cache : NULL, timestamps + (size_t)i * BENCH_TIMESTAMP_BYTES, &epoch);
+            sums[cached] += epoch;
+        }
+        ns_per[cached] = (double)(host_now_ns() - begin) / (double)records;
+    }
+    free(timestamps);
+
+    bool ok = sums[0] == sums[1];
+    printf("  %-14s %8.2f ns/damga\n", "onbelleksiz", ns_per[0]);
+    printf("  %-14s %8.2f ns/damga  (%u gun degisimi, x%.2f)%s\n", "onbellekli", ns_per[1],
+           (unsigned)cache.day_changes, ns_per[0] / ns_per[1], ok ? "" : "  OZET FARKLI");
+    s_ok &= ok;
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = argc > 1 && strcmp(argv[1], "--quick") == 0;
+
+    printf("timestamp_test: dogruluk (%d-%d)\n", TEST_FIRST_YEAR, TEST_LAST_YEAR);
+    test_walk();
+    test_month_edges();
+    test_invalid();
+
+    const uint32_t records = quick ? BENCH_RECORDS_QUICK : BENCH_RECORDS_FULL;
+    printf("timestamp_test: %u damga, saniyede bir kayit\n", (unsigned)records);
+    bench(records);
+
+    printf("timestamp_test: %s\n", s_ok ? "OK" : "HATA");
+    return s_ok ? 0 : 1;
+}
@@ -11,6 +11,7 @@
 #include "storage_spiffs.h"
 #include "time_if.h"
 #include "data_parser.h"
+#include "hd32mt_record_arena.h"
 #include "telemetry_service.h"
 #include "data_sender.h"
 #include "net_manager.h"
@@ -48,21 +49,21 @@ static void test_manual_send_task(void *arg)
 {
     ESP_LOGI("TEST_MANUAL", "Manuel veri gönderim testi başlıyor...");
 
-    // Elle oluşturulmuş veri kaydı
-    hd32mt_data_t record = {0};
+    // Elle kanal sayısı ve değerleri (tümü geçerli)
+    static const float values[] = { 11.23f, 45.67f, 89.01f, 23.45f, 78.90f,
+                                     11.22f, 33.44f, 55.66f, 77.88f, 99.00f };
+    const uint8_t channel_count = sizeof(values) / sizeof(values[0]);
 
-    // Elle kanal sayısı ve değerleri
-    record.sensor_count = 10;
-    record.sensors[0] = 11.23;
-    record.sensors[1] = 45.67;
-    record.sensors[2] = 89.01;
-    record.sensors[3] = 23.45;
-    record.sensors[4] = 78.90;
-    record.sensors[5] = 11.22;
-    record.sensors[6] = 33.44;
-    record.sensors[7] = 55.66;
-    record.sensors[8] = 77.88;
-    record.sensors[9] = 99.00;
+    // Elle oluşturulmuş veri kaydı (tek yuvalık havuzdan)
+    hd32mt_record_arena_t arena;
+    if (!hd32mt_record_arena_init(&arena, 1, channel_count)) {
+        vTaskDelete(NULL);
+        return;
+    }
+    hd32mt_record_t *record = hd32mt_record_arena_alloc(&arena);
+    record->channel_count = channel_count;
+    record->valid_mask    = (1u << record->channel_count) - 1;
+    memcpy(record->values, values, sizeof(values));
 
 
     // Zamanı elle verelim
@@ -75,64 +76,132 @@ static void test_manual_send_task(void *arg)
     ESP_LOGI("TEST_MANUAL", "Test verileri:");
     ESP_LOGI("TEST_MANUAL", "Device ID  : %s", manual_device_id);
     ESP_LOGI("TEST_MANUAL", "Timestamp  : %s", manual_timestamp);
-    ESP_LOGI("TEST_MANUAL", "Channels   : %d", record.sensor_count);
+    ESP_LOGI("TEST_MANUAL", "Channels   : %d", record->channel_count);
     ESP_LOGI("TEST_MANUAL", "Values     : %.2f, %.2f, %.2f",
-             record.sensors[0], record.sensors[1], record.sensors[2]);
+             record->values[0], record->values[1], record->values[2]);
 
     // Burada data_sender fonksiyonuna doğrudan çağrı yapıyoruz
-    bool ok = data_sender_send_frame_from_record(&record,
-                                                 record.sensor_count,
+    bool ok = data_sender_send_frame_from_record(record,
+                                                 record->channel_count,
                                                  NULL);
 
     ESP_LOGI("TEST_MANUAL", "Gönderim sonucu: %s", ok ? "OK" : "FAIL");
 
+    hd32mt_record_arena_deinit(&arena);
     vTaskDelete(NULL);
 }
-/* ---------------------------- TEST VERİ PARSİNG VE GÖNDERİMİ ---------------------------- */
-
-static const char *TAG_TEST = "TEST_INJECT";
-
-static void test_inject_task(void *arg)
+/* ---------------------------- YAKALAMA TEKRAR OYNATMA TESTİ ---------------------------- */
+
+/*
+ * 1 ise UART yerine bir replay kaynağı tüm hattan geçirilir:
+ * çerçeveleme → halka → parse → gönderim.
+ *  - APP_REPLAY_SOURCE_PARTITION: "capture" bölümündeki yakalama (HDCP ya da
+ *    DELTA SAMPLE DATA.txt metni).
+ *    Bölüm: parttool.py write_partition --partition-name capture --input <dosya>
+ *  - APP_REPLAY_SOURCE_SYNTH: sentetik HD32MT üreteci (hız/kanal/gürültü ayarlı);
+ *    uçtan uca kayıt/sn ve kayıp oranı periyodik olarak loglanır.
+ */
+#define APP_REPLAY_ENABLED          0
+#define APP_REPLAY_SOURCE_PARTITION 0
+#define APP_REPLAY_SOURCE_SYNTH     1
+#define APP_REPLAY_SOURCE           APP_REPLAY_SOURCE_PARTITION
+#define APP_REPLAY_PARTITION_LABEL  "capture"
+#define APP_REPLAY_SPEED            SERIAL_REPLAY_SPEED_REALTIME   /* 1..1000, 0 = beklemeden */
+#define APP_REPLAY_LOOP             false
+
+/* Sentetik akış ayarları */
+#define APP_SYNTH_RATE_HZ           10
+#define APP_SYNTH_CHANNELS          4
+#define APP_SYNTH_KEEPALIVE_MS      0
+#define APP_SYNTH_NOISE_BYTES       0
+#define APP_SYNTH_TRICKY_PERCENT    0
+#define APP_SYNTH_REPORT_PERIOD_MS  10000
+
+#if APP_REPLAY_ENABLED
+static const char *TAG_TEST = "TEST_REPLAY";
+
+static serial_replay_t s_test_replay;
+
+#if APP_REPLAY_SOURCE == APP_REPLAY_SOURCE_SYNTH
+static hd32mt_synth_t s_test_synth;
+
+/* Üretilen ↔ hattan geçen kayıtları karşılaştırır */
+static void test_synth_report_task(void *arg)
 {
-    FILE *f = fopen("/spiffs/DELTA SAMPLE DATA.txt", "r");  // SPIFFS'ten okuyoruz
-    if (!f) {
-        ESP_LOGE(TAG_TEST, "Dosya açılamadı!");
-        vTaskDelete(NULL);
-        return;
-    }
-
-    char line[256];
-    while (fgets(line, sizeof(line), f)) {
-        // Satırdaki \r\n karakterlerini temizle
-        char *p = strchr(line, '\r'); if (p) *p = '\0';
-        p = strchr(line, '\n'); if (p) *p = '\0';
+    uint8_t instrument_id = (uint8_t)(uintptr_t)arg;
+    uint32_t last_generated = 0;
+    uint32_t last_parsed = 0;
 
-        if (strlen(line) < 3) continue;  // boş satır geç
-
-        ESP_LOGI(TAG_TEST, "Injecting: %s", line);
-
-        // 1️⃣ Parser’a gönder
-        hd32mt_data_t parsed_record = {0};
-        if (parse_hd32mt_record(line, &parsed_record)) {
-            ESP_LOGI(TAG_TEST, "Parse OK, %d kanal", parsed_record.sensor_count);
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(APP_SYNTH_REPORT_PERIOD_MS));
 
-            // 2️⃣ Sender’a gönder
-            bool ok = data_sender_send_frame_from_record(&parsed_record,
-                                                         parsed_record.sensor_count,
-                                                         NULL);
-            ESP_LOGI(TAG_TEST, "Send result: %s", ok ? "OK" : "FAIL");
-        } else {
-            ESP_LOGW(TAG_TEST, "Parse FAIL: %s", line);
+        telemetry_source_stats_t stats;
+        if (!telemetry_service_get_source_stats(instrument_id, &stats)) {
+            continue;
         }
-
-        vTaskDelay(pdMS_TO_TICKS(1000));  // her satır arasında 1 sn bekle
+        uint32_t generated = s_test_synth.stats.records;
+        uint32_t lost = stats.framer_drops + stats.ring_dropped + stats.spill_lost + stats.parse_errors;
+        double period_s = APP_SYNTH_REPORT_PERIOD_MS / 1000.0;
+
+        ESP_LOGI(TAG_TEST, "Sentetik: uretilen=%u (%.1f/sn) cerceve=%u parse=%u (%.1f/sn) "
+                 "kayip=%u (%%%.3f) gonderim hatasi=%u zor deger=%u",
+                 (unsigned)generated, (generated - last_generated) / period_s,
+                 (unsigned)stats.framed_records,
+                 (unsigned)stats.parsed, (stats.parsed - last_parsed) / period_s,
+                 (unsigned)lost, generated ? 100.0 * lost / generated : 0.0,
+                 (unsigned)stats.send_errors, (unsigned)s_test_synth.stats.tricky_values);
+
+        last_generated = generated;
+        last_parsed    = stats.parsed;
     }
-
-    fclose(f);
-    ESP_LOGI(TAG_TEST, "Test veri enjeksiyonu tamamlandı.");
-    vTaskDelete(NULL);
 }
+#endif
 
+/* Telemetri hattını replay kaynağıyla başlatır; başarısızsa false */
+static bool test_replay_start(int total_channel_count)
+{
+    serial_if_config_t replay_instrument = SERIAL_IF_DEFAULT_CONFIG();
+
+#if APP_REPLAY_SOURCE == APP_REPLAY_SOURCE_SYNTH
+    hd32mt_synth_config_t synth_config = HD32MT_SYNTH_DEFAULT_CONFIG();
+    synth_config.channel_count         = APP_SYNTH_CHANNELS;
+    synth_config.record_rate_hz        = APP_SYNTH_RATE_HZ;
+    synth_config.keepalive_interval_ms = APP_SYNTH_KEEPALIVE_MS;
+    synth_config.noise_bytes           = APP_SYNTH_NOISE_BYTES;
+    synth_config.tricky_percent        = APP_SYNTH_TRICKY_PERCENT;
+    if (!hd32mt_synth_init(&s_test_synth, &synth_config) ||
+        !serial_replay_open_synth(&s_test_replay, &s_test_synth)) {
+        ESP_LOGE(TAG_TEST, "Sentetik üreteç ayarları geçersiz");
+        return false;
+    }
+    /* Zor değerler ancak kanal sayısı bilinirse kaydı bölmez */
+    replay_instrument.record_channel_count = APP_SYNTH_CHANNELS;
+#else
+    if (!serial_replay_open_partition(&s_test_replay, APP_REPLAY_PARTITION_LABEL)) {
+        ESP_LOGE(TAG_TEST, "'%s' bölümü açılamadı", APP_REPLAY_PARTITION_LABEL);
+        return false;
+    }
+#endif
+    serial_replay_set_speed(&s_test_replay, APP_REPLAY_SPEED);
+    s_test_replay.loop = APP_REPLAY_LOOP;
+
+    replay_instrument.rx_mode = SERIAL_RX_MODE_REPLAY;
+    replay_instrument.replay  = &s_test_replay;
+
+    ESP_LOGI(TAG_TEST, "Replay: %s, %u bayt, hız=%ux",
+             s_test_replay.format == SERIAL_REPLAY_FORMAT_CAPTURE ? "yakalama" :
+             s_test_replay.format == SERIAL_REPLAY_FORMAT_SYNTH ? "sentetik" : "metin",
+             (unsigned)s_test_replay.size, (unsigned)s_test_replay.speed_scale);
+    if (!telemetry_service_start_instruments(&replay_instrument, 1, total_channel_count)) {
+        return false;
+    }
+#if APP_REPLAY_SOURCE == APP_REPLAY_SOURCE_SYNTH
+    xTaskCreate(test_synth_report_task, "synth_report", 3072,
+                (void *)(uintptr_t)replay_instrument.instrument_id, 3, NULL);
+#endif
+    return true;
+}
+#endif
 
 /* ---------------------------- ANA GİRİŞ ---------------------------- */
 
@@ -170,18 +239,33 @@ void app_main(void)
     }
     ESP_LOGI(TAG, "Ağ bağlantısı kuruldu ✅");
 
+    if (!data_sender_init()) {
+        ESP_LOGW(TAG, "Kalıcı sunucu bağlantısı hazırlanamadı — satır başına bağlantı kullanılacak");
+    }
+
     /* 5️⃣ Telemetri servisi */
-    if (!telemetry_service_start(/* toplam kanal sayısı */ 10)) {
+#if APP_REPLAY_ENABLED
+    bool telemetry_ok = test_replay_start(/* toplam kanal sayısı */ 10);
+#else
+    bool telemetry_ok = telemetry_service_start(/* toplam kanal sayısı */ 10);
+#endif
+    if (!telemetry_ok) {
         ESP_LOGE(TAG, "Telemetri servisi başlatılamadı!");
     } else {
         ESP_LOGI(TAG, "Telemetri servisi başlatıldı ✅");
+
+#if !APP_REPLAY_ENABLED
+        /* Kesinti sırasında logger belleğinde biriken kayıtları çek */
+        if (!telemetry_service_download_history(/* instrument_id */ 0, NULL)) {
+            ESP_LOGW(TAG, "Geçmiş kayıt indirme başlatılamadı");
+        }
+#endif
     }
 
     /* 6️⃣ BLE */
     ESP_ERROR_CHECK(ble_system_init());
 
 
-    //xTaskCreate(test_inject_task, "test_inject_task", 4096, NULL, 5, NULL);
     xTaskCreate(test_manual_send_task, "test_manual_send_task", 4096, NULL, 5, NULL);
 
 